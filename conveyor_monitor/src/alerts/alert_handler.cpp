@@ -1,4 +1,5 @@
 #include "alert_handler.h"
+#include "../utils/flight_recorder.h"
 
 AlertHandler::AlertHandler() {
   alertCount = 0;
@@ -24,6 +25,7 @@ void AlertHandler::triggerAlert(AlertType type, const char* message) {
   
   // Determine alert level based on type and frequency
   AlertLevel level = determineAlertLevel(type);
+  flightRecorder.record(FLIGHT_ALERT, type, level);
   
   // Add to alert queue
   addAlert(type, level, String(message));
@@ -53,10 +55,12 @@ AlertLevel AlertHandler::determineAlertLevel(AlertType type) {
       
     case ALERT_SPEED_ANOMALY:
     case ALERT_VIBRATION_HIGH:
+    case ALERT_PRE_JAM:
       baseLevel = ALERT_WARNING;
       break;
       
     case ALERT_ENV_CONDITION:
+    case ALERT_NONE:
       baseLevel = ALERT_INFO;
       break;
   }
@@ -166,8 +170,13 @@ void AlertHandler::processAlerts(const SystemState& state) {
     }
   }
   
+  // Clear pre-jam warning once parts flow regularly again
+  if (state.flowIrregularity < PREJAM_SCORE_OFF) {
+    clearAlert(ALERT_PRE_JAM);
+  }
+  
   // Clear speed anomaly if speed is normal
-  if (abs(state.speed_rpm - NOMINAL_SPEED_RPM) < (NOMINAL_SPEED_RPM * SPEED_TOLERANCE_PCT / 100)) {
+  if (fabsf(state.speed_rpm - NOMINAL_SPEED_RPM) < SPEED_TOLERANCE_RPM) {
     clearAlert(ALERT_SPEED_ANOMALY);
   }
   
@@ -202,10 +211,15 @@ void AlertHandler::sendPendingAlerts() {
         case ALERT_ENV_CONDITION: alertTypeStr = "environmental"; break;
         case ALERT_SENSOR_FAILURE: alertTypeStr = "sensor_failure"; break;
         case ALERT_COMM_FAILURE: alertTypeStr = "comm_failure"; break;
+        case ALERT_PRE_JAM: alertTypeStr = "pre_jam"; break;
+        case ALERT_NONE: break;
       }
       
       if (notecard->sendAlert(alertTypeStr, alerts[i].message.c_str(), alerts[i].level)) {
         alerts[i].sent = true;
+      } else if (notecard->wasThrottled()) {
+        // Dropped by the data budget - don't keep retrying every loop
+        alerts[i].sent = true;
       }
     }
   }
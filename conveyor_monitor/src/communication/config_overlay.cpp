@@ -0,0 +1,170 @@
+#include "config_overlay.h"
+#include "../utils/error_handling.h"
+
+namespace {
+
+// Environment variables are strings; missing or empty keeps the default
+float envFloat(J* body, const char* name, float fallback, bool& ok) {
+  const char* value = JGetString(body, name);
+  if (value == nullptr || value[0] == '\0') {
+    return fallback;
+  }
+  char* end;
+  float parsed = strtof(value, &end);
+  ok = ok && end != value && *end == '\0';   // "0.5g" is a typo, not 0.5
+  return parsed;
+}
+
+unsigned long envULong(J* body, const char* name, unsigned long fallback, bool& ok) {
+  const char* value = JGetString(body, name);
+  if (value == nullptr || value[0] == '\0') {
+    return fallback;
+  }
+  char* end;
+  unsigned long parsed = strtoul(value, &end, 10);
+  // strtoul() would wrap "-1" to ULONG_MAX
+  ok = ok && strchr(value, '-') == nullptr && end != value && *end == '\0';
+  return parsed;
+}
+
+bool envBool(J* body, const char* name, bool fallback, bool& ok) {
+  const char* value = JGetString(body, name);
+  if (value == nullptr || value[0] == '\0') {
+    return fallback;
+  }
+  if (!strcmp(value, "1") || !strcmp(value, "true") || !strcmp(value, "on")) {
+    return true;
+  }
+  if (!strcmp(value, "0") || !strcmp(value, "false") || !strcmp(value, "off")) {
+    return false;
+  }
+  ok = false;
+  return fallback;
+}
+
+bool sameConfig(const RuntimeConfig& a, const RuntimeConfig& b) {
+  return a.thresholds.speedTolerancePct == b.thresholds.speedTolerancePct &&
+         a.thresholds.jamVibrationG == b.thresholds.jamVibrationG &&
+         a.thresholds.jamDetectTimeMs == b.thresholds.jamDetectTimeMs &&
+         a.thresholds.vibrationWarningG == b.thresholds.vibrationWarningG &&
+         a.thresholds.vibrationCriticalG == b.thresholds.vibrationCriticalG &&
+         a.tuningEnabled == b.tuningEnabled;
+}
+
+} // namespace
+
+ConfigOverlay::ConfigOverlay() {
+  config = defaultRuntimeConfig();
+  source = CONFIG_SOURCE_DEFAULT;
+  envModified = 0;
+  rejectedCount = 0;
+  updated = false;
+}
+
+void ConfigOverlay::begin() {
+  config = defaultRuntimeConfig();
+  source = CONFIG_SOURCE_DEFAULT;
+  updated = false;
+}
+
+bool ConfigOverlay::apply(const RuntimeConfig& candidate, ConfigSource from) {
+  if (!isValidAnomalyThresholds(candidate.thresholds)) {
+    rejectedCount++;
+    LOG_ERROR_CTX(SystemError::CONFIG_VALIDATION_ERROR, getSourceName(from));
+    return false;
+  }
+
+  source = from;
+  if (sameConfig(candidate, config)) {
+    return false;
+  }
+  config = candidate;
+  updated = true;
+
+  Serial.print(F("Runtime config applied from "));
+  Serial.println(getSourceName(from));
+  return true;
+}
+
+void ConfigOverlay::readEnvironment(J* body, uint32_t modified) {
+  // Unset variables fall back to the compiled-in value, not the previous override
+  const RuntimeConfig defaults = defaultRuntimeConfig();
+  RuntimeConfig candidate = defaults;
+  bool ok = true;
+  candidate.thresholds.speedTolerancePct =
+      envFloat(body, "speed_tolerance_pct", defaults.thresholds.speedTolerancePct, ok);
+  candidate.thresholds.jamVibrationG = envFloat(body, "jam_vibration_g", defaults.thresholds.jamVibrationG, ok);
+  candidate.thresholds.jamDetectTimeMs = envULong(body, "jam_detect_ms", defaults.thresholds.jamDetectTimeMs, ok);
+  candidate.thresholds.vibrationWarningG =
+      envFloat(body, "vibration_warning_g", defaults.thresholds.vibrationWarningG, ok);
+  candidate.thresholds.vibrationCriticalG =
+      envFloat(body, "vibration_critical_g", defaults.thresholds.vibrationCriticalG, ok);
+  candidate.tuningEnabled = envBool(body, "threshold_tuning", defaults.tuningEnabled, ok);
+
+  // Remember the time either way so a rejected set is not re-read every poll
+  envModified = modified;
+  if (!ok) {
+    rejectedCount++;
+    LOG_ERROR_CTX(SystemError::CONFIG_VALIDATION_ERROR, "unparsable environment variable");
+    return;
+  }
+  apply(candidate, CONFIG_SOURCE_ENV);
+}
+
+bool ConfigOverlay::popUpdate() {
+  bool wasUpdated = updated;
+  updated = false;
+  return wasUpdated;
+}
+
+void ConfigOverlay::writeState(J* body) {
+  JAddNumberToObject(body, "speed_tol", config.thresholds.speedTolerancePct);
+  JAddNumberToObject(body, "jam_g", config.thresholds.jamVibrationG);
+  JAddNumberToObject(body, "jam_ms", config.thresholds.jamDetectTimeMs);
+  JAddNumberToObject(body, "vib_warn", config.thresholds.vibrationWarningG);
+  JAddNumberToObject(body, "vib_crit", config.thresholds.vibrationCriticalG);
+  JAddBoolToObject(body, "tuning", config.tuningEnabled);
+  JAddNumberToObject(body, "env_time", envModified);
+}
+
+void ConfigOverlay::readState(J* body) {
+  RuntimeConfig candidate;
+  candidate.thresholds.speedTolerancePct = JGetNumber(body, "speed_tol");
+  candidate.thresholds.jamVibrationG = JGetNumber(body, "jam_g");
+  candidate.thresholds.jamDetectTimeMs = JGetNumber(body, "jam_ms");
+  candidate.thresholds.vibrationWarningG = JGetNumber(body, "vib_warn");
+  candidate.thresholds.vibrationCriticalG = JGetNumber(body, "vib_crit");
+  candidate.tuningEnabled = JGetBool(body, "tuning");
+  if (apply(candidate, CONFIG_SOURCE_FLASH)) {
+    envModified = JGetNumber(body, "env_time");
+  }
+  updated = false; // Restored, not changed - nothing to save or report
+}
+
+void ConfigOverlay::printStats() const {
+  Serial.print(F("Runtime Config - Source: "));
+  Serial.print(getSourceName(source));
+  Serial.print(F(", Speed tol: "));
+  Serial.print(config.thresholds.speedTolerancePct);
+  Serial.print(F("%, Jam: "));
+  Serial.print(config.thresholds.jamVibrationG, 3);
+  Serial.print(F("g/"));
+  Serial.print(config.thresholds.jamDetectTimeMs);
+  Serial.print(F("ms, Warn/Crit: "));
+  Serial.print(config.thresholds.vibrationWarningG, 3);
+  Serial.print(F("/"));
+  Serial.print(config.thresholds.vibrationCriticalG, 3);
+  Serial.print(F("g, Tuning: "));
+  Serial.print(config.tuningEnabled ? F("on") : F("off"));
+  Serial.print(F(", Rejected: "));
+  Serial.println(rejectedCount);
+}
+
+const char* ConfigOverlay::getSourceName(ConfigSource source) {
+  switch (source) {
+    case CONFIG_SOURCE_DEFAULT: return "default";
+    case CONFIG_SOURCE_FLASH: return "flash";
+    case CONFIG_SOURCE_ENV: return "env";
+    default: return "unknown";
+  }
+}
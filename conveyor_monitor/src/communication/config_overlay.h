@@ -0,0 +1,119 @@
+#ifndef CONFIG_OVERLAY_H
+#define CONFIG_OVERLAY_H
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include "../config/config.h"
+#include "../data_processing/anomaly_detector.h"
+
+/**
+ * @brief The configuration subset that can change without a reflash
+ */
+struct RuntimeConfig {
+  AnomalyThresholds thresholds;
+  bool tuningEnabled;
+};
+
+/**
+ * @brief Runtime configuration as compiled in
+ */
+constexpr RuntimeConfig defaultRuntimeConfig() {
+  return RuntimeConfig{defaultAnomalyThresholds(), TUNING_ENABLED};
+}
+
+/**
+ * @brief Where the active runtime configuration came from
+ */
+enum ConfigSource {
+  CONFIG_SOURCE_DEFAULT = 0,   // Compiled-in values
+  CONFIG_SOURCE_FLASH,         // Last applied set, restored from config.dbx
+  CONFIG_SOURCE_ENV            // Notehub environment variables
+};
+
+/**
+ * @brief Field overrides for the detection thresholds and tuning switch
+ *
+ * Everything else stays compile-time constant; this small set is what gets
+ * adjusted per line after installation. Values come from Notehub
+ * environment variables (env.get), each overriding one compiled-in default:
+ *
+ *   speed_tolerance_pct, jam_vibration_g, jam_detect_ms,
+ *   vibration_warning_g, vibration_critical_g, threshold_tuning
+ *
+ * A variable that is unset falls back to the compiled-in value, so deleting
+ * it undoes the override. A set that fails isValidAnomalyThresholds() is
+ * rejected as a whole and the previous set stays active. The applied set is
+ * kept in the local config.dbx Notefile (readState/writeState) so a reboot
+ * uses it before the environment has been read.
+ */
+class ConfigOverlay {
+private:
+  RuntimeConfig config;
+  ConfigSource source;
+  uint32_t envModified;     // Notehub modification time of the applied environment
+  uint32_t rejectedCount;
+  bool updated;
+
+  bool apply(const RuntimeConfig& candidate, ConfigSource from);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  ConfigOverlay();
+
+  /**
+   * @brief Start from the compiled-in configuration
+   */
+  void begin();
+
+  /**
+   * @brief Get the active configuration
+   */
+  const RuntimeConfig& get() const { return config; }
+
+  ConfigSource getSource() const { return source; }
+  uint32_t getRejectedCount() const { return rejectedCount; }
+
+  /**
+   * @brief Modification time of the environment already applied (env.get "time")
+   */
+  uint32_t getEnvironmentTime() const { return envModified; }
+
+  /**
+   * @brief Apply Notehub environment variables
+   * @param body env.get response body (variable name -> string value)
+   * @param modified env.get response time
+   */
+  void readEnvironment(J* body, uint32_t modified);
+
+  /**
+   * @brief Check (and clear) whether the configuration changed
+   * @return true once after each change
+   */
+  bool popUpdate();
+
+  /**
+   * @brief Serialize the active configuration into a note body
+   * @param body JSON object to add fields to
+   */
+  void writeState(J* body);
+
+  /**
+   * @brief Restore a configuration saved by writeState()
+   * @param body JSON object produced by writeState()
+   */
+  void readState(J* body);
+
+  /**
+   * @brief Print the active configuration to Serial
+   */
+  void printStats() const;
+
+  /**
+   * @brief Get human-readable source name
+   */
+  static const char* getSourceName(ConfigSource source);
+};
+
+#endif // CONFIG_OVERLAY_H
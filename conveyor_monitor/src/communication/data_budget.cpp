@@ -0,0 +1,201 @@
+#include "data_budget.h"
+
+static const unsigned long BUDGET_DAY_MS = 86400000UL;
+
+// Short per-file keys used in the persisted state note
+static const char* const FILE_KEYS[NOTE_FILE_COUNT] = { "tel", "evt", "alr", "hlt", "dtm" };
+
+DataBudgetGovernor::DataBudgetGovernor() {
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    bytesUsed[i] = 0;
+    notesSent[i] = 0;
+    notesThrottled[i] = 0;
+  }
+  dayStartTime = 0;
+  telemetryOffered = 0;
+  level = BUDGET_OK;
+  dirty = false;
+}
+
+void DataBudgetGovernor::begin() {
+  dayStartTime = millis();
+}
+
+void DataBudgetGovernor::checkDayRollover() {
+  unsigned long currentTime = millis();
+  if (currentTime - dayStartTime < BUDGET_DAY_MS) {
+    return;
+  }
+
+  Serial.print(F("Data budget day complete - used "));
+  Serial.print(getBytesUsed());
+  Serial.print(F(" of "));
+  Serial.print((unsigned long)DAILY_DATA_BUDGET_BYTES);
+  Serial.println(F(" bytes"));
+
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    bytesUsed[i] = 0;
+    notesSent[i] = 0;
+    notesThrottled[i] = 0;
+  }
+  // Advance by whole days so the day boundary does not drift
+  dayStartTime += ((currentTime - dayStartTime) / BUDGET_DAY_MS) * BUDGET_DAY_MS;
+  dirty = true;
+}
+
+void DataBudgetGovernor::updateLevel() {
+  BudgetLevel newLevel = BUDGET_OK;
+  uint32_t used = getBytesUsed();
+
+  if (used >= DAILY_DATA_BUDGET_BYTES) {
+    newLevel = BUDGET_EXHAUSTED;
+  } else {
+    float ratio = (float)getForecastBytes() / DAILY_DATA_BUDGET_BYTES;
+    if (ratio >= BUDGET_CONSTRAINED_RATIO) {
+      newLevel = BUDGET_CONSTRAINED;
+    } else if (ratio >= BUDGET_REDUCED_RATIO) {
+      newLevel = BUDGET_REDUCED;
+    }
+  }
+
+  if (newLevel != level) {
+    Serial.print(F("Data budget level: "));
+    Serial.print(getLevelName(level));
+    Serial.print(F(" -> "));
+    Serial.println(getLevelName(newLevel));
+    level = newLevel;
+  }
+}
+
+bool DataBudgetGovernor::admit(NoteFile file, AlertLevel alertLevel) {
+  checkDayRollover();
+  updateLevel();
+
+  bool allowed = true;
+  switch (file) {
+    case NOTE_FILE_ALERTS:
+      // Critical alerts always go out; the rest only stop once the budget is spent
+      allowed = (alertLevel >= ALERT_CRITICAL) || (level < BUDGET_EXHAUSTED);
+      break;
+
+    case NOTE_FILE_TELEMETRY:
+      // Degrade telemetry resolution first by decimating notes
+      telemetryOffered++;
+      if (level == BUDGET_REDUCED) {
+        allowed = (telemetryOffered % 2) == 0;
+      } else if (level == BUDGET_CONSTRAINED) {
+        allowed = (telemetryOffered % 4) == 0;
+      } else if (level == BUDGET_EXHAUSTED) {
+        allowed = false;
+      }
+      break;
+
+    case NOTE_FILE_HEALTH:
+    case NOTE_FILE_DOWNTIME:
+      // Health carries the budget state itself and a downtime batch replaces
+      // many events, so keep both until the budget is spent
+      allowed = (level < BUDGET_EXHAUSTED);
+      break;
+
+    case NOTE_FILE_EVENTS:
+    default:
+      allowed = (level < BUDGET_CONSTRAINED);
+      break;
+  }
+
+  if (!allowed) {
+    notesThrottled[file]++;
+    dirty = true;
+  }
+  return allowed;
+}
+
+void DataBudgetGovernor::recordSent(NoteFile file, size_t payloadBytes) {
+  bytesUsed[file] += payloadBytes + NOTE_OVERHEAD_BYTES;
+  notesSent[file]++;
+  dirty = true;
+}
+
+uint32_t DataBudgetGovernor::getBytesUsed() const {
+  uint32_t total = 0;
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    total += bytesUsed[i];
+  }
+  return total;
+}
+
+uint32_t DataBudgetGovernor::getNotesThrottled() const {
+  uint32_t total = 0;
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    total += notesThrottled[i];
+  }
+  return total;
+}
+
+uint32_t DataBudgetGovernor::getForecastBytes() const {
+  // Extrapolate the day's average rate, but never from less than
+  // BUDGET_FORECAST_MIN_MS so a startup burst does not look like a trend
+  unsigned long elapsed = max(millis() - dayStartTime, (unsigned long)BUDGET_FORECAST_MIN_MS);
+  float rate = (float)getBytesUsed() / elapsed;
+  return (uint32_t)(rate * BUDGET_DAY_MS);
+}
+
+void DataBudgetGovernor::writeState(J* body) {
+  char key[8];
+  JAddNumberToObject(body, "day_ms", millis() - dayStartTime);
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    snprintf(key, sizeof(key), "%s_b", FILE_KEYS[i]);
+    JAddNumberToObject(body, key, bytesUsed[i]);
+    snprintf(key, sizeof(key), "%s_n", FILE_KEYS[i]);
+    JAddNumberToObject(body, key, notesSent[i]);
+    snprintf(key, sizeof(key), "%s_t", FILE_KEYS[i]);
+    JAddNumberToObject(body, key, notesThrottled[i]);
+  }
+  dirty = false;
+}
+
+void DataBudgetGovernor::readState(J* body) {
+  unsigned long elapsed = JGetNumber(body, "day_ms");
+  if (elapsed >= BUDGET_DAY_MS) {
+    return; // Saved day already over - keep the fresh allowance
+  }
+
+  char key[8];
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    snprintf(key, sizeof(key), "%s_b", FILE_KEYS[i]);
+    bytesUsed[i] = JGetNumber(body, key);
+    snprintf(key, sizeof(key), "%s_n", FILE_KEYS[i]);
+    notesSent[i] = JGetNumber(body, key);
+    snprintf(key, sizeof(key), "%s_t", FILE_KEYS[i]);
+    notesThrottled[i] = JGetNumber(body, key);
+  }
+  // Time spent powered off is not counted, which errs on the generous side
+  dayStartTime = millis() - elapsed;
+  updateLevel();
+
+  Serial.print(F("Data budget restored - used "));
+  Serial.print(getBytesUsed());
+  Serial.println(F(" bytes today"));
+}
+
+const char* DataBudgetGovernor::getLevelName(BudgetLevel l) {
+  switch (l) {
+    case BUDGET_REDUCED: return "reduced";
+    case BUDGET_CONSTRAINED: return "constrained";
+    case BUDGET_EXHAUSTED: return "exhausted";
+    default: return "ok";
+  }
+}
+
+void DataBudgetGovernor::printStats() const {
+  Serial.print(F("Data Budget - Used: "));
+  Serial.print(getBytesUsed());
+  Serial.print(F("/"));
+  Serial.print((unsigned long)DAILY_DATA_BUDGET_BYTES);
+  Serial.print(F(" bytes, Forecast: "));
+  Serial.print(getForecastBytes());
+  Serial.print(F(", Level: "));
+  Serial.print(getLevelName(level));
+  Serial.print(F(", Throttled: "));
+  Serial.println(getNotesThrottled());
+}
@@ -0,0 +1,147 @@
+#ifndef DATA_BUDGET_H
+#define DATA_BUDGET_H
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include "../config/config.h"
+
+/**
+ * @brief Outbound Notecard files metered by the budget governor
+ */
+enum NoteFile {
+  NOTE_FILE_TELEMETRY = 0,   // telemetry.qo
+  NOTE_FILE_EVENTS,          // events.qo
+  NOTE_FILE_ALERTS,          // alerts.qo
+  NOTE_FILE_HEALTH,          // health.qo
+  NOTE_FILE_DOWNTIME,        // downtime.qo
+  NOTE_FILE_COUNT
+};
+
+/**
+ * @brief Degradation levels, ordered from least to most restrictive
+ */
+enum BudgetLevel {
+  BUDGET_OK = 0,          // On track - everything is sent
+  BUDGET_REDUCED,         // Forecast over budget - every 2nd telemetry note
+  BUDGET_CONSTRAINED,     // Forecast well over budget - every 4th telemetry note, no events
+  BUDGET_EXHAUSTED        // Budget spent - critical alerts only
+};
+
+/**
+ * @brief Daily uplink data budget governor for Notecard traffic
+ *
+ * Meters estimated bytes and note counts per outbound file against
+ * DAILY_DATA_BUDGET_BYTES and forecasts end-of-day usage from the rate so
+ * far. When the forecast runs hot, lower-priority traffic is degraded in
+ * order: telemetry resolution first, then events. Critical alerts are never
+ * throttled.
+ *
+ * The counters are written to a local (non-synced) Notecard database file so
+ * a reboot continues the current day instead of starting a fresh allowance.
+ */
+class DataBudgetGovernor {
+private:
+  uint32_t bytesUsed[NOTE_FILE_COUNT];
+  uint32_t notesSent[NOTE_FILE_COUNT];
+  uint32_t notesThrottled[NOTE_FILE_COUNT];
+  unsigned long dayStartTime;
+  uint32_t telemetryOffered;
+  BudgetLevel level;
+  bool dirty;
+
+  /**
+   * @brief Roll over to a new budget day if 24 hours have elapsed
+   */
+  void checkDayRollover();
+
+  /**
+   * @brief Recompute the degradation level from the current forecast
+   */
+  void updateLevel();
+
+public:
+  /**
+   * @brief Constructor
+   */
+  DataBudgetGovernor();
+
+  /**
+   * @brief Start a fresh budget day
+   */
+  void begin();
+
+  /**
+   * @brief Decide whether a note may be sent under the current budget
+   * @param file Destination Notecard file
+   * @param alertLevel Alert level (only consulted for NOTE_FILE_ALERTS)
+   * @return true if the note should be sent, false if it is throttled
+   */
+  bool admit(NoteFile file, AlertLevel alertLevel = ALERT_INFO);
+
+  /**
+   * @brief Record a note that was handed to the Notecard
+   * @param file Destination Notecard file
+   * @param payloadBytes Size of the note body in bytes
+   */
+  void recordSent(NoteFile file, size_t payloadBytes);
+
+  /**
+   * @brief Get total estimated bytes used today across all files
+   */
+  uint32_t getBytesUsed() const;
+
+  /**
+   * @brief Get estimated bytes used today for one file
+   */
+  uint32_t getBytesUsed(NoteFile file) const { return bytesUsed[file]; }
+
+  /**
+   * @brief Get notes sent today for one file
+   */
+  uint32_t getNotesSent(NoteFile file) const { return notesSent[file]; }
+
+  /**
+   * @brief Get total notes throttled today across all files
+   */
+  uint32_t getNotesThrottled() const;
+
+  /**
+   * @brief Forecast end-of-day usage from the usage rate so far
+   * @return Projected bytes at the end of the current budget day
+   */
+  uint32_t getForecastBytes() const;
+
+  /**
+   * @brief Get the current degradation level
+   */
+  BudgetLevel getLevel() const { return level; }
+
+  /**
+   * @brief Check whether state changed since the last save
+   */
+  bool needsPersist() const { return dirty; }
+
+  /**
+   * @brief Serialize budget state into a note body
+   * @param body JSON object to add fields to
+   */
+  void writeState(J* body);
+
+  /**
+   * @brief Restore budget state from a previously saved note body
+   * @param body JSON object produced by writeState()
+   */
+  void readState(J* body);
+
+  /**
+   * @brief Get printable name of a budget level
+   */
+  static const char* getLevelName(BudgetLevel l);
+
+  /**
+   * @brief Print budget usage statistics to serial
+   */
+  void printStats() const;
+};
+
+#endif // DATA_BUDGET_H
@@ -1,4 +1,12 @@
 #include "notecard_manager.h"
+#include "../utils/flight_recorder.h"
+#include "../data_processing/sample_capture.h"
+
+// Outcome of a note.add, for the flight recorder
+static bool traceNote(NoteFile file, bool queued) {
+  flightRecorder.record(FLIGHT_NOTE, file, queued);
+  return queued;
+}
 
 NotecardManager::NotecardManager() {
   connected = false;
@@ -7,6 +15,10 @@ NotecardManager::NotecardManager() {
   productUID = NOTECARD_PRODUCT_UID;
   continuousMode = NOTECARD_CONTINUOUS;
   syncMinutes = NOTECARD_SYNC_MINS;
+  lastBudgetSave = 0;
+  lastSendThrottled = false;
+  lastPolicySample = 0;
+  syncProfilePending = false;
 }
 
 bool NotecardManager::begin() {
@@ -33,11 +45,104 @@ bool NotecardManager::begin() {
     enableMotionDetection(true);
   }
 
+  // Continue today's data budget across reboots
+  budget.begin();
+  loadLocalState("budget.dbx", budget);
+  lastBudgetSave = millis();
+
   connected = true;
+  
+  // Stamp notes with Unix time from the start if the Notecard already has it
+  pollTime();
+  
+  // Pick the initial sync profile from the current power and queue state
+  syncPolicy.begin();
+  if (!continuousMode) {
+    sampleSyncPolicy();
+  }
+  
   Serial.println(F("Notecard initialized successfully"));
   return true;
 }
 
+void NotecardManager::update() {
+  // Persist budget counters periodically (local file, never synced)
+  if (budget.needsPersist() && millis() - lastBudgetSave >= BUDGET_PERSIST_INTERVAL) {
+    saveLocalState("budget.dbx", budget);
+    lastBudgetSave = millis();
+  }
+  
+  // Reconcile the outbound queue estimate with the Notecard
+  if (queueMonitor.pollDue()) {
+    pollQueueDepth();
+  }
+  
+  // Keep the epoch clock disciplined (rarely: the interval backs off to a day)
+  if (timeSync.syncDue()) {
+    pollTime();
+  }
+  
+  // Re-evaluate the sync profile (continuous mode keeps the radio on anyway)
+  if (!continuousMode && millis() - lastPolicySample >= SYNC_POLICY_INTERVAL) {
+    sampleSyncPolicy();
+  }
+}
+
+void NotecardManager::sampleSyncPolicy() {
+  lastPolicySample = millis();
+  
+  float voltage = 0.0f;
+  bool usbPowered = true;
+  if (!getVoltage(voltage, usbPowered) || !pollQueueDepth()) {
+    return; // Keep the current profile until the Notecard answers
+  }
+  int pending = queueMonitor.getTotalPending();
+  
+  if (syncPolicy.evaluate(voltage, usbPowered, pending)) {
+    syncProfilePending = true;
+  }
+  
+  // Only report a profile the Notecard has taken; a rejected hub.set is retried next sample
+  if (syncProfilePending && applySyncProfile()) {
+    syncProfilePending = false;
+    
+    char data[96];
+    snprintf(data, sizeof(data), "{\"profile\":\"%s\",\"mv\":%d,\"usb\":%s,\"pending\":%d}",
+             SyncPolicy::getProfileName(syncPolicy.getProfile()), (int)(voltage * 1000),
+             usbPowered ? "true" : "false", pending);
+    sendEvent("sync.profile", data);
+  }
+}
+
+void NotecardManager::addTimestamp(J* body) {
+  // "ts" says which clock "time" came from; uptime stamps are not comparable across resets
+  JAddNumberToObject(body, "time", timeSync.noteTime());
+  JAddStringToObject(body, "ts", timeSync.noteTimeBase());
+}
+
+bool NotecardManager::applySyncProfile() {
+  J *req = notecard.newRequest("hub.set");
+  if (!req) {
+    return false;
+  }
+  JAddStringToObject(req, "mode", "periodic");
+  JAddNumberToObject(req, "outbound", syncPolicy.getOutboundMinutes());
+  JAddNumberToObject(req, "inbound", syncPolicy.getInboundMinutes());
+  
+  J *rsp = notecard.requestAndResponse(req);
+  if (!rsp) {
+    return false;
+  }
+  bool ok = !notecard.responseError(rsp);
+  notecard.deleteResponse(rsp);
+  if (ok) {
+    syncMinutes = syncPolicy.getOutboundMinutes();
+  } else {
+    Serial.println(F("Sync profile: hub.set rejected, retrying at the next policy sample"));
+  }
+  return ok;
+}
+
 bool NotecardManager::configureNotecard() {
   // Set product UID
   J *req = notecard.newRequest("hub.set");
@@ -89,6 +194,18 @@ bool NotecardManager::sendTelemetry(const char* jsonData) {
   if (!connected) {
     return false;
   }
+  
+  // Held back while the Notecard queue is backed up
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_TELEMETRY)) {
+    return false;
+  }
+  
+  // Throttled notes are dropped to stay within the daily data budget
+  lastSendThrottled = !budget.admit(NOTE_FILE_TELEMETRY);
+  if (lastSendThrottled) {
+    return false;
+  }
 
   J *req = notecard.newRequest("note.add");
   if (req) {
@@ -123,6 +240,13 @@ bool NotecardManager::sendTelemetry(const char* jsonData) {
         if (JHasObjectItem(telemetryJson, "gas_resistance")) {
           JAddNumberToObject(body, "gas_resistance", JGetNumber(telemetryJson, "gas_resistance"));
         }
+        if (JHasObjectItem(telemetryJson, "iaq")) {
+          JAddNumberToObject(body, "iaq", JGetNumber(telemetryJson, "iaq"));
+          JAddNumberToObject(body, "iaq_acc", JGetNumber(telemetryJson, "iaq_acc"));
+        }
+        if (JHasObjectItem(telemetryJson, "dq")) {
+          JAddNumberToObject(body, "dq", JGetNumber(telemetryJson, "dq"));
+        }
         if (JHasObjectItem(telemetryJson, "running")) {
           JAddBoolToObject(body, "running", JGetBool(telemetryJson, "running"));
         }
@@ -134,12 +258,14 @@ bool NotecardManager::sendTelemetry(const char* jsonData) {
       }
       
       // Add timestamp
-      JAddNumberToObject(body, "time", millis() / 1000);
+      addTimestamp(body);
       
       JAddItemToObject(req, "body", body);
       
-      if (notecard.sendRequest(req)) {
+      if (traceNote(NOTE_FILE_TELEMETRY, notecard.sendRequest(req))) {
         messageCount++;
+        queueMonitor.recordAdded(NOTE_FILE_TELEMETRY);
+        budget.recordSent(NOTE_FILE_TELEMETRY, strlen(jsonData));
         return true;
       }
     }
@@ -152,15 +278,27 @@ bool NotecardManager::sendEvent(const char* eventType, const char* jsonData) {
     return false;
   }
   
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_EVENTS)) {
+    return false;
+  }
+  
+  lastSendThrottled = !budget.admit(NOTE_FILE_EVENTS);
+  if (lastSendThrottled) {
+    return false;
+  }
+  
   J *req = notecard.newRequest("note.add");
   if (req) {
     JAddStringToObject(req, "file", "events.qo");
-    JAddBoolToObject(req, "sync", true); // Sync immediately for events
+    // Sync immediately unless the policy is batching events to save power
+    bool syncNow = syncPolicy.syncEventsImmediately();
+    JAddBoolToObject(req, "sync", syncNow);
     
     J *body = JCreateObject();
     if (body) {
       JAddStringToObject(body, "event", eventType);
-      JAddNumberToObject(body, "time", millis() / 1000);
+      addTimestamp(body);
       
       // Parse and add data as an object instead of string
       if (jsonData && strlen(jsonData) > 0) {
@@ -172,9 +310,14 @@ bool NotecardManager::sendEvent(const char* eventType, const char* jsonData) {
       
       JAddItemToObject(req, "body", body);
       
-      if (notecard.sendRequest(req)) {
+      if (traceNote(NOTE_FILE_EVENTS, notecard.sendRequest(req))) {
         messageCount++;
         lastSyncTime = millis();
+        if (syncNow) {
+          syncPolicy.recordImmediateSync();
+        }
+        queueMonitor.recordAdded(NOTE_FILE_EVENTS);
+        budget.recordSent(NOTE_FILE_EVENTS, strlen(eventType) + (jsonData ? strlen(jsonData) : 0));
         return true;
       }
     }
@@ -187,6 +330,16 @@ bool NotecardManager::sendAlert(const char* alertType, const char* message, Aler
     return false;
   }
   
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_ALERTS, level)) {
+    return false;
+  }
+  
+  lastSendThrottled = !budget.admit(NOTE_FILE_ALERTS, level);
+  if (lastSendThrottled) {
+    return false;
+  }
+  
   J *req = notecard.newRequest("note.add");
   if (req) {
     JAddStringToObject(req, "file", "alerts.qo");
@@ -198,13 +351,181 @@ bool NotecardManager::sendAlert(const char* alertType, const char* message, Aler
       JAddStringToObject(body, "alert", alertType);
       JAddStringToObject(body, "message", message);
       JAddNumberToObject(body, "level", level);
-      JAddNumberToObject(body, "time", millis() / 1000);
+      addTimestamp(body);
       
       JAddItemToObject(req, "body", body);
       
-      if (notecard.sendRequest(req)) {
+      if (traceNote(NOTE_FILE_ALERTS, notecard.sendRequest(req))) {
         messageCount++;
         lastSyncTime = millis();
+        syncPolicy.recordImmediateSync();
+        queueMonitor.recordAdded(NOTE_FILE_ALERTS);
+        budget.recordSent(NOTE_FILE_ALERTS, strlen(alertType) + strlen(message));
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool NotecardManager::sendHealth(const char* jsonData) {
+  if (!connected) {
+    return false;
+  }
+  
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_HEALTH)) {
+    return false;
+  }
+  
+  lastSendThrottled = !budget.admit(NOTE_FILE_HEALTH);
+  if (lastSendThrottled) {
+    return false;
+  }
+  
+  J *req = notecard.newRequest("note.add");
+  if (req) {
+    JAddStringToObject(req, "file", "health.qo");
+    JAddBoolToObject(req, "sync", false); // Ride along with the periodic sync
+    
+    J *body = JParse(jsonData);
+    if (body) {
+      addTimestamp(body);
+      JAddItemToObject(req, "body", body);
+      
+      if (traceNote(NOTE_FILE_HEALTH, notecard.sendRequest(req))) {
+        messageCount++;
+        queueMonitor.recordAdded(NOTE_FILE_HEALTH);
+        budget.recordSent(NOTE_FILE_HEALTH, strlen(jsonData));
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool NotecardManager::sendStateLog(const char* jsonData, const uint8_t* payload, size_t payloadLen) {
+  if (!connected || payloadLen == 0 || payloadLen > MACHINE_LOG_BYTES) {
+    return false;
+  }
+  
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_DOWNTIME)) {
+    return false;
+  }
+  
+  lastSendThrottled = !budget.admit(NOTE_FILE_DOWNTIME);
+  if (lastSendThrottled) {
+    return false;
+  }
+  
+  // Binary run log travels as the note payload (base64)
+  char encoded[((MACHINE_LOG_BYTES + 2) / 3) * 4 + 1];
+  int encodedLen = JB64Encode(encoded, (const char*)payload, payloadLen);
+  
+  J *req = notecard.newRequest("note.add");
+  if (req) {
+    JAddStringToObject(req, "file", "downtime.qo");
+    JAddBoolToObject(req, "sync", false); // Ride along with the periodic sync
+    JAddStringToObject(req, "payload", encoded);
+    
+    J *body = JParse(jsonData);
+    if (body) {
+      JAddItemToObject(req, "body", body);
+      
+      if (traceNote(NOTE_FILE_DOWNTIME, notecard.sendRequest(req))) {
+        messageCount++;
+        queueMonitor.recordAdded(NOTE_FILE_DOWNTIME);
+        budget.recordSent(NOTE_FILE_DOWNTIME, strlen(jsonData) + encodedLen);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool NotecardManager::sendCrashReport(const char* jsonData, const uint8_t* payload, size_t payloadLen) {
+  if (!connected || payloadLen > FLIGHT_NOTE_BYTES) {
+    return false;
+  }
+  
+  // Once per crash: the queue limit applies, the data budget does not
+  if (!queueMonitor.admit(NOTE_FILE_EVENTS)) {
+    return false;
+  }
+  
+  // Compressed flight recorder events travel as the note payload (base64)
+  char encoded[((FLIGHT_NOTE_BYTES + 2) / 3) * 4 + 1];
+  int encodedLen = JB64Encode(encoded, (const char*)payload, payloadLen);
+  
+  J *req = notecard.newRequest("note.add");
+  if (req) {
+    JAddStringToObject(req, "file", "events.qo");
+    JAddBoolToObject(req, "sync", true);
+    JAddStringToObject(req, "payload", encoded);
+    
+    J *body = JCreateObject();
+    if (body) {
+      JAddStringToObject(body, "event", "system.crash");
+      addTimestamp(body);
+      J *dataJson = JParse(jsonData);
+      if (dataJson) {
+        JAddItemToObject(body, "data", dataJson);
+      }
+      JAddItemToObject(req, "body", body);
+      
+      if (traceNote(NOTE_FILE_EVENTS, notecard.sendRequest(req))) {
+        messageCount++;
+        lastSyncTime = millis();
+        syncPolicy.recordImmediateSync();
+        queueMonitor.recordAdded(NOTE_FILE_EVENTS);
+        budget.recordSent(NOTE_FILE_EVENTS, strlen(jsonData) + encodedLen);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool NotecardManager::sendSampleCapture(const char* jsonData, const uint8_t* payload, size_t payloadLen) {
+  if (!connected || payloadLen == 0 || payloadLen > SAMPLE_CAPTURE_PAYLOAD_BYTES) {
+    return false;
+  }
+  
+  lastSendThrottled = false;
+  if (!queueMonitor.admit(NOTE_FILE_EVENTS)) {
+    return false;
+  }
+  
+  lastSendThrottled = !budget.admit(NOTE_FILE_EVENTS);
+  if (lastSendThrottled) {
+    return false;
+  }
+  
+  // Packed readings travel as the note payload (base64); too large for the stack
+  static char encoded[((SAMPLE_CAPTURE_PAYLOAD_BYTES + 2) / 3) * 4 + 1];
+  int encodedLen = JB64Encode(encoded, (const char*)payload, payloadLen);
+  
+  J *req = notecard.newRequest("note.add");
+  if (req) {
+    JAddStringToObject(req, "file", "events.qo");
+    JAddBoolToObject(req, "sync", false); // The alert that triggered it syncs
+    JAddStringToObject(req, "payload", encoded);
+    
+    J *body = JCreateObject();
+    if (body) {
+      JAddStringToObject(body, "event", "samples.capture");
+      addTimestamp(body);
+      J *dataJson = JParse(jsonData);
+      if (dataJson) {
+        JAddItemToObject(body, "data", dataJson);
+      }
+      JAddItemToObject(req, "body", body);
+      
+      if (traceNote(NOTE_FILE_EVENTS, notecard.sendRequest(req))) {
+        messageCount++;
+        queueMonitor.recordAdded(NOTE_FILE_EVENTS);
+        budget.recordSent(NOTE_FILE_EVENTS, strlen(jsonData) + encodedLen);
         return true;
       }
     }
@@ -276,4 +597,57 @@ bool NotecardManager::getSyncStatus(unsigned long& lastSync, unsigned long& next
     return true;
   }
   return false;
+}
+
+bool NotecardManager::getVoltage(float& voltage, bool& usbPowered) {
+  J *req = notecard.newRequest("card.voltage");
+  J *rsp = notecard.requestAndResponse(req);
+  
+  if (rsp) {
+    bool ok = !notecard.responseError(rsp);
+    if (ok) {
+      voltage = JGetNumber(rsp, "value");
+      usbPowered = JGetBool(rsp, "usb");
+    }
+    notecard.deleteResponse(rsp);
+    return ok;
+  }
+  return false;
+}
+
+bool NotecardManager::pollQueueDepth() {
+  // One request reports pending notes for every outbound file
+  J *req = notecard.newRequest("file.changes");
+  J *rsp = notecard.requestAndResponse(req);
+  
+  if (rsp) {
+    bool ok = !notecard.responseError(rsp);
+    if (ok) {
+      queueMonitor.applyFileChanges(rsp);
+    }
+    notecard.deleteResponse(rsp);
+    return ok;
+  }
+  return false;
+}
+
+bool NotecardManager::pollTime() {
+  J *req = notecard.newRequest("card.time");
+  unsigned long requestTime = millis();
+  J *rsp = notecard.requestAndResponse(req);
+  unsigned long responseTime = millis();
+  
+  if (rsp) {
+    // Until its first sync the Notecard has no time and answers {no-time} or 0
+    uint32_t epoch = (uint32_t)JGetNumber(rsp, "time");
+    bool ok = !notecard.responseError(rsp) && epoch > 0;
+    notecard.deleteResponse(rsp);
+    if (ok) {
+      timeSync.apply(epoch, requestTime, responseTime);
+      flightRecorder.setTimeReference(responseTime, timeSync.epochMsAt(responseTime) / 1000);
+      return true;
+    }
+  }
+  timeSync.recordFailure(responseTime);
+  return false;
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <Arduino.h>
 #include <Notecard.h>
 #include "../config/config.h"
+#include "data_budget.h"
+#include "sync_policy.h"
+#include "queue_monitor.h"
+#include "time_sync.h"
 
 // Notecard Serial configuration
 #define NOTECARD_SERIAL Serial1
@@ -20,14 +24,34 @@ private:
   bool continuousMode;
   int syncMinutes;
   
+  // Uplink data budget
+  DataBudgetGovernor budget;
+  unsigned long lastBudgetSave;
+  bool lastSendThrottled;
+  
+  // Battery- and queue-aware sync policy
+  SyncPolicy syncPolicy;
+  unsigned long lastPolicySample;
+  bool syncProfilePending;      // Policy changed profile but hub.set has not been accepted yet
+  
+  // Outbound queue depth and backpressure
+  QueueMonitor queueMonitor;
+  
+  // Epoch clock for note timestamps
+  TimeSync timeSync;
+  
   // Helper methods
   bool configureNotecard();
   bool setLocationMode();
+  void sampleSyncPolicy();
+  bool applySyncProfile();
+  void addTimestamp(J* body);
   
 public:
   NotecardManager();
   
   bool begin();
+  void update();
   bool isConnected() { return connected; }
   void reconnect();
   
@@ -35,6 +59,18 @@ public:
   bool sendTelemetry(const char* jsonData);
   bool sendEvent(const char* eventType, const char* jsonData);
   bool sendAlert(const char* alertType, const char* message, AlertLevel level);
+  bool sendHealth(const char* jsonData);
+  bool sendStateLog(const char* jsonData, const uint8_t* payload, size_t payloadLen);
+  bool sendCrashReport(const char* jsonData, const uint8_t* payload, size_t payloadLen);
+  bool sendSampleCapture(const char* jsonData, const uint8_t* payload, size_t payloadLen);
+  
+  // Local state notes (.dbx, never synced) - owner provides readState(J*)/writeState(J*),
+  // or pass the member that restores the state
+  template<class T> void loadLocalState(const char* file, T& owner, void (T::*read)(J*) = &T::readState);
+  template<class T> void saveLocalState(const char* file, T& owner);
+  
+  // Notehub environment variables - owner provides getEnvironmentTime()/readEnvironment(J*, uint32_t)
+  template<class T> void loadEnvironment(T& owner);
   
   // Configuration
   void setSyncInterval(int minutes);
@@ -43,7 +79,87 @@ public:
   // Status
   bool getSignalStrength(int& rssi, int& bars);
   bool getSyncStatus(unsigned long& lastSync, unsigned long& nextSync);
+  bool getVoltage(float& voltage, bool& usbPowered);
+  bool pollQueueDepth();
+  bool pollTime();
   unsigned long getMessageCount() { return messageCount; }
+  const DataBudgetGovernor& getBudget() const { return budget; }
+  bool wasThrottled() const { return lastSendThrottled; } // Last send dropped by the data budget
+  const SyncPolicy& getSyncPolicy() const { return syncPolicy; }
+  const QueueMonitor& getQueueMonitor() const { return queueMonitor; }
+  Backpressure getBackpressure() const { return queueMonitor.getLevel(); }
+  const TimeSync& getTimeSync() const { return timeSync; }
 };
 
+template<class T>
+void NotecardManager::loadLocalState(const char* file, T& owner, void (T::*read)(J*)) {
+  J *req = notecard.newRequest("note.get");
+  if (req) {
+    JAddStringToObject(req, "file", file);
+    JAddStringToObject(req, "note", "state");
+    J *rsp = notecard.requestAndResponse(req);
+    if (rsp) {
+      J *body = JGetObject(rsp, "body");
+      if (!notecard.responseError(rsp) && body) {
+        (owner.*read)(body);
+      }
+      notecard.deleteResponse(rsp);
+    }
+  }
+}
+
+template<class T>
+void NotecardManager::saveLocalState(const char* file, T& owner) {
+  J *req = notecard.newRequest("note.update");
+  if (req) {
+    JAddStringToObject(req, "file", file);
+    JAddStringToObject(req, "note", "state");
+    J *body = JCreateObject();
+    if (body) {
+      owner.writeState(body);
+      JAddItemToObject(req, "body", body);
+    }
+    J *rsp = notecard.requestAndResponse(req);
+    if (rsp) {
+      bool failed = notecard.responseError(rsp);
+      notecard.deleteResponse(rsp);
+      if (!failed) {
+        return;
+      }
+    }
+  }
+  
+  // First save of the state note - create it
+  req = notecard.newRequest("note.add");
+  if (req) {
+    JAddStringToObject(req, "file", file);
+    JAddStringToObject(req, "note", "state");
+    J *body = JCreateObject();
+    if (body) {
+      owner.writeState(body);
+      JAddItemToObject(req, "body", body);
+    }
+    notecard.sendRequest(req);
+  }
+}
+
+template<class T>
+void NotecardManager::loadEnvironment(T& owner) {
+  J *req = notecard.newRequest("env.get");
+  if (req) {
+    // With "time" the Notecard answers {env-not-modified} instead of the variables
+    if (owner.getEnvironmentTime() != 0) {
+      JAddNumberToObject(req, "time", owner.getEnvironmentTime());
+    }
+    J *rsp = notecard.requestAndResponse(req);
+    if (rsp) {
+      J *body = JGetObject(rsp, "body");
+      if (!notecard.responseError(rsp) && body) {
+        owner.readEnvironment(body, (uint32_t)JGetNumber(rsp, "time"));
+      }
+      notecard.deleteResponse(rsp);
+    }
+  }
+}
+
 #endif // NOTECARD_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "queue_monitor.h"
+
+// Notecard file names, indexed by NoteFile
+static const char* const FILE_NAMES[NOTE_FILE_COUNT] = {
+  "telemetry.qo", "events.qo", "alerts.qo", "health.qo", "downtime.qo"
+};
+
+QueueMonitor::QueueMonitor() {
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    pending[i] = 0;
+    highWatermark[i] = 0;
+    notesHeld[i] = 0;
+  }
+  totalHighWatermark = 0;
+  softEvents = 0;
+  hardEvents = 0;
+  telemetryOffered = 0;
+  lastPollTime = 0;
+  level = BACKPRESSURE_NONE;
+}
+
+bool QueueMonitor::pollDue() const {
+  unsigned long sincePoll = millis() - lastPollTime;
+  if (sincePoll >= QUEUE_POLL_INTERVAL) {
+    return true;
+  }
+  // Confirm quickly before holding traffic back on a stale estimate
+  return getTotalPending() >= QUEUE_SOFT_LIMIT && sincePoll >= QUEUE_POLL_MIN_INTERVAL;
+}
+
+void QueueMonitor::applyFileChanges(J* rsp) {
+  lastPollTime = millis();
+
+  J *info = JGetObject(rsp, "info");
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    J *fileInfo = info ? JGetObject(info, FILE_NAMES[i]) : nullptr;
+    pending[i] = fileInfo ? JGetInt(fileInfo, "changes") : 0;
+  }
+  updateLevel();
+}
+
+void QueueMonitor::updateLevel() {
+  uint16_t total = getTotalPending();
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    highWatermark[i] = max(highWatermark[i], pending[i]);
+  }
+  totalHighWatermark = max(totalHighWatermark, total);
+
+  Backpressure newLevel = BACKPRESSURE_NONE;
+  if (total >= QUEUE_HARD_LIMIT) {
+    newLevel = BACKPRESSURE_HARD;
+  } else if (total >= QUEUE_SOFT_LIMIT) {
+    newLevel = BACKPRESSURE_SOFT;
+  }
+
+  if (newLevel != level) {
+    if (newLevel == BACKPRESSURE_SOFT && level == BACKPRESSURE_NONE) softEvents++;
+    if (newLevel == BACKPRESSURE_HARD) hardEvents++;
+
+    Serial.print(F("Queue backpressure: "));
+    Serial.print(getLevelName(level));
+    Serial.print(F(" -> "));
+    Serial.print(getLevelName(newLevel));
+    Serial.print(F(" ("));
+    Serial.print(total);
+    Serial.println(F(" pending)"));
+    level = newLevel;
+  }
+}
+
+bool QueueMonitor::admit(NoteFile file, AlertLevel alertLevel) {
+  bool allowed = true;
+  uint16_t total = getTotalPending();
+
+  switch (file) {
+    case NOTE_FILE_ALERTS:
+      // Alerts may use the reserve; critical alerts are never held back here
+      allowed = (alertLevel >= ALERT_CRITICAL) || (total < QUEUE_CAPACITY_NOTES);
+      break;
+
+    case NOTE_FILE_TELEMETRY:
+      telemetryOffered++;
+      if (level == BACKPRESSURE_SOFT) {
+        allowed = (telemetryOffered % 2) == 0;
+      } else if (level == BACKPRESSURE_HARD) {
+        allowed = false;
+      }
+      break;
+
+    default:
+      allowed = (level < BACKPRESSURE_HARD);
+      break;
+  }
+
+  if (!allowed) {
+    notesHeld[file]++;
+  }
+  return allowed;
+}
+
+void QueueMonitor::recordAdded(NoteFile file) {
+  pending[file]++;
+  updateLevel();
+}
+
+uint16_t QueueMonitor::getTotalPending() const {
+  uint16_t total = 0;
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    total += pending[i];
+  }
+  return total;
+}
+
+uint32_t QueueMonitor::getNotesHeld() const {
+  uint32_t total = 0;
+  for (int i = 0; i < NOTE_FILE_COUNT; i++) {
+    total += notesHeld[i];
+  }
+  return total;
+}
+
+const char* QueueMonitor::getLevelName(Backpressure b) {
+  switch (b) {
+    case BACKPRESSURE_SOFT: return "soft";
+    case BACKPRESSURE_HARD: return "hard";
+    default: return "none";
+  }
+}
+
+void QueueMonitor::printStats() const {
+  Serial.print(F("Queue - Pending: "));
+  Serial.print(getTotalPending());
+  Serial.print(F(" (tel "));
+  Serial.print(pending[NOTE_FILE_TELEMETRY]);
+  Serial.print(F(", evt "));
+  Serial.print(pending[NOTE_FILE_EVENTS]);
+  Serial.print(F(", alr "));
+  Serial.print(pending[NOTE_FILE_ALERTS]);
+  Serial.print(F("), High: "));
+  Serial.print(totalHighWatermark);
+  Serial.print(F(", Backpressure: "));
+  Serial.print(getLevelName(level));
+  Serial.print(F(", Held: "));
+  Serial.println(getNotesHeld());
+}
@@ -0,0 +1,126 @@
+#ifndef QUEUE_MONITOR_H
+#define QUEUE_MONITOR_H
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include "../config/config.h"
+#include "data_budget.h"
+
+/**
+ * @brief Backpressure levels, ordered from least to most restrictive
+ */
+enum Backpressure {
+  BACKPRESSURE_NONE = 0,   // Queue draining normally
+  BACKPRESSURE_SOFT,       // Above QUEUE_SOFT_LIMIT - telemetry halved
+  BACKPRESSURE_HARD        // Above QUEUE_HARD_LIMIT - alerts only
+};
+
+/**
+ * @brief Outbound Notecard queue depth monitor and backpressure source
+ *
+ * Keeps a per-file estimate of notes waiting to sync. The estimate is
+ * reconciled against the Notecard with a single file.changes request every
+ * QUEUE_POLL_INTERVAL and incremented locally for every note added in
+ * between, so it only ever over-estimates the real queue. That keeps the
+ * firmware from filling the card's storage during long coverage gaps:
+ * telemetry and events are held back at QUEUE_HARD_LIMIT, which leaves
+ * QUEUE_ALERT_RESERVE slots that only alerts may use.
+ */
+class QueueMonitor {
+private:
+  uint16_t pending[NOTE_FILE_COUNT];
+  uint16_t highWatermark[NOTE_FILE_COUNT];
+  uint16_t totalHighWatermark;
+  uint32_t notesHeld[NOTE_FILE_COUNT];
+  uint32_t softEvents;
+  uint32_t hardEvents;
+  uint32_t telemetryOffered;
+  unsigned long lastPollTime;
+  Backpressure level;
+
+  /**
+   * @brief Recompute backpressure level and watermarks from the estimate
+   */
+  void updateLevel();
+
+public:
+  /**
+   * @brief Constructor
+   */
+  QueueMonitor();
+
+  /**
+   * @brief Check whether the Notecard should be polled now
+   * @return true if the regular interval elapsed, or a limit is near and
+   *         the minimum re-poll interval elapsed
+   */
+  bool pollDue() const;
+
+  /**
+   * @brief Reconcile the estimate with a file.changes response
+   * @param rsp Response to a file.changes request
+   */
+  void applyFileChanges(J* rsp);
+
+  /**
+   * @brief Decide whether a note may be queued under current backpressure
+   * @param file Destination Notecard file
+   * @param alertLevel Alert level (only consulted for NOTE_FILE_ALERTS)
+   * @return true if the note may be added, false if it must be held back
+   */
+  bool admit(NoteFile file, AlertLevel alertLevel = ALERT_INFO);
+
+  /**
+   * @brief Record a note added to the Notecard since the last poll
+   * @param file Destination Notecard file
+   */
+  void recordAdded(NoteFile file);
+
+  /**
+   * @brief Get the current backpressure level
+   */
+  Backpressure getLevel() const { return level; }
+
+  /**
+   * @brief Get estimated notes pending across all files
+   */
+  uint16_t getTotalPending() const;
+
+  /**
+   * @brief Get estimated notes pending in one file
+   */
+  uint16_t getPending(NoteFile file) const { return pending[file]; }
+
+  /**
+   * @brief Get the highest total pending count observed
+   */
+  uint16_t getHighWatermark() const { return totalHighWatermark; }
+
+  /**
+   * @brief Get the highest pending count observed for one file
+   */
+  uint16_t getHighWatermark(NoteFile file) const { return highWatermark[file]; }
+
+  /**
+   * @brief Get total notes held back by backpressure
+   */
+  uint32_t getNotesHeld() const;
+
+  /**
+   * @brief Get number of times soft/hard backpressure was entered
+   */
+  uint32_t getSoftEvents() const { return softEvents; }
+  uint32_t getHardEvents() const { return hardEvents; }
+
+  /**
+   * @brief Get printable name of a backpressure level
+   */
+  static const char* getLevelName(Backpressure b);
+
+  /**
+   * @brief Print queue statistics to serial
+   */
+  void printStats() const;
+};
+
+#endif // QUEUE_MONITOR_H
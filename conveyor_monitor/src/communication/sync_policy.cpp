@@ -0,0 +1,112 @@
+#include "sync_policy.h"
+
+SyncPolicy::SyncPolicy() {
+  profile = SYNC_BALANCED;
+  profileEnteredTime = 0;
+  lastVoltage = 0.0f;
+  lastUsbPower = true;
+  lastPendingNotes = 0;
+  transitions = 0;
+  scheduledSyncs = 0.0f;
+  immediateSyncs = 0;
+}
+
+void SyncPolicy::begin() {
+  profile = SYNC_BALANCED;
+  profileEnteredTime = millis();
+}
+
+bool SyncPolicy::evaluate(float voltage, bool usbPowered, int pendingNotes) {
+  lastVoltage = voltage;
+  lastUsbPower = usbPowered;
+  lastPendingNotes = pendingNotes;
+
+  SyncProfile newProfile;
+  if (!usbPowered && voltage < SYNC_LOW_BATTERY_VOLTAGE) {
+    newProfile = SYNC_LOW_BATTERY;
+  } else if (!usbPowered && profile == SYNC_LOW_BATTERY && voltage < SYNC_LOW_BATTERY_RECOVER_VOLTAGE) {
+    newProfile = SYNC_LOW_BATTERY; // Stay put until the battery has clearly recovered
+  } else if (!usbPowered) {
+    newProfile = SYNC_FRUGAL;
+  } else if (pendingNotes >= SYNC_BACKLOG_HIGH) {
+    newProfile = SYNC_AGGRESSIVE;
+  } else if (profile == SYNC_AGGRESSIVE && pendingNotes > SYNC_BACKLOG_LOW) {
+    newProfile = SYNC_AGGRESSIVE; // Keep draining until the backlog is low
+  } else {
+    newProfile = SYNC_BALANCED;
+  }
+
+  if (newProfile == profile) {
+    return false;
+  }
+
+  unsigned long currentTime = millis();
+  accumulateScheduledSyncs(currentTime);
+
+  Serial.print(F("Sync profile: "));
+  Serial.print(getProfileName(profile));
+  Serial.print(F(" -> "));
+  Serial.print(getProfileName(newProfile));
+  Serial.print(F(" ("));
+  Serial.print(voltage);
+  Serial.print(usbPowered ? F("V usb, ") : F("V battery, "));
+  Serial.print(pendingNotes);
+  Serial.println(F(" pending)"));
+
+  profile = newProfile;
+  profileEnteredTime = currentTime;
+  transitions++;
+  return true;
+}
+
+void SyncPolicy::accumulateScheduledSyncs(unsigned long currentTime) {
+  float minutesInProfile = (currentTime - profileEnteredTime) / 60000.0f;
+  scheduledSyncs += minutesInProfile / getOutboundMinutes();
+}
+
+int SyncPolicy::getOutboundMinutes() const {
+  switch (profile) {
+    case SYNC_AGGRESSIVE: return SYNC_AGGRESSIVE_OUTBOUND;
+    case SYNC_FRUGAL: return SYNC_FRUGAL_OUTBOUND;
+    case SYNC_LOW_BATTERY: return SYNC_LOW_BATTERY_OUTBOUND;
+    default: return SYNC_BALANCED_OUTBOUND;
+  }
+}
+
+int SyncPolicy::getInboundMinutes() const {
+  switch (profile) {
+    case SYNC_AGGRESSIVE: return SYNC_AGGRESSIVE_INBOUND;
+    case SYNC_FRUGAL: return SYNC_FRUGAL_INBOUND;
+    case SYNC_LOW_BATTERY: return SYNC_LOW_BATTERY_INBOUND;
+    default: return SYNC_BALANCED_INBOUND;
+  }
+}
+
+uint32_t SyncPolicy::getRadioOnSeconds() const {
+  // Include the scheduled syncs of the profile currently in effect
+  float minutesInProfile = (millis() - profileEnteredTime) / 60000.0f;
+  float sessions = scheduledSyncs + minutesInProfile / getOutboundMinutes() + immediateSyncs;
+  return (uint32_t)(sessions * SYNC_SESSION_EST_SECONDS);
+}
+
+const char* SyncPolicy::getProfileName(SyncProfile p) {
+  switch (p) {
+    case SYNC_FRUGAL: return "frugal";
+    case SYNC_AGGRESSIVE: return "aggressive";
+    case SYNC_LOW_BATTERY: return "low_battery";
+    default: return "balanced";
+  }
+}
+
+void SyncPolicy::printStats() const {
+  Serial.print(F("Sync Policy - Profile: "));
+  Serial.print(getProfileName(profile));
+  Serial.print(F(", Voltage: "));
+  Serial.print(lastVoltage);
+  Serial.print(lastUsbPower ? F("V (usb)") : F("V (battery)"));
+  Serial.print(F(", Pending: "));
+  Serial.print(lastPendingNotes);
+  Serial.print(F(", Radio-on: "));
+  Serial.print(getRadioOnSeconds());
+  Serial.println(F("s"));
+}
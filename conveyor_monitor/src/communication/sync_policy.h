@@ -0,0 +1,124 @@
+#ifndef SYNC_POLICY_H
+#define SYNC_POLICY_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Notecard sync profiles
+ *
+ * The numbers are reported in the health note, so a new profile gets the
+ * next free one rather than its place in the radio-use order.
+ */
+enum SyncProfile {
+  SYNC_FRUGAL = 0,       // On battery - long intervals, events batched
+  SYNC_BALANCED = 1,     // Powered, queue draining normally
+  SYNC_AGGRESSIVE = 2,   // Powered and backed up - short intervals
+  SYNC_LOW_BATTERY = 3   // Battery nearly flat - longest intervals, events batched
+};
+
+/**
+ * @brief Battery- and queue-aware Notecard sync policy
+ *
+ * Chooses hub.set outbound/inbound intervals and whether events sync
+ * immediately or ride along with the next periodic sync, from the power
+ * source and voltage reported by card.voltage and the pending outbound note
+ * count reported by the QueueMonitor. On battery below
+ * SYNC_LOW_BATTERY_VOLTAGE the backlog is ignored and the least radio use
+ * wins. The voltage and backlog thresholds have separate enter/exit levels
+ * so the profile does not flap around a single value.
+ *
+ * Radio-on time is estimated from the number of sync sessions (scheduled
+ * ones derived from the outbound interval, plus immediate ones requested by
+ * sync:true notes) times SYNC_SESSION_EST_SECONDS.
+ */
+class SyncPolicy {
+private:
+  SyncProfile profile;
+  unsigned long profileEnteredTime;
+  float lastVoltage;
+  bool lastUsbPower;
+  int lastPendingNotes;
+  uint32_t transitions;
+
+  // Radio-on accounting
+  float scheduledSyncs;
+  uint32_t immediateSyncs;
+
+  /**
+   * @brief Add the scheduled syncs of the profile being left to the total
+   * @param currentTime Current millis() timestamp
+   */
+  void accumulateScheduledSyncs(unsigned long currentTime);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  SyncPolicy();
+
+  /**
+   * @brief Initialize in SYNC_BALANCED (the configured hub.set intervals)
+   */
+  void begin();
+
+  /**
+   * @brief Evaluate the policy against the latest Notecard readings
+   * @param voltage Supply voltage from card.voltage
+   * @param usbPowered true if the Notecard reports USB/mains power
+   * @param pendingNotes Outbound notes waiting to sync
+   * @return true if the profile changed and hub.set must be reapplied
+   */
+  bool evaluate(float voltage, bool usbPowered, int pendingNotes);
+
+  /**
+   * @brief Record a note sent with sync:true (forces a sync session)
+   */
+  void recordImmediateSync() { immediateSyncs++; }
+
+  /**
+   * @brief Get the current sync profile
+   */
+  SyncProfile getProfile() const { return profile; }
+
+  /**
+   * @brief Get hub.set outbound interval for the current profile
+   * @return Interval in minutes
+   */
+  int getOutboundMinutes() const;
+
+  /**
+   * @brief Get hub.set inbound interval for the current profile
+   * @return Interval in minutes
+   */
+  int getInboundMinutes() const;
+
+  /**
+   * @brief Whether events should sync immediately or be batched
+   * @return true to add events with sync:true
+   */
+  bool syncEventsImmediately() const { return profile == SYNC_BALANCED || profile == SYNC_AGGRESSIVE; }
+
+  /**
+   * @brief Get estimated radio-on time since startup
+   * @return Seconds of estimated radio activity
+   */
+  uint32_t getRadioOnSeconds() const;
+
+  float getLastVoltage() const { return lastVoltage; }
+  bool isUsbPowered() const { return lastUsbPower; }
+  int getLastPendingNotes() const { return lastPendingNotes; }
+  uint32_t getTransitions() const { return transitions; }
+
+  /**
+   * @brief Get printable name of a sync profile
+   */
+  static const char* getProfileName(SyncProfile p);
+
+  /**
+   * @brief Print policy statistics to serial
+   */
+  void printStats() const;
+};
+
+#endif // SYNC_POLICY_H
@@ -1,4 +1,5 @@
 #include "telemetry_formatter.h"
+#include "../sensors/iaq_estimator.h"
 #include "../utils/error_handling.h"
 #include "../utils/performance_utils.h"
 
@@ -6,12 +7,10 @@ TelemetryFormatter::TelemetryFormatter() {
   // Constructor - no initialization needed
 }
 
-float TelemetryFormatter::validateFloat(float value, float defaultValue) const {
-  if (isnan(value) || !isfinite(value)) {
-    return defaultValue;
-  }
-  return value;
-}
+// Field names for data quality warnings, indexed by SensorField
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+  "speed", "parts", "vibration", "temperature", "humidity", "pressure", "gas"
+};
 
 void TelemetryFormatter::appendFloatField(String& json, const char* fieldName, float value, int precision, bool isLast) const {
   json += "\"";
@@ -49,31 +48,30 @@ bool TelemetryFormatter::formatTelemetry(const SystemState& state, char* outputB
     return false;
   }
   
-  // Validate and sanitize input data
-  float speed = validateFloat(state.speed_rpm, 0.0f);
-  float vibration = validateFloat(state.vibrationLevel, 0.0f);
-  float temp = validateFloat(state.temperature, 22.0f);
-  float humidity = validateFloat(state.humidity, 50.0f);
-  float pressure = validateFloat(state.pressure, 1013.25f);
-  uint32_t gas = state.gasResistance;
-  
-  // Use fast string builder for better performance
+  // Values are finite by construction (SensorManager never stores a bad
+  // reading); "dq" tells the cloud which ones are valid and fresh
   FastStringBuilder builder(outputBuffer, bufferSize);
   
   builder.append("{\"speed_rpm\":")
-         .append(speed, 1)
+         .append(state.speed_rpm, 1)
          .append(",\"parts_per_min\":")
          .appendUInt(state.partsPerMinute)
          .append(",\"vibration\":")
-         .append(vibration, 2)
+         .append(state.vibrationLevel, 2)
          .append(",\"temp\":")
-         .append(temp, 1)
+         .append(state.temperature, 1)
          .append(",\"humidity\":")
-         .append(humidity, 1)
+         .append(state.humidity, 1)
          .append(",\"pressure\":")
-         .append(pressure, 1)
+         .append(state.pressure, 1)
          .append(",\"gas_resistance\":")
-         .appendUInt(gas)
+         .appendUInt(state.gasResistance)
+         .append(",\"iaq\":")
+         .appendUInt(state.iaq)
+         .append(",\"iaq_acc\":")
+         .appendUInt(state.iaqAccuracy)
+         .append(",\"dq\":")
+         .appendUInt(usableFields(state))
          .append(",\"running\":")
          .append(state.conveyorRunning)
          .append(",\"operator\":")
@@ -90,47 +88,355 @@ bool TelemetryFormatter::formatTelemetry(const SystemState& state, char* outputB
   return true;
 }
 
-bool TelemetryFormatter::validateSystemState(const SystemState& state) const {
-  bool isValid = true;
+bool TelemetryFormatter::formatHealth(const HealthReport& report, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
+  }
+  
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"uptime\":")
+         .appendUInt(report.uptime_s)
+         .append(",\"errors\":")
+         .appendUInt(report.errorCount)
+         .append(",\"budget\":{\"used\":")
+         .appendUInt(report.budgetUsedBytes)
+         .append(",\"limit\":")
+         .appendUInt(report.budgetLimitBytes)
+         .append(",\"forecast\":")
+         .appendUInt(report.budgetForecastBytes)
+         .append(",\"level\":")
+         .appendUInt(report.budgetLevel)
+         .append(",\"throttled\":")
+         .appendUInt(report.notesThrottled)
+         .append("},\"sync\":{\"profile\":")
+         .appendUInt(report.syncProfile)
+         .append(",\"mv\":")
+         .appendUInt(report.supply_mv)
+         .append(",\"radio_s\":")
+         .appendUInt(report.radioOnSeconds)
+         .append("},\"queue\":{\"pending\":")
+         .appendUInt(report.queuePending)
+         .append(",\"high\":")
+         .appendUInt(report.queueHighWatermark)
+         .append(",\"bp\":")
+         .appendUInt(report.backpressure)
+         .append(",\"held\":")
+         .appendUInt(report.notesHeld)
+         .append("},\"sampling\":{\"mode\":")
+         .appendUInt(report.samplingMode)
+         .append(",\"reads_saved\":")
+         .appendInt(report.sensorReadsSaved)
+         .append(",\"syncs_saved\":")
+         .appendInt(report.cloudSyncsSaved)
+         .append("},\"wdt\":{\"over\":")
+         .appendUInt(report.taskOverruns)
+         .append(",\"resets\":")
+         .appendUInt(report.watchdogResets);
+  if (report.taskOverruns > 0) {
+    builder.append(",\"slow\":\"")
+           .append(TaskWatchdog::getTaskName(report.slowestTask))
+           .append("\",\"slow_ms\":")
+           .appendUInt(report.slowestTaskMs);
+  }
+  builder.append("},\"clock\":{\"synced\":")
+         .append(report.clockSynced ? "true" : "false")
+         .append(",\"ppm\":")
+         .append(report.clockDriftPpm, 1)
+         .append(",\"err_ms\":")
+         .appendInt(report.clockErrorMs)
+         .append(",\"syncs\":")
+         .appendUInt(report.clockSyncs)
+         .append("},\"energy\":{\"mah\":")
+         .append(report.energyMah, 1)
+         .append(",\"ma\":")
+         .append(report.averageCurrentMa)
+         .append(",\"mcu_ma\":")
+         .append(report.mcuCurrentMa)
+         .append(",\"sensors_ma\":")
+         .append(report.sensorCurrentMa)
+         .append(",\"radio_ma\":")
+         .append(report.radioCurrentMa)
+         .append(",\"sleep_pct\":")
+         .appendUInt(report.mcuSleepPct)
+         .append("}}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
+  }
+  
+  return true;
+}
+
+bool TelemetryFormatter::formatShiftSummary(const OEEShiftSummary& summary, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
+  }
+  
+  const OEEAccumulator& t = summary.totals;
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"shift\":")
+         .appendUInt(summary.shiftNumber)
+         .append(",\"oee\":")
+         .appendUInt((uint32_t)(t.oee() * 1000.0f))
+         .append(",\"avail\":")
+         .appendUInt((uint32_t)(t.availability() * 1000.0f))
+         .append(",\"perf\":")
+         .appendUInt((uint32_t)(t.performance() * 1000.0f))
+         .append(",\"qual\":")
+         .appendUInt((uint32_t)(t.quality() * 1000.0f))
+         .append(",\"run_s\":")
+         .appendUInt(t.runMs / 1000)
+         .append(",\"idle_s\":")
+         .appendUInt(t.idleMs / 1000)
+         .append(",\"jam_s\":")
+         .appendUInt(t.jamMs / 1000)
+         .append(",\"parts\":")
+         .appendUInt(t.parts)
+         .append(",\"good\":")
+         .appendUInt(t.goodParts)
+         .append(",\"hourly\":[");
+  
+  for (uint8_t i = 0; i < summary.hourCount; i++) {
+    if (i > 0) {
+      builder.append(",");
+    }
+    builder.appendUInt(summary.hourlyOEE[i]);
+  }
+  builder.append("]}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
+  }
+  
+  return true;
+}
+
+bool TelemetryFormatter::formatCrashReport(const FlightRecorder& recorder, const WatchdogReport& report,
+                                           char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
+  }
+  
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  FlightFreeze freeze = recorder.getPreviousFreeze();
+  
+  // A fault or halt froze the recorder; otherwise the watchdog knows why the run ended
+  builder.append("{\"v\":")
+         .appendUInt(FLIGHT_FORMAT_VERSION)
+         .append(",\"cause\":\"")
+         .append(freeze != FLIGHT_RUNNING ? FlightRecorder::getFreezeName(freeze)
+                                          : TaskWatchdog::getResetCauseName(report.cause))
+         .append("\"");
+  if (report.cause != WDT_RESET_NONE) {
+    builder.append(",\"task\":\"")
+           .append(TaskWatchdog::getTaskName(report.task))
+           .append("\"");
+  }
+  builder.append(",\"end_ms\":")
+         .appendUInt(recorder.getPreviousEndMs());
+  if (recorder.getPreviousEndTime() != 0) {
+    builder.append(",\"end_time\":")
+           .appendUInt(recorder.getPreviousEndTime());
+  }
+  builder.append(",\"events\":")
+         .appendUInt(recorder.getPreviousEvents())
+         .append(",\"lost\":")
+         .appendUInt(recorder.getPreviousTotal() - recorder.getPreviousEvents());
+  if (freeze == FLIGHT_FROZEN_FAULT) {
+    const FlightFault& fault = recorder.getPreviousFault();
+    builder.append(",\"pc\":").appendUInt(fault.pc)
+           .append(",\"lr\":").appendUInt(fault.lr)
+           .append(",\"psr\":").appendUInt(fault.psr)
+           .append(",\"cfsr\":").appendUInt(fault.cfsr)
+           .append(",\"hfsr\":").appendUInt(fault.hfsr)
+           .append(",\"mmfar\":").appendUInt(fault.mmfar)
+           .append(",\"bfar\":").appendUInt(fault.bfar);
+  }
+  builder.append("}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
+  }
+  
+  return true;
+}
+
+bool TelemetryFormatter::formatSPCViolation(const SPCViolation& violation, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
+  }
+  
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"signal\":\"")
+         .append(SPCMonitor::getSignalName(violation.signal))
+         .append("\",\"rules\":[");
   
-  // Check for invalid float values
-  if (isnan(state.speed_rpm) || !isfinite(state.speed_rpm)) {
-    Serial.println(F("WARNING: Invalid speed_rpm value"));
-    isValid = false;
+  bool first = true;
+  for (int i = 0; i < SPC_RULE_COUNT; i++) {
+    SPCRule rule = (SPCRule)(1 << i);
+    if (!(violation.rules & rule)) {
+      continue;
+    }
+    builder.append(first ? "\"" : ",\"")
+           .append(SPCChart::getRuleName(rule))
+           .append("\"");
+    first = false;
   }
   
-  if (isnan(state.vibrationLevel) || !isfinite(state.vibrationLevel)) {
-    Serial.println(F("WARNING: Invalid vibrationLevel value"));
-    isValid = false;
+  builder.append("],\"value\":")
+         .append(violation.value, 3)
+         .append(",\"range\":")
+         .append(violation.range, 3)
+         .append(",\"cl\":")
+         .append(violation.centerLine, 3)
+         .append(",\"sigma\":")
+         .append(violation.sigma, 4)
+         .append("}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
   }
   
-  if (isnan(state.temperature) || !isfinite(state.temperature)) {
-    Serial.println(F("WARNING: Invalid temperature value"));
-    isValid = false;
+  return true;
+}
+
+bool TelemetryFormatter::formatTuningUpdate(const ThresholdTuner& tuner, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
   }
   
-  if (isnan(state.humidity) || !isfinite(state.humidity)) {
-    Serial.println(F("WARNING: Invalid humidity value"));
-    isValid = false;
+  const AnomalyThresholds& t = tuner.getThresholds();
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"epoch\":")
+         .appendUInt(tuner.getEpochs())
+         .append(",\"p_lo\":")
+         .append(tuner.getLastLowQuantile(), 3)
+         .append(",\"p50\":")
+         .append(tuner.getLastMedian(), 3)
+         .append(",\"jam_g\":")
+         .append(t.jamVibrationG, 3)
+         .append(",\"vib_warn\":")
+         .append(t.vibrationWarningG, 3)
+         .append(",\"vib_crit\":")
+         .append(t.vibrationCriticalG, 3)
+         .append(",\"frozen\":")
+         .appendUInt(tuner.getSamplesFrozen())
+         .append("}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
   }
   
-  if (isnan(state.pressure) || !isfinite(state.pressure)) {
-    Serial.println(F("WARNING: Invalid pressure value"));
-    isValid = false;
+  return true;
+}
+
+bool TelemetryFormatter::formatRULUpdate(const RULEstimator& estimator, const RULEstimate* rul, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
   }
   
-  // Check for reasonable value ranges
-  if (state.speed_rpm < 0.0f || state.speed_rpm > 200.0f) {
-    Serial.print(F("WARNING: Speed out of reasonable range: "));
-    Serial.println(state.speed_rpm);
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"hi_g\":")
+         .append(estimator.getLastIndicator(), 3)
+         .append(",\"op_h\":")
+         .append(estimator.getOperatingHours(), 1)
+         .append(",\"points\":")
+         .appendUInt(estimator.getPoints())
+         .append(",\"slope\":")
+         .append(estimator.getSlope(), 5);
+  
+  if (rul != nullptr) {
+    builder.append(",\"rul_h\":")
+           .append(rul->hours, 0)
+           .append(",\"rul_lo_h\":")
+           .append(rul->lowHours, 0)
+           .append(",\"rul_hi_h\":")
+           .append(rul->highHours, 0);
   }
+  builder.append("}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
+  }
+  
+  return true;
+}
+
+bool TelemetryFormatter::formatWatchdogReport(const WatchdogReport& report, char* outputBuffer, size_t bufferSize) const {
+  if (outputBuffer == nullptr || bufferSize == 0) {
+    LOG_ERROR(SystemError::INVALID_PARAMETER);
+    return false;
+  }
+  
+  FastStringBuilder builder(outputBuffer, bufferSize);
+  
+  builder.append("{\"cause\":\"")
+         .append(TaskWatchdog::getResetCauseName(report.cause))
+         .append("\",\"resets\":")
+         .appendUInt(report.resets);
+  if (report.cause != WDT_RESET_NONE) {
+    builder.append(",\"task\":\"")
+           .append(TaskWatchdog::getTaskName(report.task))
+           .append("\",\"stuck_ms\":")
+           .appendUInt(report.stuckMs);
+  }
+  if (report.cause == WDT_RESET_HALT) {
+    builder.append(",\"reason\":\"")
+           .append(report.haltReason)
+           .append("\"");
+  }
+  builder.append(",\"overruns\":[");
+  for (int i = 0; i < WDT_TASK_COUNT; i++) {
+    if (i > 0) builder.append(",");
+    builder.appendUInt(report.overruns[i]);
+  }
+  builder.append("],\"worst_ms\":[");
+  for (int i = 0; i < WDT_TASK_COUNT; i++) {
+    if (i > 0) builder.append(",");
+    builder.appendUInt(report.worstMs[i]);
+  }
+  builder.append("]}");
+  
+  if (builder.getLength() >= bufferSize - 1) {
+    LOG_ERROR(SystemError::BUFFER_OVERFLOW);
+    return false;
+  }
+  
+  return true;
+}
+
+bool TelemetryFormatter::validateSystemState(const SystemState& state) const {
+  uint8_t invalid = ~state.validMask & FIELD_ALL_MASK;
+  uint8_t stale = state.staleMask & state.validMask;
   
-  if (state.temperature < -50.0f || state.temperature > 100.0f) {
-    Serial.print(F("WARNING: Temperature out of reasonable range: "));
-    Serial.println(state.temperature);
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    if (invalid & FIELD_BIT(i)) {
+      Serial.print(F("WARNING: Invalid "));
+      Serial.println(FIELD_NAMES[i]);
+    } else if (stale & FIELD_BIT(i)) {
+      Serial.print(F("WARNING: Stale "));
+      Serial.println(FIELD_NAMES[i]);
+    }
   }
   
-  return isValid;
+  return (invalid | stale) == 0;
 }
 
 void TelemetryFormatter::printDebugInfo(const SystemState& state) const {
@@ -142,6 +448,8 @@ void TelemetryFormatter::printDebugInfo(const SystemState& state) const {
   Serial.print(F("Humidity: ")); Serial.print(state.humidity); Serial.println(F(" %"));
   Serial.print(F("Pressure: ")); Serial.print(state.pressure); Serial.println(F(" hPa"));
   Serial.print(F("Gas Resistance: ")); Serial.print(state.gasResistance); Serial.println(F(" Ω"));
+  Serial.print(F("IAQ: ")); Serial.print(state.iaq);
+  Serial.print(F(" (")); Serial.print(IAQEstimator::getAccuracyName((IAQAccuracy)state.iaqAccuracy)); Serial.println(F(")"));
   Serial.print(F("Running: ")); Serial.println(state.conveyorRunning ? "YES" : "NO");
   Serial.print(F("Operator: ")); Serial.println(state.operatorPresent ? "YES" : "NO");
 }
\ No newline at end of file
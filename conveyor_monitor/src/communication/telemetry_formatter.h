@@ -3,6 +3,12 @@
 
 #include <Arduino.h>
 #include "../config/data_types.h"
+#include "../data_processing/oee_tracker.h"
+#include "../data_processing/spc_monitor.h"
+#include "../data_processing/threshold_tuner.h"
+#include "../data_processing/rul_estimator.h"
+#include "../utils/task_watchdog.h"
+#include "../utils/flight_recorder.h"
 
 /**
  * @brief Handles telemetry data formatting and validation
@@ -15,14 +21,6 @@ class TelemetryFormatter {
 private:
   static const size_t TELEMETRY_BUFFER_SIZE = 512;
   
-  /**
-   * @brief Validates and sanitizes a float value
-   * @param value The float value to validate
-   * @param defaultValue The default value to use if invalid
-   * @return Validated float value
-   */
-  float validateFloat(float value, float defaultValue) const;
-  
   /**
    * @brief Appends a float field to the JSON string
    * @param json The JSON string to append to
@@ -67,9 +65,76 @@ public:
   bool formatTelemetry(const SystemState& state, char* outputBuffer, size_t bufferSize) const;
   
   /**
-   * @brief Validates system state data and logs any issues
-   * @param state The system state data to validate
-   * @return true if all data is valid, false if issues found
+   * @brief Formats a device health snapshot into JSON for health.qo
+   * @param report The health snapshot
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatHealth(const HealthReport& report, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats a completed shift OEE summary into JSON
+   * @param summary The shift summary (ratios are sent in permille)
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatShiftSummary(const OEEShiftSummary& summary, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats an SPC rule-violation event into JSON
+   * @param violation The violation (rules are sent by name)
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatSPCViolation(const SPCViolation& violation, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats newly tuned detection thresholds into JSON
+   * @param tuner The threshold tuner after a completed epoch
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatTuningUpdate(const ThresholdTuner& tuner, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats a new hourly degradation point and the resulting estimate into JSON
+   * @param estimator The RUL estimator after adding a point
+   * @param rul The current estimate, or nullptr while the model is still collecting points
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatRULUpdate(const RULEstimator& estimator, const RULEstimate* rul, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats the previous run's watchdog record into JSON
+   * @param report Reset cause, hung task and per-task overruns (arrays indexed by WatchdogTask)
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatWatchdogReport(const WatchdogReport& report, char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Formats the body of a crash note (the events travel as its payload)
+   * @param recorder Flight recorder holding the previous run
+   * @param report Watchdog record of the previous run (cause and task when no fault froze the recorder)
+   * @param outputBuffer The buffer to write the JSON string to
+   * @param bufferSize The size of the output buffer
+   * @return true if formatting succeeded, false otherwise
+   */
+  bool formatCrashReport(const FlightRecorder& recorder, const WatchdogReport& report,
+                         char* outputBuffer, size_t bufferSize) const;
+  
+  /**
+   * @brief Logs fields flagged invalid or stale at acquisition
+   * @param state The system state data to check
+   * @return true if every measured field is valid and fresh
+   * @details Only reads the quality masks; values are never re-validated here
    */
   bool validateSystemState(const SystemState& state) const;
   
@@ -0,0 +1,130 @@
+#include "time_sync.h"
+
+TimeSync::TimeSync() {
+  synced = false;
+  baseMillis = 0;
+  baseEpochMs = 0;
+  lastReadingMillis = 0;
+  lastReadingEpochMs = 0;
+  driftPpm = 0.0f;
+  interval = TIME_SYNC_MIN_INTERVAL;
+  lastAttempt = 0;
+  waitMs = 0;
+  lastErrorMs = 0;
+  syncs = 0;
+  steps = 0;
+  failures = 0;
+}
+
+bool TimeSync::syncDue() const {
+  return millis() - lastAttempt >= waitMs;
+}
+
+void TimeSync::apply(uint32_t epochSeconds, unsigned long requestTime, unsigned long responseTime) {
+  // The reply describes the middle of the round trip, and card.time truncates to the second
+  unsigned long midpoint = requestTime + (responseTime - requestTime) / 2;
+  uint64_t measured = (uint64_t)epochSeconds * 1000 + 500;
+  lastAttempt = responseTime;
+  syncs++;
+
+  if (!synced) {
+    synced = true;
+    baseMillis = midpoint;
+    baseEpochMs = measured;
+    lastReadingMillis = midpoint;
+    lastReadingEpochMs = measured;
+    lastErrorMs = 0;
+    interval = TIME_SYNC_MIN_INTERVAL;
+    waitMs = interval;
+    return;
+  }
+
+  uint64_t predicted = epochMsAt(midpoint);
+  int64_t error = (int64_t)(measured - predicted);
+  lastErrorMs = error > INT32_MAX ? INT32_MAX : error < INT32_MIN ? INT32_MIN : (int32_t)error;
+  int32_t span = (int32_t)(midpoint - lastReadingMillis);
+
+  if (error > TIME_STEP_THRESHOLD_MS || error < -TIME_STEP_THRESHOLD_MS || span <= 0) {
+    // Too far off to slew: start over from this reading
+    baseMillis = midpoint;
+    baseEpochMs = measured;
+    lastReadingMillis = midpoint;
+    lastReadingEpochMs = measured;
+    driftPpm = 0.0f;
+    interval = TIME_SYNC_MIN_INTERVAL;
+    waitMs = interval;
+    steps++;
+    return;
+  }
+
+  // Rate from reading to reading, so the phase corrections below do not feed back into it.
+  // Over a short span the one-second truncation swamps it
+  if (span >= (int32_t)TIME_SYNC_MIN_INTERVAL / 2) {
+    int64_t spanError = (int64_t)(measured - lastReadingEpochMs) - span;
+    float spanPpm = (float)spanError * 1e6f / (float)span;
+    driftPpm += TIME_DRIFT_GAIN * (spanPpm - driftPpm);
+    driftPpm = constrain(driftPpm, -TIME_MAX_DRIFT_PPM, TIME_MAX_DRIFT_PPM);
+    lastReadingMillis = midpoint;
+    lastReadingEpochMs = measured;
+  }
+
+  // Phase: a share of the error, the rest is card.time's truncation noise
+  baseMillis = midpoint;
+  baseEpochMs = predicted + (int64_t)(TIME_PHASE_GAIN * (float)error);
+
+  // Back off while predictions hold; tighten when one misses
+  if (error <= TIME_SYNC_TOLERANCE_MS && error >= -TIME_SYNC_TOLERANCE_MS) {
+    interval = min(interval * 2, TIME_SYNC_MAX_INTERVAL);
+  } else {
+    interval = max(interval / 2, TIME_SYNC_MIN_INTERVAL);
+  }
+  waitMs = interval;
+}
+
+void TimeSync::recordFailure(unsigned long currentTime) {
+  lastAttempt = currentTime;
+  waitMs = TIME_SYNC_RETRY_MS;
+  failures++;
+
+  // Too long since the last reading to vouch for the extrapolation; the drift is kept
+  if (synced && currentTime - baseMillis > TIME_HOLDOVER_MAX_MS) {
+    synced = false;
+  }
+}
+
+uint64_t TimeSync::epochMsAt(unsigned long ms) const {
+  // Unsigned, so dt does not turn negative after 24.8 days; the cap only matters if
+  // recordFailure() never got to drop the sync
+  uint32_t dt = (uint32_t)(ms - baseMillis);
+  if (dt > TIME_HOLDOVER_MAX_MS) {
+    dt = TIME_HOLDOVER_MAX_MS;
+  }
+  return baseEpochMs + dt + (int64_t)((float)dt * driftPpm * 1e-6f);
+}
+
+uint32_t TimeSync::noteTime() const {
+  unsigned long currentTime = millis();
+  return synced ? (uint32_t)(epochMsAt(currentTime) / 1000) : currentTime / 1000;
+}
+
+void TimeSync::printStats() const {
+  Serial.print(F("Clock - Synced: "));
+  Serial.print(synced ? F("yes") : F("no"));
+  if (synced) {
+    Serial.print(F(", Epoch: "));
+    Serial.print(noteTime());
+    Serial.print(F(", Drift: "));
+    Serial.print(driftPpm, 1);
+    Serial.print(F(" ppm, Last error: "));
+    Serial.print(lastErrorMs);
+    Serial.print(F(" ms, Interval: "));
+    Serial.print(interval / 60000UL);
+    Serial.print(F(" min"));
+  }
+  Serial.print(F(", Syncs: "));
+  Serial.print(syncs);
+  Serial.print(F(", Steps: "));
+  Serial.print(steps);
+  Serial.print(F(", Failures: "));
+  Serial.println(failures);
+}
@@ -0,0 +1,110 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Local epoch clock disciplined by the Notecard's card.time
+ *
+ * millis() is uptime: it restarts on every reset, wraps after 49 days and
+ * runs off the MCU oscillator, which can be off by thousands of ppm. The
+ * Notecard knows Unix time (from the cell network and Notehub) but only to
+ * the second, and asking it costs a serial round trip. So card.time is
+ * only read now and then, and in between wall time is extrapolated:
+ *
+ *   epoch(m) = baseEpoch + dt * (1 + driftPpm / 1e6),  dt = m - baseMillis
+ *
+ * Each sync takes the midpoint of the request as the instant the reply
+ * describes (and the middle of the reported second), compares it with the
+ * prediction and corrects a share of the offset (TIME_PHASE_GAIN). The rate
+ * is measured between raw readings, at least half an hour apart, and
+ * blended into the drift estimate (TIME_DRIFT_GAIN). An error beyond
+ * TIME_STEP_THRESHOLD_MS (first sync after a long outage, a network time
+ * correction) re-bases the clock instead and forgets the drift.
+ *
+ * The sync interval starts at TIME_SYNC_MIN_INTERVAL and doubles, up to
+ * TIME_SYNC_MAX_INTERVAL, for as long as predictions land within
+ * TIME_SYNC_TOLERANCE_MS (and halves when one does not), so a settled
+ * clock costs one request a day.
+ *
+ * Without a successful card.time for TIME_HOLDOVER_MAX_MS the clock drops
+ * back to unsynced, and notes are stamped with (and marked as) uptime until
+ * the next reading.
+ */
+class TimeSync {
+private:
+  bool synced;
+  unsigned long baseMillis;       // millis() at the reference point
+  uint64_t baseEpochMs;           // Unix time at baseMillis (ms)
+  unsigned long lastReadingMillis; // Raw card.time reading the drift is measured from
+  uint64_t lastReadingEpochMs;
+  float driftPpm;                 // Positive: millis() runs slow against wall time
+  unsigned long interval;         // Current resync interval (ms)
+  unsigned long lastAttempt;
+  unsigned long waitMs;           // Until the next attempt: interval, or the retry delay
+  int32_t lastErrorMs;            // Measured minus predicted at the last sync
+
+  // Statistics
+  uint32_t syncs;
+  uint32_t steps;
+  uint32_t failures;
+
+public:
+  /**
+   * @brief Constructor
+   */
+  TimeSync();
+
+  /**
+   * @brief Check whether card.time should be read now
+   */
+  bool syncDue() const;
+
+  /**
+   * @brief Discipline the clock with a card.time reading
+   * @param epochSeconds "time" of the card.time response
+   * @param requestTime millis() just before the request was sent
+   * @param responseTime millis() just after the response arrived
+   */
+  void apply(uint32_t epochSeconds, unsigned long requestTime, unsigned long responseTime);
+
+  /**
+   * @brief Record a failed or time-less card.time (retried after TIME_SYNC_RETRY_MS)
+   */
+  void recordFailure(unsigned long currentTime);
+
+  /**
+   * @brief Unix time in ms at a millis() timestamp at or after the last sync
+   *
+   * Held at TIME_HOLDOVER_MAX_MS past the sync rather than wrapping.
+   */
+  uint64_t epochMsAt(unsigned long ms) const;
+
+  /**
+   * @brief Value for the "time" field of a note body
+   * @return Unix seconds once synced, uptime seconds before that
+   */
+  uint32_t noteTime() const;
+
+  /**
+   * @brief Value for the "ts" field of a note body: the clock noteTime() reads
+   * @return "epoch" once synced, "uptime" before that
+   */
+  const char* noteTimeBase() const { return synced ? "epoch" : "uptime"; }
+
+  bool isSynced() const { return synced; }
+  float getDriftPpm() const { return driftPpm; }
+  int32_t getLastErrorMs() const { return lastErrorMs; }
+  unsigned long getInterval() const { return interval; }
+  uint32_t getSyncCount() const { return syncs; }
+  uint32_t getStepCount() const { return steps; }
+  uint32_t getFailureCount() const { return failures; }
+
+  /**
+   * @brief Print sync state and drift to serial
+   */
+  void printStats() const;
+};
+
+#endif // TIME_SYNC_H
@@ -16,7 +16,8 @@ enum AlertType {
   ALERT_VIBRATION_HIGH,
   ALERT_ENV_CONDITION,
   ALERT_SENSOR_FAILURE,
-  ALERT_COMM_FAILURE
+  ALERT_COMM_FAILURE,
+  ALERT_PRE_JAM          // Part flow bunching ahead of a jam
 };
 
 // Gesture types
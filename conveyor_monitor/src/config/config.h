@@ -9,4 +9,18 @@
 #include "alert_config.h"
 #include "data_types.h"
 
+// Checks that span configuration modules
+static_assert(MOTION_STALE_MS >= 2 * SENSOR_READ_INTERVAL_ECONOMY,
+              "Motion fields would go stale between economy-rate reads");
+static_assert(SPC_SETTLE_MS >= VIBRATION_SAMPLE_SIZE * SENSOR_READ_INTERVAL_ECONOMY &&
+              TUNE_SETTLE_MS >= VIBRATION_SAMPLE_SIZE * SENSOR_READ_INTERVAL_ECONOMY &&
+              RUL_SETTLE_MS >= VIBRATION_SAMPLE_SIZE * SENSOR_READ_INTERVAL_ECONOMY,
+              "Settling must cover one vibration RMS window at the slowest read rate");
+static_assert(SPC_VIBRATION_SAMPLE_MS >= VIBRATION_SAMPLE_SIZE * SENSOR_READ_INTERVAL_ECONOMY,
+              "SPC vibration points must not share an RMS window");
+static_assert(RUL_MIN_SAMPLES * DATA_PROCESS_INTERVAL <= RUL_INTERVAL_MS,
+              "A RUL point needs more samples than one interval can hold");
+static_assert(PART_FLOW_MAX_READ_GAP_MS >= 4 * SENSOR_READ_INTERVAL_ECONOMY,
+              "Economy-rate ToF reads would interrupt the part flow model");
+
 #endif // CONFIG_H
\ No newline at end of file
@@ -3,20 +3,48 @@
 
 #include <Arduino.h>
 
+// Measured SystemState fields, as bit positions in the quality masks
+enum SensorField {
+  FIELD_SPEED = 0,
+  FIELD_PARTS,
+  FIELD_VIBRATION,
+  FIELD_TEMPERATURE,
+  FIELD_HUMIDITY,
+  FIELD_PRESSURE,
+  FIELD_GAS,
+  FIELD_COUNT
+};
+
+#define FIELD_BIT(f)     ((uint8_t)(1u << (f)))
+#define FIELD_ALL_MASK   ((uint8_t)((1u << FIELD_COUNT) - 1))
+
 // System state structure
 struct SystemState {
   bool conveyorRunning;
   float speed_rpm;
   int partsPerMinute;
+  uint32_t totalParts;
+  float flowIrregularity;  // 0 (regular) - 1 (bunched), see PartFlowMonitor
   float vibrationLevel;
   float temperature;
   float humidity;
   float pressure;
   uint32_t gasResistance;
+  uint16_t iaq;         // 0 (clean) - 500, see IAQEstimator
+  uint8_t iaqAccuracy;  // IAQAccuracy
   unsigned long lastJamTime;
   bool operatorPresent;
+  uint8_t validMask;    // FIELD_BIT set = value came from a good reading
+  uint8_t staleMask;    // FIELD_BIT set = not refreshed within its stale window
 };
 
+/**
+ * @brief Fields that are both valid and fresh
+ */
+inline uint8_t usableFields(const SystemState& state) {
+  return state.validMask & ~state.staleMask;
+}
+
 // Sensor reading structure
 struct SensorReadings {
   // Encoder
@@ -43,4 +71,53 @@ struct SensorReadings {
   uint8_t proximity;
 };
 
+// Device health snapshot reported on health.qo
+struct HealthReport {
+  unsigned long uptime_s;
+  int errorCount;
+
+  // Uplink data budget
+  uint32_t budgetUsedBytes;
+  uint32_t budgetLimitBytes;
+  uint32_t budgetForecastBytes;
+  uint8_t budgetLevel;
+  uint32_t notesThrottled;
+
+  // Sync policy
+  uint8_t syncProfile;
+  uint16_t supply_mv;
+  uint32_t radioOnSeconds;
+
+  // Outbound queue
+  uint16_t queuePending;
+  uint16_t queueHighWatermark;
+  uint8_t backpressure;
+  uint32_t notesHeld;
+
+  // Adaptive sampling
+  uint8_t samplingMode;
+  int32_t sensorReadsSaved;
+  int32_t cloudSyncsSaved;
+
+  // Task watchdog
+  uint32_t taskOverruns;
+  uint8_t slowestTask;
+  uint32_t slowestTaskMs;
+  uint32_t watchdogResets;
+
+  // Epoch clock (card.time)
+  bool clockSynced;
+  float clockDriftPpm;           // MCU clock error estimate
+  int32_t clockErrorMs;          // Prediction error at the last sync
+  uint32_t clockSyncs;
+
+  // Energy model (estimates from time in each power state)
+  float energyMah;               // Charge drawn since boot
+  float averageCurrentMa;        // Whole board
+  float mcuCurrentMa;
+  float sensorCurrentMa;         // All sensors
+  float radioCurrentMa;          // Notecard
+  uint8_t mcuSleepPct;           // Share of time in WFI sleep
+};
+
 #endif // DATA_TYPES_H
\ No newline at end of file
@@ -1,45 +1,185 @@
 #ifndef SENSOR_CONFIG_H
 #define SENSOR_CONFIG_H
 
+#include <stdint.h>
+
 // Sensor I2C addresses
-#define BME688_I2C_ADDR         0x76    // Environmental sensor
-#define VL53L1X_I2C_ADDR        0x29    // ToF distance sensor
-#define LSM9DS1_AG_I2C_ADDR     0x6B    // Accel/Gyro
-#define LSM9DS1_M_I2C_ADDR      0x1E    // Magnetometer
-#define APDS9960_I2C_ADDR       0x39    // Gesture sensor
-#define SEESAW_I2C_ADDR         0x36    // Rotary encoder (Adafruit Seesaw)
+constexpr uint8_t BME688_I2C_ADDR = 0x76;      // Environmental sensor
+constexpr uint8_t VL53L1X_I2C_ADDR = 0x29;     // ToF distance sensor
+constexpr uint8_t LSM9DS1_AG_I2C_ADDR = 0x6B;  // Accel/Gyro
+constexpr uint8_t LSM9DS1_M_I2C_ADDR = 0x1E;   // Magnetometer
+constexpr uint8_t APDS9960_I2C_ADDR = 0x39;    // Gesture sensor
+constexpr uint8_t SEESAW_I2C_ADDR = 0x36;      // Rotary encoder (Adafruit Seesaw)
+
+// Sensor interrupt lines
+constexpr uint8_t APDS9960_INT_PIN = 5;        // APDS9960 INT (open drain, active low, gesture FIFO)
 
 // Conveyor parameters
-#define SEESAW_ENCODER_MODULE    1       // Seesaw encoder module number
-#define ENCODER_PULSES_PER_REV   24      // Seesaw encoder resolution (24 detents)
-#define CONVEYOR_GEAR_RATIO      5.0     // Motor to belt ratio
-#define NOMINAL_SPEED_RPM        60.0    // Expected conveyor speed
-#define MIN_SPEED_THRESHOLD      5.0     // Below this = stopped
-#define SPEED_TOLERANCE_PCT      10.0    // Acceptable speed variation %
+constexpr int SEESAW_ENCODER_MODULE = 1;      // Seesaw encoder module number
+constexpr int ENCODER_PULSES_PER_REV = 24;    // Seesaw encoder resolution (24 detents)
+constexpr float CONVEYOR_GEAR_RATIO = 5.0f;   // Motor to belt ratio
+constexpr float NOMINAL_SPEED_RPM = 60.0f;    // Expected conveyor speed
+constexpr float MIN_SPEED_THRESHOLD = 5.0f;   // Below this = stopped
+constexpr float SPEED_TOLERANCE_PCT = 10.0f;  // Acceptable speed variation %
 
 // Part detection parameters
-#define PART_DISTANCE_MM         50      // Expected distance to parts
-#define PART_DETECT_THRESHOLD    100     // Detection distance threshold
-#define JAM_DETECT_TIME_MS       10000   // Time with low vibration = jam (10 seconds)
-#define JAM_VIBRATION_THRESHOLD  0.3     // Vibration level below which indicates jam (g)
-#define EXPECTED_PARTS_PER_MIN   30      // Normal production rate
+constexpr int PART_DISTANCE_MM = 50;                   // Expected distance to parts
+constexpr int PART_DETECT_THRESHOLD = 100;             // Detection distance threshold
+constexpr unsigned long JAM_DETECT_TIME_MS = 10000UL;  // Time with low vibration = jam (10 seconds)
+constexpr float JAM_VIBRATION_THRESHOLD = 0.3f;        // Vibration level below which indicates jam (g)
+constexpr int EXPECTED_PARTS_PER_MIN = 30;             // Normal production rate
+constexpr int SENSOR_FAULT_TIMEOUTS = 5;               // Consecutive ToF timeouts = sensor fault
+
+// Part flow (pre-jam warning from part spacing and ToF dwell, in belt travel)
+constexpr int PART_FLOW_WINDOW = 16;                           // Recent gaps and dwells scored
+constexpr int PART_FLOW_MIN_GAPS = 8;                          // Gaps in the window before a score
+constexpr uint32_t PART_FLOW_LEARN_PARTS = 32;                 // Gaps averaged into the first baseline
+constexpr float PART_FLOW_BASELINE_ALPHA = 0.02f;              // Baseline follows regular flow over ~50 parts
+constexpr float PART_FLOW_MAX_GAP_RATIO = 3.0f;                // Longer gaps = feed stopped, the window restarts
+constexpr unsigned long PART_FLOW_MAX_READ_GAP_MS = 2000UL;    // Longer between ToF reads = travel unknown
+constexpr int PART_FLOW_BINS = 9;                              // Gap histogram bins for the entropy (last = overflow)
+constexpr float PART_FLOW_BIN_WIDTH = 0.25f;                   // Bin width, in baseline gaps
+constexpr float PART_FLOW_CV_RISE = 0.25f;                     // Gap CV rise above baseline for a full score term
+constexpr float PART_FLOW_ENTROPY_RISE = 1.0f;                 // Gap entropy rise above baseline (bits) for a full term
+constexpr float PART_FLOW_DWELL_RISE = 1.0f;                   // Dwell growth (x baseline - 1) for a full term
+constexpr float PREJAM_SCORE_ON = 0.5f;                        // Irregularity that raises the pre-jam warning
+constexpr float PREJAM_SCORE_OFF = 0.3f;                       // ...and that clears it
+
+// Data quality (SystemState validity/staleness masks)
+constexpr unsigned long MOTION_STALE_MS = 1000UL;  // Speed/parts/vibration older than this are stale
+constexpr unsigned long ENV_STALE_MS = 10000UL;    // Environmental readings older than this are stale
+
+// Sensor power duty-cycling (standby between scheduled reads)
+constexpr bool SENSOR_DUTY_CYCLING = true;                // false = BME688, VL53L1X and APDS9960 run continuously
+constexpr unsigned long ENV_READ_INTERVAL = 3000UL;       // One BME688 forced measurement per IAQ sample
+constexpr unsigned long BME688_MEASURE_MS = 200UL;        // Until the first beginReading() reports the real duration
+constexpr unsigned long TOF_STANDBY_DELAY_MS = 5000UL;    // Line stopped this long = VL53L1X to standby
+constexpr unsigned long TOF_STANDBY_CHECK_MS = 10000UL;   // One check measurement per interval in standby
+constexpr unsigned long VL53L1X_WAKE_MS = 60UL;           // Standby to first range (boot + 50 ms timing budget)
+constexpr unsigned long GESTURE_IDLE_MS = 15000UL;        // No operator this long = gesture engine off
+constexpr unsigned long APDS9960_WAKE_MS = 10UL;          // Gesture engine start-up after enabling
+constexpr unsigned long PROXIMITY_READ_INTERVAL = 250UL;  // Proximity poll while the gesture engine is off
 
 // Vibration analysis parameters
-#define VIBRATION_SAMPLE_RATE    100     // Hz
-#define VIBRATION_SAMPLE_SIZE    256     // Samples for FFT
-#define VIBRATION_BASELINE_G     0.5     // Normal vibration level
-#define VIBRATION_WARNING_G      1.0     // Warning threshold
-#define VIBRATION_CRITICAL_G     2.0     // Critical threshold
+constexpr int VIBRATION_SAMPLE_RATE = 100;    // Hz
+constexpr int VIBRATION_SAMPLE_SIZE = 256;    // Samples for FFT
+constexpr float VIBRATION_BASELINE_G = 0.5f;  // Normal vibration level
+constexpr float VIBRATION_WARNING_G = 1.0f;   // Warning threshold
+constexpr float VIBRATION_CRITICAL_G = 2.0f;  // Critical threshold
+
+// Belt speed estimate (Kalman filter over encoder speed, IMU motion cue)
+constexpr bool SPEED_FILTER_ENABLED = true;          // false = raw encoder speed
+constexpr float SPEED_ENCODER_VARIANCE = 0.25f;      // RPM^2 - detent quantisation (1/12) plus jitter
+constexpr float SPEED_PROCESS_NOISE = 0.5f;          // RPM^2/s^3 - speed changes expected in steady running
+constexpr float SPEED_MOTION_DEADBAND_G = 0.15f;     // Accel changes below this are ordinary vibration noise
+constexpr float SPEED_MOTION_SMOOTHING = 0.2f;       // Weight of a new accel magnitude in the cue's average
+constexpr float SPEED_GATE_SIGMA = 4.0f;             // Encoder readings further out are held back one read
+constexpr float SPEED_INITIAL_VARIANCE = 100.0f;     // RPM^2 - before the first encoder reading
 
 // Environmental thresholds
-#define TEMP_MIN_C              10.0     // Minimum operating temp
-#define TEMP_MAX_C              40.0     // Maximum operating temp
-#define TEMP_WARNING_C          35.0     // Warning threshold
-#define HUMIDITY_MAX_PCT        80.0     // Maximum humidity
-#define AIR_QUALITY_THRESHOLD   250      // IAQ threshold
+constexpr float TEMP_MIN_C = 10.0f;         // Minimum operating temp
+constexpr float TEMP_MAX_C = 40.0f;         // Maximum operating temp
+constexpr float TEMP_WARNING_C = 35.0f;     // Warning threshold
+constexpr float HUMIDITY_MAX_PCT = 80.0f;   // Maximum humidity
+constexpr int AIR_QUALITY_THRESHOLD = 250;  // IAQ threshold
+
+// Indoor air quality estimate from BME688 gas resistance
+constexpr unsigned long IAQ_SAMPLE_INTERVAL_MS = 3000UL;    // BME688 low-power gas rate
+constexpr unsigned long IAQ_BURN_IN_MS = 300000UL;          // Heater stabilisation before learning (5 min)
+constexpr float IAQ_HUMIDITY_REF_PCT = 40.0f;               // Ideal indoor humidity
+constexpr float IAQ_HUMIDITY_COMP = 0.03f;                  // ln(ohm) gas drop per %RH above reference
+constexpr float IAQ_HUMIDITY_WEIGHT = 25.0f;                // Humidity share of the air quality score (%)
+constexpr float IAQ_BASELINE_RISE = 0.05f;                  // Baseline follows cleaner air within minutes
+constexpr float IAQ_BASELINE_DECAY = 0.0001f;               // ...and dirtier air over ~1 day (sensor drift)
+constexpr unsigned long IAQ_LOW_ACCURACY_MS = 1800000UL;    // Baseline learning before medium accuracy (30 min)
+constexpr unsigned long IAQ_HIGH_ACCURACY_MS = 14400000UL;  // Baseline learning before high accuracy (4 h)
+
+// Self-tuning vibration and jam thresholds (learned from normal running)
+constexpr bool TUNING_ENABLED = true;              // false = always use the fixed thresholds above
+constexpr float TUNE_LOW_QUANTILE = 0.10f;         // Lower tail used for the spread (incidents inflate the upper one)
+constexpr unsigned long TUNE_SETTLE_MS = 64000UL;  // Running time before samples count (vibration RMS window fill at the economy rate)
+constexpr uint32_t TUNE_LEARN_SAMPLES = 14400;     // Normal samples before the first tuning (2 h at 2 Hz)
+constexpr uint32_t TUNE_EPOCH_SAMPLES = 57600;     // Samples per re-tuning epoch afterwards (8 h at 2 Hz)
+constexpr float TUNE_ADAPT_RATE = 0.25f;           // Share of each later epoch's target adopted
+constexpr float TUNE_WARNING_RATIO = 2.0f;         // Warning = median x ratio (VIBRATION_WARNING_G / VIBRATION_BASELINE_G)
+constexpr float TUNE_CRITICAL_RATIO = 4.0f;        // Critical = median x ratio
+constexpr float TUNE_JAM_RATIO = 0.6f;             // Jam = median x ratio
+constexpr float TUNE_GUARD_SPREADS = 5.0f;         // Guard band between levels, in (median - low quantile) spreads
+constexpr float TUNE_MIN_SCALE = 0.5f;             // Tuned thresholds stay within these multiples
+constexpr float TUNE_MAX_SCALE = 2.0f;             // ...of the fixed thresholds
+
+// Remaining useful life (degradation fit to hourly vibration health indicators)
+constexpr unsigned long RUL_INTERVAL_MS = 3600000UL;  // One health indicator point per hour
+constexpr unsigned long RUL_SETTLE_MS = 64000UL;      // Running time before samples count (vibration RMS window fill at the economy rate)
+constexpr uint32_t RUL_MIN_SAMPLES = 1800;            // Samples a point needs (15 min of running at 2 Hz)
+constexpr float RUL_MIN_SPEED_RATIO = 0.5f;           // Samples below this share of nominal speed are skipped
+constexpr float RUL_SPEED_EXPONENT = 1.0f;            // Vibration ~ speed^k, normalised to NOMINAL_SPEED_RPM
+constexpr bool RUL_EXPONENTIAL = true;                // Fit ln(indicator) (exponential growth); false = linear in g
+constexpr float RUL_FORGETTING = 0.98f;               // RLS forgetting factor per point (~50 h memory)
+constexpr float RUL_INITIAL_VARIANCE = 1000.0f;       // RLS covariance before the first point
+constexpr uint32_t RUL_MIN_POINTS = 6;                // Points before RUL is estimated
+constexpr float RUL_CONFIDENCE_Z = 1.645f;            // Bounds: 90% two-sided
+constexpr float RUL_MAX_HOURS = 8760.0f;              // Reported when no degradation is seen (1 year)
 
 // Operator interaction
-#define JAM_ACK_WINDOW          30000    // 30s to acknowledge jam
-#define GESTURE_COOLDOWN_MS     2000     // Prevent gesture spam
+constexpr unsigned long JAM_ACK_WINDOW = 30000UL;      // 30s to acknowledge jam
+constexpr unsigned long GESTURE_COOLDOWN_MS = 500UL;   // Debounce only: the engine segments each gesture
+
+// Gesture classification from the raw APDS9960 FIFO (U/D/L/R photodiode datasets)
+constexpr unsigned long GESTURE_POLL_MS = 20UL;  // FIFO poll while a gesture is in progress (its tail stays below the INT threshold)
+constexpr int GESTURE_FIFO_BURST = 8;            // Datasets per I2C read (32-byte Wire buffer)
+constexpr uint8_t GESTURE_ACTIVE_COUNTS = 10;    // All four photodiodes above this = hand over the sensor
+constexpr int GESTURE_EDGE_SAMPLES = 2;          // Active datasets averaged for the entry and exit ratios
+constexpr int GESTURE_MIN_DELTA_Q8 = 100;        // Entry-to-exit ratio change for a swipe (Q8, 256 = full scale)
+constexpr int GESTURE_WAVE_MIN_SAMPLES = 24;     // Active datasets with no swipe = wave (hand held over the sensor)
+
+// Derived values (folded by the compiler)
+constexpr float SPEED_TOLERANCE_RPM = NOMINAL_SPEED_RPM * SPEED_TOLERANCE_PCT / 100.0f;
+constexpr float SPEED_MOTION_RPM_PER_G = NOMINAL_SPEED_RPM / VIBRATION_BASELINE_G;  // Vibration ~ speed
+
+// Consistency checks
+static_assert(MIN_SPEED_THRESHOLD < NOMINAL_SPEED_RPM - SPEED_TOLERANCE_RPM,
+              "Stopped threshold must sit below the speed tolerance band");
+static_assert(SPEED_TOLERANCE_PCT > 0.0f && SPEED_TOLERANCE_PCT < 100.0f, "Speed tolerance is a percentage");
+static_assert(PART_DISTANCE_MM < PART_DETECT_THRESHOLD, "Parts must pass inside the detection distance");
+static_assert(JAM_VIBRATION_THRESHOLD < VIBRATION_BASELINE_G, "Jam level must be below normal vibration");
+static_assert(VIBRATION_BASELINE_G < VIBRATION_WARNING_G, "Warning level must be above normal vibration");
+static_assert(VIBRATION_WARNING_G < VIBRATION_CRITICAL_G, "Vibration warning must be below critical");
+static_assert(VIBRATION_SAMPLE_SIZE > 0 && (VIBRATION_SAMPLE_SIZE & (VIBRATION_SAMPLE_SIZE - 1)) == 0,
+              "Vibration window must be a power of two");
+static_assert(SPEED_ENCODER_VARIANCE > 0.0f && SPEED_PROCESS_NOISE > 0.0f,
+              "Speed filter noise levels must be positive");
+static_assert(SPEED_MOTION_DEADBAND_G < VIBRATION_BASELINE_G - JAM_VIBRATION_THRESHOLD,
+              "Motion cue dead band would hide a start or stop");
+static_assert(SPEED_MOTION_SMOOTHING > 0.0f && SPEED_MOTION_SMOOTHING <= 1.0f, "Motion cue smoothing out of range");
+static_assert(SPEED_GATE_SIGMA >= 3.0f, "Speed gate would hold back ordinary encoder noise");
+static_assert(PART_FLOW_MIN_GAPS >= 4 && PART_FLOW_MIN_GAPS <= PART_FLOW_WINDOW, "Part flow window too small to score");
+static_assert(PART_FLOW_BASELINE_ALPHA > 0.0f && PART_FLOW_BASELINE_ALPHA < 0.5f, "Part flow baseline rate out of range");
+static_assert((PART_FLOW_BINS - 0.5f) * PART_FLOW_BIN_WIDTH < PART_FLOW_MAX_GAP_RATIO,
+              "Gap histogram must end below the feed-stopped gap");
+static_assert(0.0f < PREJAM_SCORE_OFF && PREJAM_SCORE_OFF < PREJAM_SCORE_ON && PREJAM_SCORE_ON < 1.0f,
+              "Pre-jam hysteresis out of order");
+static_assert(GESTURE_FIFO_BURST * 4 <= 32 && 32 % GESTURE_FIFO_BURST == 0, "Gesture burst must fit the Wire buffer");
+static_assert(GESTURE_MIN_DELTA_Q8 > 0 && GESTURE_MIN_DELTA_Q8 < 512, "Swipe delta outside the ratio range");
+static_assert(GESTURE_EDGE_SAMPLES >= 1 && 2 * GESTURE_EDGE_SAMPLES <= GESTURE_WAVE_MIN_SAMPLES,
+              "Entry and exit samples must not overlap in a wave");
+static_assert(GESTURE_POLL_MS < GESTURE_COOLDOWN_MS, "Gesture end would be seen after the cooldown");
+static_assert(TEMP_MIN_C < TEMP_WARNING_C && TEMP_WARNING_C < TEMP_MAX_C, "Temperature limits out of order");
+static_assert(IAQ_LOW_ACCURACY_MS < IAQ_HIGH_ACCURACY_MS, "IAQ accuracy stages out of order");
+static_assert(IAQ_BASELINE_DECAY < IAQ_BASELINE_RISE, "IAQ baseline must follow clean air faster than dirty");
+static_assert(ENV_READ_INTERVAL == IAQ_SAMPLE_INTERVAL_MS, "BME688 reads should land on the IAQ sample rate");
+static_assert(ENV_READ_INTERVAL + BME688_MEASURE_MS < ENV_STALE_MS, "Environmental fields would go stale between reads");
+static_assert(VL53L1X_WAKE_MS < TOF_STANDBY_DELAY_MS && TOF_STANDBY_DELAY_MS <= TOF_STANDBY_CHECK_MS,
+              "ToF standby timing out of order");
+static_assert(APDS9960_WAKE_MS < PROXIMITY_READ_INTERVAL && PROXIMITY_READ_INTERVAL < GESTURE_COOLDOWN_MS,
+              "Gesture engine must wake well within a gesture");
+static_assert(TUNE_LOW_QUANTILE > 0.0f && TUNE_LOW_QUANTILE < 0.5f, "Spread quantile must be in the lower half");
+static_assert(TUNE_JAM_RATIO < 1.0f && 1.0f < TUNE_WARNING_RATIO && TUNE_WARNING_RATIO < TUNE_CRITICAL_RATIO,
+              "Tuning ratios must keep jam < median < warning < critical");
+static_assert(TUNE_MIN_SCALE < 1.0f && TUNE_MAX_SCALE > 1.0f, "Tuning bounds must include the fixed thresholds");
+static_assert(TUNE_LEARN_SAMPLES > 0 && TUNE_EPOCH_SAMPLES > 0, "Tuning needs samples");
+static_assert(RUL_FORGETTING > 0.9f && RUL_FORGETTING <= 1.0f, "RUL forgetting factor out of range");
+static_assert(RUL_MIN_POINTS >= 3, "RUL bounds need at least one degree of freedom");
+static_assert(RUL_MIN_SPEED_RATIO > 0.0f && RUL_MIN_SPEED_RATIO < 1.0f, "RUL speed ratio must be a share of nominal");
 
 #endif // SENSOR_CONFIG_H
\ No newline at end of file
@@ -1,21 +1,206 @@
 #ifndef SYSTEM_CONFIG_H
 #define SYSTEM_CONFIG_H
 
+#include <stdint.h>
+
 // System Configuration for FlexForge Conveyor Monitor
 
 // Virtual Sensor Mode - generates fake data if sensor init fails
-#define VIRTUAL_SENSOR    1    // Set to 1 to enable virtual sensors
+constexpr bool VIRTUAL_SENSOR = true;  // Fall back to generated data when a sensor fails to start
 
 // Timing intervals (milliseconds)
-#define SENSOR_READ_INTERVAL     100    // 10Hz for critical sensors
-#define DATA_PROCESS_INTERVAL    500    // 2Hz for data processing
-#define CLOUD_SYNC_INTERVAL      60000  // 1 minute for normal telemetry
-#define HEALTH_CHECK_INTERVAL    30000  // 30 seconds health check
+constexpr unsigned long SENSOR_READ_INTERVAL = 100UL;     // 10Hz for critical sensors
+constexpr unsigned long DATA_PROCESS_INTERVAL = 500UL;    // 2Hz for data processing
+constexpr unsigned long CLOUD_SYNC_INTERVAL = 60000UL;    // 1 minute for normal telemetry
+constexpr unsigned long HEALTH_CHECK_INTERVAL = 30000UL;  // 30 seconds health check
+constexpr unsigned long HEALTH_REPORT_INTERVAL = 900000UL; // Health note every 15 minutes
+constexpr unsigned long ENV_POLL_INTERVAL = 300000UL;     // 5 minutes between Notehub env override checks
+
+// Adaptive sampling - rates used instead of the fixed intervals above
+constexpr bool ADAPTIVE_SAMPLING_ENABLED = true;                 // false = always use the fixed intervals
+constexpr unsigned long SENSOR_READ_INTERVAL_BOOST = 50UL;       // 20Hz while the line is changing
+constexpr unsigned long SENSOR_READ_INTERVAL_ECONOMY = 250UL;    // 4Hz while the line is stable or idle
+constexpr unsigned long CLOUD_SYNC_INTERVAL_BOOST = 15000UL;     // 15 seconds while the line is changing
+constexpr unsigned long CLOUD_SYNC_INTERVAL_ECONOMY = 300000UL;  // 5 minutes while the line is stable or idle
+constexpr unsigned long ADAPTIVE_QUIET_PERIOD_MS = 120000UL;     // Trigger-free time before stepping down a level
+constexpr unsigned long ADAPTIVE_MIN_DWELL_MS = 30000UL;         // Minimum time in a level before stepping down
+constexpr float ADAPTIVE_TREND_THRESHOLD = 0.005f;               // Rising vibration trend (g/sample) that boosts rates
+constexpr float ADAPTIVE_CUSUM_DRIFT = 0.5f;                     // CUSUM allowance (standard deviations)
+constexpr float ADAPTIVE_CUSUM_THRESHOLD = 5.0f;                 // CUSUM decision level (standard deviations)
+
+// OEE accounting
+constexpr unsigned long OEE_SHIFT_DURATION_MS = 28800000UL;  // 8 hour shifts
+constexpr unsigned long OEE_HOUR_MS = 3600000UL;             // Hourly sub-totals within a shift
+constexpr int OEE_MAX_HOURS_PER_SHIFT = 12;                  // Hourly slots kept per shift summary
+constexpr bool OEE_IDLE_IS_DOWNTIME = true;                  // Count idle (stopped, no jam) against availability
+
+// Statistical process control (spc.violation events)
+constexpr int SPC_MAX_SUBGROUP = 10;                           // Largest X-bar/R subgroup with tabulated constants
+constexpr int SPC_BASELINE_POINTS = 25;                        // Chart points that fix the centre line and limits
+constexpr unsigned long SPC_SETTLE_MS = 64000UL;               // Belt running time before charting (vibration RMS window fill at the economy rate)
+constexpr int SPC_SPEED_SUBGROUP = 5;                          // Speed readings per X-bar/R point
+constexpr float SPC_SPEED_MIN_SIGMA = 0.05f;                   // RPM - sigma floor for a suspiciously steady baseline
+constexpr float SPC_VIBRATION_MIN_SIGMA = 0.005f;              // g
+constexpr unsigned long SPC_VIBRATION_SAMPLE_MS = 64000UL;     // Vibration point spacing (>= RMS window, so points are independent)
+constexpr unsigned long SPC_EVENT_MIN_INTERVAL_MS = 300000UL;  // Per-signal spacing of spc.violation events
+
+// Machine state log (downtime.qo)
+constexpr unsigned long MACHINE_STATE_DEBOUNCE_MS = 300UL;      // Candidate state must hold this long
+constexpr unsigned long MICROSTOP_MAX_MS = 30000UL;             // Stops shorter than this are micro-stops
+constexpr unsigned long MACHINE_LOG_TICK_MS = 10UL;             // Run duration resolution
+constexpr int MACHINE_LOG_BYTES = 256;                          // On-device run buffer
+constexpr int MACHINE_LOG_FLUSH_BYTES = 192;                    // Flush when the buffer reaches this
+constexpr unsigned long MACHINE_LOG_FLUSH_INTERVAL = 300000UL;  // Flush a non-empty buffer at least every 5 minutes
+constexpr unsigned long MACHINE_LOG_RETRY_MS = 60000UL;         // Wait after a held or throttled upload
+
+// Raw sample capture (samples.capture events)
+constexpr uint16_t SAMPLE_CAPTURE_SAMPLES = 64;                 // Packed records per capture (39 bytes each)
+constexpr uint16_t SAMPLE_CAPTURE_POST = 16;                    // Of which recorded after the trigger
+constexpr unsigned long SAMPLE_CAPTURE_MIN_INTERVAL = 900000UL; // At most one capture per 15 minutes
 
 // Notecard configuration
-#define NOTECARD_PRODUCT_UID    "com.blues.flex_forge.production_line"
-#define NOTECARD_CONTINUOUS     false    // Use periodic sync
-#define NOTECARD_SYNC_MINS      5        // Sync every 5 minutes
-#define NOTECARD_MOTION_SENSE   true     // Enable motion sensitivity
+constexpr const char* NOTECARD_PRODUCT_UID = "com.blues.flex_forge.production_line";
+constexpr bool NOTECARD_CONTINUOUS = false;                                           // Use periodic sync
+constexpr int NOTECARD_SYNC_MINS = 5;                                                 // Sync every 5 minutes
+constexpr bool NOTECARD_MOTION_SENSE = true;                                          // Enable motion sensitivity
+
+// Adaptive sync policy (battery- and queue-aware hub.set intervals)
+constexpr unsigned long SYNC_POLICY_INTERVAL = 300000UL;         // Sample card.voltage and queue depth every 5 minutes
+constexpr int SYNC_AGGRESSIVE_OUTBOUND = 1;                      // Minutes - powered and backed up
+constexpr int SYNC_AGGRESSIVE_INBOUND = 5;
+constexpr int SYNC_BALANCED_OUTBOUND = NOTECARD_SYNC_MINS;
+constexpr int SYNC_BALANCED_INBOUND = (NOTECARD_SYNC_MINS * 2);
+constexpr int SYNC_FRUGAL_OUTBOUND = 30;                         // Minutes - running on battery
+constexpr int SYNC_FRUGAL_INBOUND = 120;
+constexpr float SYNC_LOW_BATTERY_VOLTAGE = 3.5f;                 // On battery below this (LiPo near empty): sync as little as possible
+constexpr float SYNC_LOW_BATTERY_RECOVER_VOLTAGE = 3.6f;         // Back to frugal only above this
+constexpr int SYNC_LOW_BATTERY_OUTBOUND = 120;                   // Minutes - battery nearly flat
+constexpr int SYNC_LOW_BATTERY_INBOUND = 720;
+constexpr int SYNC_BACKLOG_HIGH = 50;                            // Pending notes that count as backed up
+constexpr int SYNC_BACKLOG_LOW = 10;                             // Pending notes that count as drained
+constexpr int SYNC_SESSION_EST_SECONDS = 20;                     // Estimated radio-on time per sync session
+
+// Outbound queue backpressure (notes pending on the Notecard)
+// The limits are sized by the sync outage to ride out at the note rate of normal sampling:
+// full detail for 2.5 h, then half the telemetry for 3 h more, then alerts only. Alerts are
+// left out of the rate; they have QUEUE_ALERT_RESERVE. After changing an interval, compare
+// QUEUE_NOTES_PER_HOUR with the "Queue:" line of tools/build/replay (note.add counts per file).
+constexpr unsigned long QUEUE_POLL_INTERVAL = 60000UL;                          // Reconcile pending counts via file.changes every minute
+constexpr unsigned long QUEUE_POLL_MIN_INTERVAL = 10000UL;                      // Fastest re-poll when nearing a limit
+constexpr int QUEUE_TELEMETRY_NOTES_PER_HOUR = (int)(3600000UL / CLOUD_SYNC_INTERVAL);
+constexpr int QUEUE_EVENT_NOTES_PER_HOUR = 4;                                   // sync.profile, sampling.mode, operator actions
+constexpr int QUEUE_NOTES_PER_HOUR = QUEUE_TELEMETRY_NOTES_PER_HOUR + QUEUE_EVENT_NOTES_PER_HOUR +
+                                     (int)(3600000UL / HEALTH_REPORT_INTERVAL) +
+                                     (int)(3600000UL / MACHINE_LOG_FLUSH_INTERVAL);  // 80
+constexpr int QUEUE_FULL_DETAIL_MINUTES = 150;                                  // Outage bridged before telemetry is halved
+constexpr int QUEUE_REDUCED_MINUTES = 180;                                      // Further outage bridged at half telemetry
+constexpr int QUEUE_ALERT_RESERVE = 50;                                         // Slots only alerts may use
+constexpr int QUEUE_SOFT_LIMIT = QUEUE_NOTES_PER_HOUR * QUEUE_FULL_DETAIL_MINUTES / 60;  // 200: above this, telemetry is halved
+constexpr int QUEUE_HARD_LIMIT = QUEUE_SOFT_LIMIT +
+                                 (QUEUE_NOTES_PER_HOUR - QUEUE_TELEMETRY_NOTES_PER_HOUR / 2) * QUEUE_REDUCED_MINUTES / 60;  // 350: alerts only
+constexpr int QUEUE_CAPACITY_NOTES = QUEUE_HARD_LIMIT + QUEUE_ALERT_RESERVE;   // 400: pending notes the firmware will ever queue
+
+// Epoch time (card.time disciplines a local clock; note "time" is Unix seconds once synced, "ts" says which)
+constexpr unsigned long TIME_SYNC_MIN_INTERVAL = 3600000UL;     // Resync hourly while the clock is settling
+constexpr unsigned long TIME_SYNC_MAX_INTERVAL = 86400000UL;    // Back off to daily once predictions hold
+constexpr unsigned long TIME_SYNC_RETRY_MS = 60000UL;           // Retry after a failure or before the Notecard has time
+constexpr long TIME_SYNC_TOLERANCE_MS = 1000;                   // Prediction error that still doubles the interval
+constexpr long TIME_STEP_THRESHOLD_MS = 60000;                  // Larger errors re-base the clock instead of slewing
+constexpr float TIME_DRIFT_GAIN = 0.5f;                         // Share of the measured drift taken per sync
+constexpr float TIME_PHASE_GAIN = 0.5f;                         // Share of the offset error corrected per sync
+constexpr float TIME_MAX_DRIFT_PPM = 20000.0f;                  // Worst plausible MCU clock error (HSI +/-2%)
+constexpr unsigned long TIME_HOLDOVER_MAX_MS = 604800000UL;     // Extrapolate at most a week past the last sync
+
+// Uplink data budget
+constexpr int DAILY_DATA_BUDGET_BYTES = 131072;              // 128 KB/day cellular allowance
+constexpr int NOTE_OVERHEAD_BYTES = 48;                      // Estimated per-note framing/metadata overhead
+constexpr unsigned long BUDGET_FORECAST_MIN_MS = 3600000UL;  // Forecast from at least 1 hour of usage
+constexpr float BUDGET_REDUCED_RATIO = 1.0f;                 // Forecast/budget ratio that halves telemetry
+constexpr float BUDGET_CONSTRAINED_RATIO = 1.25f;            // Forecast/budget ratio that quarters telemetry and drops events
+constexpr unsigned long BUDGET_PERSIST_INTERVAL = 600000UL;  // Save budget state every 10 minutes
+
+// Flight recorder (no-init RAM trace, reported after a crash)
+constexpr uint16_t FLIGHT_RECORDER_EVENTS = 256;   // Ring slots, 8 bytes each (power of two)
+constexpr unsigned long FLIGHT_SPAN_MIN_MS = 10UL; // Task runs shorter than this leave no trace (unless something happened inside)
+constexpr size_t FLIGHT_NOTE_BYTES = 512;          // Compressed events in the crash note payload
+constexpr uint8_t FLIGHT_FORMAT_VERSION = 1;       // First payload byte
+
+// Watchdog (IWDG) and per-task budgets
+constexpr bool WATCHDOG_ENABLED = true;                        // Reset the MCU when a task hangs
+constexpr unsigned long WATCHDOG_TIMEOUT_MS = 10000UL;         // Reset this long after the last feed
+constexpr unsigned long WDT_CHECKIN_DEADLINE_MS = 5000UL;      // Sensor, processing and housekeeping must each run this often
+constexpr unsigned long WDT_SYNC_DEADLINE_MS = 2 * CLOUD_SYNC_INTERVAL_ECONOMY;  // Slowest telemetry schedule, with margin
+constexpr unsigned long WDT_HEALTH_DEADLINE_MS = 2 * HEALTH_CHECK_INTERVAL;
+constexpr unsigned long WDT_SETUP_BUDGET_MS = 30000UL;         // Whole of setup(); it feeds between stages
+constexpr unsigned long WDT_SENSOR_READ_BUDGET_MS = 500UL;     // One readAll(), including a blocking BME688 read without duty-cycling
+constexpr unsigned long WDT_PROCESSING_BUDGET_MS = 4000UL;     // Processing and alert checks; a 3.5 kB sample-capture note takes 3.7 s at 9600 baud
+constexpr unsigned long WDT_SYNC_BUDGET_MS = 5000UL;           // One telemetry sync
+constexpr unsigned long WDT_HOUSEKEEPING_BUDGET_MS = 5000UL;   // Queue/time/policy polling or an env override check
+constexpr unsigned long WDT_HEALTH_BUDGET_MS = 5000UL;         // Health check, including a Notecard reconnect
+constexpr unsigned long WDT_GESTURE_BUDGET_MS = 50UL;          // One gesture FIFO drain (up to 32 datasets over I2C)
+
+// On-target math benchmark (fast_math vs libm, DWT cycle counter)
+constexpr bool MATH_BENCH_AT_BOOT = false;                     // Print cycles per call during setup(); takes ~10 ms
+
+// Energy model (typical currents in mA; adjust for the board and sensor breakouts)
+constexpr float MCU_ACTIVE_MA = 8.0f;          // STM32L4 run mode at 80 MHz
+constexpr float MCU_SLEEP_MA = 2.5f;           // Sleep (WFI) with peripherals clocked
+constexpr float ENCODER_ACTIVE_MA = 4.0f;      // Seesaw encoder, always on
+constexpr float BME688_ACTIVE_MA = 12.0f;      // Forced measurement with the gas heater on
+constexpr float BME688_STANDBY_MA = 0.0002f;   // Sleep mode
+constexpr float VL53L1X_ACTIVE_MA = 10.0f;     // Continuous ranging, 50 ms budget every 100 ms
+constexpr float VL53L1X_STANDBY_MA = 0.005f;   // Software standby
+constexpr float IMU_ACTIVE_MA = 4.6f;          // LSM9DS1 accel, gyro and magnetometer, always on
+constexpr float APDS9960_ACTIVE_MA = 2.5f;     // Gesture engine, LED pulses averaged
+constexpr float APDS9960_STANDBY_MA = 0.3f;    // Proximity only
+constexpr float NOTECARD_IDLE_MA = 0.018f;     // Idle between sync sessions
+constexpr float NOTECARD_RADIO_MA = 150.0f;    // Averaged over a cellular sync session
+
+// Consistency checks
+static_assert(SENSOR_READ_INTERVAL_BOOST <= SENSOR_READ_INTERVAL &&
+              SENSOR_READ_INTERVAL <= SENSOR_READ_INTERVAL_ECONOMY, "Sensor read rates out of order");
+static_assert(CLOUD_SYNC_INTERVAL_BOOST <= CLOUD_SYNC_INTERVAL &&
+              CLOUD_SYNC_INTERVAL <= CLOUD_SYNC_INTERVAL_ECONOMY, "Telemetry rates out of order");
+static_assert(SENSOR_READ_INTERVAL <= DATA_PROCESS_INTERVAL, "Processing faster than sensing repeats readings");
+static_assert(ADAPTIVE_CUSUM_DRIFT < ADAPTIVE_CUSUM_THRESHOLD, "CUSUM drift must be below the decision level");
+static_assert(OEE_SHIFT_DURATION_MS / OEE_HOUR_MS <= OEE_MAX_HOURS_PER_SHIFT, "Shift has more hours than slots");
+static_assert(SPC_SPEED_SUBGROUP >= 2 && SPC_SPEED_SUBGROUP <= SPC_MAX_SUBGROUP,
+              "Speed subgroup needs tabulated control chart constants");
+static_assert(SPC_BASELINE_POINTS >= 20, "Control limits need at least 20 baseline points");
+static_assert(MACHINE_LOG_FLUSH_BYTES < MACHINE_LOG_BYTES, "State log must flush before it is full");
+static_assert(SAMPLE_CAPTURE_POST < SAMPLE_CAPTURE_SAMPLES, "Sample capture needs samples from before the trigger");
+static_assert(SYNC_AGGRESSIVE_OUTBOUND <= SYNC_BALANCED_OUTBOUND && SYNC_BALANCED_OUTBOUND <= SYNC_FRUGAL_OUTBOUND &&
+              SYNC_FRUGAL_OUTBOUND <= SYNC_LOW_BATTERY_OUTBOUND && SYNC_FRUGAL_INBOUND <= SYNC_LOW_BATTERY_INBOUND,
+              "Sync profiles out of order");
+static_assert(SYNC_LOW_BATTERY_VOLTAGE > 0.0f && SYNC_LOW_BATTERY_VOLTAGE < SYNC_LOW_BATTERY_RECOVER_VOLTAGE,
+              "Low-battery hysteresis needs 0 < enter < recover");
+static_assert(SYNC_BACKLOG_LOW < SYNC_BACKLOG_HIGH, "Backlog hysteresis needs low < high");
+static_assert(QUEUE_POLL_MIN_INTERVAL <= QUEUE_POLL_INTERVAL, "Queue poll intervals out of order");
+static_assert(QUEUE_SOFT_LIMIT < QUEUE_HARD_LIMIT, "Queue soft limit must be below the hard limit");
+static_assert(TIME_SYNC_MIN_INTERVAL <= TIME_SYNC_MAX_INTERVAL && TIME_SYNC_RETRY_MS <= TIME_SYNC_MIN_INTERVAL,
+              "Time sync intervals out of order");
+static_assert(TIME_SYNC_TOLERANCE_MS < TIME_STEP_THRESHOLD_MS, "Time step threshold must exceed the tolerance");
+static_assert(TIME_HOLDOVER_MAX_MS >= TIME_SYNC_MAX_INTERVAL + TIME_SYNC_RETRY_MS && TIME_HOLDOVER_MAX_MS <= 0x7FFFFFFFUL,
+              "Holdover must outlast a sync interval and fit the 32-bit millis() span");
+static_assert(TIME_DRIFT_GAIN > 0.0f && TIME_DRIFT_GAIN <= 1.0f && TIME_PHASE_GAIN > 0.0f && TIME_PHASE_GAIN <= 1.0f,
+              "Time loop gains out of range");
+static_assert(BUDGET_REDUCED_RATIO < BUDGET_CONSTRAINED_RATIO, "Budget levels out of order");
+static_assert(MCU_SLEEP_MA < MCU_ACTIVE_MA && BME688_STANDBY_MA < BME688_ACTIVE_MA &&
+              VL53L1X_STANDBY_MA < VL53L1X_ACTIVE_MA && APDS9960_STANDBY_MA < APDS9960_ACTIVE_MA &&
+              NOTECARD_IDLE_MA < NOTECARD_RADIO_MA, "Standby must draw less than active");
+static_assert(FLIGHT_RECORDER_EVENTS >= 16 && (FLIGHT_RECORDER_EVENTS & (FLIGHT_RECORDER_EVENTS - 1)) == 0,
+              "Flight recorder ring must be a power of two");
+static_assert(FLIGHT_NOTE_BYTES >= 64 && FLIGHT_NOTE_BYTES <= 1024, "Crash note payload out of range");
+static_assert(WATCHDOG_TIMEOUT_MS >= 1000UL && WATCHDOG_TIMEOUT_MS <= 32000UL,
+              "IWDG timeout out of range (LSI / 256 prescaler tops out at 32 s)");
+static_assert(WDT_SENSOR_READ_BUDGET_MS < WATCHDOG_TIMEOUT_MS && WDT_PROCESSING_BUDGET_MS < WATCHDOG_TIMEOUT_MS &&
+              WDT_SYNC_BUDGET_MS < WATCHDOG_TIMEOUT_MS && WDT_HEALTH_BUDGET_MS < WATCHDOG_TIMEOUT_MS &&
+              WDT_GESTURE_BUDGET_MS < WATCHDOG_TIMEOUT_MS && WDT_HOUSEKEEPING_BUDGET_MS < WATCHDOG_TIMEOUT_MS,
+              "A task budget must expire before the watchdog does");
+static_assert(WDT_CHECKIN_DEADLINE_MS >= 2 * SENSOR_READ_INTERVAL_ECONOMY &&
+              WDT_CHECKIN_DEADLINE_MS >= 2 * DATA_PROCESS_INTERVAL,
+              "Check-in deadline shorter than the task period");
+static_assert(WDT_SYNC_DEADLINE_MS >= CLOUD_SYNC_INTERVAL_ECONOMY + WDT_SYNC_BUDGET_MS,
+              "Sync deadline shorter than the slowest telemetry schedule");
 
-#endif // SYSTEM_CONFIG_H
\ No newline at end of file
+#endif // SYSTEM_CONFIG_H
@@ -17,11 +17,20 @@
 #include "config/config.h"
 #include "sensors/sensor_manager.h"
 #include "data_processing/data_processor.h"
+#include "data_processing/adaptive_rate_controller.h"
+#include "data_processing/machine_state_tracker.h"
+#include "data_processing/sample_capture.h"
 #include "communication/notecard_manager.h"
+#include "communication/config_overlay.h"
 #include "alerts/alert_handler.h"
 #include "communication/telemetry_formatter.h"
 #include "utils/error_handling.h"
 #include "utils/performance_utils.h"
+#include "utils/task_watchdog.h"
+#include "utils/flight_recorder.h"
+#include "utils/energy_model.h"
+#include "utils/fast_math.h"
+#include "utils/math_bench.h"
 
 // Global objects
 SensorManager sensorManager;
@@ -29,25 +38,39 @@ DataProcessor dataProcessor;
 NotecardManager notecardManager;
 AlertHandler alertHandler;
 TelemetryFormatter telemetryFormatter;
+AdaptiveRateController rateController;
+MachineStateTracker machineState;
+SampleCapture sampleCapture;
+ConfigOverlay configOverlay;
+TaskWatchdog taskWatchdog;
+EnergyModel energyModel;
 
 // Timing variables
 unsigned long lastSensorRead = 0;
 unsigned long lastDataProcess = 0;
 unsigned long lastCloudSync = 0;
 unsigned long lastHealthCheck = 0;
+unsigned long lastHealthReport = 0;
+unsigned long lastConfigCheck = 0;
 
 // System state
 SystemState currentState = {
   .conveyorRunning = false,
   .speed_rpm = 0.0,
   .partsPerMinute = 0,
+  .totalParts = 0,
+  .flowIrregularity = 0.0,
   .vibrationLevel = 0.0,
   .temperature = 0.0,
   .humidity = 0.0,
   .pressure = 0.0,
   .gasResistance = 0,
+  .iaq = 0,
+  .iaqAccuracy = 0,
   .lastJamTime = 0,
-  .operatorPresent = false
+  .operatorPresent = false,
+  .validMask = 0,
+  .staleMask = 0
 };
 
 void setup() {
@@ -59,77 +82,160 @@ void setup() {
   Serial.println(F("FlexForge Conveyor Monitor v1.0"));
   Serial.println(F("Initializing..."));
 
+  // Keep the previous run's trace, then arm the watchdog before anything that can hang
+  flightRecorder.begin();
+  taskWatchdog.begin();
+  energyModel.begin();
+  energyModel.setState(ENERGY_MCU, POWER_ACTIVE);
+
   // Initialize I2C bus
   Wire.begin();
   Wire.setClock(400000); // 400kHz I2C for sensors
 
   // Initialize components
-  if (!sensorManager.begin()) {
+  if (!sensorManager.begin(&energyModel)) {
     Serial.println(F("ERROR: Sensor initialization failed!"));
-    while(1) { delay(1000); } // Halt
+    taskWatchdog.halt("sensor init");
   }
+  taskWatchdog.feed();
 
   if (!notecardManager.begin()) {
     Serial.println(F("ERROR: Notecard initialization failed!"));
-    while(1) { delay(1000); } // Halt
+    taskWatchdog.halt("notecard init");
   }
+  energyModel.setState(ENERGY_NOTECARD, POWER_STANDBY);
+  taskWatchdog.feed();
 
   dataProcessor.begin();
+  notecardManager.loadLocalState("tuning.dbx", dataProcessor);
+  notecardManager.loadLocalState("rul.dbx", dataProcessor, &DataProcessor::restoreRULState);
+  
+  // Field overrides: the last applied set from flash, then the Notehub environment
+  configOverlay.begin();
+  notecardManager.loadLocalState("config.dbx", configOverlay);
+  dataProcessor.applyConfig(configOverlay.get().thresholds, configOverlay.get().tuningEnabled);
+  checkConfigOverrides();
+  taskWatchdog.feed();
   alertHandler.begin(&notecardManager);
+  rateController.begin();
+  machineState.begin();
+
+  if (MATH_BENCH_AT_BOOT) {
+    runMathBench();
+  }
 
   Serial.println(F("System ready!"));
 
   // Send startup notification
   notecardManager.sendEvent("system.startup", "{\"version\":\"1.0\",\"sensors\":\"ok\"}");
+  reportWatchdog();
+  reportCrash();
+  
+  taskWatchdog.endTask(WDT_TASK_SETUP);
+  taskWatchdog.feed();
 }
 
 void loop() {
+  energyModel.setState(ENERGY_MCU, POWER_ACTIVE);
   unsigned long currentMillis = millis();
 
-  // Read sensors at high frequency
-  if (currentMillis - lastSensorRead >= SENSOR_READ_INTERVAL) {
+  // Read sensors at high frequency (rate adapts to line activity)
+  if (currentMillis - lastSensorRead >= rateController.getSensorReadInterval()) {
     lastSensorRead = currentMillis;
+    taskWatchdog.beginTask(WDT_TASK_SENSOR_READ);
     readSensors();
+    rateController.recordSensorRead();
+    taskWatchdog.endTask(WDT_TASK_SENSOR_READ);
   }
   
   // Process data at medium frequency
   if (currentMillis - lastDataProcess >= DATA_PROCESS_INTERVAL) {
     lastDataProcess = currentMillis;
+    taskWatchdog.beginTask(WDT_TASK_PROCESSING);
     processData();
     checkAlerts();
+    taskWatchdog.endTask(WDT_TASK_PROCESSING);
   }
   
-  // Sync to cloud at low frequency (or immediately for alerts)
-  if (currentMillis - lastCloudSync >= CLOUD_SYNC_INTERVAL || alertHandler.hasPendingAlerts()) {
+  // Sync to cloud at low frequency (or immediately for alerts while the queue has room)
+  bool alertsWaiting = alertHandler.hasPendingAlerts() &&
+                       notecardManager.getQueueMonitor().getTotalPending() < QUEUE_CAPACITY_NOTES;
+  bool syncDue = currentMillis - lastCloudSync >= rateController.getCloudSyncInterval();
+  if (syncDue || alertsWaiting) {
     lastCloudSync = currentMillis;
     Serial.println(F("=== Cloud Sync Triggered ==="));
+    taskWatchdog.beginTask(WDT_TASK_CLOUD_SYNC);
     syncToCloud();
+    if (syncDue) {
+      rateController.recordCloudSync();   // Alert syncs would happen on the fixed schedule too
+    }
+    taskWatchdog.endTask(WDT_TASK_CLOUD_SYNC);
   }
   
   // Periodic health check
   if (currentMillis - lastHealthCheck >= HEALTH_CHECK_INTERVAL) {
     lastHealthCheck = currentMillis;
+    taskWatchdog.beginTask(WDT_TASK_HEALTH);
     performHealthCheck();
+    taskWatchdog.endTask(WDT_TASK_HEALTH);
+  }
+  
+  // Pick up configuration overrides set in Notehub
+  if (currentMillis - lastConfigCheck >= ENV_POLL_INTERVAL) {
+    lastConfigCheck = currentMillis;
+    taskWatchdog.beginTask(WDT_TASK_HOUSEKEEPING);
+    checkConfigOverrides();
+    taskWatchdog.endTask(WDT_TASK_HOUSEKEEPING);
   }
   
-  // Handle any operator gestures
+  // Drain the gesture FIFO when the APDS9960 signals, then act on any finished gesture
+  if (sensorManager.gesturePending()) {
+    taskWatchdog.beginTask(WDT_TASK_GESTURE);
+    PERF_TIME(gestureTimer, sensorManager.serviceGesture());
+    taskWatchdog.endTask(WDT_TASK_GESTURE);
+  }
   handleOperatorInput();
+  
+  // Notecard housekeeping (budget persistence, queue polling, sync policy)
+  taskWatchdog.beginTask(WDT_TASK_HOUSEKEEPING);
+  notecardManager.update();
+  taskWatchdog.endTask(WDT_TASK_HOUSEKEEPING);
+  
+  // Only fed while every task above keeps its deadline
+  taskWatchdog.feed();
+  
+  // Sleep until the next interrupt (SysTick at the latest)
+  energyModel.setState(ENERGY_MCU, POWER_STANDBY);
+  __WFI();
 }
 
 void readSensors() {
   // Read all sensors and update raw data with performance monitoring
   PERF_TIME(sensorReadTimer, sensorManager.readAll());
   
+  // Keep the latest raw reads packed, for a capture around the next alert
+  PERF_TIME(sampleTimer, sampleCapture.add(sensorManager.getRawReadings()));
+  
   // Update current state with latest readings
   currentState.speed_rpm = sensorManager.getConveyorSpeed();
   currentState.conveyorRunning = (currentState.speed_rpm > MIN_SPEED_THRESHOLD);
   currentState.partsPerMinute = sensorManager.getPartsCount();
+  currentState.totalParts = sensorManager.getTotalParts();
+  currentState.flowIrregularity = sensorManager.getFlowIrregularity();
   currentState.vibrationLevel = sensorManager.getVibrationMagnitude();
   currentState.temperature = sensorManager.getTemperature();
   currentState.humidity = sensorManager.getHumidity();
   currentState.pressure = sensorManager.getPressure();
   currentState.gasResistance = sensorManager.getAirQuality();
+  currentState.iaq = sensorManager.getIAQ();
+  currentState.iaqAccuracy = sensorManager.getIAQAccuracy();
   currentState.operatorPresent = sensorManager.isOperatorPresent();
+  currentState.validMask = sensorManager.getValidMask();
+  currentState.staleMask = sensorManager.getStaleMask();
+  
+  // Track run/stop/jam transitions at sensor-read resolution
+  machineState.update(currentState.conveyorRunning, dataProcessor.detectJam(),
+                      sensorManager.hasMotionSensorFault());
   
   // Debug telemetry values
   static unsigned long lastDebug = 0;
@@ -151,15 +257,153 @@ void processData() {
   if (dataProcessor.detectJam()) {
     currentState.lastJamTime = millis();
     alertHandler.triggerAlert(ALERT_JAM_DETECTED, "Conveyor jam detected");
+    sampleCapture.start(CAPTURE_JAM);
+  }
+  
+  if (dataProcessor.detectPreJam()) {
+    alertHandler.triggerAlert(ALERT_PRE_JAM, "Irregular part flow - jam risk");
   }
   
   if (dataProcessor.detectVibrationAnomaly()) {
     alertHandler.triggerAlert(ALERT_VIBRATION_HIGH, "Abnormal vibration detected");
+    sampleCapture.start(CAPTURE_VIBRATION);
   }
   
   if (dataProcessor.detectEnvironmentalAnomaly()) {
     alertHandler.triggerAlert(ALERT_ENV_CONDITION, "Environmental conditions out of range");
   }
+  
+  // Adapt sensor and telemetry rates to what the line is doing
+  const StatisticalAnalyzer& stats = dataProcessor.getStatisticalAnalyzer();
+  if (rateController.update(stats.getCurrentVibration(), stats.getVibrationTrend(),
+                            alertHandler.getActiveAlertCount())) {
+    char data[96];
+    snprintf(data, sizeof(data), "{\"mode\":\"%s\",\"reads_saved\":%ld,\"syncs_saved\":%ld}",
+             AdaptiveRateController::getModeName(rateController.getMode()),
+             rateController.getSensorReadsSaved(),
+             rateController.getCloudSyncsSaved());
+    notecardManager.sendEvent("sampling.mode", data);
+  }
+  
+  // Upload the raw reads around the last jam or vibration alert
+  if (sampleCapture.isComplete()) {
+    flushSampleCapture();
+  }
+  
+  // Upload the downtime run log in batches
+  if (machineState.flushDue()) {
+    flushStateLog();
+  }
+  
+  // Report OEE once per completed shift
+  OEEShiftSummary shiftSummary;
+  if (dataProcessor.popShiftSummary(shiftSummary)) {
+    char data[256];
+    if (telemetryFormatter.formatShiftSummary(shiftSummary, data, sizeof(data))) {
+      notecardManager.sendEvent("oee.shift", data);
+    }
+  }
+  
+  // Keep newly tuned thresholds across reboots and tell the cloud
+  if (dataProcessor.popThresholdUpdate()) {
+    notecardManager.saveLocalState("tuning.dbx", dataProcessor);
+    char data[160];
+    if (telemetryFormatter.formatTuningUpdate(dataProcessor.getThresholdTuner(), data, sizeof(data))) {
+      notecardManager.sendEvent("tuning.update", data);
+    }
+  }
+  
+  // Keep the degradation model across reboots and report the hourly point
+  if (dataProcessor.popRULUpdate()) {
+    notecardManager.saveLocalState("rul.dbx", dataProcessor.getRULEstimator());
+    RULEstimate rul;
+    bool estimated = dataProcessor.estimateRUL(rul);
+    char data[160];
+    if (telemetryFormatter.formatRULUpdate(dataProcessor.getRULEstimator(), estimated ? &rul : nullptr, data, sizeof(data))) {
+      notecardManager.sendEvent("rul.update", data);
+    }
+  }
+  
+  // Report control chart rule violations (spaced per signal)
+  SPCViolation violation;
+  while (dataProcessor.popSPCViolation(violation)) {
+    char data[160];
+    if (telemetryFormatter.formatSPCViolation(violation, data, sizeof(data))) {
+      notecardManager.sendEvent("spc.violation", data);
+    }
+  }
+}
+
+void checkConfigOverrides() {
+  notecardManager.loadEnvironment(configOverlay);
+  if (configOverlay.popUpdate()) {
+    notecardManager.saveLocalState("config.dbx", configOverlay);
+    dataProcessor.applyConfig(configOverlay.get().thresholds, configOverlay.get().tuningEnabled);
+    configOverlay.printStats();
+    taskWatchdog.printStats();
+  }
+}
+
+void reportCrash() {
+  // Last events before a fault, halt or watchdog reset (clean resets are not reported)
+  bool crashed = flightRecorder.getPreviousFreeze() != FLIGHT_RUNNING ||
+                 taskWatchdog.getLastBoot().cause != WDT_RESET_NONE;
+  if (!flightRecorder.hasPreviousRun() || !crashed) {
+    return;
+  }
+  char data[256];
+  if (telemetryFormatter.formatCrashReport(flightRecorder, taskWatchdog.getLastBoot(), data, sizeof(data))) {
+    notecardManager.sendCrashReport(data, flightRecorder.getPayload(), flightRecorder.getPayloadLength());
+  }
+  flightRecorder.printStats();
+}
+
+void reportWatchdog() {
+  // How the previous run ended: hung task, missed deadline or halt, plus slow stages
+  if (!taskWatchdog.hasBootReport()) {
+    return;
+  }
+  char data[256];
+  if (telemetryFormatter.formatWatchdogReport(taskWatchdog.getLastBoot(), data, sizeof(data))) {
+    notecardManager.sendEvent("watchdog.report", data);
+  }
+}
+
+void flushStateLog() {
+  // Times are relative to when the note is added; the Notecard stamps that
+  unsigned long currentTime = millis();
+  char data[128];
+  snprintf(data, sizeof(data),
+           "{\"start_ms\":%lu,\"tick_ms\":%lu,\"runs\":%u,\"state\":%d,\"state_ms\":%lu,\"dropped\":%lu}",
+           currentTime - machineState.getLogStartTime(),
+           MACHINE_LOG_TICK_MS,
+           (unsigned)machineState.getLogRuns(),
+           (int)machineState.getState(),
+           machineState.getStateDuration(),
+           (unsigned long)machineState.getRunsDropped());
+  
+  if (notecardManager.sendStateLog(data, machineState.getLog(), machineState.getLogLength())) {
+    machineState.clearLog();
+  } else {
+    machineState.deferFlush();
+  }
+}
+
+void flushSampleCapture() {
+  // Times are relative to when the note is added; the Notecard stamps that
+  unsigned long currentTime = millis();
+  char data[128];
+  snprintf(data, sizeof(data),
+           "{\"v\":%u,\"trigger\":\"%s\",\"samples\":%u,\"record_bytes\":%u,\"trigger_ms\":%lu,\"end_ms\":%lu}",
+           (unsigned)PACKED_READINGS_VERSION,
+           SampleCapture::getTriggerName(sampleCapture.getTrigger()),
+           (unsigned)sampleCapture.getSampleCount(),
+           (unsigned)sizeof(PackedReadings),
+           currentTime - sampleCapture.getTriggerTime(),
+           currentTime - sampleCapture.getLastSampleTime());
+  
+  sampleCapture.release(notecardManager.sendSampleCapture(data, sampleCapture.getPayload(),
+                                                          sampleCapture.getPayloadLength()));
 }
 
 void checkAlerts() {
@@ -168,7 +412,14 @@ void checkAlerts() {
 }
 
 void syncToCloud() {
-  // Validate system state and print debug info
+  // Honor queue backpressure - alerts still go out below
+  if (notecardManager.getBackpressure() == BACKPRESSURE_HARD) {
+    Serial.println(F("Notecard queue full - telemetry held back"));
+    alertHandler.sendPendingAlerts();
+    return;
+  }
+  
+  // Log any fields flagged by the acquisition quality masks
   telemetryFormatter.validateSystemState(currentState);
   
   // Format telemetry data using the formatter with performance monitoring
@@ -214,8 +465,23 @@ void handleOperatorInput() {
         // Pause monitoring
         notecardManager.sendEvent("operator.action", "{\"action\":\"monitoring_paused\"}");
         break;
+        
+      case GESTURE_SWIPE_DOWN:
+        // Maintenance done: start a new degradation model (only with the belt stopped)
+        if (!currentState.conveyorRunning) {
+          dataProcessor.resetMaintenance();
+          notecardManager.saveLocalState("rul.dbx", dataProcessor.getRULEstimator());
+          notecardManager.sendEvent("operator.action", "{\"action\":\"maintenance_reset\"}");
+        }
+        break;
+        
+      case GESTURE_WAVE:
+        // Presence only; no action is mapped to it
+      case GESTURE_NONE:
+        break;
     }
     
+    sensorManager.recordGestureAction();
     sensorManager.clearGesture();
   }
 }
@@ -238,9 +504,15 @@ void performHealthCheck() {
     alertHandler.triggerAlert(ALERT_SENSOR_FAILURE, "Critical system errors detected");
   }
   
+  // Fold state times into the energy model (well inside the micros() wrap)
+  energyModel.setRadioSeconds(notecardManager.getSyncPolicy().getRadioOnSeconds());
+  energyModel.update();
+  
   // Log system stats
   Serial.print(F("Health: Speed="));
   Serial.print(currentState.speed_rpm);
+  Serial.print(F(" +/-"));
+  Serial.print(sensorManager.getSpeedUncertainty());
   Serial.print(F(" RPM, Parts="));
   Serial.print(currentState.partsPerMinute);
   Serial.print(F("/min, Vib="));
@@ -269,6 +541,109 @@ void performHealthCheck() {
     Serial.print(F("μs, Calls: "));
     Serial.println(telemetryTimer.getCallCount());
     
+    Serial.print(F("SPC - Avg: "));
+    Serial.print(spcTimer.getAverageTime());
+    Serial.print(F("μs, Calls: "));
+    Serial.println(spcTimer.getCallCount());
+    
+    Serial.print(F("Gesture FIFO - Avg: "));
+    Serial.print(gestureTimer.getAverageTime());
+    Serial.print(F("μs, Calls: "));
+    Serial.println(gestureTimer.getCallCount());
+    
+    Serial.print(F("Sample pack - Avg: "));
+    Serial.print(sampleTimer.getAverageTime());
+    Serial.print(F("μs, Calls: "));
+    Serial.println(sampleTimer.getCallCount());
+    
+    Serial.print(F("OEE - Shift: "));
+    Serial.print(dataProcessor.getEfficiencyScore());
+    Serial.print(F("%, Last hour: "));
+    Serial.print(dataProcessor.getOEETracker().getLastHour().oee() * 100.0f);
+    Serial.println(F("%"));
+    
+    Serial.print(F("Speed filter - Encoder: "));
+    Serial.print(sensorManager.getEncoderSpeed(), 0);
+    Serial.print(F(" RPM, Filtered: "));
+    Serial.print(sensorManager.getConveyorSpeed());
+    Serial.print(F(" +/-"));
+    Serial.print(sensorManager.getSpeedUncertainty());
+    Serial.print(F(" RPM, Held back: "));
+    Serial.print(sensorManager.getSpeedFilter().getRejected());
+    Serial.print(F("/"));
+    Serial.println(sensorManager.getSpeedFilter().getUpdates());
+    
+    sensorManager.getPartFlow().printStats();
+    sensorManager.printGestureStats();
+    dataProcessor.getSPCMonitor().printStats();
+    dataProcessor.getThresholdTuner().printStats();
+    dataProcessor.getRULEstimator().printStats(dataProcessor.getAnomalyDetector().getThresholds().vibrationCriticalG);
+    configOverlay.printStats();
+    machineState.printStats();
+    sampleCapture.printStats();
+    rateController.printStats();
+    notecardManager.getBudget().printStats();
+    notecardManager.getSyncPolicy().printStats();
+    notecardManager.getQueueMonitor().printStats();
+    notecardManager.getTimeSync().printStats();
+    energyModel.printStats();
+    flightRecorder.printStats();
+    
     lastErrorReport = millis();
   }
+  
+  // Periodic health note (budget, sync policy, queue, sampling savings)
+  if (millis() - lastHealthReport >= HEALTH_REPORT_INTERVAL) {
+    lastHealthReport = millis();
+    reportHealth();
+  }
+}
+
+void reportHealth() {
+  const DataBudgetGovernor& budget = notecardManager.getBudget();
+  const SyncPolicy& syncPolicy = notecardManager.getSyncPolicy();
+  const QueueMonitor& queue = notecardManager.getQueueMonitor();
+  const TimeSync& clock = notecardManager.getTimeSync();
+  
+  HealthReport report;
+  report.uptime_s = millis() / 1000;
+  report.errorCount = systemErrorHandler.getErrorCount();
+  report.budgetUsedBytes = budget.getBytesUsed();
+  report.budgetLimitBytes = DAILY_DATA_BUDGET_BYTES;
+  report.budgetForecastBytes = budget.getForecastBytes();
+  report.budgetLevel = budget.getLevel();
+  report.notesThrottled = budget.getNotesThrottled();
+  report.syncProfile = syncPolicy.getProfile();
+  report.supply_mv = (uint16_t)(syncPolicy.getLastVoltage() * 1000);
+  report.radioOnSeconds = syncPolicy.getRadioOnSeconds();
+  report.queuePending = queue.getTotalPending();
+  report.queueHighWatermark = queue.getHighWatermark();
+  report.backpressure = queue.getLevel();
+  report.notesHeld = queue.getNotesHeld();
+  report.samplingMode = rateController.getMode();
+  report.sensorReadsSaved = rateController.getSensorReadsSaved();
+  report.cloudSyncsSaved = rateController.getCloudSyncsSaved();
+  report.taskOverruns = taskWatchdog.getOverruns();
+  report.slowestTask = taskWatchdog.getSlowestTask();
+  report.slowestTaskMs = taskWatchdog.getSlowestMs();
+  report.watchdogResets = taskWatchdog.getLastBoot().resets;
+  report.clockSynced = clock.isSynced();
+  report.clockDriftPpm = clock.getDriftPpm();
+  report.clockErrorMs = clock.getLastErrorMs();
+  report.clockSyncs = clock.getSyncCount();
+  report.energyMah = energyModel.getTotalChargeMah();
+  report.averageCurrentMa = energyModel.getAverageCurrentMa();
+  report.mcuCurrentMa = energyModel.getAverageCurrentMa(ENERGY_MCU);
+  report.sensorCurrentMa = energyModel.getAverageCurrentMa(ENERGY_ENCODER) +
+                           energyModel.getAverageCurrentMa(ENERGY_BME688) +
+                           energyModel.getAverageCurrentMa(ENERGY_VL53L1X) +
+                           energyModel.getAverageCurrentMa(ENERGY_IMU) +
+                           energyModel.getAverageCurrentMa(ENERGY_APDS9960);
+  report.radioCurrentMa = energyModel.getAverageCurrentMa(ENERGY_NOTECARD);
+  report.mcuSleepPct = (uint8_t)roundToInt((1.0f - energyModel.getDutyCycle(ENERGY_MCU)) * 100.0f);
+  
+  char healthData[640];
+  if (telemetryFormatter.formatHealth(report, healthData, sizeof(healthData))) {
+    notecardManager.sendHealth(healthData);
+  }
 }
\ No newline at end of file
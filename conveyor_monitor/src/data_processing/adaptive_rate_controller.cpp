@@ -0,0 +1,159 @@
+#include "adaptive_rate_controller.h"
+
+// Smoothing factor for the slowly adapting vibration mean/variance
+static const float VIBRATION_EWMA_ALPHA = 0.02f;
+// Samples used to seed the mean/variance before change-points are reported
+static const uint16_t CUSUM_WARMUP_SAMPLES = 20;
+
+AdaptiveRateController::AdaptiveRateController() {
+  mode = SAMPLING_NORMAL;
+  modeEnteredTime = 0;
+  lastTriggerTime = 0;
+  startTime = 0;
+  vibrationMean = 0.0f;
+  vibrationVar = 0.0f;
+  cusumHigh = 0.0f;
+  cusumLow = 0.0f;
+  warmupSamples = 0;
+  lastAlertCount = 0;
+  sensorReads = 0;
+  cloudSyncs = 0;
+  modeChanges = 0;
+}
+
+void AdaptiveRateController::begin() {
+  unsigned long currentTime = millis();
+  mode = SAMPLING_NORMAL;
+  modeEnteredTime = currentTime;
+  lastTriggerTime = currentTime;
+  startTime = currentTime;
+  Serial.println(F("Adaptive rate controller initialized"));
+}
+
+bool AdaptiveRateController::detectChangePoint(float vibration) {
+  if (warmupSamples < CUSUM_WARMUP_SAMPLES) {
+    // Seed mean/variance with a plain running average until warmed up
+    warmupSamples++;
+    float delta = vibration - vibrationMean;
+    vibrationMean += delta / warmupSamples;
+    vibrationVar += (delta * (vibration - vibrationMean) - vibrationVar) / warmupSamples;
+    return false;
+  }
+
+  // Normalize against the current regime; floor sigma so a perfectly
+  // quiet signal does not turn noise into change-points
+  float sigma = max(sqrtf(vibrationVar), 0.01f);
+  float z = (vibration - vibrationMean) / sigma;
+
+  cusumHigh = max(0.0f, cusumHigh + z - (float)ADAPTIVE_CUSUM_DRIFT);
+  cusumLow = max(0.0f, cusumLow - z - (float)ADAPTIVE_CUSUM_DRIFT);
+
+  if (cusumHigh > ADAPTIVE_CUSUM_THRESHOLD || cusumLow > ADAPTIVE_CUSUM_THRESHOLD) {
+    // Learn the new regime's mean and sigma afresh so the shift is reported once;
+    // the first warm-up sample overwrites both
+    cusumHigh = 0.0f;
+    cusumLow = 0.0f;
+    warmupSamples = 0;
+    return true;
+  }
+
+  float delta = vibration - vibrationMean;
+  vibrationMean += VIBRATION_EWMA_ALPHA * delta;
+  vibrationVar = (1.0f - VIBRATION_EWMA_ALPHA) * (vibrationVar + VIBRATION_EWMA_ALPHA * delta * delta);
+  return false;
+}
+
+bool AdaptiveRateController::update(float currentVibration, float vibrationTrend, int activeAlerts) {
+  unsigned long currentTime = millis();
+
+  bool changePoint = detectChangePoint(currentVibration);
+  bool risingTrend = vibrationTrend > ADAPTIVE_TREND_THRESHOLD;
+  bool newAlert = activeAlerts > lastAlertCount;
+  lastAlertCount = activeAlerts;
+
+  if (!ADAPTIVE_SAMPLING_ENABLED) {
+    return false;
+  }
+
+  if (changePoint || risingTrend || newAlert) {
+    lastTriggerTime = currentTime;
+    if (mode != SAMPLING_BOOST) {
+      Serial.print(F("Adaptive sampling trigger:"));
+      if (changePoint) Serial.print(F(" change-point"));
+      if (risingTrend) Serial.print(F(" rising-trend"));
+      if (newAlert) Serial.print(F(" alert"));
+      Serial.println();
+      setMode(SAMPLING_BOOST, currentTime);
+      return true;
+    }
+    return false;
+  }
+
+  // Step down one level at a time, only after a full quiet period and dwell
+  if (mode != SAMPLING_ECONOMY &&
+      currentTime - lastTriggerTime >= ADAPTIVE_QUIET_PERIOD_MS &&
+      currentTime - modeEnteredTime >= ADAPTIVE_MIN_DWELL_MS) {
+    setMode(static_cast<SamplingMode>(mode - 1), currentTime);
+    return true;
+  }
+
+  return false;
+}
+
+void AdaptiveRateController::setMode(SamplingMode newMode, unsigned long currentTime) {
+  Serial.print(F("Sampling mode: "));
+  Serial.print(getModeName(mode));
+  Serial.print(F(" -> "));
+  Serial.println(getModeName(newMode));
+
+  mode = newMode;
+  modeEnteredTime = currentTime;
+  modeChanges++;
+}
+
+unsigned long AdaptiveRateController::getSensorReadInterval() const {
+  switch (mode) {
+    case SAMPLING_BOOST: return SENSOR_READ_INTERVAL_BOOST;
+    case SAMPLING_ECONOMY: return SENSOR_READ_INTERVAL_ECONOMY;
+    default: return SENSOR_READ_INTERVAL;
+  }
+}
+
+unsigned long AdaptiveRateController::getCloudSyncInterval() const {
+  switch (mode) {
+    case SAMPLING_BOOST: return CLOUD_SYNC_INTERVAL_BOOST;
+    case SAMPLING_ECONOMY: return CLOUD_SYNC_INTERVAL_ECONOMY;
+    default: return CLOUD_SYNC_INTERVAL;
+  }
+}
+
+long AdaptiveRateController::getSensorReadsSaved() const {
+  unsigned long elapsed = millis() - startTime;
+  return (long)(elapsed / SENSOR_READ_INTERVAL) - (long)sensorReads;
+}
+
+long AdaptiveRateController::getCloudSyncsSaved() const {
+  unsigned long elapsed = millis() - startTime;
+  return (long)(elapsed / CLOUD_SYNC_INTERVAL) - (long)cloudSyncs;
+}
+
+const char* AdaptiveRateController::getModeName(SamplingMode m) {
+  switch (m) {
+    case SAMPLING_ECONOMY: return "economy";
+    case SAMPLING_BOOST: return "boost";
+    default: return "normal";
+  }
+}
+
+void AdaptiveRateController::printStats() const {
+  Serial.print(F("Sampling - Mode: "));
+  Serial.print(getModeName(mode));
+  Serial.print(F(", Changes: "));
+  Serial.print(modeChanges);
+  Serial.print(F(", Reads saved: "));
+  Serial.print(getSensorReadsSaved());
+  Serial.print(F(" of "));
+  Serial.print((millis() - startTime) / SENSOR_READ_INTERVAL);
+  Serial.print(F(", Syncs saved: "));
+  Serial.println(getCloudSyncsSaved());
+}
@@ -0,0 +1,141 @@
+#ifndef ADAPTIVE_RATE_CONTROLLER_H
+#define ADAPTIVE_RATE_CONTROLLER_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Sampling/reporting levels, ordered from lowest to highest rate
+ */
+enum SamplingMode {
+  SAMPLING_ECONOMY = 0,   // Stable or idle line - reduced rates
+  SAMPLING_NORMAL = 1,    // Default fixed-schedule rates
+  SAMPLING_BOOST = 2      // Change-point, rising trend or alert - raised rates
+};
+
+/**
+ * @brief Anomaly-driven controller for sensor and telemetry rates
+ *
+ * Watches the vibration signal for change-points (two-sided CUSUM against a
+ * slowly adapting mean), rising vibration trends and newly raised alerts. Any
+ * trigger jumps straight to SAMPLING_BOOST; the controller then steps down
+ * one level at a time once the line has been quiet for
+ * ADAPTIVE_QUIET_PERIOD_MS and the current level has been held for at least
+ * ADAPTIVE_MIN_DWELL_MS, which keeps it from oscillating between levels.
+ *
+ * Actual sensor reads and interval-driven cloud syncs are counted against
+ * what the fixed SENSOR_READ_INTERVAL / CLOUD_SYNC_INTERVAL schedule would
+ * have done so the savings can be reported. Syncs forced by waiting alerts
+ * happen on either schedule and are left out.
+ */
+class AdaptiveRateController {
+private:
+  SamplingMode mode;
+  unsigned long modeEnteredTime;
+  unsigned long lastTriggerTime;
+  unsigned long startTime;
+
+  // Change-point detection state (CUSUM on normalized vibration)
+  float vibrationMean;
+  float vibrationVar;
+  float cusumHigh;
+  float cusumLow;
+  uint16_t warmupSamples;
+  int lastAlertCount;
+
+  // Savings accounting against the fixed schedule
+  uint32_t sensorReads;
+  uint32_t cloudSyncs;
+  uint32_t modeChanges;
+
+  /**
+   * @brief Feed one vibration sample to the CUSUM detector
+   * @param vibration Current vibration level in g
+   * @return true if a change-point was detected on this sample
+   */
+  bool detectChangePoint(float vibration);
+
+  /**
+   * @brief Switch to a new mode and log the transition
+   * @param newMode Mode to enter
+   * @param currentTime Current millis() timestamp
+   */
+  void setMode(SamplingMode newMode, unsigned long currentTime);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  AdaptiveRateController();
+
+  /**
+   * @brief Initialize the controller in SAMPLING_NORMAL mode
+   */
+  void begin();
+
+  /**
+   * @brief Update the controller with the latest analysis results
+   * @param currentVibration Current vibration level in g
+   * @param vibrationTrend Vibration trend in g per sample
+   * @param activeAlerts Number of unacknowledged alerts
+   * @return true if the sampling mode changed during this update
+   */
+  bool update(float currentVibration, float vibrationTrend, int activeAlerts);
+
+  /**
+   * @brief Get the current sampling mode
+   */
+  SamplingMode getMode() const { return mode; }
+
+  /**
+   * @brief Get the sensor read interval for the current mode
+   * @return Interval in milliseconds
+   */
+  unsigned long getSensorReadInterval() const;
+
+  /**
+   * @brief Get the cloud sync interval for the current mode
+   * @return Interval in milliseconds
+   */
+  unsigned long getCloudSyncInterval() const;
+
+  /**
+   * @brief Record that a sensor read was performed
+   */
+  void recordSensorRead() { sensorReads++; }
+
+  /**
+   * @brief Record a cloud sync made because getCloudSyncInterval() elapsed
+   *        (not one forced by waiting alerts)
+   */
+  void recordCloudSync() { cloudSyncs++; }
+
+  /**
+   * @brief Get sensor reads saved relative to the fixed schedule
+   * @return Reads saved (negative when boosted reads exceeded the schedule)
+   */
+  long getSensorReadsSaved() const;
+
+  /**
+   * @brief Get cloud syncs saved relative to the fixed schedule
+   * @return Syncs saved (negative when boosted syncs exceeded the schedule)
+   */
+  long getCloudSyncsSaved() const;
+
+  /**
+   * @brief Get number of mode transitions since startup
+   */
+  uint32_t getModeChanges() const { return modeChanges; }
+
+  /**
+   * @brief Get printable name of a sampling mode
+   */
+  static const char* getModeName(SamplingMode m);
+
+  /**
+   * @brief Print mode and savings statistics to serial
+   */
+  void printStats() const;
+};
+
+#endif // ADAPTIVE_RATE_CONTROLLER_H
@@ -2,13 +2,20 @@
 
 AnomalyDetector::AnomalyDetector() {
   lowVibrationStartTime = 0;
+  lastJamMessageTime = 0;
   wasRunning = false;
   inLowVibrationState = false;
+  preJamActive = false;
+  preJamSpent = false;
   
-  // Calculate thresholds once
-  speedToleranceRPM = NOMINAL_SPEED_RPM * (SPEED_TOLERANCE_PCT / 100.0f);
-  vibrationWarningLevel = VIBRATION_WARNING_G;
-  vibrationCriticalLevel = VIBRATION_CRITICAL_G;
+  setThresholds(defaultAnomalyThresholds());
+}
+
+void AnomalyDetector::setThresholds(const AnomalyThresholds& newThresholds) {
+  thresholds = newThresholds;
+  
+  // Calculate derived thresholds once
+  speedToleranceRPM = speedToleranceRpm(thresholds);
 }
 
 void AnomalyDetector::begin() {
@@ -20,9 +27,33 @@ void AnomalyDetector::update(const SystemState& state, float averageSpeed, float
   // Vibration-based jam detection
   unsigned long currentTime = millis();
   
+  // Pre-jam: part flow irregularity, only while parts can flow and be seen. A confirmed
+  // jam ends the warning; the score it left behind must settle before it warns again
+  const uint8_t flowInputs = FIELD_BIT(FIELD_SPEED) | FIELD_BIT(FIELD_PARTS);
+  if (detectJam()) {
+    preJamActive = false;
+    preJamSpent = true;
+  }
+  if (!state.conveyorRunning || (usableFields(state) & flowInputs) != flowInputs) {
+    preJamActive = false;
+  } else if (state.flowIrregularity < PREJAM_SCORE_OFF) {
+    preJamActive = false;
+    preJamSpent = false;
+  } else if (state.flowIrregularity >= PREJAM_SCORE_ON && !preJamSpent) {
+    preJamActive = true;
+  }
+  
+  // A jam cannot be confirmed from invalid or stale inputs - restart the timer
+  const uint8_t jamInputs = FIELD_BIT(FIELD_SPEED) | FIELD_BIT(FIELD_VIBRATION);
+  if ((usableFields(state) & jamInputs) != jamInputs) {
+    inLowVibrationState = false;
+    lowVibrationStartTime = currentTime;
+    return;
+  }
+  
   // Check if belt should be running but vibration is too low
   if (state.conveyorRunning && state.speed_rpm > MIN_SPEED_THRESHOLD) {
-    if (state.vibrationLevel < JAM_VIBRATION_THRESHOLD) {
+    if (state.vibrationLevel < thresholds.jamVibrationG) {
       // Low vibration while running - potential jam
       if (!inLowVibrationState) {
         // Just entered low vibration state
@@ -31,16 +62,15 @@ void AnomalyDetector::update(const SystemState& state, float averageSpeed, float
         Serial.print(F("Jam detection: Low vibration detected ("));
         Serial.print(state.vibrationLevel);
         Serial.print(F("g < "));
-        Serial.print(JAM_VIBRATION_THRESHOLD);
+        Serial.print(thresholds.jamVibrationG);
         Serial.println(F("g) while running"));
       } else {
         // Check if we've been in low vibration state long enough
-        if (currentTime - lowVibrationStartTime > JAM_DETECT_TIME_MS) {
+        if (currentTime - lowVibrationStartTime > thresholds.jamDetectTimeMs) {
           // Jam confirmed - vibration has been low for too long
-          static unsigned long lastJamMsg = 0;
-          if (currentTime - lastJamMsg > 5000) { // Don't spam
+          if (currentTime - lastJamMessageTime > 5000) { // Don't spam
             Serial.println(F("JAM DETECTED: Low vibration for extended period"));
-            lastJamMsg = currentTime;
+            lastJamMessageTime = currentTime;
           }
         }
       }
@@ -67,7 +97,7 @@ bool AnomalyDetector::detectSpeedAnomaly(float averageSpeed, float speedVariance
     return false; // Conveyor is stopped, not an anomaly
   }
   
-  float deviation = abs(averageSpeed - NOMINAL_SPEED_RPM);
+  float deviation = fabsf(averageSpeed - NOMINAL_SPEED_RPM);
   
   // Also check for high variance (unstable speed)
   bool speedUnstable = speedVariance > (speedToleranceRPM * 0.5f);
@@ -79,17 +109,17 @@ bool AnomalyDetector::detectJam() const {
   // Vibration-based jam detection
   // Jam is detected if belt should be running but vibration is too low for extended period
   unsigned long currentTime = millis();
-  return inLowVibrationState && (currentTime - lowVibrationStartTime > JAM_DETECT_TIME_MS);
+  return inLowVibrationState && (currentTime - lowVibrationStartTime > thresholds.jamDetectTimeMs);
 }
 
 bool AnomalyDetector::detectVibrationAnomaly(float currentVibration, float vibrationBaseline, float vibrationTrend) const {
   // Critical threshold check
-  if (currentVibration > vibrationCriticalLevel) {
+  if (currentVibration > thresholds.vibrationCriticalG) {
     return true;
   }
   
   // Warning if above baseline and trending up
-  if (currentVibration > vibrationWarningLevel && vibrationTrend > 0.01f) {
+  if (currentVibration > thresholds.vibrationWarningG && vibrationTrend > 0.01f) {
     return true;
   }
   
@@ -115,6 +145,14 @@ bool AnomalyDetector::detectEnvironmentalAnomaly(float temperature, float humidi
   return false;
 }
 
+bool AnomalyDetector::detectAirQualityAnomaly(uint16_t iaq, uint8_t accuracy) const {
+  // Until the clean-air baseline is learned the index is relative to nothing
+  if (accuracy < IAQ_ACCURACY_MEDIUM) {
+    return false;
+  }
+  return iaq > AIR_QUALITY_THRESHOLD;
+}
+
 unsigned long AnomalyDetector::getJamDuration() const {
   if (!inLowVibrationState) {
     return 0;
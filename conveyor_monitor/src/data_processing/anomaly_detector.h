@@ -4,6 +4,50 @@
 #include <Arduino.h>
 #include "../config/data_types.h"
 #include "../config/sensor_config.h"
+#include "../sensors/iaq_estimator.h"
+
+/**
+ * @brief Tunable detection thresholds
+ *
+ * Defaults come from sensor_config.h; host tools inject other values to
+ * backtest and sweep them without rebuilding.
+ */
+struct AnomalyThresholds {
+  float speedTolerancePct;        // SPEED_TOLERANCE_PCT
+  float jamVibrationG;            // JAM_VIBRATION_THRESHOLD
+  unsigned long jamDetectTimeMs;  // JAM_DETECT_TIME_MS
+  float vibrationWarningG;        // VIBRATION_WARNING_G
+  float vibrationCriticalG;       // VIBRATION_CRITICAL_G
+};
+
+/**
+ * @brief Thresholds as configured in sensor_config.h
+ */
+constexpr AnomalyThresholds defaultAnomalyThresholds() {
+  return AnomalyThresholds{SPEED_TOLERANCE_PCT, JAM_VIBRATION_THRESHOLD, JAM_DETECT_TIME_MS,
+                           VIBRATION_WARNING_G, VIBRATION_CRITICAL_G};
+}
+
+/**
+ * @brief Check that a threshold set can detect anything
+ *
+ * Used at compile time on the defaults and at run time on field overrides.
+ */
+constexpr bool isValidAnomalyThresholds(const AnomalyThresholds& t) {
+  return t.speedTolerancePct > 0.0f && t.speedTolerancePct < 100.0f &&
+         t.jamVibrationG > 0.0f && t.jamVibrationG < t.vibrationWarningG &&
+         t.vibrationWarningG < t.vibrationCriticalG &&
+         t.jamDetectTimeMs >= 1000 && t.jamDetectTimeMs <= 600000UL;
+}
+
+/**
+ * @brief Speed deviation that counts as an anomaly, in RPM
+ */
+constexpr float speedToleranceRpm(const AnomalyThresholds& t) {
+  return NOMINAL_SPEED_RPM * (t.speedTolerancePct / 100.0f);
+}
+
+static_assert(isValidAnomalyThresholds(defaultAnomalyThresholds()), "Default anomaly thresholds are inconsistent");
 
 /**
  * @brief Specialized class for detecting system anomalies
@@ -16,13 +60,17 @@ class AnomalyDetector {
 private:
   // Jam detection state
   unsigned long lowVibrationStartTime;
+  unsigned long lastJamMessageTime;
   bool wasRunning;
   bool inLowVibrationState;
   
+  // Pre-jam warning state (part flow irregularity, with hysteresis)
+  bool preJamActive;
+  bool preJamSpent;     // A jam followed the warning; re-arm once the flow settles
+  
   // Thresholds for detection
+  AnomalyThresholds thresholds;
   float speedToleranceRPM;
-  float vibrationWarningLevel;
-  float vibrationCriticalLevel;
   
 public:
   /**
@@ -35,6 +83,18 @@ public:
    */
   void begin();
   
+  /**
+   * @brief Replace the detection thresholds
+   * @param newThresholds Thresholds to use from the next update
+   */
+  void setThresholds(const AnomalyThresholds& newThresholds);
+  
+  /**
+   * @brief Get the active detection thresholds
+   * @return Current thresholds
+   */
+  const AnomalyThresholds& getThresholds() const { return thresholds; }
+  
   /**
    * @brief Update detector state with current system data
    * @param state Current system state
@@ -58,6 +118,15 @@ public:
    */
   bool detectJam() const;
   
+  /**
+   * @brief Detect part flow bunching that tends to precede a jam
+   * @return true while the flow irregularity is above PREJAM_SCORE_ON (until
+   *         it falls below PREJAM_SCORE_OFF) and no jam is detected yet. After a
+   *         confirmed jam it stays false until the irregularity has fallen below
+   *         PREJAM_SCORE_OFF, even across a belt stop
+   */
+  bool detectPreJam() const { return preJamActive && !detectJam(); }
+  
   /**
    * @brief Detect vibration anomalies
    * @param currentVibration Current vibration level
@@ -76,6 +145,14 @@ public:
    */
   bool detectEnvironmentalAnomaly(float temperature, float humidity, float tempVariance) const;
   
+  /**
+   * @brief Detect poor air quality
+   * @param iaq IAQ index (0-500)
+   * @param accuracy IAQAccuracy of the index
+   * @return true if IAQ exceeds AIR_QUALITY_THRESHOLD with a learned baseline
+   */
+  bool detectAirQualityAnomaly(uint16_t iaq, uint8_t accuracy) const;
+  
   /**
    * @brief Check if currently in jam state
    * @return true if jam state active
@@ -1,7 +1,15 @@
 #include "data_processor.h"
+#include "../utils/performance_utils.h"
 
 DataProcessor::DataProcessor() {
   // Delegated constructors handle initialization
+  oeeStarted = false;
+  thresholdsUpdated = false;
+  rulUpdated = false;
+  airQualityIndex = 0;
+  airQualityAccuracy = IAQ_ACCURACY_UNRELIABLE;
+  inputEpoch = 0;
+  memoize = true;
 }
 
 void DataProcessor::begin() {
@@ -10,11 +18,16 @@ void DataProcessor::begin() {
   // Initialize specialized components
   statisticalAnalyzer.begin();
   anomalyDetector.begin();
+  spcMonitor.begin();
+  thresholdTuner.begin();
+  rulEstimator.begin();
   
   Serial.println(F("Data processor ready"));
 }
 
 void DataProcessor::update(const SystemState& state) {
+  inputEpoch++;
+  
   // Update statistical analysis first (provides data for anomaly detection)
   statisticalAnalyzer.update(state);
   
@@ -23,25 +36,122 @@ void DataProcessor::update(const SystemState& state) {
                         statisticalAnalyzer.getAverageSpeed(),
                         statisticalAnalyzer.getSpeedVariance(),
                         statisticalAnalyzer.getVibrationBaseline());
+  airQualityIndex = state.iaq;
+  airQualityAccuracy = state.iaqAccuracy;
+  
+  // Control charts catch runs and drifts inside the fixed tolerance bands
+  PERF_TIME(spcTimer, spcMonitor.update(state));
+  
+  // Learn per-line thresholds from normal running only (a suspected jam counts as abnormal)
+  bool anomalyActive = anomalyDetector.getJamDuration() > 0 || detectVibrationAnomaly() || detectSpeedAnomaly();
+  if (thresholdTuner.update(state, anomalyActive)) {
+    setThresholds(thresholdTuner.getThresholds());
+    thresholdsUpdated = true;
+  }
+  
+  // Hourly wear indicator for the remaining-useful-life model (a jam's low vibration is not wear)
+  if (rulEstimator.update(state, anomalyDetector.getJamDuration() > 0)) {
+    rulUpdated = true;
+  }
+  
+  // OEE accounting - start from the first state so existing parts are not counted
+  if (!oeeStarted) {
+    oeeTracker.begin(state.totalParts);
+    oeeStarted = true;
+    return;
+  }
+  bool qualitySuspect = detectVibrationAnomaly() || detectSpeedAnomaly();
+  oeeTracker.update(state, anomalyDetector.detectJam(), qualitySuspect);
+}
+
+void DataProcessor::setMemoization(bool enabled) {
+  memoize = enabled;
+  statisticalAnalyzer.setMemoization(enabled);
+}
+
+uint32_t DataProcessor::getCacheHits() const {
+  return speedAnomaly.getHits() + vibrationAnomaly.getHits() + rulResult.getHits() +
+         statisticalAnalyzer.getCacheHits();
+}
+
+uint32_t DataProcessor::getCacheMisses() const {
+  return speedAnomaly.getMisses() + vibrationAnomaly.getMisses() + rulResult.getMisses() +
+         statisticalAnalyzer.getCacheMisses();
+}
+
+void DataProcessor::setThresholds(const AnomalyThresholds& thresholds) {
+  anomalyDetector.setThresholds(thresholds);
+  inputEpoch++;
 }
 
 bool DataProcessor::detectSpeedAnomaly() const {
-  return anomalyDetector.detectSpeedAnomaly(statisticalAnalyzer.getAverageSpeed(),
-                                           statisticalAnalyzer.getSpeedVariance());
+  return cached(speedAnomaly, [this] {
+    return anomalyDetector.detectSpeedAnomaly(statisticalAnalyzer.getAverageSpeed(),
+                                              statisticalAnalyzer.getSpeedVariance());
+  });
 }
 
 bool DataProcessor::detectJam() const {
   return anomalyDetector.detectJam();
 }
 
+bool DataProcessor::detectPreJam() const {
+  return anomalyDetector.detectPreJam();
+}
+
 bool DataProcessor::detectVibrationAnomaly() const {
-  return anomalyDetector.detectVibrationAnomaly(statisticalAnalyzer.getCurrentVibration(),
-                                               statisticalAnalyzer.getVibrationBaseline(),
-                                               statisticalAnalyzer.getVibrationTrend());
+  return cached(vibrationAnomaly, [this] {
+    return anomalyDetector.detectVibrationAnomaly(statisticalAnalyzer.getCurrentVibration(),
+                                                  statisticalAnalyzer.getVibrationBaseline(),
+                                                  statisticalAnalyzer.getVibrationTrend());
+  });
 }
 
 bool DataProcessor::detectEnvironmentalAnomaly() const {
   return anomalyDetector.detectEnvironmentalAnomaly(statisticalAnalyzer.getCurrentTemperature(),
                                                    statisticalAnalyzer.getCurrentHumidity(),
-                                                   statisticalAnalyzer.getTemperatureVariance());
+                                                   statisticalAnalyzer.getTemperatureVariance()) ||
+         anomalyDetector.detectAirQualityAnomaly(airQualityIndex, airQualityAccuracy);
+}
+
+bool DataProcessor::popThresholdUpdate() {
+  bool updated = thresholdsUpdated;
+  thresholdsUpdated = false;
+  return updated;
+}
+
+float DataProcessor::predictMaintenanceHours() const {
+  RULEstimate rul;
+  return estimateRUL(rul) ? rul.hours : RUL_MAX_HOURS;
+}
+
+bool DataProcessor::estimateRUL(RULEstimate& result) const {
+  const RULResult& rul = cached(rulResult, [this] {
+    RULResult fresh;
+    fresh.valid = rulEstimator.estimate(anomalyDetector.getThresholds().vibrationCriticalG, fresh.estimate);
+    return fresh;
+  });
+  if (rul.valid) {
+    result = rul.estimate;
+  }
+  return rul.valid;
+}
+
+bool DataProcessor::popRULUpdate() {
+  bool updated = rulUpdated;
+  rulUpdated = false;
+  return updated;
+}
+
+void DataProcessor::applyConfig(const AnomalyThresholds& thresholds, bool tuningEnabled) {
+  thresholdTuner.setDefaults(thresholds);
+  thresholdTuner.setEnabled(tuningEnabled);
+  setThresholds(tuningEnabled ? thresholdTuner.getThresholds() : thresholds);
+}
+
+void DataProcessor::readState(J* body) {
+  thresholdTuner.readState(body);
+  if (thresholdTuner.isTuned()) {
+    setThresholds(thresholdTuner.getThresholds());
+  }
 }
\ No newline at end of file
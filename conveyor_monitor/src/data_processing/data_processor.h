@@ -5,6 +5,11 @@
 #include "../config/data_types.h"
 #include "anomaly_detector.h"
 #include "statistical_analyzer.h"
+#include "oee_tracker.h"
+#include "spc_monitor.h"
+#include "threshold_tuner.h"
+#include "rul_estimator.h"
+#include "../utils/performance_utils.h"
 
 /**
  * @brief Main data processing coordinator
@@ -12,11 +17,53 @@
  * This class coordinates between statistical analysis and anomaly detection,
  * providing a unified interface for the main application. It delegates
  * specialized tasks to the appropriate analyzer classes.
+ *
+ * Detector results and the RUL estimate are memoized per input epoch,
+ * which advances with every update() and every threshold change, so the
+ * update itself, processData() and reporting share one evaluation.
  */
 class DataProcessor {
 private:
   StatisticalAnalyzer statisticalAnalyzer;
   AnomalyDetector anomalyDetector;
+  OEETracker oeeTracker;
+  SPCMonitor spcMonitor;
+  ThresholdTuner thresholdTuner;
+  RULEstimator rulEstimator;
+  bool thresholdsUpdated;
+  bool rulUpdated;
+  bool oeeStarted;
+  
+  // Latest air quality index from the sensor layer
+  uint16_t airQualityIndex;
+  uint8_t airQualityAccuracy;
+  
+  // Derived results, memoized per input epoch
+  struct RULResult {
+    bool valid;
+    RULEstimate estimate;
+  };
+  uint32_t inputEpoch;
+  bool memoize;
+  mutable EpochCache<bool> speedAnomaly;
+  mutable EpochCache<bool> vibrationAnomaly;
+  mutable EpochCache<RULResult> rulResult;
+  
+  /**
+   * @brief Read a derived result through its cache
+   */
+  template<typename T, typename Compute>
+  const T& cached(EpochCache<T>& cache, Compute compute) const {
+    if (!memoize) {
+      cache.invalidate();
+    }
+    return cache.get(inputEpoch, compute);
+  }
+  
+  /**
+   * @brief Hand new thresholds to the detector (starts a new epoch)
+   */
+  void setThresholds(const AnomalyThresholds& thresholds);
   
 public:
   /**
@@ -35,6 +82,18 @@ public:
    */
   void update(const SystemState& state);
   
+  /**
+   * @brief Enable or disable memoization of derived results and statistics
+   * @param enabled false = recompute on every read (benchmarking)
+   */
+  void setMemoization(bool enabled);
+  
+  /**
+   * @brief Derived reads served from the caches / computed, statistics included
+   */
+  uint32_t getCacheHits() const;
+  uint32_t getCacheMisses() const;
+  
   /**
    * @brief Detect speed anomalies in conveyor operation
    * @return true if speed deviation exceeds tolerance or shows instability
@@ -49,6 +108,12 @@ public:
    */
   bool detectJam() const;
   
+  /**
+   * @brief Detect part flow bunching ahead of a jam
+   * @return true while the part spacing and dwell are irregular (see PartFlowMonitor)
+   */
+  bool detectPreJam() const;
+  
   /**
    * @brief Detect abnormal vibration patterns
    * @return true if vibration exceeds critical thresholds or shows concerning trends
@@ -58,8 +123,9 @@ public:
   
   /**
    * @brief Detect environmental condition anomalies
-   * @return true if temperature, humidity, or pressure outside operating ranges
+   * @return true if temperature, humidity, or air quality outside operating ranges
    * @details Monitors temp (10-40°C), humidity (<80%), rapid changes (>5°C variance)
+   *          and IAQ (>250 once the baseline is learned)
    */
   bool detectEnvironmentalAnomaly() const;
   
@@ -88,18 +154,90 @@ public:
   bool isJamDetected() const { return anomalyDetector.isJamDetected(); }
   
   /**
-   * @brief Predict hours until maintenance needed
-   * @return Estimated hours until maintenance required based on vibration trends
-   * @details Returns 999.0 if no degradation trend detected
+   * @brief Predict operating hours until maintenance needed
+   * @return Remaining useful life until vibration reaches the critical threshold
+   * @details RUL_MAX_HOURS until enough hourly points show a degradation trend
+   */
+  float predictMaintenanceHours() const;
+  
+  /**
+   * @brief Estimate remaining useful life with confidence bounds
+   * @param result Filled when enough hourly points are in
+   * @return false while the degradation model is still collecting points
+   */
+  bool estimateRUL(RULEstimate& result) const;
+  
+  /**
+   * @brief Check whether a new hourly degradation point came in since the last call
+   */
+  bool popRULUpdate();
+  
+  /**
+   * @brief Start a new degradation model (maintenance done)
+   */
+  void resetMaintenance() {
+    rulEstimator.reset();
+    inputEpoch++;
+  }
+  
+  /**
+   * @brief Get Overall Equipment Effectiveness for the shift in progress
+   * @return OEE percentage (0-100) = availability x performance x quality
+   */
+  float getEfficiencyScore() const { return oeeTracker.getCurrentShift().oee() * 100.0f; }
+  
+  /**
+   * @brief Collect the summary of the most recently completed shift
+   * @param summary Filled with the shift summary
+   * @return true if a shift ended since the last call
+   */
+  bool popShiftSummary(OEEShiftSummary& summary) { return oeeTracker.popShiftSummary(summary); }
+  
+  /**
+   * @brief Collect the next due SPC rule-violation event
+   * @param violation Filled with the event
+   * @return true if an event was due
+   */
+  bool popSPCViolation(SPCViolation& violation) { return spcMonitor.popViolation(violation); }
+  
+  /**
+   * @brief Check whether the tuned thresholds changed since the last call
+   * @return true once per completed tuning epoch
+   */
+  bool popThresholdUpdate();
+  
+  /**
+   * @brief Turn threshold tuning on or off (TUNING_ENABLED by default)
+   */
+  void setThresholdTuning(bool enable) { thresholdTuner.setEnabled(enable); }
+  
+  /**
+   * @brief Detect with field-configured thresholds
+   * @param thresholds Fixed thresholds (validated by the caller)
+   * @param tuningEnabled Learn per-line thresholds within bounds of these; off detects with them as given
+   */
+  void applyConfig(const AnomalyThresholds& thresholds, bool tuningEnabled);
+  
+  /**
+   * @brief Serialize learned state (tuned thresholds) into a note body
+   * @param body JSON object to add fields to
    */
-  float predictMaintenanceHours() const { return statisticalAnalyzer.predictMaintenanceHours(); }
+  void writeState(J* body) { thresholdTuner.writeState(body); }
   
   /**
-   * @brief Calculate overall system efficiency score
-   * @return Efficiency percentage (0-100) based on speed, vibration, and jam status
-   * @details Weighted average: 40% speed + 40% vibration + 20% jam penalty
+   * @brief Restore learned state and detect with the restored thresholds
+   * @param body JSON object produced by writeState()
    */
-  float getEfficiencyScore() const { return statisticalAnalyzer.getEfficiencyScore(anomalyDetector.isJamDetected()); }
+  void readState(J* body);
+  
+  /**
+   * @brief Restore the degradation model (rul.dbx) and start a new epoch
+   * @param body JSON object produced by RULEstimator::writeState()
+   */
+  void restoreRULState(J* body) {
+    rulEstimator.readState(body);
+    inputEpoch++;
+  }
   
   /**
    * @brief Get direct access to statistical analyzer component
@@ -112,6 +250,30 @@ public:
    * @return Reference to AnomalyDetector for advanced anomaly analysis
    */
   const AnomalyDetector& getAnomalyDetector() const { return anomalyDetector; }
+  
+  /**
+   * @brief Get direct access to OEE tracker component
+   * @return Reference to OEETracker for hourly and shift totals
+   */
+  const OEETracker& getOEETracker() const { return oeeTracker; }
+  
+  /**
+   * @brief Get direct access to the SPC control charts
+   * @return Reference to SPCMonitor for chart limits and violation counts
+   */
+  const SPCMonitor& getSPCMonitor() const { return spcMonitor; }
+  
+  /**
+   * @brief Get direct access to the threshold tuner
+   * @return Reference to ThresholdTuner for learning progress and quantiles
+   */
+  const ThresholdTuner& getThresholdTuner() const { return thresholdTuner; }
+  
+  /**
+   * @brief Get direct access to the remaining-useful-life estimator
+   * @return Reference to RULEstimator for its model, points and saving (writeState)
+   */
+  const RULEstimator& getRULEstimator() const { return rulEstimator; }
 };
 
 #endif // DATA_PROCESSOR_H
\ No newline at end of file
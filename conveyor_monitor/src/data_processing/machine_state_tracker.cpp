@@ -0,0 +1,170 @@
+#include "machine_state_tracker.h"
+
+// Longest run that fits the varint after the 3-bit state shift (~31 days)
+static const uint32_t MAX_RUN_TICKS = 0x0FFFFFFFUL;
+
+// Worst-case bytes for one record (35 bits of payload)
+static const uint16_t MAX_RECORD_BYTES = 5;
+
+MachineStateTracker::MachineStateTracker() {
+  state = MACHINE_IDLE;
+  stateStartTime = 0;
+  candidate = MACHINE_IDLE;
+  candidateStartTime = 0;
+  jamLatched = false;
+  logLength = 0;
+  logRuns = 0;
+  logStartTime = 0;
+  lastFlushTime = 0;
+  retryTime = 0;
+  transitions = 0;
+  microStops = 0;
+  runsDropped = 0;
+}
+
+void MachineStateTracker::begin() {
+  unsigned long currentTime = millis();
+  stateStartTime = currentTime;
+  candidateStartTime = currentTime;
+  logStartTime = currentTime;
+  lastFlushTime = currentTime;
+}
+
+MachineState MachineStateTracker::classify(bool running, bool jamDetected, bool sensorFault) const {
+  if (sensorFault) {
+    return MACHINE_SENSOR_FAULT;
+  }
+  if (jamDetected) {
+    return MACHINE_JAMMED;
+  }
+  if (running) {
+    return MACHINE_RUNNING;
+  }
+  // A stop straight after running is a micro-stop until it lasts too long
+  if (state == MACHINE_RUNNING || state == MACHINE_MICROSTOP) {
+    return MACHINE_MICROSTOP;
+  }
+  return MACHINE_IDLE;
+}
+
+bool MachineStateTracker::update(bool running, bool jamDetected, bool sensorFault) {
+  unsigned long currentTime = millis();
+
+  // A stop that outlasted the limit was never a micro-stop: the whole run is idle
+  if (state == MACHINE_MICROSTOP && currentTime - stateStartTime >= MICROSTOP_MAX_MS) {
+    state = MACHINE_IDLE;
+    candidate = MACHINE_IDLE;
+    return true;
+  }
+
+  // Hold a confirmed jam through the stop that clears it
+  if (jamDetected) {
+    jamLatched = true;
+  } else if (running) {
+    jamLatched = false;
+  }
+
+  MachineState observed = classify(running, jamLatched, sensorFault);
+  if (observed == state) {
+    candidate = state;
+    return false;
+  }
+
+  if (observed != candidate) {
+    candidate = observed;
+    candidateStartTime = currentTime;
+    return false;
+  }
+
+  if (currentTime - candidateStartTime < MACHINE_STATE_DEBOUNCE_MS) {
+    return false;
+  }
+
+  // Accepted - back-date the transition to when the candidate first appeared
+  if (state == MACHINE_MICROSTOP && observed == MACHINE_RUNNING) {
+    microStops++;
+  }
+  enterState(observed, candidateStartTime);
+  return true;
+}
+
+void MachineStateTracker::enterState(MachineState newState, unsigned long startTime) {
+  appendRun(state, stateStartTime, startTime - stateStartTime);
+  state = newState;
+  stateStartTime = startTime;
+  candidate = newState;
+  candidateStartTime = startTime;
+  transitions++;
+}
+
+void MachineStateTracker::appendRun(MachineState runState, unsigned long runStart, unsigned long durationMs) {
+  if (logLength + MAX_RECORD_BYTES > MACHINE_LOG_BYTES) {
+    // Upload is behind - the cloud sees the gap from the batch times
+    runsDropped++;
+    return;
+  }
+  if (logRuns == 0) {
+    logStartTime = runStart;
+  }
+
+  uint32_t ticks = min((uint32_t)(durationMs / MACHINE_LOG_TICK_MS), MAX_RUN_TICKS);
+  uint32_t value = (ticks << 3) | (uint32_t)runState;
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    runLog[logLength++] = value ? (byte | 0x80) : byte;
+  } while (value);
+  logRuns++;
+}
+
+bool MachineStateTracker::flushDue() const {
+  if (logRuns == 0) {
+    return false;
+  }
+  if (retryTime != 0 && millis() - retryTime < MACHINE_LOG_RETRY_MS) {
+    return false;
+  }
+  return logLength >= MACHINE_LOG_FLUSH_BYTES ||
+         millis() - lastFlushTime >= MACHINE_LOG_FLUSH_INTERVAL;
+}
+
+void MachineStateTracker::clearLog() {
+  logLength = 0;
+  logRuns = 0;
+  lastFlushTime = millis();
+  retryTime = 0;
+}
+
+void MachineStateTracker::deferFlush() {
+  retryTime = millis();
+  if (retryTime == 0) {
+    retryTime = 1;
+  }
+}
+
+const char* MachineStateTracker::getStateName(MachineState s) {
+  switch (s) {
+    case MACHINE_RUNNING: return "running";
+    case MACHINE_MICROSTOP: return "microstop";
+    case MACHINE_JAMMED: return "jammed";
+    case MACHINE_SENSOR_FAULT: return "sensor_fault";
+    default: return "idle";
+  }
+}
+
+void MachineStateTracker::printStats() const {
+  Serial.print(F("Machine State - "));
+  Serial.print(getStateName(state));
+  Serial.print(F(" for "));
+  Serial.print(getStateDuration() / 1000);
+  Serial.print(F("s, Transitions: "));
+  Serial.print(transitions);
+  Serial.print(F(", Micro-stops: "));
+  Serial.print(microStops);
+  Serial.print(F(", Log: "));
+  Serial.print(logRuns);
+  Serial.print(F(" runs/"));
+  Serial.print(logLength);
+  Serial.print(F(" bytes, Dropped: "));
+  Serial.println(runsDropped);
+}
@@ -0,0 +1,137 @@
+#ifndef MACHINE_STATE_TRACKER_H
+#define MACHINE_STATE_TRACKER_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Conveyor machine states (3-bit codes in the run log)
+ */
+enum MachineState {
+  MACHINE_RUNNING = 0,
+  MACHINE_IDLE,            // Stopped for longer than MICROSTOP_MAX_MS
+  MACHINE_MICROSTOP,       // Stopped after running, for at most MICROSTOP_MAX_MS
+  MACHINE_JAMMED,          // Confirmed jam, until the belt runs normally again
+  MACHINE_SENSOR_FAULT,    // Speed/part sensors cannot be trusted
+  MACHINE_STATE_COUNT
+};
+
+/**
+ * @brief Run/stop/jam state tracker with a compact run-length log
+ *
+ * Derives the machine state on every sensor read. A new state must hold for
+ * MACHINE_STATE_DEBOUNCE_MS before it is accepted, and the transition is then
+ * back-dated to when it first appeared, so short stops are kept at tick
+ * resolution without logging speed noise. A stop that outlasts
+ * MICROSTOP_MAX_MS is reclassified as idle from its start. A confirmed jam
+ * is latched: stopping the belt to clear it is still jam downtime, until
+ * the belt runs without a jam again.
+ *
+ * Each completed run is appended to the log as one unsigned LEB128 varint of
+ * (duration_ticks << 3) | state, with MACHINE_LOG_TICK_MS ticks. Runs up to
+ * 160 ms take one byte, up to 20 s two bytes and up to 43 minutes three bytes.
+ * Run start times are implicit: batch start time plus the sum of earlier runs.
+ */
+class MachineStateTracker {
+private:
+  MachineState state;
+  unsigned long stateStartTime;
+
+  // Debounce
+  MachineState candidate;
+  unsigned long candidateStartTime;
+  bool jamLatched;
+
+  // Run log
+  uint8_t runLog[MACHINE_LOG_BYTES];
+  uint16_t logLength;
+  uint16_t logRuns;
+  unsigned long logStartTime;
+  unsigned long lastFlushTime;
+  unsigned long retryTime;          // Last failed upload (0 = none pending)
+
+  // Statistics
+  uint32_t transitions;
+  uint32_t microStops;
+  uint32_t runsDropped;
+
+  /**
+   * @brief Map the instantaneous inputs to a state
+   */
+  MachineState classify(bool running, bool jamDetected, bool sensorFault) const;
+
+  /**
+   * @brief Close the current run and start a new state
+   * @param newState State being entered
+   * @param startTime When the new state began
+   */
+  void enterState(MachineState newState, unsigned long startTime);
+
+  /**
+   * @brief Append one completed run to the log
+   * @param runState State of the completed run
+   * @param runStart When the run began
+   * @param durationMs Run length
+   */
+  void appendRun(MachineState runState, unsigned long runStart, unsigned long durationMs);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  MachineStateTracker();
+
+  /**
+   * @brief Start tracking in the idle state
+   */
+  void begin();
+
+  /**
+   * @brief Update with the latest readings
+   * @param running Belt running (speed above MIN_SPEED_THRESHOLD)
+   * @param jamDetected Confirmed jam (AnomalyDetector::detectJam())
+   * @param sensorFault Motion sensors cannot be trusted
+   * @return true if the state changed
+   */
+  bool update(bool running, bool jamDetected, bool sensorFault);
+
+  /**
+   * @brief Check whether the log should be uploaded now
+   * @return true if the buffer is nearly full, or holds runs older than
+   *         MACHINE_LOG_FLUSH_INTERVAL
+   */
+  bool flushDue() const;
+
+  /**
+   * @brief Discard the logged runs after a successful upload
+   */
+  void clearLog();
+  
+  /**
+   * @brief Hold the log back for MACHINE_LOG_RETRY_MS after a failed upload
+   */
+  void deferFlush();
+
+  const uint8_t* getLog() const { return runLog; }
+  uint16_t getLogLength() const { return logLength; }
+  uint16_t getLogRuns() const { return logRuns; }
+  unsigned long getLogStartTime() const { return logStartTime; }
+
+  MachineState getState() const { return state; }
+  unsigned long getStateDuration() const { return millis() - stateStartTime; }
+  uint32_t getTransitions() const { return transitions; }
+  uint32_t getMicroStops() const { return microStops; }
+  uint32_t getRunsDropped() const { return runsDropped; }
+
+  /**
+   * @brief Get printable name of a machine state
+   */
+  static const char* getStateName(MachineState s);
+
+  /**
+   * @brief Print tracker statistics to serial
+   */
+  void printStats() const;
+};
+
+#endif // MACHINE_STATE_TRACKER_H
@@ -0,0 +1,117 @@
+#include "oee_tracker.h"
+
+float OEEAccumulator::availability() const {
+  uint32_t planned = runMs + jamMs;
+  if (OEE_IDLE_IS_DOWNTIME) {
+    planned += idleMs;
+  }
+  return planned > 0 ? (float)runMs / planned : 0.0f;
+}
+
+float OEEAccumulator::performance() const {
+  float idealParts = (runMs / 60000.0f) * EXPECTED_PARTS_PER_MIN;
+  if (idealParts <= 0.0f) {
+    return 0.0f;
+  }
+  return min(1.0f, parts / idealParts);
+}
+
+float OEEAccumulator::quality() const {
+  return parts > 0 ? (float)goodParts / parts : 1.0f;
+}
+
+OEETracker::OEETracker() {
+  hour.clear();
+  shift.clear();
+  lastHour.clear();
+  completed.shiftNumber = 0;
+  completed.totals.clear();
+  completed.hourCount = 0;
+  summaryReady = false;
+  shiftNumber = 0;
+  hourIndex = 0;
+  for (int i = 0; i < OEE_MAX_HOURS_PER_SHIFT; i++) {
+    hourlyOEE[i] = 0;
+  }
+  lastUpdateTime = 0;
+  hourStartTime = 0;
+  shiftStartTime = 0;
+  lastTotalParts = 0;
+}
+
+void OEETracker::begin(uint32_t totalParts) {
+  unsigned long currentTime = millis();
+  lastUpdateTime = currentTime;
+  hourStartTime = currentTime;
+  shiftStartTime = currentTime;
+  lastTotalParts = totalParts;
+  Serial.println(F("OEE tracker initialized"));
+}
+
+void OEETracker::update(const SystemState& state, bool jamDetected, bool qualitySuspect) {
+  unsigned long currentTime = millis();
+  uint32_t dt = currentTime - lastUpdateTime;
+  lastUpdateTime = currentTime;
+
+  // Attribute elapsed time to exactly one state
+  uint32_t* bucketHour = jamDetected ? &hour.jamMs : (state.conveyorRunning ? &hour.runMs : &hour.idleMs);
+  uint32_t* bucketShift = jamDetected ? &shift.jamMs : (state.conveyorRunning ? &shift.runMs : &shift.idleMs);
+  *bucketHour += dt;
+  *bucketShift += dt;
+
+  // New parts since the previous update
+  uint32_t newParts = state.totalParts - lastTotalParts;
+  lastTotalParts = state.totalParts;
+  uint32_t newGood = qualitySuspect ? 0 : newParts;
+  hour.parts += newParts;
+  hour.goodParts += newGood;
+  shift.parts += newParts;
+  shift.goodParts += newGood;
+
+  if (currentTime - hourStartTime >= OEE_HOUR_MS) {
+    hourStartTime += OEE_HOUR_MS;
+    closeHour();
+  }
+  if (currentTime - shiftStartTime >= OEE_SHIFT_DURATION_MS) {
+    shiftStartTime += OEE_SHIFT_DURATION_MS;
+    closeShift();
+  }
+}
+
+void OEETracker::closeHour() {
+  if (hourIndex < OEE_MAX_HOURS_PER_SHIFT) {
+    hourlyOEE[hourIndex++] = (uint16_t)(hour.oee() * 1000.0f);
+  }
+  lastHour = hour;
+  hour.clear();
+}
+
+void OEETracker::closeShift() {
+  completed.shiftNumber = shiftNumber;
+  completed.totals = shift;
+  completed.hourCount = hourIndex;
+  for (int i = 0; i < OEE_MAX_HOURS_PER_SHIFT; i++) {
+    completed.hourlyOEE[i] = hourlyOEE[i];
+    hourlyOEE[i] = 0;
+  }
+  summaryReady = true;
+
+  Serial.print(F("Shift "));
+  Serial.print(shiftNumber);
+  Serial.print(F(" complete - OEE: "));
+  Serial.print(shift.oee() * 100.0f);
+  Serial.println(F("%"));
+
+  shift.clear();
+  hourIndex = 0;
+  shiftNumber++;
+}
+
+bool OEETracker::popShiftSummary(OEEShiftSummary& summary) {
+  if (!summaryReady) {
+    return false;
+  }
+  summary = completed;
+  summaryReady = false;
+  return true;
+}
@@ -0,0 +1,121 @@
+#ifndef OEE_TRACKER_H
+#define OEE_TRACKER_H
+
+#include <Arduino.h>
+#include "../config/data_types.h"
+#include "../config/sensor_config.h"
+#include "../config/system_config.h"
+
+/**
+ * @brief Running totals for one OEE accounting period
+ */
+struct OEEAccumulator {
+  uint32_t runMs;       // Belt running, no jam
+  uint32_t idleMs;      // Belt stopped, no jam
+  uint32_t jamMs;       // Jam confirmed (AnomalyDetector::detectJam())
+  uint32_t parts;       // Every new part in the period, whatever the belt state
+  uint32_t goodParts;   // Parts counted with no quality-suspect condition
+
+  void clear() { runMs = idleMs = jamMs = parts = goodParts = 0; }
+
+  float availability() const;
+  float performance() const;
+  float quality() const;
+  float oee() const { return availability() * performance() * quality(); }
+};
+
+/**
+ * @brief Completed shift summary
+ */
+struct OEEShiftSummary {
+  uint16_t shiftNumber;
+  OEEAccumulator totals;
+  uint8_t hourCount;
+  uint16_t hourlyOEE[OEE_MAX_HOURS_PER_SHIFT];   // Per-hour OEE in permille
+};
+
+/**
+ * @brief Incremental Overall Equipment Effectiveness engine
+ *
+ * Attributes the time between updates to running, idle or jammed and counts
+ * new parts against the ideal EXPECTED_PARTS_PER_MIN rate. Parts produced
+ * while a quality-suspect condition is active (vibration or speed anomaly)
+ * are counted but not as good. Each update is O(1): it only adds to the
+ * current hour and shift accumulators.
+ *
+ * - Availability = run / (run + jam [+ idle if OEE_IDLE_IS_DOWNTIME])
+ * - Performance  = parts / (run minutes * EXPECTED_PARTS_PER_MIN), capped at 1
+ * - Quality      = good parts / parts
+ *
+ * When a shift ends its totals and hourly OEE values are kept as a summary
+ * until collected with popShiftSummary().
+ */
+class OEETracker {
+private:
+  OEEAccumulator hour;
+  OEEAccumulator shift;
+  OEEAccumulator lastHour;
+  OEEShiftSummary completed;
+  bool summaryReady;
+
+  uint16_t shiftNumber;
+  uint8_t hourIndex;
+  uint16_t hourlyOEE[OEE_MAX_HOURS_PER_SHIFT];
+
+  unsigned long lastUpdateTime;
+  unsigned long hourStartTime;
+  unsigned long shiftStartTime;
+  uint32_t lastTotalParts;
+
+  void closeHour();
+  void closeShift();
+
+public:
+  /**
+   * @brief Constructor
+   */
+  OEETracker();
+
+  /**
+   * @brief Start the first shift
+   * @param totalParts Current monotonic part count
+   */
+  void begin(uint32_t totalParts);
+
+  /**
+   * @brief Account the time and parts since the previous update
+   * @param state Current system state (running flag and part total)
+   * @param jamDetected Whether a confirmed jam is active
+   * @param qualitySuspect Whether parts made now are of doubtful quality
+   */
+  void update(const SystemState& state, bool jamDetected, bool qualitySuspect);
+
+  /**
+   * @brief Collect the summary of the most recently completed shift
+   * @param summary Filled with the shift summary
+   * @return true if a new summary was available (returned only once)
+   */
+  bool popShiftSummary(OEEShiftSummary& summary);
+
+  /**
+   * @brief Get totals for the shift in progress
+   */
+  const OEEAccumulator& getCurrentShift() const { return shift; }
+
+  /**
+   * @brief Get totals for the hour in progress
+   */
+  const OEEAccumulator& getCurrentHour() const { return hour; }
+
+  /**
+   * @brief Get totals for the last completed hour
+   */
+  const OEEAccumulator& getLastHour() const { return lastHour; }
+
+  /**
+   * @brief Get current shift number (since startup)
+   */
+  uint16_t getShiftNumber() const { return shiftNumber; }
+};
+
+#endif // OEE_TRACKER_H
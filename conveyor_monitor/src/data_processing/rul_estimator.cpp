@@ -0,0 +1,238 @@
+#include "rul_estimator.h"
+#include "../config/system_config.h"
+#include "../utils/fast_math.h"
+
+namespace {
+
+constexpr float MS_PER_HOUR = 3600000.0f;
+constexpr float MIN_INDICATOR_G = 0.001f;   // Keeps ln() finite for a dead-still reading
+
+inline float toModel(float g) {
+  return RUL_EXPONENTIAL ? fastLogf(max(g, MIN_INDICATOR_G)) : g;
+}
+
+} // namespace
+
+RULEstimator::RULEstimator() {
+  intervalStart = 0;
+  runningSince = 0;
+  lastUpdate = 0;
+  running = false;
+  indicatorSum = 0.0f;
+  indicatorSamples = 0;
+  intervalRunMs = 0;
+  intervalsSkipped = 0;
+  resets = 0;
+  clearModel();
+}
+
+void RULEstimator::begin() {
+  intervalStart = millis();
+  lastUpdate = intervalStart;
+  running = false;
+  indicatorSum = 0.0f;
+  indicatorSamples = 0;
+  intervalRunMs = 0;
+}
+
+void RULEstimator::reset() {
+  clearModel();
+  resets++;
+  Serial.println(F("Degradation model reset (maintenance)"));
+}
+
+void RULEstimator::clearModel() {
+  level = 0.0f;
+  slope = 0.0f;
+  p00 = RUL_INITIAL_VARIANCE;
+  p01 = 0.0f;
+  p11 = RUL_INITIAL_VARIANCE;
+  residualSum = 0.0f;
+  weightSum = 0.0f;
+  operatingHours = 0.0f;
+  lastPointHours = 0.0f;
+  lastIndicator = 0.0f;
+  points = 0;
+}
+
+bool RULEstimator::update(const SystemState& state, bool jamSuspected) {
+  unsigned long now = millis();
+  unsigned long elapsed = now - lastUpdate;
+  lastUpdate = now;
+
+  // Close the interval: a point if the line ran enough of it
+  bool added = false;
+  if (now - intervalStart >= RUL_INTERVAL_MS) {
+    operatingHours += intervalRunMs / MS_PER_HOUR;
+    if (indicatorSamples >= RUL_MIN_SAMPLES) {
+      addPoint(indicatorSum / indicatorSamples);
+      added = true;
+    } else {
+      intervalsSkipped++;
+    }
+    intervalStart = now;
+    indicatorSum = 0.0f;
+    indicatorSamples = 0;
+    intervalRunMs = 0;
+  }
+
+  if (!state.conveyorRunning || state.speed_rpm <= MIN_SPEED_THRESHOLD) {
+    running = false;
+    return added;
+  }
+  if (!running) {
+    running = true;
+    runningSince = now;
+    return added;
+  }
+  intervalRunMs += elapsed;
+  if (now - runningSince < RUL_SETTLE_MS || jamSuspected) {
+    return added;
+  }
+
+  // Scale to nominal speed; very slow running says little about wear
+  const uint8_t needed = FIELD_BIT(FIELD_SPEED) | FIELD_BIT(FIELD_VIBRATION);
+  if ((usableFields(state) & needed) != needed || state.speed_rpm < NOMINAL_SPEED_RPM * RUL_MIN_SPEED_RATIO) {
+    return added;
+  }
+  float speedRatio = NOMINAL_SPEED_RPM / state.speed_rpm;
+  float scale = (RUL_SPEED_EXPONENT == 1.0f) ? speedRatio : fastExpf(RUL_SPEED_EXPONENT * fastLogf(speedRatio));
+  indicatorSum += state.vibrationLevel * scale;
+  indicatorSamples++;
+  return added;
+}
+
+void RULEstimator::addPoint(float indicator) {
+  lastIndicator = indicator;
+  float y = toModel(indicator);
+
+  if (points == 0) {
+    level = y;
+    slope = 0.0f;
+    weightSum = 1.0f;
+    lastPointHours = operatingHours;
+    points = 1;
+    return;
+  }
+
+  // Move the intercept to this point: level += slope dt, P = F P F' with F = [1 dt; 0 1]
+  float dt = operatingHours - lastPointHours;
+  lastPointHours = operatingHours;
+  level += slope * dt;
+  p00 += 2.0f * dt * p01 + dt * dt * p11;
+  p01 += dt * p11;
+
+  // RLS step for the regressor x = [1, 0]
+  float gainDenominator = RUL_FORGETTING + p00;
+  float k0 = p00 / gainDenominator;
+  float k1 = p01 / gainDenominator;
+  float error = y - level;
+  level += k0 * error;
+  slope += k1 * error;
+  float posteriorError = y - level;
+
+  float oldP01 = p01;
+  p00 = (p00 - k0 * p00) / RUL_FORGETTING;
+  p01 = (p01 - k0 * oldP01) / RUL_FORGETTING;
+  p11 = (p11 - k1 * oldP01) / RUL_FORGETTING;
+
+  residualSum = RUL_FORGETTING * residualSum + error * posteriorError;
+  weightSum = RUL_FORGETTING * weightSum + 1.0f;
+  points++;
+}
+
+bool RULEstimator::estimate(float criticalG, RULEstimate& result) const {
+  if (points < RUL_MIN_POINTS) {
+    return false;
+  }
+
+  float margin = toModel(criticalG) - level;
+  if (margin <= 0.0f) {
+    result.hours = 0.0f;
+    result.lowHours = 0.0f;
+    result.highHours = 0.0f;
+    return true;
+  }
+
+  // Residual variance with two parameters fitted
+  float variance = max(residualSum, 0.0f) / max(weightSum - 2.0f, 1.0f);
+  float levelSpread = RUL_CONFIDENCE_Z * sqrtf(variance * max(p00, 0.0f));
+  float slopeSpread = RUL_CONFIDENCE_Z * sqrtf(variance * max(p11, 0.0f));
+
+  float fastSlope = slope + slopeSpread;
+  float slowSlope = slope - slopeSpread;
+  result.hours = slope > 0.0f ? margin / slope : RUL_MAX_HOURS;
+  result.lowHours = fastSlope > 0.0f ? max(margin - levelSpread, 0.0f) / fastSlope : RUL_MAX_HOURS;
+  result.highHours = slowSlope > 0.0f ? (margin + levelSpread) / slowSlope : RUL_MAX_HOURS;
+
+  result.hours = min(result.hours, RUL_MAX_HOURS);
+  result.lowHours = min(result.lowHours, result.hours);
+  result.highHours = constrain(result.highHours, result.hours, RUL_MAX_HOURS);
+  return true;
+}
+
+void RULEstimator::writeState(J* body) const {
+  JAddNumberToObject(body, "points", points);
+  JAddNumberToObject(body, "level", level);
+  JAddNumberToObject(body, "slope", slope);
+  JAddNumberToObject(body, "p00", p00);
+  JAddNumberToObject(body, "p01", p01);
+  JAddNumberToObject(body, "p11", p11);
+  JAddNumberToObject(body, "rss", residualSum);
+  JAddNumberToObject(body, "w", weightSum);
+  JAddNumberToObject(body, "op_h", operatingHours);
+  JAddNumberToObject(body, "hi_g", lastIndicator);
+  JAddNumberToObject(body, "resets", resets);
+}
+
+void RULEstimator::readState(J* body) {
+  uint32_t savedPoints = JGetInt(body, "points");
+  float savedLevel = JGetNumber(body, "level");
+  float savedSlope = JGetNumber(body, "slope");
+  resets = JGetInt(body, "resets");
+  if (savedPoints == 0 || !isfinite(savedLevel) || !isfinite(savedSlope)) {
+    return; // Nothing fitted yet (or fitted since a maintenance reset)
+  }
+
+  points = savedPoints;
+  level = savedLevel;
+  slope = savedSlope;
+  p00 = JGetNumber(body, "p00");
+  p01 = JGetNumber(body, "p01");
+  p11 = JGetNumber(body, "p11");
+  residualSum = JGetNumber(body, "rss");
+  weightSum = JGetNumber(body, "w");
+  operatingHours = JGetNumber(body, "op_h");
+  lastPointHours = operatingHours;
+  lastIndicator = JGetNumber(body, "hi_g");
+
+  Serial.print(F("Degradation model restored - "));
+  Serial.print(points);
+  Serial.print(F(" points, "));
+  Serial.print(operatingHours, 1);
+  Serial.println(F(" operating hours"));
+}
+
+void RULEstimator::printStats(float criticalG) const {
+  Serial.print(F("RUL - Points: "));
+  Serial.print(points);
+  Serial.print(F(", Skipped: "));
+  Serial.print(intervalsSkipped);
+  Serial.print(F(", Op hours: "));
+  Serial.print(operatingHours, 1);
+  Serial.print(F(", HI: "));
+  Serial.print(lastIndicator, 3);
+  Serial.print(F("g"));
+
+  RULEstimate rul;
+  if (estimate(criticalG, rul)) {
+    Serial.print(F(", RUL: "));
+    Serial.print(rul.hours, 0);
+    Serial.print(F("h ("));
+    Serial.print(rul.lowHours, 0);
+    Serial.print(F("-"));
+    Serial.print(rul.highHours, 0);
+    Serial.print(F("h)"));
+  }
+  Serial.println();
+}
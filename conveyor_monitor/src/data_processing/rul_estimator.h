@@ -0,0 +1,133 @@
+#ifndef RUL_ESTIMATOR_H
+#define RUL_ESTIMATOR_H
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include "../config/data_types.h"
+#include "../config/sensor_config.h"
+
+/**
+ * @brief Remaining useful life with confidence bounds (operating hours)
+ */
+struct RULEstimate {
+  float hours;         // Until the indicator reaches the critical level
+  float lowHours;      // Lower bound (plan maintenance by this)
+  float highHours;     // Upper bound (RUL_MAX_HOURS = no significant degradation)
+};
+
+/**
+ * @brief Remaining useful life from a degradation curve fit to hourly health indicators
+ *
+ * Health indicator (HI): the mean vibration of one RUL_INTERVAL_MS, from
+ * samples taken while the belt has run for RUL_SETTLE_MS, the reading is
+ * usable and no jam is suspected. Each sample is scaled by
+ * (NOMINAL_SPEED_RPM / speed)^RUL_SPEED_EXPONENT, so a line run slower or
+ * faster for a shift does not look like wear or repair. Intervals with
+ * fewer than RUL_MIN_SAMPLES samples (line mostly stopped) are skipped.
+ * Time is counted in operating hours, which wear follows; stopped time
+ * does not age the model.
+ *
+ * Model: y = level + slope x (t - t_last), y = ln(HI) (exponential
+ * growth, RUL_EXPONENTIAL) or HI. Recursive least squares with forgetting
+ * factor RUL_FORGETTING: O(1) per point, two parameters and a 2x2
+ * covariance. The intercept is kept at the latest point (the covariance
+ * is shifted with it), so the float state does not lose precision as
+ * operating hours grow.
+ *
+ * RUL = (y_critical - level) / slope. The bounds use level and slope at
+ * +/- RUL_CONFIDENCE_Z standard errors, from the residual variance of the
+ * fit; a slope not significantly above zero has no upper bound.
+ *
+ * reset() starts a new model after maintenance.
+ */
+class RULEstimator {
+private:
+  // Hour in progress
+  unsigned long intervalStart;
+  unsigned long runningSince;
+  unsigned long lastUpdate;
+  bool running;
+  float indicatorSum;
+  uint32_t indicatorSamples;
+  uint32_t intervalRunMs;  // Belt running time this interval
+
+  // Degradation model
+  float level;           // Fitted y at the latest point
+  float slope;           // Per operating hour
+  float p00, p01, p11;   // Parameter covariance (unscaled)
+  float residualSum;     // Forgetting-weighted sum of squared residuals
+  float weightSum;       // Forgetting-weighted number of points
+  float operatingHours;  // Since reset()
+  float lastPointHours;
+  float lastIndicator;   // Latest HI (g at nominal speed)
+  uint32_t points;
+  uint32_t intervalsSkipped;
+  uint32_t resets;
+
+  void clearModel();
+  void addPoint(float indicator);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  RULEstimator();
+
+  /**
+   * @brief Start the first interval
+   */
+  void begin();
+
+  /**
+   * @brief Feed one processing cycle
+   * @param state Current system state
+   * @param jamSuspected Whether a jam is detected or being timed (low vibration that is not wear)
+   * @return true if an interval closed with a new point
+   */
+  bool update(const SystemState& state, bool jamSuspected);
+
+  /**
+   * @brief Forget the degradation history (maintenance done)
+   */
+  void reset();
+
+  /**
+   * @brief Estimate the remaining useful life
+   * @param criticalG Vibration level that ends the useful life (at nominal speed)
+   * @param result Filled when an estimate is available
+   * @return false until RUL_MIN_POINTS points are in
+   */
+  bool estimate(float criticalG, RULEstimate& result) const;
+
+  uint32_t getPoints() const { return points; }
+  uint32_t getIntervalsSkipped() const { return intervalsSkipped; }
+  uint32_t getResets() const { return resets; }
+  float getOperatingHours() const { return operatingHours; }
+  float getLastIndicator() const { return lastIndicator; }
+
+  /**
+   * @brief Get the fitted growth per operating hour
+   * @return Fraction per hour with RUL_EXPONENTIAL (0.01 = 1%/h), else g per hour
+   */
+  float getSlope() const { return slope; }
+
+  /**
+   * @brief Serialize the model into a note body
+   * @param body JSON object to add fields to
+   */
+  void writeState(J* body) const;
+
+  /**
+   * @brief Restore a model saved by writeState()
+   * @param body JSON object produced by writeState()
+   */
+  void readState(J* body);
+
+  /**
+   * @brief Print model progress and the latest estimate to Serial
+   * @param criticalG Vibration level the estimate runs to
+   */
+  void printStats(float criticalG) const;
+};
+
+#endif // RUL_ESTIMATOR_H
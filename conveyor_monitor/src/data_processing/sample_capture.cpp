@@ -0,0 +1,89 @@
+#include "sample_capture.h"
+#include <algorithm>
+
+SampleCapture::SampleCapture() {
+  batch.version = PACKED_READINGS_VERSION;
+  batch.recordBytes = sizeof(PackedReadings);
+  head = 0;
+  count = 0;
+  lastSampleTime = 0;
+  trigger = CAPTURE_NONE;
+  postRemaining = 0;
+  complete = false;
+  triggerTime = 0;
+  lastCaptureTime = 0;
+  captures = 0;
+  suppressed = 0;
+  failed = 0;
+}
+
+void SampleCapture::add(const SensorReadings& readings) {
+  if (complete) {
+    return;
+  }
+  unsigned long currentTime = millis();
+  batch.records[head] = packReadings(readings, count > 0 ? currentTime - lastSampleTime : 0);
+  lastSampleTime = currentTime;
+  head = (head + 1) % SAMPLE_CAPTURE_SAMPLES;
+  if (count < SAMPLE_CAPTURE_SAMPLES) {
+    count++;
+  }
+
+  if (trigger != CAPTURE_NONE && --postRemaining == 0) {
+    // Oldest record first, so the payload is the batch as it stands
+    if (count == SAMPLE_CAPTURE_SAMPLES) {
+      std::rotate(batch.records, batch.records + head, batch.records + SAMPLE_CAPTURE_SAMPLES);
+    }
+    batch.records[0].dt_ms = 0;
+    complete = true;
+  }
+}
+
+bool SampleCapture::start(CaptureTrigger reason) {
+  if (trigger != CAPTURE_NONE || count == 0) {
+    return false;
+  }
+  unsigned long currentTime = millis();
+  if (captures > 0 && currentTime - lastCaptureTime < SAMPLE_CAPTURE_MIN_INTERVAL) {
+    suppressed++;
+    return false;
+  }
+  trigger = reason;
+  postRemaining = SAMPLE_CAPTURE_POST;
+  triggerTime = currentTime;
+  lastCaptureTime = currentTime;
+  captures++;
+  return true;
+}
+
+void SampleCapture::release(bool sent) {
+  if (!sent) {
+    failed++;
+  }
+  // Start over: the next capture's lead-up must not reach back into this one
+  head = 0;
+  count = 0;
+  trigger = CAPTURE_NONE;
+  complete = false;
+}
+
+const char* SampleCapture::getTriggerName(CaptureTrigger reason) {
+  switch (reason) {
+    case CAPTURE_JAM: return "jam";
+    case CAPTURE_VIBRATION: return "vibration";
+    default: return "none";
+  }
+}
+
+void SampleCapture::printStats() const {
+  Serial.print(F("Sample capture - Record: "));
+  Serial.print((unsigned)sizeof(PackedReadings));
+  Serial.print(F(" bytes ("));
+  Serial.print((unsigned)sizeof(SensorReadings));
+  Serial.print(F(" unpacked), Captures: "));
+  Serial.print(captures);
+  Serial.print(F(", Suppressed: "));
+  Serial.print(suppressed);
+  Serial.print(F(", Failed: "));
+  Serial.println(failed);
+}
@@ -0,0 +1,107 @@
+#ifndef SAMPLE_CAPTURE_H
+#define SAMPLE_CAPTURE_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+#include "../sensors/packed_readings.h"
+
+/**
+ * @brief What started a capture
+ */
+enum CaptureTrigger : uint8_t {
+  CAPTURE_NONE = 0,
+  CAPTURE_JAM,
+  CAPTURE_VIBRATION
+};
+
+// Version and record size bytes, then the records
+constexpr size_t SAMPLE_CAPTURE_PAYLOAD_BYTES = 2 + SAMPLE_CAPTURE_SAMPLES * sizeof(PackedReadings);
+
+/**
+ * @brief Raw readings around a jam or vibration alert, for offline analysis
+ *
+ * Every sensor read is packed (PackedReadings, 39 bytes instead of 68) into
+ * a ring of SAMPLE_CAPTURE_SAMPLES records. A trigger lets
+ * SAMPLE_CAPTURE_POST more reads in and then freezes the ring, so the
+ * capture holds the lead-up to the alert as well as its start. The frozen
+ * records are put in time order in place and uploaded as the payload of a
+ * samples.capture event:
+ *   byte  PACKED_READINGS_VERSION
+ *   byte  sizeof(PackedReadings)
+ *   records, oldest first; each dt_ms is the time since the one before
+ * Captures are spaced at least SAMPLE_CAPTURE_MIN_INTERVAL apart to bound
+ * the data used by a line that keeps jamming.
+ */
+class SampleCapture {
+private:
+  struct __attribute__((packed)) Batch {
+    uint8_t version;
+    uint8_t recordBytes;
+    PackedReadings records[SAMPLE_CAPTURE_SAMPLES];
+  } batch;
+
+  uint16_t head;                    // Slot of the next record
+  uint16_t count;                   // Valid records
+  unsigned long lastSampleTime;
+
+  // Capture in progress
+  CaptureTrigger trigger;
+  uint16_t postRemaining;           // Reads still to take after the trigger
+  bool complete;                    // Frozen, in time order, ready to upload
+  unsigned long triggerTime;
+  unsigned long lastCaptureTime;
+
+  // Statistics
+  uint32_t captures;
+  uint32_t suppressed;              // Triggers inside the minimum interval
+  uint32_t failed;                  // Completed captures that could not be sent
+
+public:
+  /**
+   * @brief Constructor
+   */
+  SampleCapture();
+
+  /**
+   * @brief Record one sensor read (ignored while a completed capture waits)
+   * @param readings Raw readings of this read
+   */
+  void add(const SensorReadings& readings);
+
+  /**
+   * @brief Start a capture unless one is running or the last was too recent
+   * @param reason Trigger reported with the capture
+   * @return true if a capture was started
+   */
+  bool start(CaptureTrigger reason);
+
+  /**
+   * @brief Check whether a capture is ready to upload
+   */
+  bool isComplete() const { return complete; }
+
+  /**
+   * @brief Resume recording after the capture was uploaded (or given up)
+   * @param sent Whether the upload was accepted
+   */
+  void release(bool sent);
+
+  const uint8_t* getPayload() const { return (const uint8_t*)&batch; }
+  size_t getPayloadLength() const { return 2 + count * sizeof(PackedReadings); }
+  uint16_t getSampleCount() const { return count; }
+  CaptureTrigger getTrigger() const { return trigger; }
+  unsigned long getTriggerTime() const { return triggerTime; }
+  unsigned long getLastSampleTime() const { return lastSampleTime; }
+
+  /**
+   * @brief Get printable name of a trigger
+   */
+  static const char* getTriggerName(CaptureTrigger reason);
+
+  /**
+   * @brief Print record size and capture counts to serial
+   */
+  void printStats() const;
+};
+
+#endif // SAMPLE_CAPTURE_H
@@ -0,0 +1,196 @@
+#include "spc_chart.h"
+
+namespace {
+
+// Range chart constants by subgroup size; an individuals chart uses the
+// moving range of two points, i.e. the n = 2 row
+const float SPC_D2[SPC_MAX_SUBGROUP + 1] = {
+  0.0f, 1.128f, 1.128f, 1.693f, 2.059f, 2.326f, 2.534f, 2.704f, 2.847f, 2.970f, 3.078f
+};
+const float SPC_D3[SPC_MAX_SUBGROUP + 1] = {
+  0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.076f, 0.136f, 0.184f, 0.223f
+};
+const float SPC_D4[SPC_MAX_SUBGROUP + 1] = {
+  0.0f, 3.267f, 3.267f, 2.574f, 2.282f, 2.114f, 2.004f, 1.924f, 1.864f, 1.816f, 1.777f
+};
+
+// Window masks over the rule history
+const uint16_t LAST_3 = 0x0007;
+const uint16_t LAST_5 = 0x001F;
+const uint16_t LAST_8 = 0x00FF;
+const uint16_t LAST_13 = 0x1FFF;     // 13 steps between 14 points
+const uint16_t ZIGZAG_A = 0x0AAA;
+const uint16_t ZIGZAG_B = 0x1555;
+
+inline uint16_t push(uint16_t history, bool bit) {
+  return (uint16_t)((history << 1) | (bit ? 1 : 0));
+}
+
+} // namespace
+
+SPCChart::SPCChart() {
+  begin(1, 0.0f);
+}
+
+void SPCChart::begin(uint8_t size, float sigmaFloor) {
+  subgroupSize = constrain(size, (uint8_t)1, (uint8_t)SPC_MAX_SUBGROUP);
+  subgroupCount = 0;
+  subgroupSum = 0.0f;
+  subgroupMin = 0.0f;
+  subgroupMax = 0.0f;
+
+  baselinePoints = 0;
+  baselineRanges = 0;
+  baselineSum = 0.0f;
+  baselineRangeSum = 0.0f;
+
+  limitsReady = false;
+  minSigma = sigmaFloor;
+  centerLine = 0.0f;
+  sigma = 0.0f;
+  rangeCenter = 0.0f;
+  rangeUpper = 0.0f;
+  rangeLower = 0.0f;
+
+  lastPoint = 0.0f;
+  lastRange = 0.0f;
+  hasPoint = false;
+
+  aboveCenter = belowCenter = 0;
+  aboveB = belowB = 0;
+  aboveA = belowA = 0;
+  rising = falling = 0;
+  historyLength = 0;
+
+  activeRules = SPC_RULE_NONE;
+  pointCount = 0;
+  violationCount = 0;
+}
+
+uint8_t SPCChart::addSample(float value) {
+  if (!isfinite(value)) {
+    return SPC_RULE_NONE;
+  }
+
+  if (subgroupSize == 1) {
+    // Individuals: the moving range needs the previous point
+    float range = hasPoint ? fabsf(value - lastPoint) : 0.0f;
+    bool hasRange = hasPoint;
+    uint8_t previous = activeRules;
+    addPoint(value, range, hasRange);
+    return activeRules & ~previous;
+  }
+
+  if (subgroupCount == 0) {
+    subgroupSum = 0.0f;
+    subgroupMin = subgroupMax = value;
+  }
+  subgroupSum += value;
+  if (value < subgroupMin) subgroupMin = value;
+  if (value > subgroupMax) subgroupMax = value;
+  if (++subgroupCount < subgroupSize) {
+    return SPC_RULE_NONE;
+  }
+  subgroupCount = 0;
+
+  uint8_t previous = activeRules;
+  addPoint(subgroupSum / subgroupSize, subgroupMax - subgroupMin, true);
+  return activeRules & ~previous;
+}
+
+void SPCChart::addPoint(float point, float range, bool hasRange) {
+  if (!limitsReady) {
+    baselineSum += point;
+    baselinePoints++;
+    if (hasRange) {
+      baselineRangeSum += range;
+      baselineRanges++;
+    }
+    if (baselinePoints >= SPC_BASELINE_POINTS && baselineRanges > 0) {
+      freezeLimits();
+    }
+  } else {
+    activeRules = evaluate(point, range, hasRange);
+    if (activeRules != SPC_RULE_NONE) {
+      violationCount++;
+    }
+  }
+
+  lastPoint = point;
+  lastRange = hasRange ? range : 0.0f;
+  hasPoint = true;
+  pointCount++;
+}
+
+void SPCChart::freezeLimits() {
+  centerLine = baselineSum / baselinePoints;
+  rangeCenter = baselineRangeSum / baselineRanges;
+  rangeUpper = SPC_D4[subgroupSize] * rangeCenter;
+  rangeLower = SPC_D3[subgroupSize] * rangeCenter;
+
+  // sigma of the process from R-bar, then of a subgroup mean
+  float processSigma = rangeCenter / SPC_D2[subgroupSize];
+  if (processSigma < minSigma) {
+    processSigma = minSigma;
+  }
+  sigma = processSigma / sqrtf((float)subgroupSize);
+  limitsReady = true;
+}
+
+uint8_t SPCChart::evaluate(float point, float range, bool hasRange) {
+  float deviation = point - centerLine;
+
+  aboveCenter = push(aboveCenter, deviation > 0.0f);
+  belowCenter = push(belowCenter, deviation < 0.0f);
+  aboveB = push(aboveB, deviation > sigma);
+  belowB = push(belowB, deviation < -sigma);
+  aboveA = push(aboveA, deviation > 2.0f * sigma);
+  belowA = push(belowA, deviation < -2.0f * sigma);
+  rising = push(rising, point > lastPoint);
+  falling = push(falling, point < lastPoint);
+  if (historyLength < 16) {
+    historyLength++;
+  }
+
+  uint8_t rules = SPC_RULE_NONE;
+  if (fabsf(deviation) > 3.0f * sigma) {
+    rules |= SPC_RULE_BEYOND_3S;
+  }
+  if (historyLength >= 3 &&
+      (__builtin_popcount(aboveA & LAST_3) >= 2 || __builtin_popcount(belowA & LAST_3) >= 2)) {
+    rules |= SPC_RULE_ZONE_A;
+  }
+  if (historyLength >= 5 &&
+      (__builtin_popcount(aboveB & LAST_5) >= 4 || __builtin_popcount(belowB & LAST_5) >= 4)) {
+    rules |= SPC_RULE_ZONE_B;
+  }
+  if (historyLength >= 8 &&
+      ((aboveCenter & LAST_8) == LAST_8 || (belowCenter & LAST_8) == LAST_8)) {
+    rules |= SPC_RULE_RUN;
+  }
+  if (historyLength >= 5 &&
+      ((rising & LAST_5) == LAST_5 || (falling & LAST_5) == LAST_5)) {
+    rules |= SPC_RULE_TREND;
+  }
+  if (historyLength >= 13 && ((rising | falling) & LAST_13) == LAST_13 &&
+      ((rising & LAST_13) == ZIGZAG_A || (rising & LAST_13) == ZIGZAG_B)) {
+    rules |= SPC_RULE_ALTERNATING;
+  }
+  if (hasRange && (range > rangeUpper || range < rangeLower)) {
+    rules |= SPC_RULE_RANGE;
+  }
+  return rules;
+}
+
+const char* SPCChart::getRuleName(SPCRule rule) {
+  switch (rule) {
+    case SPC_RULE_BEYOND_3S: return "beyond_3s";
+    case SPC_RULE_ZONE_A: return "zone_a";
+    case SPC_RULE_ZONE_B: return "zone_b";
+    case SPC_RULE_RUN: return "run";
+    case SPC_RULE_TREND: return "trend";
+    case SPC_RULE_ALTERNATING: return "alternating";
+    case SPC_RULE_RANGE: return "range";
+    default: return "none";
+  }
+}
@@ -0,0 +1,136 @@
+#ifndef SPC_CHART_H
+#define SPC_CHART_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Western Electric / Nelson run rules, as bits in a rule mask
+ */
+enum SPCRule {
+  SPC_RULE_NONE        = 0x00,
+  SPC_RULE_BEYOND_3S   = 0x01,  // 1 point beyond 3 sigma (WE 1)
+  SPC_RULE_ZONE_A      = 0x02,  // 2 of 3 beyond 2 sigma, same side (WE 2)
+  SPC_RULE_ZONE_B      = 0x04,  // 4 of 5 beyond 1 sigma, same side (WE 3)
+  SPC_RULE_RUN         = 0x08,  // 8 in a row on one side of the centre line (WE 4)
+  SPC_RULE_TREND       = 0x10,  // 6 in a row rising or falling (Nelson 3)
+  SPC_RULE_ALTERNATING = 0x20,  // 14 in a row alternating up and down (Nelson 4)
+  SPC_RULE_RANGE       = 0x40   // Subgroup range / moving range outside its limits
+};
+
+#define SPC_RULE_COUNT 7
+
+/**
+ * @brief Incremental Shewhart control chart for one signal
+ *
+ * With a subgroup size of 1 this is an individuals/moving-range (I-MR)
+ * chart; with 2..SPC_MAX_SUBGROUP it is an X-bar/R chart over consecutive
+ * samples. The first SPC_BASELINE_POINTS chart points set the centre line
+ * and sigma (R-bar / d2), after which the limits are frozen and every new
+ * point is checked against the run rules.
+ *
+ * The rules only need the last 14 points, kept as one bit per point in
+ * small shift registers (above centre, beyond 1 sigma, beyond 2 sigma,
+ * rising, falling for each side), so each point costs a few shifts, masks
+ * and popcounts regardless of history length.
+ */
+class SPCChart {
+private:
+  // Subgroup being collected
+  uint8_t subgroupSize;
+  uint8_t subgroupCount;
+  float subgroupSum;
+  float subgroupMin;
+  float subgroupMax;
+
+  // Phase I (baseline) sums
+  uint16_t baselinePoints;
+  uint16_t baselineRanges;
+  float baselineSum;
+  float baselineRangeSum;
+
+  // Frozen limits
+  bool limitsReady;
+  float minSigma;
+  float centerLine;
+  float sigma;             // Sigma of a plotted point (sigma / sqrt(n) for X-bar)
+  float rangeCenter;
+  float rangeUpper;
+  float rangeLower;
+
+  // Latest point
+  float lastPoint;
+  float lastRange;
+  bool hasPoint;
+
+  // Rule history, newest point in bit 0
+  uint16_t aboveCenter, belowCenter;
+  uint16_t aboveB, belowB;
+  uint16_t aboveA, belowA;
+  uint16_t rising, falling;
+  uint8_t historyLength;
+
+  uint8_t activeRules;
+  uint32_t pointCount;
+  uint32_t violationCount;
+
+  void addPoint(float point, float range, bool hasRange);
+  void freezeLimits();
+  uint8_t evaluate(float point, float range, bool hasRange);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  SPCChart();
+
+  /**
+   * @brief Start a new baseline
+   * @param subgroupSize Samples per plotted point (1 = individuals chart)
+   * @param minSigma Lower bound for the learned sigma, in signal units
+   */
+  void begin(uint8_t subgroupSize, float minSigma);
+
+  /**
+   * @brief Add one sample
+   * @param value Signal value
+   * @return Rules that started failing at this point (SPCRule bits), 0 while
+   *         a subgroup or the baseline is still being collected
+   */
+  uint8_t addSample(float value);
+
+  /**
+   * @brief Check if the baseline is complete and the rules are active
+   */
+  bool hasLimits() const { return limitsReady; }
+
+  float getCenterLine() const { return centerLine; }
+  float getSigma() const { return sigma; }
+  float getUpperLimit() const { return centerLine + 3.0f * sigma; }
+  float getLowerLimit() const { return centerLine - 3.0f * sigma; }
+  float getRangeUpperLimit() const { return rangeUpper; }
+
+  /**
+   * @brief Get the latest plotted point (subgroup mean or individual value)
+   */
+  float getLastPoint() const { return lastPoint; }
+
+  /**
+   * @brief Get the latest subgroup range or moving range
+   */
+  float getLastRange() const { return lastRange; }
+
+  /**
+   * @brief Get the rules failing at the latest point
+   * @return SPCRule bits
+   */
+  uint8_t getActiveRules() const { return activeRules; }
+
+  uint8_t getSubgroupSize() const { return subgroupSize; }
+  uint32_t getPointCount() const { return pointCount; }
+  uint32_t getViolationCount() const { return violationCount; }
+
+  static const char* getRuleName(SPCRule rule);
+};
+
+#endif // SPC_CHART_H
@@ -0,0 +1,120 @@
+#include "spc_monitor.h"
+
+SPCMonitor::SPCMonitor() {
+  eventsSent = 0;
+  runningSince = 0;
+  running = false;
+  for (int i = 0; i < SPC_SIGNAL_COUNT; i++) {
+    pendingRules[i] = SPC_RULE_NONE;
+    lastEventTime[i] = 0;
+    eventSent[i] = false;
+    lastSampleTime[i] = 0;
+    sampleInterval[i] = 0;
+    sampled[i] = false;
+  }
+}
+
+void SPCMonitor::begin() {
+  charts[SPC_SIGNAL_SPEED].begin(SPC_SPEED_SUBGROUP, SPC_SPEED_MIN_SIGMA);
+  charts[SPC_SIGNAL_VIBRATION].begin(1, SPC_VIBRATION_MIN_SIGMA);
+  sampleInterval[SPC_SIGNAL_SPEED] = 0;
+  sampleInterval[SPC_SIGNAL_VIBRATION] = SPC_VIBRATION_SAMPLE_MS;
+  for (int i = 0; i < SPC_SIGNAL_COUNT; i++) {
+    pendingRules[i] = SPC_RULE_NONE;
+    eventSent[i] = false;
+    sampled[i] = false;
+  }
+  running = false;
+}
+
+void SPCMonitor::addSample(SPCSignal signal, float value, unsigned long now) {
+  if (sampled[signal] && now - lastSampleTime[signal] < sampleInterval[signal]) {
+    return;
+  }
+  sampled[signal] = true;
+  lastSampleTime[signal] = now;
+  pendingRules[signal] |= charts[signal].addSample(value);
+}
+
+void SPCMonitor::update(const SystemState& state) {
+  if (!state.conveyorRunning) {
+    running = false;
+    return;
+  }
+  unsigned long now = millis();
+  if (!running) {
+    running = true;
+    runningSince = now;
+  }
+  if (now - runningSince < SPC_SETTLE_MS) {
+    return;
+  }
+
+  uint8_t usable = usableFields(state);
+  if (usable & FIELD_BIT(FIELD_SPEED)) {
+    addSample(SPC_SIGNAL_SPEED, state.speed_rpm, now);
+  }
+  if (usable & FIELD_BIT(FIELD_VIBRATION)) {
+    addSample(SPC_SIGNAL_VIBRATION, state.vibrationLevel, now);
+  }
+}
+
+bool SPCMonitor::popViolation(SPCViolation& violation) {
+  unsigned long now = millis();
+  for (int i = 0; i < SPC_SIGNAL_COUNT; i++) {
+    if (pendingRules[i] == SPC_RULE_NONE) {
+      continue;
+    }
+    if (eventSent[i] && now - lastEventTime[i] < SPC_EVENT_MIN_INTERVAL_MS) {
+      continue;
+    }
+
+    const SPCChart& chart = charts[i];
+    violation.signal = (SPCSignal)i;
+    violation.rules = pendingRules[i];
+    violation.value = chart.getLastPoint();
+    violation.range = chart.getLastRange();
+    violation.centerLine = chart.getCenterLine();
+    violation.sigma = chart.getSigma();
+
+    pendingRules[i] = SPC_RULE_NONE;
+    lastEventTime[i] = now;
+    eventSent[i] = true;
+    eventsSent++;
+    return true;
+  }
+  return false;
+}
+
+void SPCMonitor::printStats() const {
+  for (int i = 0; i < SPC_SIGNAL_COUNT; i++) {
+    const SPCChart& chart = charts[i];
+    Serial.print(F("SPC "));
+    Serial.print(getSignalName((SPCSignal)i));
+    if (!chart.hasLimits()) {
+      Serial.print(F(" - baseline "));
+      Serial.print(chart.getPointCount());
+      Serial.print(F("/"));
+      Serial.println(SPC_BASELINE_POINTS);
+      continue;
+    }
+    Serial.print(F(" - CL: "));
+    Serial.print(chart.getCenterLine(), 3);
+    Serial.print(F(", Sigma: "));
+    Serial.print(chart.getSigma(), 4);
+    Serial.print(F(", Points: "));
+    Serial.print(chart.getPointCount());
+    Serial.print(F(", Out of control: "));
+    Serial.print(chart.getViolationCount());
+    Serial.print(F(", Active rules: "));
+    Serial.println(chart.getActiveRules());
+  }
+}
+
+const char* SPCMonitor::getSignalName(SPCSignal signal) {
+  switch (signal) {
+    case SPC_SIGNAL_SPEED: return "speed";
+    case SPC_SIGNAL_VIBRATION: return "vibration";
+    default: return "unknown";
+  }
+}
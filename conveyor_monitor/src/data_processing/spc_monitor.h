@@ -0,0 +1,98 @@
+#ifndef SPC_MONITOR_H
+#define SPC_MONITOR_H
+
+#include <Arduino.h>
+#include "../config/data_types.h"
+#include "../config/system_config.h"
+#include "spc_chart.h"
+
+/**
+ * @brief Signals kept under statistical process control
+ */
+enum SPCSignal {
+  SPC_SIGNAL_SPEED = 0,     // X-bar/R, SPC_SPEED_SUBGROUP readings per point
+  SPC_SIGNAL_VIBRATION,     // Individuals/moving range, one point per SPC_VIBRATION_SAMPLE_MS
+  SPC_SIGNAL_COUNT
+};
+
+/**
+ * @brief One rule-violation event for a signal
+ */
+struct SPCViolation {
+  SPCSignal signal;
+  uint8_t rules;          // SPCRule bits that started failing since the last event
+  float value;            // Latest plotted point
+  float range;            // Latest subgroup range / moving range
+  float centerLine;
+  float sigma;
+};
+
+/**
+ * @brief Control charts for the line's process signals
+ *
+ * Speed and vibration are only charted once the belt has been running for
+ * SPC_SETTLE_MS, and only from fields that are valid and fresh, so start-up
+ * transients, stops and sensor faults do not end up in the baseline or trip
+ * the run rules. Vibration is an RMS over the last VIBRATION_SAMPLE_SIZE
+ * reads, so it is charted no faster than that window turns over; closer
+ * points would be correlated and break the run rules' false alarm rates.
+ *
+ * New rule failures are held per signal and handed out at
+ * most once every SPC_EVENT_MIN_INTERVAL_MS; failures in between are merged
+ * into the next event.
+ */
+class SPCMonitor {
+private:
+  SPCChart charts[SPC_SIGNAL_COUNT];
+  uint8_t pendingRules[SPC_SIGNAL_COUNT];
+  unsigned long lastEventTime[SPC_SIGNAL_COUNT];
+  bool eventSent[SPC_SIGNAL_COUNT];
+  unsigned long lastSampleTime[SPC_SIGNAL_COUNT];
+  unsigned long sampleInterval[SPC_SIGNAL_COUNT];   // 0 = every update
+  bool sampled[SPC_SIGNAL_COUNT];
+  uint32_t eventsSent;
+  unsigned long runningSince;
+  bool running;
+
+  void addSample(SPCSignal signal, float value, unsigned long now);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  SPCMonitor();
+
+  /**
+   * @brief Start new baselines for all signals
+   */
+  void begin();
+
+  /**
+   * @brief Chart the current readings
+   * @param state Current system state
+   */
+  void update(const SystemState& state);
+
+  /**
+   * @brief Collect the next due rule-violation event
+   * @param violation Filled with the event
+   * @return true if an event was due (each failure is returned once)
+   */
+  bool popViolation(SPCViolation& violation);
+
+  /**
+   * @brief Get the chart for a signal
+   */
+  const SPCChart& getChart(SPCSignal signal) const { return charts[signal]; }
+
+  uint32_t getEventsSent() const { return eventsSent; }
+
+  /**
+   * @brief Print chart limits and violation counts to Serial
+   */
+  void printStats() const;
+
+  static const char* getSignalName(SPCSignal signal);
+};
+
+#endif // SPC_MONITOR_H
@@ -2,8 +2,8 @@
 
 StatisticalAnalyzer::StatisticalAnalyzer() 
   : speedHistory(true), vibrationHistory(true), tempHistory(true), humidityHistory(true) {
-  averageSpeed = 0.0f;
-  speedVariance = 0.0f;
+  updateEpoch = 0;
+  memoize = true;
   vibrationBaseline = VIBRATION_BASELINE_G;
   baselineEstablished = false;
 }
@@ -25,20 +25,23 @@ void StatisticalAnalyzer::begin() {
   for (int i = 0; i < 30; i++) {
     vibrationHistory.push(VIBRATION_BASELINE_G);
   }
+  updateEpoch++;
   
   Serial.println(F("Statistical analyzer initialized"));
 }
 
 void StatisticalAnalyzer::update(const SystemState& state) {
-  // Update speed history using circular buffer
-  speedHistory.push(state.speed_rpm);
+  // Invalid or stale fields are skipped so they never reach the averages
+  uint8_t usable = usableFields(state);
+  
+  // Derived statistics are recomputed on their first read from here on
+  updateEpoch++;
   
-  // Calculate speed statistics using circular buffer methods
-  averageSpeed = speedHistory.average();
-  speedVariance = speedHistory.variance(averageSpeed);
+  // Update speed history using circular buffer
+  speedHistory.pushMasked(state.speed_rpm, usable & FIELD_BIT(FIELD_SPEED));
   
   // Update vibration history using circular buffer
-  vibrationHistory.push(state.vibrationLevel);
+  vibrationHistory.pushMasked(state.vibrationLevel, usable & FIELD_BIT(FIELD_VIBRATION));
   
   // Establish vibration baseline after buffer is full
   if (!baselineEstablished && vibrationHistory.isFull()) {
@@ -50,8 +53,8 @@ void StatisticalAnalyzer::update(const SystemState& state) {
   }
   
   // Update environmental history using circular buffers
-  tempHistory.push(state.temperature);
-  humidityHistory.push(state.humidity);
+  tempHistory.pushMasked(state.temperature, usable & FIELD_BIT(FIELD_TEMPERATURE));
+  humidityHistory.pushMasked(state.humidity, usable & FIELD_BIT(FIELD_HUMIDITY));
 }
 
 float StatisticalAnalyzer::calculateMean(const float* data, int size) const {
@@ -85,7 +88,7 @@ float StatisticalAnalyzer::calculateTrend(const float* data, int size) const {
   }
   
   float denominator = size * sumX2 - sumX * sumX;
-  if (abs(denominator) < 0.001f) {
+  if (fabsf(denominator) < 0.001f) {
     return 0.0f; // Avoid division by zero
   }
   
@@ -93,7 +96,35 @@ float StatisticalAnalyzer::calculateTrend(const float* data, int size) const {
   return slope;
 }
 
+uint32_t StatisticalAnalyzer::getCacheHits() const {
+  return speedStats.getHits() + vibrationTrend.getHits() + temperatureVariance.getHits() + humidityTrend.getHits();
+}
+
+uint32_t StatisticalAnalyzer::getCacheMisses() const {
+  return speedStats.getMisses() + vibrationTrend.getMisses() + temperatureVariance.getMisses() +
+         humidityTrend.getMisses();
+}
+
+StatisticalAnalyzer::SpeedStats StatisticalAnalyzer::computeSpeedStats() const {
+  SpeedStats stats;
+  stats.mean = speedHistory.average();
+  stats.variance = speedHistory.variance(stats.mean);
+  return stats;
+}
+
+float StatisticalAnalyzer::getAverageSpeed() const {
+  return cached(speedStats, [this] { return computeSpeedStats(); }).mean;
+}
+
+float StatisticalAnalyzer::getSpeedVariance() const {
+  return cached(speedStats, [this] { return computeSpeedStats(); }).variance;
+}
+
 float StatisticalAnalyzer::getVibrationTrend() const {
+  return cached(vibrationTrend, [this] { return computeVibrationTrend(); });
+}
+
+float StatisticalAnalyzer::computeVibrationTrend() const {
   if (!baselineEstablished || vibrationHistory.size() < 2) {
     return 0.0f;
   }
@@ -112,7 +143,7 @@ float StatisticalAnalyzer::getVibrationTrend() const {
   }
   
   float denominator = size * sumX2 - sumX * sumX;
-  if (abs(denominator) < 0.001f) {
+  if (fabsf(denominator) < 0.001f) {
     return 0.0f; // Avoid division by zero
   }
   
@@ -127,6 +158,10 @@ float StatisticalAnalyzer::getCurrentVibration() const {
 }
 
 float StatisticalAnalyzer::getTemperatureVariance() const {
+  return cached(temperatureVariance, [this] { return computeTemperatureVariance(); });
+}
+
+float StatisticalAnalyzer::computeTemperatureVariance() const {
   if (tempHistory.isEmpty()) {
     return 0.0f;
   }
@@ -135,6 +170,10 @@ float StatisticalAnalyzer::getTemperatureVariance() const {
 }
 
 float StatisticalAnalyzer::getHumidityTrend() const {
+  return cached(humidityTrend, [this] { return computeHumidityTrend(); });
+}
+
+float StatisticalAnalyzer::computeHumidityTrend() const {
   if (humidityHistory.size() < 2) {
     return 0.0f;
   }
@@ -153,7 +192,7 @@ float StatisticalAnalyzer::getHumidityTrend() const {
   }
   
   float denominator = size * sumX2 - sumX * sumX;
-  if (abs(denominator) < 0.001f) {
+  if (fabsf(denominator) < 0.001f) {
     return 0.0f; // Avoid division by zero
   }
   
@@ -173,52 +212,3 @@ float StatisticalAnalyzer::getCurrentHumidity() const {
   }
   return humidityHistory.newest();
 }
-
-float StatisticalAnalyzer::getEfficiencyScore(bool jamDetected) const {
-  // Calculate efficiency based on multiple factors
-  float speedScore = 100.0f;
-  float vibrationScore = 100.0f;
-  float jamScore = 100.0f;
-  
-  // Speed efficiency
-  if (averageSpeed > 0.0f) {
-    float speedRatio = averageSpeed / NOMINAL_SPEED_RPM;
-    speedScore = 100.0f * (1.0f - abs(1.0f - speedRatio));
-    speedScore = max(0.0f, min(100.0f, speedScore)); // Clamp to 0-100
-  }
-  
-  // Vibration score
-  if (baselineEstablished) {
-    float currentVibration = getCurrentVibration();
-    vibrationScore = 100.0f * (1.0f - (currentVibration / VIBRATION_CRITICAL_G));
-    vibrationScore = max(0.0f, min(100.0f, vibrationScore)); // Clamp to 0-100
-  }
-  
-  // Jam score (penalize current jam state)
-  if (jamDetected) {
-    jamScore = 0.0f; // Significant penalty for active jam
-  }
-  
-  // Weighted average
-  return (speedScore * 0.4f + vibrationScore * 0.4f + jamScore * 0.2f);
-}
-
-float StatisticalAnalyzer::predictMaintenanceHours() const {
-  // Simple prediction based on vibration trend
-  if (!baselineEstablished) {
-    return 999.0f; // Unknown
-  }
-  
-  float trend = getVibrationTrend();
-  float currentVibration = getCurrentVibration();
-  
-  if (trend <= 0.0f) {
-    return 999.0f; // No degradation
-  }
-  
-  // Estimate hours until critical threshold
-  float remainingG = VIBRATION_CRITICAL_G - currentVibration;
-  float hoursToFailure = (remainingG / trend) * 24.0f; // Assuming trend is per day
-  
-  return max(0.0f, hoursToFailure);
-}
\ No newline at end of file
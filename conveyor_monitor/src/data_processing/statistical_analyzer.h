@@ -5,19 +5,22 @@
 #include "../config/data_types.h"
 #include "../config/sensor_config.h"
 #include "../utils/circular_buffer.h"
+#include "../utils/performance_utils.h"
 
 /**
  * @brief Specialized class for statistical analysis of sensor data
  * 
  * This class handles data history management, statistical calculations,
  * and trend analysis for all monitored parameters.
+ *
+ * Derived statistics are computed lazily: each update() starts a new epoch
+ * and a statistic is calculated on its first read in that epoch, however
+ * many detectors and reports ask for it afterwards.
  */
 class StatisticalAnalyzer {
 private:
   // Speed monitoring using circular buffer
   CircularBuffer<float, 10> speedHistory;
-  float averageSpeed;
-  float speedVariance;
   
   // Vibration analysis using circular buffer
   CircularBuffer<float, 30> vibrationHistory;
@@ -28,6 +31,34 @@ private:
   CircularBuffer<float, 10> tempHistory;
   CircularBuffer<float, 10> humidityHistory;
   
+  // Derived statistics, memoized per update
+  struct SpeedStats {
+    float mean;
+    float variance;
+  };
+  uint32_t updateEpoch;
+  bool memoize;
+  mutable EpochCache<SpeedStats> speedStats;
+  mutable EpochCache<float> vibrationTrend;
+  mutable EpochCache<float> temperatureVariance;
+  mutable EpochCache<float> humidityTrend;
+  
+  /**
+   * @brief Read a derived statistic through its cache
+   */
+  template<typename T, typename Compute>
+  const T& cached(EpochCache<T>& cache, Compute compute) const {
+    if (!memoize) {
+      cache.invalidate();
+    }
+    return cache.get(updateEpoch, compute);
+  }
+  
+  SpeedStats computeSpeedStats() const;
+  float computeVibrationTrend() const;
+  float computeTemperatureVariance() const;
+  float computeHumidityTrend() const;
+  
   /**
    * @brief Calculate mean of array data
    * @param data Array of float values
@@ -70,10 +101,22 @@ public:
    */
   void update(const SystemState& state);
   
+  /**
+   * @brief Enable or disable memoization of derived statistics
+   * @param enabled false = recompute on every read (benchmarking)
+   */
+  void setMemoization(bool enabled) { memoize = enabled; }
+  
+  /**
+   * @brief Derived statistic reads served from the cache / computed
+   */
+  uint32_t getCacheHits() const;
+  uint32_t getCacheMisses() const;
+  
   // Speed statistics getters
-  float getAverageSpeed() const { return averageSpeed; }
-  float getSpeedVariance() const { return speedVariance; }
-  float getSpeedStability() const { return speedVariance; } // Alias for compatibility
+  float getAverageSpeed() const;
+  float getSpeedVariance() const;
+  float getSpeedStability() const { return getSpeedVariance(); } // Alias for compatibility
   
   // Vibration statistics getters
   float getVibrationBaseline() const { return vibrationBaseline; }
@@ -86,19 +129,6 @@ public:
   float getHumidityTrend() const;
   float getCurrentTemperature() const;
   float getCurrentHumidity() const;
-  
-  /**
-   * @brief Get efficiency score based on statistical analysis
-   * @param jamDetected Whether a jam is currently detected
-   * @return Efficiency score from 0-100
-   */
-  float getEfficiencyScore(bool jamDetected) const;
-  
-  /**
-   * @brief Predict maintenance hours based on vibration trend
-   * @return Estimated hours until maintenance needed
-   */
-  float predictMaintenanceHours() const;
 };
 
 #endif // STATISTICAL_ANALYZER_H
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "threshold_tuner.h"
+
+namespace {
+
+inline float clampToDefault(float value, float fixed) {
+  return constrain(value, fixed * TUNE_MIN_SCALE, fixed * TUNE_MAX_SCALE);
+}
+
+} // namespace
+
+ThresholdTuner::ThresholdTuner()
+  : lowQuantile(TUNE_LOW_QUANTILE), medianQuantile(0.5f) {
+  defaults = defaultAnomalyThresholds();
+  thresholds = defaults;
+  lastLow = 0.0f;
+  lastMedian = 0.0f;
+  enabled = TUNING_ENABLED;
+  tuned = false;
+  epochs = 0;
+  samplesFrozen = 0;
+  runningSince = 0;
+  running = false;
+}
+
+void ThresholdTuner::begin() {
+  lowQuantile.reset(TUNE_LOW_QUANTILE);
+  medianQuantile.reset(0.5f);
+  running = false;
+}
+
+bool ThresholdTuner::update(const SystemState& state, bool alertActive) {
+  if (!enabled) {
+    return false;
+  }
+
+  unsigned long now = millis();
+  if (!state.conveyorRunning || state.speed_rpm <= MIN_SPEED_THRESHOLD) {
+    running = false;
+    return false;
+  }
+  if (!running) {
+    running = true;
+    runningSince = now;
+  }
+  if (now - runningSince < TUNE_SETTLE_MS) {
+    return false;
+  }
+
+  // Learning is frozen while anything looks wrong
+  if (alertActive || !(usableFields(state) & FIELD_BIT(FIELD_VIBRATION))) {
+    samplesFrozen++;
+    return false;
+  }
+
+  lowQuantile.add(state.vibrationLevel);
+  medianQuantile.add(state.vibrationLevel);
+  uint32_t needed = tuned ? TUNE_EPOCH_SAMPLES : TUNE_LEARN_SAMPLES;
+  if (medianQuantile.getCount() < needed) {
+    return false;
+  }
+
+  finishEpoch();
+  return true;
+}
+
+AnomalyThresholds ThresholdTuner::deriveTarget() const {
+  float median = medianQuantile.getValue();
+  float guard = TUNE_GUARD_SPREADS * max(median - lowQuantile.getValue(), 0.0f);
+
+  AnomalyThresholds target = thresholds;
+  target.vibrationWarningG = clampToDefault(max(median * TUNE_WARNING_RATIO, median + guard),
+                                            defaults.vibrationWarningG);
+  target.vibrationCriticalG = clampToDefault(max(median * TUNE_CRITICAL_RATIO,
+                                                 target.vibrationWarningG + guard),
+                                             defaults.vibrationCriticalG);
+  target.jamVibrationG = clampToDefault(min(median * TUNE_JAM_RATIO, median - guard),
+                                        defaults.jamVibrationG);
+  return target;
+}
+
+void ThresholdTuner::finishEpoch() {
+  AnomalyThresholds target = deriveTarget();
+  lastLow = lowQuantile.getValue();
+  lastMedian = medianQuantile.getValue();
+
+  if (!tuned) {
+    thresholds = target;
+    tuned = true;
+  } else {
+    thresholds.vibrationWarningG += TUNE_ADAPT_RATE * (target.vibrationWarningG - thresholds.vibrationWarningG);
+    thresholds.vibrationCriticalG += TUNE_ADAPT_RATE * (target.vibrationCriticalG - thresholds.vibrationCriticalG);
+    thresholds.jamVibrationG += TUNE_ADAPT_RATE * (target.jamVibrationG - thresholds.jamVibrationG);
+  }
+
+  epochs++;
+  lowQuantile.reset(TUNE_LOW_QUANTILE);
+  medianQuantile.reset(0.5f);
+
+  Serial.print(F("Thresholds tuned - jam "));
+  Serial.print(thresholds.jamVibrationG, 3);
+  Serial.print(F("g, warning "));
+  Serial.print(thresholds.vibrationWarningG, 3);
+  Serial.print(F("g, critical "));
+  Serial.print(thresholds.vibrationCriticalG, 3);
+  Serial.println(F("g"));
+}
+
+void ThresholdTuner::setDefaults(const AnomalyThresholds& newDefaults) {
+  defaults = newDefaults;
+  if (!tuned) {
+    thresholds = defaults;
+    return;
+  }
+
+  // Keep what was learned within the new bounds; untuned fields follow the defaults
+  thresholds.speedTolerancePct = defaults.speedTolerancePct;
+  thresholds.jamDetectTimeMs = defaults.jamDetectTimeMs;
+  thresholds.jamVibrationG = clampToDefault(thresholds.jamVibrationG, defaults.jamVibrationG);
+  thresholds.vibrationWarningG = clampToDefault(thresholds.vibrationWarningG, defaults.vibrationWarningG);
+  thresholds.vibrationCriticalG = clampToDefault(thresholds.vibrationCriticalG, defaults.vibrationCriticalG);
+  if (!isValidAnomalyThresholds(thresholds)) {
+    // Bounds moved too far for the learned levels - start over from the new defaults
+    thresholds = defaults;
+    tuned = false;
+    epochs = 0;
+  }
+}
+
+void ThresholdTuner::writeState(J* body) {
+  JAddBoolToObject(body, "tuned", tuned);
+  JAddNumberToObject(body, "epochs", epochs);
+  JAddNumberToObject(body, "jam_g", thresholds.jamVibrationG);
+  JAddNumberToObject(body, "vib_warn", thresholds.vibrationWarningG);
+  JAddNumberToObject(body, "vib_crit", thresholds.vibrationCriticalG);
+  JAddNumberToObject(body, "p_lo", lastLow);
+  JAddNumberToObject(body, "p50", lastMedian);
+}
+
+void ThresholdTuner::readState(J* body) {
+  if (!enabled || !JGetBool(body, "tuned")) {
+    return; // Nothing learned yet, or tuning switched off since
+  }
+
+  // Re-apply the bounds in case the fixed thresholds changed since the save
+  AnomalyThresholds restored = defaults;
+  restored.jamVibrationG = clampToDefault(JGetNumber(body, "jam_g"), defaults.jamVibrationG);
+  restored.vibrationWarningG = clampToDefault(JGetNumber(body, "vib_warn"), defaults.vibrationWarningG);
+  restored.vibrationCriticalG = clampToDefault(JGetNumber(body, "vib_crit"), defaults.vibrationCriticalG);
+  if (!isValidAnomalyThresholds(restored)) {
+    // Clamped out of order (or not numbers) - learn again from the defaults
+    Serial.println(F("Tuned thresholds inconsistent - using defaults"));
+    return;
+  }
+  thresholds = restored;
+  epochs = JGetInt(body, "epochs");
+  lastLow = JGetNumber(body, "p_lo");
+  lastMedian = JGetNumber(body, "p50");
+  tuned = true;
+
+  Serial.print(F("Tuned thresholds restored - epoch "));
+  Serial.println(epochs);
+}
+
+void ThresholdTuner::printStats() const {
+  Serial.print(F("Threshold Tuning - "));
+  if (!enabled) {
+    Serial.println(F("disabled"));
+    return;
+  }
+  Serial.print(tuned ? F("tuned") : F("learning"));
+  Serial.print(F(", Epochs: "));
+  Serial.print(epochs);
+  Serial.print(F(", Samples: "));
+  Serial.print(getSamples());
+  Serial.print(F("/"));
+  Serial.print((unsigned long)(tuned ? TUNE_EPOCH_SAMPLES : TUNE_LEARN_SAMPLES));
+  Serial.print(F(", Frozen: "));
+  Serial.print(samplesFrozen);
+  Serial.print(F(", Jam/Warn/Crit: "));
+  Serial.print(thresholds.jamVibrationG, 3);
+  Serial.print(F("/"));
+  Serial.print(thresholds.vibrationWarningG, 3);
+  Serial.print(F("/"));
+  Serial.print(thresholds.vibrationCriticalG, 3);
+  Serial.println(F("g"));
+}
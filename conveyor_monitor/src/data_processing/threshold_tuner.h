@@ -0,0 +1,122 @@
+#ifndef THRESHOLD_TUNER_H
+#define THRESHOLD_TUNER_H
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include "../config/data_types.h"
+#include "../config/sensor_config.h"
+#include "../utils/p2_quantile.h"
+#include "anomaly_detector.h"
+
+/**
+ * @brief Per-line vibration and jam thresholds learned from normal running
+ *
+ * Running vibration is summarised by two streaming quantiles (P²): the
+ * median and the TUNE_LOW_QUANTILE tail. Only samples taken while the belt
+ * has been running for TUNE_SETTLE_MS, the reading is usable and no
+ * anomaly is active or suspected count, so jams, stops and incidents do not
+ * teach the tuner that they are normal. Incidents the detectors have not
+ * caught yet (a slow vibration ramp below the warning level) still get in,
+ * and they land in the upper tail - so the scale comes from the median and
+ * the spread from the lower half only.
+ *
+ * After TUNE_LEARN_SAMPLES the thresholds are derived, with
+ * spread = median - low quantile and guard = TUNE_GUARD_SPREADS x spread:
+ *   - warning  = max(median x TUNE_WARNING_RATIO, median + guard)
+ *   - critical = max(median x TUNE_CRITICAL_RATIO, warning + guard)
+ *   - jam      = min(median x TUNE_JAM_RATIO, median - guard)
+ * each kept within TUNE_MIN_SCALE..TUNE_MAX_SCALE of the fixed thresholds
+ * (sensor_config.h, or a field override via setDefaults()).
+ * Every TUNE_EPOCH_SAMPLES afterwards the quantiles start over and the
+ * thresholds move TUNE_ADAPT_RATE of the way to the new targets, so they
+ * follow slow wear without jumping on one bad shift.
+ */
+class ThresholdTuner {
+private:
+  P2Quantile lowQuantile;
+  P2Quantile medianQuantile;
+  AnomalyThresholds defaults;
+  AnomalyThresholds thresholds;
+  float lastLow;
+  float lastMedian;
+  bool enabled;
+  bool tuned;
+  uint32_t epochs;
+  uint32_t samplesFrozen;
+  unsigned long runningSince;
+  bool running;
+
+  AnomalyThresholds deriveTarget() const;
+  void finishEpoch();
+
+public:
+  /**
+   * @brief Constructor
+   */
+  ThresholdTuner();
+
+  /**
+   * @brief Start learning from the fixed thresholds
+   */
+  void begin();
+
+  /**
+   * @brief Feed one processing cycle
+   * @param state Current system state
+   * @param alertActive Whether any detector currently reports an anomaly
+   * @return true if the thresholds changed (an epoch completed)
+   */
+  bool update(const SystemState& state, bool alertActive);
+
+  /**
+   * @brief Get the thresholds to detect with
+   * @return Fixed thresholds until the first epoch completes
+   */
+  const AnomalyThresholds& getThresholds() const { return thresholds; }
+
+  /**
+   * @brief Replace the fixed thresholds that learning starts from and is bounded by
+   * @param newDefaults Thresholds to use until tuned (e.g. a field override)
+   */
+  void setDefaults(const AnomalyThresholds& newDefaults);
+
+  /**
+   * @brief Turn learning on or off; off keeps the current thresholds
+   */
+  void setEnabled(bool enable) { enabled = enable; }
+  bool isEnabled() const { return enabled; }
+
+  /**
+   * @brief Check if the thresholds have been tuned at least once
+   */
+  bool isTuned() const { return tuned; }
+
+  uint32_t getEpochs() const { return epochs; }
+  uint32_t getSamples() const { return medianQuantile.getCount(); }
+  uint32_t getSamplesFrozen() const { return samplesFrozen; }
+
+  /**
+   * @brief Get the quantiles the current thresholds were derived from
+   */
+  float getLastLowQuantile() const { return lastLow; }
+  float getLastMedian() const { return lastMedian; }
+
+  /**
+   * @brief Serialize tuned thresholds into a note body
+   * @param body JSON object to add fields to
+   */
+  void writeState(J* body);
+
+  /**
+   * @brief Restore tuned thresholds from a previously saved note body
+   * @param body JSON object produced by writeState()
+   */
+  void readState(J* body);
+
+  /**
+   * @brief Print tuning progress and thresholds to Serial
+   */
+  void printStats() const;
+};
+
+#endif // THRESHOLD_TUNER_H
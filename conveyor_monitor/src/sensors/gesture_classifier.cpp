@@ -0,0 +1,64 @@
+#include "gesture_classifier.h"
+
+GestureClassifier::GestureClassifier() {
+  begin();
+}
+
+void GestureClassifier::begin() {
+  entryUD = 0;
+  entryLR = 0;
+  for (int i = 0; i < GESTURE_EDGE_SAMPLES; i++) {
+    exitUD[i] = 0;
+    exitLR[i] = 0;
+  }
+  active = 0;
+  datasets = 0;
+}
+
+void GestureClassifier::add(uint8_t up, uint8_t down, uint8_t left, uint8_t right) {
+  if (datasets < UINT16_MAX) {
+    datasets++;
+  }
+  if (up <= GESTURE_ACTIVE_COUNTS || down <= GESTURE_ACTIVE_COUNTS ||
+      left <= GESTURE_ACTIVE_COUNTS || right <= GESTURE_ACTIVE_COUNTS) {
+    return;   // Hand not over the sensor (or only at its edge)
+  }
+
+  int16_t ud = (int16_t)(((int32_t)up - down) * 256 / ((int32_t)up + down));
+  int16_t lr = (int16_t)(((int32_t)left - right) * 256 / ((int32_t)left + right));
+  if (active < GESTURE_EDGE_SAMPLES) {
+    entryUD += ud;
+    entryLR += lr;
+  }
+  exitUD[active % GESTURE_EDGE_SAMPLES] = ud;
+  exitLR[active % GESTURE_EDGE_SAMPLES] = lr;
+  if (active < UINT16_MAX) {
+    active++;
+  }
+}
+
+GestureType GestureClassifier::finish() {
+  GestureType gesture = GESTURE_NONE;
+  if (active >= 2 * GESTURE_EDGE_SAMPLES) {
+    int32_t exitSumUD = 0;
+    int32_t exitSumLR = 0;
+    for (int i = 0; i < GESTURE_EDGE_SAMPLES; i++) {
+      exitSumUD += exitUD[i];
+      exitSumLR += exitLR[i];
+    }
+    // Both sums cover GESTURE_EDGE_SAMPLES ratios; compare before dividing
+    int32_t deltaUD = exitSumUD - entryUD;
+    int32_t deltaLR = exitSumLR - entryLR;
+    int32_t minDelta = (int32_t)GESTURE_MIN_DELTA_Q8 * GESTURE_EDGE_SAMPLES;
+
+    if (abs(deltaUD) >= minDelta && abs(deltaUD) >= abs(deltaLR)) {
+      gesture = deltaUD < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN;
+    } else if (abs(deltaLR) >= minDelta) {
+      gesture = deltaLR < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT;
+    } else if (active >= GESTURE_WAVE_MIN_SAMPLES) {
+      gesture = GESTURE_WAVE;
+    }
+  }
+  begin();
+  return gesture;
+}
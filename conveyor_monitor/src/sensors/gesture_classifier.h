@@ -0,0 +1,69 @@
+#ifndef GESTURE_CLASSIFIER_H
+#define GESTURE_CLASSIFIER_H
+
+#include <Arduino.h>
+#include "../config/sensor_config.h"
+#include "../config/alert_config.h"
+
+/**
+ * @brief Gesture direction from raw APDS9960 photodiode datasets, in fixed point
+ *
+ * The gesture engine fills its FIFO with U/D/L/R counts while a hand is
+ * over the sensor. For each dataset with all four counts above
+ * GESTURE_ACTIVE_COUNTS the classifier takes the axis ratios
+ *   ud = 256 (u - d) / (u + d),  lr = 256 (l - r) / (l + r)   (Q8)
+ * and keeps the mean of the first and of the last GESTURE_EDGE_SAMPLES.
+ * A swipe carries the hand from one side of the sensor to the other, so
+ * the exit ratio differs from the entry ratio along the swipe axis. The
+ * axis with the larger change wins if it changed by GESTURE_MIN_DELTA_Q8;
+ * the sign convention is the SparkFun library's, so a mounted sensor keeps
+ * its directions. A hand held over the sensor for GESTURE_WAVE_MIN_SAMPLES
+ * datasets without a swipe is a wave; anything shorter is noise.
+ *
+ * Integer arithmetic only, O(1) per dataset, the stream is not buffered.
+ */
+class GestureClassifier {
+private:
+  int32_t entryUD;                          // Sum of the first active ratios
+  int32_t entryLR;
+  int16_t exitUD[GESTURE_EDGE_SAMPLES];     // Latest active ratios (ring)
+  int16_t exitLR[GESTURE_EDGE_SAMPLES];
+  uint16_t active;                          // Active datasets this gesture
+  uint16_t datasets;                        // All datasets this gesture
+
+public:
+  /**
+   * @brief Constructor
+   */
+  GestureClassifier();
+
+  /**
+   * @brief Forget the gesture in progress
+   */
+  void begin();
+
+  /**
+   * @brief Add one FIFO dataset
+   * @param up Up photodiode count
+   * @param down Down photodiode count
+   * @param left Left photodiode count
+   * @param right Right photodiode count
+   */
+  void add(uint8_t up, uint8_t down, uint8_t left, uint8_t right);
+
+  /**
+   * @brief Classify the gesture seen since begin() and start the next one
+   * @return Swipe direction, GESTURE_WAVE, or GESTURE_NONE if too short or unclear
+   */
+  GestureType finish();
+
+  /**
+   * @brief Check whether a hand has been seen since begin()
+   */
+  bool hasActivity() const { return active > 0; }
+
+  uint16_t getActive() const { return active; }
+  uint16_t getDatasets() const { return datasets; }
+};
+
+#endif // GESTURE_CLASSIFIER_H
@@ -0,0 +1,96 @@
+#include "iaq_estimator.h"
+#include "../utils/fast_math.h"
+
+IAQEstimator::IAQEstimator() {
+  baselineLogGas = 0.0f;
+  gasScore = 0.0f;
+  iaq = 0;
+  accuracy = IAQ_ACCURACY_UNRELIABLE;
+  baselineValid = false;
+  startTime = 0;
+  learningStartTime = 0;
+  lastSampleTime = 0;
+  sampled = false;
+}
+
+void IAQEstimator::begin() {
+  startTime = millis();
+  baselineValid = false;
+  sampled = false;
+  iaq = 0;
+  accuracy = IAQ_ACCURACY_UNRELIABLE;
+}
+
+float IAQEstimator::humidityScore(float humidity) {
+  // Full marks around the reference, falling off linearly to 0% and 100%
+  if (humidity >= IAQ_HUMIDITY_REF_PCT - 2.0f && humidity <= IAQ_HUMIDITY_REF_PCT + 2.0f) {
+    return IAQ_HUMIDITY_WEIGHT;
+  }
+  if (humidity < IAQ_HUMIDITY_REF_PCT) {
+    return IAQ_HUMIDITY_WEIGHT * constrain(humidity, 0.0f, 100.0f) / IAQ_HUMIDITY_REF_PCT;
+  }
+  return IAQ_HUMIDITY_WEIGHT * (100.0f - constrain(humidity, 0.0f, 100.0f)) / (100.0f - IAQ_HUMIDITY_REF_PCT);
+}
+
+bool IAQEstimator::update(uint32_t gasResistance, float humidity) {
+  unsigned long now = millis();
+  if (sampled && now - lastSampleTime < IAQ_SAMPLE_INTERVAL_MS) {
+    return false;
+  }
+  if (gasResistance == 0 || !isfinite(humidity)) {
+    return false;
+  }
+  sampled = true;
+  lastSampleTime = now;
+
+  // The heater needs a few minutes before readings mean anything
+  if (now - startTime < IAQ_BURN_IN_MS) {
+    return true;
+  }
+
+  // Wetter air lowers the resistance - add back what humidity took away
+  float logGas = fastLogf((float)gasResistance) + IAQ_HUMIDITY_COMP * (humidity - IAQ_HUMIDITY_REF_PCT);
+
+  if (!baselineValid) {
+    baselineLogGas = logGas;
+    baselineValid = true;
+    learningStartTime = now;
+  } else if (logGas > baselineLogGas) {
+    baselineLogGas += IAQ_BASELINE_RISE * (logGas - baselineLogGas);
+  } else {
+    baselineLogGas += IAQ_BASELINE_DECAY * (logGas - baselineLogGas);
+  }
+
+  // Resistance ratio to clean air, 1.0 = as clean as the baseline
+  float ratio = fastExpf(logGas - baselineLogGas);
+  if (ratio > 1.0f) {
+    ratio = 1.0f;
+  }
+  gasScore = (100.0f - IAQ_HUMIDITY_WEIGHT) * ratio;
+  float score = gasScore + humidityScore(humidity);
+  iaq = (uint16_t)constrain(roundToInt((100.0f - score) * 5.0f), (int32_t)0, (int32_t)500);
+
+  unsigned long learned = now - learningStartTime;
+  if (learned >= IAQ_HIGH_ACCURACY_MS) {
+    accuracy = IAQ_ACCURACY_HIGH;
+  } else if (learned >= IAQ_LOW_ACCURACY_MS) {
+    accuracy = IAQ_ACCURACY_MEDIUM;
+  } else {
+    accuracy = IAQ_ACCURACY_LOW;
+  }
+  return true;
+}
+
+uint32_t IAQEstimator::getBaselineOhms() const {
+  return baselineValid ? (uint32_t)fastExpf(baselineLogGas) : 0;
+}
+
+const char* IAQEstimator::getAccuracyName(IAQAccuracy accuracy) {
+  switch (accuracy) {
+    case IAQ_ACCURACY_UNRELIABLE: return "unreliable";
+    case IAQ_ACCURACY_LOW: return "low";
+    case IAQ_ACCURACY_MEDIUM: return "medium";
+    case IAQ_ACCURACY_HIGH: return "high";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,82 @@
+#ifndef IAQ_ESTIMATOR_H
+#define IAQ_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "../config/sensor_config.h"
+
+/**
+ * @brief Confidence in the IAQ index, in the style of the BME688 BSEC states
+ */
+enum IAQAccuracy {
+  IAQ_ACCURACY_UNRELIABLE = 0,  // Heater burn-in, no baseline yet
+  IAQ_ACCURACY_LOW,             // Baseline still being learned
+  IAQ_ACCURACY_MEDIUM,          // Baseline learned for IAQ_LOW_ACCURACY_MS
+  IAQ_ACCURACY_HIGH             // Baseline learned for IAQ_HIGH_ACCURACY_MS
+};
+
+/**
+ * @brief Incremental indoor air quality index from BME688 gas resistance
+ *
+ * Raw gas resistance depends on the individual sensor, its age and the
+ * humidity, so it is scored against a learned clean-air baseline:
+ *   - gas is compensated in the log domain for humidity above/below
+ *     IAQ_HUMIDITY_REF_PCT
+ *   - the baseline rises quickly towards cleaner air and decays slowly
+ *     towards dirtier air, tracking sensor drift
+ *   - score = humidity comfort (IAQ_HUMIDITY_WEIGHT %) + gas ratio to
+ *     baseline (the rest); IAQ = (100 - score) * 5, 0 = clean, 500 = very bad
+ *
+ * State is O(1) and updates are rate-limited to IAQ_SAMPLE_INTERVAL_MS,
+ * so it can be fed from every sensor read.
+ */
+class IAQEstimator {
+private:
+  float baselineLogGas;         // Compensated ln(ohm) of clean air
+  float gasScore;               // 0..(100 - IAQ_HUMIDITY_WEIGHT)
+  uint16_t iaq;
+  IAQAccuracy accuracy;
+  bool baselineValid;
+  unsigned long startTime;
+  unsigned long learningStartTime;
+  unsigned long lastSampleTime;
+  bool sampled;
+
+  static float humidityScore(float humidity);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  IAQEstimator();
+
+  /**
+   * @brief Start burn-in now
+   */
+  void begin();
+
+  /**
+   * @brief Feed a gas/humidity reading
+   * @param gasResistance Gas resistance in ohms
+   * @param humidity Relative humidity in %
+   * @return true if the reading was used (at most every IAQ_SAMPLE_INTERVAL_MS)
+   */
+  bool update(uint32_t gasResistance, float humidity);
+
+  /**
+   * @brief Get the IAQ index
+   * @return 0 (clean) to 500; 0 while accuracy is IAQ_ACCURACY_UNRELIABLE
+   */
+  uint16_t getIAQ() const { return iaq; }
+
+  IAQAccuracy getAccuracy() const { return accuracy; }
+
+  /**
+   * @brief Get the learned clean-air gas resistance
+   * @return Ohms at IAQ_HUMIDITY_REF_PCT, 0 before the baseline exists
+   */
+  uint32_t getBaselineOhms() const;
+
+  static const char* getAccuracyName(IAQAccuracy accuracy);
+};
+
+#endif // IAQ_ESTIMATOR_H
@@ -0,0 +1,165 @@
+#ifndef PACKED_READINGS_H
+#define PACKED_READINGS_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include "../config/data_types.h"
+
+/**
+ * @brief Fixed-point SensorReadings for buffering and binary upload
+ *
+ * SensorReadings holds floats and is padded to 68 bytes. PackedReadings
+ * stores each value as an integer at a step matched to what the sensor
+ * actually resolves, in 39 bytes with no padding:
+ *
+ *   Field        Step               Range                 Sensor LSB
+ *   speed        0.01 RPM           0 .. 655 RPM          1/12 RPM detent
+ *   accel        1 mg               +/-32.7 g             0.244 mg (+/-8 g)
+ *   gyro         0.01 dps           +/-327 dps            8.75 mdps (245 dps)
+ *   mag          1 mgauss           +/-32.7 gauss         0.14 mgauss (4 gauss)
+ *   temperature  0.01 C             +/-327 C              0.01 C
+ *   humidity     0.01 %RH           0 .. 655 %RH          0.008 %RH
+ *   pressure     2 Pa above 300 hPa 300 .. 1610 hPa       0.18 Pa (noise ~1.5 Pa)
+ *   gas          100 ohm            0 .. 6.55 Mohm        log scale, ~2% repeatability
+ *
+ * The encoder count and ToF distance are already integers and are kept as
+ * they are. Values outside a range saturate, NaN is stored as 0, and
+ * rounding is to the nearest step, so a decoded value is within half a
+ * step of the original.
+ *
+ * Multi-byte fields are little-endian, as the Cortex-M stores them; the
+ * struct is the wire format. Any change to the layout must bump
+ * PACKED_READINGS_VERSION, which leads every batch of records.
+ */
+
+constexpr uint8_t PACKED_READINGS_VERSION = 1;
+
+// Counts per unit of the SensorReadings field
+constexpr float PACKED_SPEED_PER_RPM = 100.0f;
+constexpr float PACKED_ACCEL_PER_G = 1000.0f;
+constexpr float PACKED_GYRO_PER_DPS = 100.0f;
+constexpr float PACKED_MAG_PER_GAUSS = 1000.0f;
+constexpr float PACKED_TEMP_PER_C = 100.0f;
+constexpr float PACKED_HUMIDITY_PER_PCT = 100.0f;
+constexpr float PACKED_PRESSURE_PER_HPA = 50.0f;
+constexpr float PACKED_PRESSURE_BASE_HPA = 300.0f;
+constexpr uint32_t PACKED_GAS_OHMS = 100;
+
+constexpr uint8_t PACKED_FLAG_OBJECT = 0x01;    // objectDetected
+
+struct __attribute__((packed)) PackedReadings {
+  uint16_t dt_ms;           // Since the previous record of the batch (saturated)
+  uint16_t speed;
+  int32_t encoderPulses;
+  uint16_t distance_mm;
+  int16_t accel[3];         // x, y, z
+  int16_t gyro[3];
+  int16_t mag[3];
+  int16_t temperature;
+  uint16_t humidity;
+  uint16_t pressure;
+  uint16_t gas;
+  uint8_t gesture;
+  uint8_t proximity;
+  uint8_t flags;            // PACKED_FLAG_*
+};
+
+static_assert(sizeof(PackedReadings) == 39, "PackedReadings layout changed: bump PACKED_READINGS_VERSION");
+static_assert(offsetof(PackedReadings, encoderPulses) == 4 && offsetof(PackedReadings, accel) == 10 &&
+              offsetof(PackedReadings, temperature) == 28 && offsetof(PackedReadings, gesture) == 36,
+              "PackedReadings field offsets are the wire format");
+
+namespace packed_detail {
+
+// Nearest step, saturated to [lo, hi]; NaN becomes 0. Selects and one
+// truncation of a non-negative value, no branches on the sign of the reading
+constexpr int32_t toSteps(float value, float perUnit, int32_t lo, int32_t hi) {
+  float steps = value * perUnit;
+  steps = steps == steps ? steps : 0.0f;
+  steps = steps > (float)lo ? steps : (float)lo;
+  steps = steps < (float)hi ? steps : (float)hi;
+  return (int32_t)(steps - (float)lo + 0.5f) + lo;
+}
+
+constexpr int16_t toInt16(float value, float perUnit) {
+  return (int16_t)toSteps(value, perUnit, INT16_MIN, INT16_MAX);
+}
+
+constexpr uint16_t toUInt16(float value, float perUnit) {
+  return (uint16_t)toSteps(value, perUnit, 0, UINT16_MAX);
+}
+
+} // namespace packed_detail
+
+/**
+ * @brief Encode readings as a fixed-point record
+ * @param readings Raw readings
+ * @param dtMs Time since the previous record of the batch
+ */
+constexpr PackedReadings packReadings(const SensorReadings& readings, uint32_t dtMs) {
+  using namespace packed_detail;
+  PackedReadings p{};
+  p.dt_ms = dtMs < UINT16_MAX ? (uint16_t)dtMs : UINT16_MAX;
+  p.speed = toUInt16(readings.encoderSpeed, PACKED_SPEED_PER_RPM);
+  p.encoderPulses = readings.encoderPulses;
+  p.distance_mm = readings.distance_mm;
+  p.accel[0] = toInt16(readings.accel_x, PACKED_ACCEL_PER_G);
+  p.accel[1] = toInt16(readings.accel_y, PACKED_ACCEL_PER_G);
+  p.accel[2] = toInt16(readings.accel_z, PACKED_ACCEL_PER_G);
+  p.gyro[0] = toInt16(readings.gyro_x, PACKED_GYRO_PER_DPS);
+  p.gyro[1] = toInt16(readings.gyro_y, PACKED_GYRO_PER_DPS);
+  p.gyro[2] = toInt16(readings.gyro_z, PACKED_GYRO_PER_DPS);
+  p.mag[0] = toInt16(readings.mag_x, PACKED_MAG_PER_GAUSS);
+  p.mag[1] = toInt16(readings.mag_y, PACKED_MAG_PER_GAUSS);
+  p.mag[2] = toInt16(readings.mag_z, PACKED_MAG_PER_GAUSS);
+  p.temperature = toInt16(readings.temperature, PACKED_TEMP_PER_C);
+  p.humidity = toUInt16(readings.humidity, PACKED_HUMIDITY_PER_PCT);
+  p.pressure = toUInt16(readings.pressure - PACKED_PRESSURE_BASE_HPA, PACKED_PRESSURE_PER_HPA);
+  uint32_t gasSteps = (readings.gasResistance + PACKED_GAS_OHMS / 2) / PACKED_GAS_OHMS;
+  p.gas = gasSteps < UINT16_MAX ? (uint16_t)gasSteps : UINT16_MAX;
+  p.gesture = readings.gesture;
+  p.proximity = readings.proximity;
+  p.flags = readings.objectDetected ? PACKED_FLAG_OBJECT : 0;
+  return p;
+}
+
+/**
+ * @brief Decode a record back into readings (within half a step of the original)
+ */
+constexpr SensorReadings unpackReadings(const PackedReadings& p) {
+  SensorReadings r{};
+  r.encoderSpeed = p.speed / PACKED_SPEED_PER_RPM;
+  r.encoderPulses = p.encoderPulses;
+  r.distance_mm = p.distance_mm;
+  r.objectDetected = (p.flags & PACKED_FLAG_OBJECT) != 0;
+  r.accel_x = p.accel[0] / PACKED_ACCEL_PER_G;
+  r.accel_y = p.accel[1] / PACKED_ACCEL_PER_G;
+  r.accel_z = p.accel[2] / PACKED_ACCEL_PER_G;
+  r.gyro_x = p.gyro[0] / PACKED_GYRO_PER_DPS;
+  r.gyro_y = p.gyro[1] / PACKED_GYRO_PER_DPS;
+  r.gyro_z = p.gyro[2] / PACKED_GYRO_PER_DPS;
+  r.mag_x = p.mag[0] / PACKED_MAG_PER_GAUSS;
+  r.mag_y = p.mag[1] / PACKED_MAG_PER_GAUSS;
+  r.mag_z = p.mag[2] / PACKED_MAG_PER_GAUSS;
+  r.temperature = p.temperature / PACKED_TEMP_PER_C;
+  r.humidity = p.humidity / PACKED_HUMIDITY_PER_PCT;
+  r.pressure = PACKED_PRESSURE_BASE_HPA + p.pressure / PACKED_PRESSURE_PER_HPA;
+  r.gasResistance = (uint32_t)p.gas * PACKED_GAS_OHMS;
+  r.gesture = p.gesture;
+  r.proximity = p.proximity;
+  return r;
+}
+
+// Evaluated by the compiler: rounding, saturation and the pressure offset
+static_assert(packReadings(SensorReadings{}, 0).pressure == 0, "Pressure below the base saturates at 0");
+static_assert(packed_detail::toInt16(21.375f, PACKED_TEMP_PER_C) == 2138 &&
+              packed_detail::toInt16(-0.004f, PACKED_TEMP_PER_C) == 0 &&
+              packed_detail::toInt16(-9.0f, PACKED_ACCEL_PER_G) == -9000 &&
+              packed_detail::toInt16(40.0f, PACKED_ACCEL_PER_G) == INT16_MAX &&
+              packed_detail::toUInt16(1013.25f - PACKED_PRESSURE_BASE_HPA, PACKED_PRESSURE_PER_HPA) == 35663,
+              "Fixed-point conversion");
+static_assert(unpackReadings(packReadings(SensorReadings{}, 70000)).gasResistance == 0 &&
+              packReadings(SensorReadings{}, 70000).dt_ms == UINT16_MAX,
+              "Round trip");
+
+#endif // PACKED_READINGS_H
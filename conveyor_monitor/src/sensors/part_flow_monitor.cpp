@@ -0,0 +1,163 @@
+#include "part_flow_monitor.h"
+#include "../utils/fast_math.h"
+
+PartFlowMonitor::PartFlowMonitor() {
+  begin();
+}
+
+void PartFlowMonitor::begin() {
+  gaps.clear();
+  dwells.clear();
+  travel = 0.0f;
+  lastUpdate = 0;
+  partPresent = false;
+  onsetValid = false;
+
+  baselineGap = 0.0f;
+  baselineDwell = 0.0f;
+  baselineCv = 0.0f;
+  baselineEntropy = 0.0f;
+  gapSamples = 0;
+  dwellSamples = 0;
+  windowSamples = 0;
+
+  gapCv = 0.0f;
+  gapEntropy = 0.0f;
+  dwellRatio = 1.0f;
+  score = 0.0f;
+
+  parts = 0;
+  restarts = 0;
+  interruptions = 0;
+}
+
+void PartFlowMonitor::update(unsigned long now, bool present, float speedRpm) {
+  unsigned long dt = now - lastUpdate;
+  lastUpdate = now;
+  if (dt > PART_FLOW_MAX_READ_GAP_MS) {
+    interrupt();   // ToF was in standby or not read: travel since is unknown
+  } else {
+    travel += max(speedRpm, 0.0f) * (dt / 60000.0f);
+  }
+
+  if (present && !partPresent) {
+    parts++;
+    if (onsetValid) {
+      addGap(travel);
+    }
+    travel = 0.0f;
+    onsetValid = true;
+  } else if (!present && partPresent && onsetValid) {
+    addDwell(travel);
+  }
+  partPresent = present;
+}
+
+void PartFlowMonitor::interrupt() {
+  if (onsetValid) {
+    interruptions++;
+  }
+  onsetValid = false;
+}
+
+void PartFlowMonitor::addGap(float gap) {
+  if (gapSamples > 0 && gap > PART_FLOW_MAX_GAP_RATIO * baselineGap) {
+    // Feed stopped (jam, empty hopper): the spacing before says nothing about the flow after
+    gaps.clear();
+    dwells.clear();
+    score = 0.0f;
+    restarts++;
+    return;
+  }
+
+  gaps.push(gap);
+  measure();
+  score = isLearned() ? scoreFlow() : 0.0f;
+  if (score < PREJAM_SCORE_OFF) {
+    learn(gap);
+  }
+}
+
+void PartFlowMonitor::addDwell(float dwell) {
+  dwells.push(dwell);
+  if (score < PREJAM_SCORE_OFF) {
+    float alpha = dwellSamples < PART_FLOW_LEARN_PARTS ? 1.0f / (dwellSamples + 1) : PART_FLOW_BASELINE_ALPHA;
+    baselineDwell += alpha * (dwell - baselineDwell);
+    dwellSamples++;
+  }
+}
+
+void PartFlowMonitor::measure() {
+  float mean = gaps.average();
+  gapCv = mean > 0.0f ? sqrtf(gaps.variance(mean)) / mean : 0.0f;
+
+  // Entropy of the gaps binned around multiples of the baseline gap
+  uint8_t counts[PART_FLOW_BINS] = {0};
+  float binScale = baselineGap > 0.0f ? 1.0f / (baselineGap * PART_FLOW_BIN_WIDTH) : 0.0f;
+  for (float gap : gaps) {
+    int bin = (int)(gap * binScale + 0.5f);
+    counts[min(bin, PART_FLOW_BINS - 1)]++;
+  }
+  float n = (float)gaps.size();
+  float nats = 0.0f;
+  for (int i = 0; i < PART_FLOW_BINS; i++) {
+    if (counts[i] > 0) {
+      float p = counts[i] / n;
+      nats -= p * fastLogf(p);
+    }
+  }
+  gapEntropy = nats * 1.4426950f;   // Bits
+
+  dwellRatio = (dwells.size() > 0 && baselineDwell > 0.0f) ? dwells.average() / baselineDwell : 1.0f;
+}
+
+float PartFlowMonitor::scoreFlow() const {
+  if (gaps.size() < (size_t)PART_FLOW_MIN_GAPS) {
+    return 0.0f;
+  }
+  float cvTerm = constrain((gapCv - baselineCv) / PART_FLOW_CV_RISE, 0.0f, 1.0f);
+  float entropyTerm = constrain((gapEntropy - baselineEntropy) / PART_FLOW_ENTROPY_RISE, 0.0f, 1.0f);
+  float dwellTerm = constrain((dwellRatio - 1.0f) / PART_FLOW_DWELL_RISE, 0.0f, 1.0f);
+  return (cvTerm + entropyTerm + dwellTerm) * (1.0f / 3.0f);
+}
+
+void PartFlowMonitor::learn(float gap) {
+  // Running mean while learning, then an EWMA that follows slow changes
+  float alpha = gapSamples < PART_FLOW_LEARN_PARTS ? 1.0f / (gapSamples + 1) : PART_FLOW_BASELINE_ALPHA;
+  baselineGap += alpha * (gap - baselineGap);
+  gapSamples++;
+
+  if (gaps.size() >= (size_t)PART_FLOW_MIN_GAPS) {
+    alpha = windowSamples < PART_FLOW_LEARN_PARTS ? 1.0f / (windowSamples + 1) : PART_FLOW_BASELINE_ALPHA;
+    baselineCv += alpha * (gapCv - baselineCv);
+    baselineEntropy += alpha * (gapEntropy - baselineEntropy);
+    windowSamples++;
+  }
+}
+
+void PartFlowMonitor::printStats() const {
+  Serial.print(F("Part flow - Score: "));
+  Serial.print(score, 2);
+  Serial.print(F(", Gap CV: "));
+  Serial.print(gapCv, 3);
+  Serial.print(F(" (base "));
+  Serial.print(baselineCv, 3);
+  Serial.print(F("), Entropy: "));
+  Serial.print(gapEntropy, 2);
+  Serial.print(F(" bits (base "));
+  Serial.print(baselineEntropy, 2);
+  Serial.print(F("), Dwell: x"));
+  Serial.print(dwellRatio, 2);
+  Serial.print(F(", Spacing: "));
+  Serial.print(baselineGap, 2);
+  Serial.print(F(" rev, Parts: "));
+  Serial.print(parts);
+  Serial.print(F(", Restarts: "));
+  Serial.print(restarts);
+  Serial.print(F(", Interrupted: "));
+  Serial.print(interruptions);
+  if (!isLearned()) {
+    Serial.print(F(" (learning)"));
+  }
+  Serial.println();
+}
@@ -0,0 +1,118 @@
+#ifndef PART_FLOW_MONITOR_H
+#define PART_FLOW_MONITOR_H
+
+#include <Arduino.h>
+#include "../config/sensor_config.h"
+#include "../utils/circular_buffer.h"
+
+/**
+ * @brief Part spacing and ToF dwell model that scores bunching ahead of a jam
+ *
+ * Fed with every ToF reading. Gaps (part onset to next onset) and dwells
+ * (onset to clear) are measured in belt revolutions, integrated from the
+ * encoder speed, so a slower belt or a micro-stop does not look like
+ * irregular flow; only parts moving relative to the belt do.
+ *
+ * Over the last PART_FLOW_WINDOW parts it measures:
+ *   - the coefficient of variation of the gaps,
+ *   - the Shannon entropy of the gaps, in PART_FLOW_BINS bins of
+ *     PART_FLOW_BIN_WIDTH baseline gaps (regular flow fills one or two bins),
+ *   - the mean dwell against the baseline dwell.
+ * Baselines for all three are learned from the first PART_FLOW_LEARN_PARTS
+ * parts and then follow the flow while it scores below PREJAM_SCORE_OFF,
+ * so bunching is not learned as normal.
+ *
+ * Score (0 = regular, 1 = fully bunched): the mean of the rise of each
+ * measure above its baseline, scaled by PART_FLOW_CV_RISE,
+ * PART_FLOW_ENTROPY_RISE and PART_FLOW_DWELL_RISE and clamped to 0-1. It
+ * changes only when a part arrives: during a jam it holds its last value.
+ *
+ * A gap over PART_FLOW_MAX_GAP_RATIO baseline gaps means the feed stopped;
+ * the window restarts with the flow after it. O(PART_FLOW_WINDOW) per part,
+ * O(1) per reading.
+ */
+class PartFlowMonitor {
+private:
+  CircularBuffer<float, PART_FLOW_WINDOW> gaps;     // Onset to onset (revolutions)
+  CircularBuffer<float, PART_FLOW_WINDOW> dwells;   // Onset to clear (revolutions)
+  float travel;               // Belt revolutions since the last onset
+  unsigned long lastUpdate;
+  bool partPresent;
+  bool onsetValid;            // The last onset was seen with travel tracked since
+
+  // Baselines of regular flow
+  float baselineGap;
+  float baselineDwell;
+  float baselineCv;
+  float baselineEntropy;
+  uint32_t gapSamples;
+  uint32_t dwellSamples;
+  uint32_t windowSamples;
+
+  // Latest measures
+  float gapCv;
+  float gapEntropy;
+  float dwellRatio;
+  float score;
+
+  uint32_t parts;
+  uint32_t restarts;
+  uint32_t interruptions;
+
+  void addGap(float gap);
+  void addDwell(float dwell);
+  void measure();
+  float scoreFlow() const;
+  void learn(float gap);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  PartFlowMonitor();
+
+  /**
+   * @brief Forget the flow and its baselines
+   */
+  void begin();
+
+  /**
+   * @brief Process one ToF reading
+   * @param now Reading time (ms)
+   * @param present A part is in front of the sensor
+   * @param speedRpm Belt speed at the reading
+   */
+  void update(unsigned long now, bool present, float speedRpm);
+
+  /**
+   * @brief Drop the part in progress (ToF timeout, reading lost)
+   *
+   * The next onset starts a new gap instead of closing one of unknown length.
+   */
+  void interrupt();
+
+  /**
+   * @brief Get the irregularity score
+   * @return 0 (regular or still learning) - 1 (bunched)
+   */
+  float getScore() const { return score; }
+
+  /**
+   * @brief Check whether the baselines are learned and the window can be scored
+   */
+  bool isLearned() const { return windowSamples >= PART_FLOW_LEARN_PARTS; }
+
+  float getGapCv() const { return gapCv; }
+  float getGapEntropy() const { return gapEntropy; }
+  float getDwellRatio() const { return dwellRatio; }
+  float getBaselineGap() const { return baselineGap; }
+  uint32_t getParts() const { return parts; }
+  uint32_t getRestarts() const { return restarts; }
+
+  /**
+   * @brief Print the flow measures and baselines to Serial
+   */
+  void printStats() const;
+};
+
+#endif // PART_FLOW_MONITOR_H
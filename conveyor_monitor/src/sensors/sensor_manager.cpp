@@ -1,5 +1,6 @@
 #include "sensor_manager.h"
 #include "../utils/error_handling.h"
+#include "../utils/fast_math.h"
 #include <Wire.h>
 #include <Adafruit_BME680.h>
 #include <VL53L1X.h>
@@ -10,6 +11,32 @@
 // Variable to track last part detection state
 static bool lastPartDetected = false;
 
+// APDS9960 gesture registers, read directly: the library decode blocks until the gesture ends
+constexpr uint8_t APDS9960_GCONF4 = 0xAB;     // bit 0 GMODE: gesture in progress
+constexpr uint8_t APDS9960_GFLVL = 0xAE;      // Datasets in the FIFO
+constexpr uint8_t APDS9960_GFIFO_U = 0xFC;    // U, D, L, R; a burst read walks the FIFO
+
+// Set by the APDS9960 INT line (FIFO above its threshold)
+static volatile bool gestureInterrupt = false;
+
+static void onGestureInterrupt() {
+  gestureInterrupt = true;
+}
+
+static uint8_t readApdsBlock(uint8_t reg, uint8_t* data, uint8_t length) {
+  Wire.beginTransmission(APDS9960_I2C_ADDR);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) {
+    return 0;
+  }
+  uint8_t count = 0;
+  Wire.requestFrom(APDS9960_I2C_ADDR, length);
+  while (Wire.available() && count < length) {
+    data[count++] = (uint8_t)Wire.read();
+  }
+  return count;
+}
+
 // Sensor objects
 Adafruit_BME680 bme;
 VL53L1X distanceSensor;
@@ -23,13 +50,45 @@ SensorManager::SensorManager() {
   baselineEncoderPosition = 0;
   lastEncoderTime = 0;
   currentSpeed_rpm = 0.0;
+  lastSpeedUpdate = 0;
   lastPartDetectTime = 0;
   partCount = 0;
   partCountStartTime = millis();
+  totalParts = 0;
+  distanceTimeouts = 0;
+  validMask = 0;
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    fieldUpdateTime[i] = 0;
+  }
   vibrationBufferIndex = 0;
   vibrationMagnitude = 0.0;
+  accelMagnitude = 0.0f;
   lastGesture = GESTURE_NONE;
   lastGestureTime = 0;
+  lastGestureDrain = 0;
+  lastGestureActivity = 0;
+  gestureEndMicros = 0;
+  for (int i = 0; i <= GESTURE_WAVE; i++) {
+    gestureCounts[i] = 0;
+  }
+  gesturesDebounced = 0;
+  gestureDatasets = 0;
+  gestureActions = 0;
+  gestureLatencyTotal = 0;
+  gestureLatencyMax = 0;
+  energyModel = nullptr;
+  envMeasuring = false;
+  envStartTime = 0;
+  lastEnvReading = 0;
+  bmeMeasureMs = BME688_MEASURE_MS;
+  tofRanging = false;
+  tofWakeTime = 0;
+  tofStandbyTime = 0;
+  lastRunningTime = 0;
+  gestureEngineOn = false;
+  gestureWakeTime = 0;
+  lastPresenceTime = 0;
+  lastProximityRead = 0;
   
   // Initialize availability flags
   seesawAvailable = false;
@@ -47,10 +106,10 @@ bool SensorManager::initializeSensorWithFallback(bool (SensorManager::*initFunc)
     Serial.println(F(" init failed"));
     LOG_ERROR_CTX(SystemError::SENSOR_INIT_FAILED, sensorName);
     
-    #if VIRTUAL_SENSOR
+    if (VIRTUAL_SENSOR) {
       Serial.print(F("  -> Using "));
       Serial.println(virtualFallbackMsg);
-    #endif
+    }
   } else {
     Serial.print(sensorName);
     Serial.println(F(" initialized successfully"));
@@ -58,8 +117,9 @@ bool SensorManager::initializeSensorWithFallback(bool (SensorManager::*initFunc)
   return availabilityFlag;
 }
 
-bool SensorManager::begin() {
+bool SensorManager::begin(EnergyModel* energy) {
   Serial.println(F("Initializing sensors..."));
+  energyModel = energy;
   bool allSensorsOk = true;
 
   // Initialize I2C sensors using helper method to reduce duplication
@@ -78,15 +138,27 @@ bool SensorManager::begin() {
   allSensorsOk &= initializeSensorWithFallback(&SensorManager::initializeAPDS9960, apds9960Available, 
                                               "APDS9960", "virtual gesture data");
 
-  #if VIRTUAL_SENSOR
+  // Gas heater burn-in starts with the BME688 (or its virtual stand-in)
+  iaqEstimator.begin();
+
+  // Power states after init; the BME688 only draws during measurement pulses
+  unsigned long currentTime = millis();
+  lastEnvReading = currentTime - ENV_READ_INTERVAL;   // First measurement right away
+  lastRunningTime = currentTime;
+  setPower(ENERGY_ENCODER, seesawAvailable ? POWER_ACTIVE : POWER_OFF);
+  setPower(ENERGY_BME688, bme688Available ? POWER_STANDBY : POWER_OFF);
+  setPower(ENERGY_VL53L1X, tofRanging ? POWER_ACTIVE : POWER_OFF);
+  setPower(ENERGY_IMU, lsm9ds1Available ? POWER_ACTIVE : POWER_OFF);
+  setPower(ENERGY_APDS9960, !apds9960Available ? POWER_OFF : (gestureEngineOn ? POWER_ACTIVE : POWER_STANDBY));
+
+  if (VIRTUAL_SENSOR) {
     Serial.println(F("Sensor initialization complete (virtual mode enabled)"));
     return true;
-  #else
-    if (allSensorsOk) {
-      Serial.println(F("All sensors initialized successfully"));
-    }
-    return allSensorsOk;
-  #endif
+  }
+  if (allSensorsOk) {
+    Serial.println(F("All sensors initialized successfully"));
+  }
+  return allSensorsOk;
 }
 
 bool SensorManager::initializeSeesaw() {
@@ -149,6 +221,8 @@ bool SensorManager::initializeVL53L1X() {
 
   // Start continuous mode
   distanceSensor.startContinuous(100); // 100ms between measurements
+  tofRanging = true;
+  tofWakeTime = millis();
 
   // Wait for first measurement to be ready
   delay(200);
@@ -180,10 +254,21 @@ bool SensorManager::initializeAPDS9960() {
   }
   
   // Configure gesture sensor
-  gestureSensor.enableGestureSensor(true);
-  gestureSensor.enableProximitySensor(true);  // Enable proximity for gesture detection
   gestureSensor.setGestureGain(GGAIN_2X);
   gestureSensor.setGestureLEDDrive(LED_DRIVE_25MA);
+  if (SENSOR_DUTY_CYCLING) {
+    // Proximity only until an operator comes near
+    gestureSensor.enableProximitySensor(false);
+  } else {
+    gestureSensor.enableGestureSensor(true);
+    // Proximity is polled; its interrupt would latch INT low and mask the gesture interrupt
+    gestureSensor.enableProximitySensor(false);
+    gestureEngineOn = true;
+  }
+  
+  // INT pulls low when the gesture FIFO passes its threshold; serviceGesture() drains it
+  pinMode(APDS9960_INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(APDS9960_INT_PIN), onGestureInterrupt, FALLING);
   
   return true;
 }
@@ -196,6 +281,7 @@ void SensorManager::readAll() {
   readGesture();
   
   calculateVibration();
+  updateSpeedEstimate();
   updatePartCount();
 }
 
@@ -209,11 +295,11 @@ void SensorManager::readEncoder() {
     
     // Convert position offset to speed (each detent = 1 RPM increment)
     // Positive offset = faster, negative offset = reverse/slower
-    currentSpeed_rpm = positionOffset * 1.0; // 1 RPM per detent
+    currentSpeed_rpm = positionOffset * 1.0f; // 1 RPM per detent
 
     // Clamp speed to reasonable range
-    if (currentSpeed_rpm < 0.0) currentSpeed_rpm = 0.0;        // No negative speeds
-    if (currentSpeed_rpm > 100.0) currentSpeed_rpm = 100.0;    // Max 100 RPM
+    if (currentSpeed_rpm < 0.0f) currentSpeed_rpm = 0.0f;        // No negative speeds
+    if (currentSpeed_rpm > 100.0f) currentSpeed_rpm = 100.0f;    // Max 100 RPM
 
     // Debug encoder readings
     /*
@@ -235,31 +321,86 @@ void SensorManager::readEncoder() {
 
     currentReadings.encoderSpeed = currentSpeed_rpm;
     currentReadings.encoderPulses = encoderPosition;
+    markField(FIELD_SPEED, true);
   } else {
     Serial.println(F("Seesaw not available, using virtual encoder"));
     generateVirtualEncoderData();
+    markField(FIELD_SPEED, VIRTUAL_SENSOR);
   }
 }
 
 void SensorManager::readEnvironmental() {
   if (bme688Available) {
-    if (bme.performReading()) {
-      currentReadings.temperature = bme.temperature;
-      currentReadings.humidity = bme.humidity;
-      currentReadings.pressure = bme.pressure / 100.0; // Convert to hPa
-      currentReadings.gasResistance = bme.gas_resistance;
+    if (!SENSOR_DUTY_CYCLING) {
+      // Blocks for the whole measurement on every read
+      if (bme.performReading()) {
+        storeEnvironmental();
+      }
+      if (energyModel) {
+        energyModel->addPulse(ENERGY_BME688, bmeMeasureMs * 1000UL);
+      }
+      return;
+    }
+
+    unsigned long currentTime = millis();
+    if (envMeasuring) {
+      // The sensor returns to sleep by itself once the measurement is done
+      if (currentTime - envStartTime >= bmeMeasureMs) {
+        envMeasuring = false;
+        lastEnvReading = currentTime;
+        if (bme.endReading()) {
+          storeEnvironmental();
+        }
+      }
+    } else if (currentTime - lastEnvReading >= ENV_READ_INTERVAL - bmeMeasureMs) {
+      // Start early by the measurement time so the result is ready when due
+      unsigned long readyTime = bme.beginReading();
+      if (readyTime != 0) {
+        envMeasuring = true;
+        envStartTime = currentTime;
+        bmeMeasureMs = min(readyTime - currentTime, ENV_READ_INTERVAL);
+        if (energyModel) {
+          energyModel->addPulse(ENERGY_BME688, bmeMeasureMs * 1000UL);
+        }
+      }
     }
   } else {
     generateVirtualEnvironmentalData();
+    markField(FIELD_TEMPERATURE, VIRTUAL_SENSOR);
+    markField(FIELD_HUMIDITY, VIRTUAL_SENSOR);
+    markField(FIELD_PRESSURE, VIRTUAL_SENSOR);
+    markField(FIELD_GAS, VIRTUAL_SENSOR);
+    iaqEstimator.update(currentReadings.gasResistance, currentReadings.humidity);
   }
 }
 
 void SensorManager::readDistance() {
   if (vl53l1xAvailable) {
+    unsigned long currentTime = millis();
+    if (SENSOR_DUTY_CYCLING) {
+      if (currentSpeed_rpm > MIN_SPEED_THRESHOLD) {
+        lastRunningTime = currentTime;
+      }
+      if (!tofRanging) {
+        if (currentSpeed_rpm > MIN_SPEED_THRESHOLD || currentTime - tofStandbyTime >= TOF_STANDBY_CHECK_MS) {
+          wakeRanging(currentTime);
+        } else {
+          // A stopped belt carries no parts; the encoder vouches for the count
+          markField(FIELD_PARTS, (validMask & FIELD_BIT(FIELD_SPEED)) != 0);
+        }
+        return;
+      }
+      if (currentTime - tofWakeTime < VL53L1X_WAKE_MS) {
+        return;   // First range not ready yet
+      }
+    }
+
     uint16_t distance = distanceSensor.read(false);
     
     if (distance != 0 && !distanceSensor.timeoutOccurred()) {
       currentReadings.distance_mm = distance;
+      distanceTimeouts = 0;
+      markField(FIELD_PARTS, true);
       
       // Detect if object is present
       currentReadings.objectDetected = (distance < PART_DETECT_THRESHOLD);
@@ -267,17 +408,31 @@ void SensorManager::readDistance() {
       // Track part detection
       if (currentReadings.objectDetected && !lastPartDetected) {
         partCount++;
+        totalParts++;
         lastPartDetectTime = millis();
       }
       lastPartDetected = currentReadings.objectDetected;
+      partFlow.update(currentTime, currentReadings.objectDetected, currentSpeed_rpm);
     } else {
-      // Handle timeout - keep last valid reading but don't update part detection
+      // Handle timeout - keep last valid reading but don't update part detection,
+      // and stop vouching for it now rather than when it goes stale
+      markField(FIELD_PARTS, false);
       if (distanceSensor.timeoutOccurred()) {
         Serial.println(F("VL53L1X timeout"));
+        if (distanceTimeouts < 255) {
+          distanceTimeouts++;
+        }
       }
+      partFlow.interrupt();
+    }
+
+    // Stopped long enough (or this was a check measurement): back to standby
+    if (SENSOR_DUTY_CYCLING && currentTime - lastRunningTime >= TOF_STANDBY_DELAY_MS) {
+      standbyRanging(currentTime);
     }
   } else {
     generateVirtualDistanceData();
+    markField(FIELD_PARTS, VIRTUAL_SENSOR);
   }
 }
 
@@ -290,12 +445,18 @@ void SensorManager::readIMU() {
       currentReadings.accel_z = imu.calcAccel(imu.az);
       
       // Add to vibration buffer
-      float magnitude = sqrt(sq(currentReadings.accel_x) + 
-                            sq(currentReadings.accel_y) + 
-                            sq(currentReadings.accel_z));
+      float magnitude = sqrtf(sq(currentReadings.accel_x) + 
+                             sq(currentReadings.accel_y) + 
+                             sq(currentReadings.accel_z));
       
-      vibrationBuffer[vibrationBufferIndex] = magnitude;
-      vibrationBufferIndex = (vibrationBufferIndex + 1) % VIBRATION_SAMPLE_SIZE;
+      // A non-finite sample would poison the RMS window for a full buffer
+      bool magnitudeOk = isfinite(magnitude);
+      if (magnitudeOk) {
+        accelMagnitude = magnitude;
+        vibrationBuffer[vibrationBufferIndex] = magnitude;
+        vibrationBufferIndex = (vibrationBufferIndex + 1) & (VIBRATION_SAMPLE_SIZE - 1);
+      }
+      markField(FIELD_VIBRATION, magnitudeOk);
     }
     
     if (imu.gyroAvailable()) {
@@ -313,71 +474,194 @@ void SensorManager::readIMU() {
     }
   } else {
     generateVirtualIMUData();
+    markField(FIELD_VIBRATION, VIRTUAL_SENSOR);
   }
 }
 
 void SensorManager::readGesture() {
   if (apds9960Available) {
-    if (gestureSensor.isGestureAvailable()) {
-      int gesture = gestureSensor.readGesture();
-      unsigned long currentTime = millis();
+    unsigned long currentTime = millis();
+    
+    // Gestures are drained by serviceGesture() on the APDS9960 interrupt; read proximity
+    // here (less often while nobody is near)
+    if (gestureEngineOn || currentTime - lastProximityRead >= PROXIMITY_READ_INTERVAL) {
+      uint8_t proximity = 0;
+      gestureSensor.readProximity(proximity);
+      currentReadings.proximity = proximity;
+      lastProximityRead = currentTime;
       
-      // Apply cooldown to prevent spam
-      if (currentTime - lastGestureTime >= GESTURE_COOLDOWN_MS) {
-        switch (gesture) {
-          case DIR_UP:
-            lastGesture = GESTURE_SWIPE_UP;
-            Serial.println(F("Gesture detected: UP"));
-            break;
-          case DIR_DOWN:
-            lastGesture = GESTURE_SWIPE_DOWN;
-            Serial.println(F("Gesture detected: DOWN"));
-            break;
-          case DIR_LEFT:
-            lastGesture = GESTURE_SWIPE_LEFT;
-            Serial.println(F("Gesture detected: LEFT"));
-            break;
-          case DIR_RIGHT:
-            lastGesture = GESTURE_SWIPE_RIGHT;
-            Serial.println(F("Gesture detected: RIGHT"));
-            break;
-          case DIR_NEAR:
-          case DIR_FAR:
-            lastGesture = GESTURE_WAVE;
-            Serial.println(F("Gesture detected: WAVE"));
-            break;
-        }
-        lastGestureTime = currentTime;
+      // Periodic proximity debug
+      static unsigned long lastProxDebug = 0;
+      if (millis() - lastProxDebug > 10000) { // Every 10 seconds
+        Serial.print(F("APDS9960 Proximity: "));
+        Serial.print(proximity);
+        Serial.print(F(" (Operator: "));
+        Serial.print(proximity > 10 ? "YES" : "NO");
+        Serial.println(F(")"));
+        lastProxDebug = millis();
       }
     }
-    
-    // Read proximity
-    uint8_t proximity = 0;
-    gestureSensor.readProximity(proximity);
-    currentReadings.proximity = proximity;
-    
-    // Periodic proximity debug
-    static unsigned long lastProxDebug = 0;
-    if (millis() - lastProxDebug > 10000) { // Every 10 seconds
-      Serial.print(F("APDS9960 Proximity: "));
-      Serial.print(proximity);
-      Serial.print(F(" (Operator: "));
-      Serial.print(proximity > 10 ? "YES" : "NO");
-      Serial.println(F(")"));
-      lastProxDebug = millis();
+
+    if (SENSOR_DUTY_CYCLING) {
+      updateGesturePower(currentTime);
     }
   } else {
     generateVirtualGestureData();
   }
 }
 
+void SensorManager::storeEnvironmental() {
+  // Keep the last good value of any field that comes back non-finite
+  bool tempOk = isfinite(bme.temperature);
+  bool humidityOk = isfinite(bme.humidity);
+  bool pressureOk = isfinite(bme.pressure);
+  if (tempOk) currentReadings.temperature = bme.temperature;
+  if (humidityOk) currentReadings.humidity = bme.humidity;
+  if (pressureOk) currentReadings.pressure = bme.pressure / 100.0f; // Convert to hPa
+  currentReadings.gasResistance = bme.gas_resistance;
+  markField(FIELD_TEMPERATURE, tempOk);
+  markField(FIELD_HUMIDITY, humidityOk);
+  markField(FIELD_PRESSURE, pressureOk);
+  markField(FIELD_GAS, true);
+  if (humidityOk) {
+    iaqEstimator.update(currentReadings.gasResistance, currentReadings.humidity);
+  }
+}
+
+void SensorManager::setPower(EnergyConsumer consumer, PowerState state) {
+  if (energyModel) {
+    energyModel->setState(consumer, state);
+  }
+}
+
+void SensorManager::wakeRanging(unsigned long now) {
+  distanceSensor.startContinuous(100);
+  tofRanging = true;
+  tofWakeTime = now;
+  setPower(ENERGY_VL53L1X, POWER_ACTIVE);
+}
+
+void SensorManager::standbyRanging(unsigned long now) {
+  distanceSensor.stopContinuous();
+  tofRanging = false;
+  tofStandbyTime = now;
+  setPower(ENERGY_VL53L1X, POWER_STANDBY);
+}
+
+void SensorManager::updateGesturePower(unsigned long now) {
+  if (isOperatorPresent()) {
+    lastPresenceTime = now;
+    if (!gestureEngineOn) {
+      gestureSensor.enableGestureSensor(true);
+      gestureEngineOn = true;
+      gestureWakeTime = now;
+      setPower(ENERGY_APDS9960, POWER_ACTIVE);
+    }
+  } else if (gestureEngineOn && now - lastPresenceTime >= GESTURE_IDLE_MS) {
+    gestureSensor.disableGestureSensor();
+    gestureEngineOn = false;
+    gestureClassifier.begin();
+    gestureInterrupt = false;
+    setPower(ENERGY_APDS9960, POWER_STANDBY);
+  }
+}
+
+bool SensorManager::gesturePending() const {
+  if (!apds9960Available || !gestureEngineOn || millis() - gestureWakeTime < APDS9960_WAKE_MS) {
+    return false;
+  }
+  return gestureInterrupt ||
+         (gestureClassifier.getDatasets() > 0 && millis() - lastGestureDrain >= GESTURE_POLL_MS);
+}
+
+void SensorManager::serviceGesture() {
+  gestureInterrupt = false;
+  unsigned long now = millis();
+  lastGestureDrain = now;
+  
+  // GMODE first: once it reads 0 no more datasets arrive, so the drain below completes the gesture
+  uint8_t gconf4 = 0;
+  uint8_t level = 0;
+  if (readApdsBlock(APDS9960_GCONF4, &gconf4, 1) != 1 || readApdsBlock(APDS9960_GFLVL, &level, 1) != 1) {
+    gestureClassifier.begin();
+    return;
+  }
+  
+  uint16_t activeBefore = gestureClassifier.getActive();
+  uint8_t data[GESTURE_FIFO_BURST * 4];
+  while (level > 0) {
+    uint8_t count = min(level, (uint8_t)GESTURE_FIFO_BURST);
+    if (readApdsBlock(APDS9960_GFIFO_U, data, count * 4) != count * 4) {
+      break;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      gestureClassifier.add(data[i * 4], data[i * 4 + 1], data[i * 4 + 2], data[i * 4 + 3]);
+    }
+    gestureDatasets += count;
+    level -= count;
+  }
+  if (gestureClassifier.getActive() != activeBefore) {
+    lastGestureActivity = micros();
+  }
+  
+  if ((gconf4 & 0x01) || gestureClassifier.getDatasets() == 0) {
+    return;   // Gesture still in progress (or nothing to classify)
+  }
+  GestureType gesture = gestureClassifier.finish();
+  gestureCounts[gesture]++;
+  if (gesture == GESTURE_NONE) {
+    return;
+  }
+  if (now - lastGestureTime >= GESTURE_COOLDOWN_MS) {
+    lastGesture = gesture;
+    lastGestureTime = now;
+    gestureEndMicros = lastGestureActivity;
+  } else {
+    gesturesDebounced++;
+  }
+}
+
+void SensorManager::recordGestureAction() {
+  unsigned long latency = micros() - gestureEndMicros;
+  gestureActions++;
+  gestureLatencyTotal += latency;
+  gestureLatencyMax = max(gestureLatencyMax, latency);
+}
+
+void SensorManager::printGestureStats() const {
+  static const char* const names[] = {"rejected", "up", "down", "left", "right", "wave"};
+  Serial.print(F("Gestures -"));
+  for (int i = 0; i <= GESTURE_WAVE; i++) {
+    Serial.print(' ');
+    Serial.print(names[i]);
+    Serial.print(F(": "));
+    Serial.print(gestureCounts[i]);
+  }
+  Serial.print(F(", Debounced: "));
+  Serial.print(gesturesDebounced);
+  Serial.print(F(", Datasets: "));
+  Serial.print(gestureDatasets);
+  Serial.print(F(", Latency avg/max: "));
+  Serial.print(gestureActions > 0 ? gestureLatencyTotal / gestureActions : 0UL);
+  Serial.print(F("/"));
+  Serial.print(gestureLatencyMax);
+  Serial.println(F("μs"));
+}
+
 void SensorManager::calculateVibration() {
   // Calculate RMS vibration magnitude
-  float sum = 0;
+  float sum = 0.0f;
   for (int i = 0; i < VIBRATION_SAMPLE_SIZE; i++) {
     sum += sq(vibrationBuffer[i]);
   }
-  vibrationMagnitude = sqrt(sum / VIBRATION_SAMPLE_SIZE);
+  vibrationMagnitude = sqrtf(sum / VIBRATION_SAMPLE_SIZE);
+}
+
+void SensorManager::updateSpeedEstimate() {
+  unsigned long currentTime = millis();
+  float dtSeconds = (currentTime - lastSpeedUpdate) / 1000.0f;
+  lastSpeedUpdate = currentTime;
+  speedFilter.update(currentSpeed_rpm, accelMagnitude, dtSeconds);
 }
 
 void SensorManager::updatePartCount() {
@@ -399,6 +683,35 @@ int SensorManager::getPartsCount() const {
   return 0;
 }
 
+void SensorManager::markField(SensorField field, bool ok) {
+  if (ok) {
+    validMask |= FIELD_BIT(field);
+    fieldUpdateTime[field] = millis();
+  } else {
+    validMask &= ~FIELD_BIT(field);
+  }
+}
+
+uint8_t SensorManager::getStaleMask() const {
+  unsigned long currentTime = millis();
+  uint8_t stale = 0;
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    unsigned long window = (i >= FIELD_TEMPERATURE) ? ENV_STALE_MS : MOTION_STALE_MS;
+    stale |= (uint8_t)((currentTime - fieldUpdateTime[i] > window) << i);
+  }
+  return stale;
+}
+
+bool SensorManager::hasMotionSensorFault() const {
+  if (distanceTimeouts >= SENSOR_FAULT_TIMEOUTS) {
+    return true;
+  }
+  if (VIRTUAL_SENSOR) {
+    return false;
+  }
+  return !seesawAvailable || !vl53l1xAvailable;
+}
+
 bool SensorManager::checkSensorHealth() const {
   // Check if we're getting readings from all sensors
   bool healthy = true;
@@ -446,7 +759,7 @@ void SensorManager::generateVirtualEncoderData() {
   
   if (timeDiff >= 1000) {
     // Simulate encoder with slight variations
-    float variation = (sin(currentTime / 5000.0) * 2.0) - 1.0; // -1 to +1
+    float variation = (fastSinTurns(periodPhase(currentTime, 31416)) * 2.0f) - 1.0f; // -1 to +1
     currentSpeed_rpm = NOMINAL_SPEED_RPM + variation;
     
     // Update position based on speed
@@ -463,21 +776,22 @@ void SensorManager::generateVirtualEnvironmentalData() {
   unsigned long currentTime = millis();
   
   // Generate realistic environmental data with slight variations
-  float tempVariation = sin(currentTime / 30000.0) * 2.0; // ±2°C
-  float humidityVariation = cos(currentTime / 45000.0) * 5.0; // ±5%
-  
-  currentReadings.temperature = 22.0 + tempVariation;
-  currentReadings.humidity = 45.0 + humidityVariation;
-  currentReadings.pressure = 1013.25 + (sin(currentTime / 60000.0) * 2.0);
-  currentReadings.gasResistance = 150000 + (sin(currentTime / 20000.0) * 25000);
+  // (periods are 2*pi x the original time constants, in whole ms)
+  float tempVariation = fastSinTurns(periodPhase(currentTime, 188496)) * 2.0f; // ±2°C
+  float humidityVariation = fastCosTurns(periodPhase(currentTime, 282743)) * 5.0f; // ±5%
+  
+  currentReadings.temperature = 22.0f + tempVariation;
+  currentReadings.humidity = 45.0f + humidityVariation;
+  currentReadings.pressure = 1013.25f + (fastSinTurns(periodPhase(currentTime, 376991)) * 2.0f);
+  currentReadings.gasResistance = 150000 + (fastSinTurns(periodPhase(currentTime, 125664)) * 25000.0f);
 }
 
 void SensorManager::generateVirtualDistanceData() {
   unsigned long currentTime = millis();
   
   // Simulate parts passing by
-  float sineWave = sin(currentTime / 1000.0); // 1 Hz
-  currentReadings.distance_mm = 200 + (sineWave * 150); // 50-350mm range
+  float sineWave = fastSinTurns(periodPhase(currentTime, 6283)); // ~0.16 Hz
+  currentReadings.distance_mm = 200 + (sineWave * 150.0f); // 50-350mm range
   
   // Detect virtual parts
   currentReadings.objectDetected = (currentReadings.distance_mm < PART_DETECT_THRESHOLD);
@@ -485,30 +799,32 @@ void SensorManager::generateVirtualDistanceData() {
   // Track part detection
   if (currentReadings.objectDetected && !lastPartDetected) {
     partCount++;
+    totalParts++;
     lastPartDetectTime = currentTime;
   }
   lastPartDetected = currentReadings.objectDetected;
+  partFlow.update(currentTime, currentReadings.objectDetected, currentSpeed_rpm);
 }
 
 void SensorManager::generateVirtualIMUData() {
   unsigned long currentTime = millis();
   
   // Generate realistic vibration data
-  float baseVibration = VIBRATION_BASELINE_G;
   float vibrationNoise = (random(100) - 50) / 500.0; // ±0.1g noise
-  float periodicVibration = sin(currentTime / 200.0) * 0.05; // 5Hz oscillation
+  float periodicVibration = fastSinTurns(periodPhase(currentTime, 1257)) * 0.05f; // ~0.8 Hz oscillation
   
   currentReadings.accel_x = vibrationNoise;
   currentReadings.accel_y = vibrationNoise * 0.8;
   currentReadings.accel_z = 1.0 + periodicVibration; // 1g gravity + vibration
   
   // Add to vibration buffer
-  float magnitude = sqrt(sq(currentReadings.accel_x) + 
-                        sq(currentReadings.accel_y) + 
-                        sq(currentReadings.accel_z));
+  float magnitude = sqrtf(sq(currentReadings.accel_x) + 
+                         sq(currentReadings.accel_y) + 
+                         sq(currentReadings.accel_z));
   
+  accelMagnitude = magnitude;
   vibrationBuffer[vibrationBufferIndex] = magnitude;
-  vibrationBufferIndex = (vibrationBufferIndex + 1) % VIBRATION_SAMPLE_SIZE;
+  vibrationBufferIndex = (vibrationBufferIndex + 1) & (VIBRATION_SAMPLE_SIZE - 1);
   
   // Simulate gyro (mostly zeros with small drift)
   currentReadings.gyro_x = (random(10) - 5) / 10.0;
@@ -3,6 +3,11 @@
 
 #include <Arduino.h>
 #include "../config/config.h"
+#include "iaq_estimator.h"
+#include "speed_filter.h"
+#include "part_flow_monitor.h"
+#include "gesture_classifier.h"
+#include "../utils/energy_model.h"
 
 class SensorManager {
 private:
@@ -23,25 +28,65 @@ private:
   int32_t encoderPosition;
   int32_t baselineEncoderPosition;  // Position at startup (zero speed)
   unsigned long lastEncoderTime;
-  float currentSpeed_rpm;
+  float currentSpeed_rpm;           // Raw encoder speed
+  
+  // Speed estimate fused from encoder and IMU
+  SpeedFilter speedFilter;
+  unsigned long lastSpeedUpdate;
   
   // Part detection
   unsigned long lastPartDetectTime;
   int partCount;
   unsigned long partCountStartTime;
+  uint32_t totalParts;              // Monotonic count since startup
+  uint8_t distanceTimeouts;         // Consecutive ToF read timeouts
+  PartFlowMonitor partFlow;         // Spacing and dwell irregularity (pre-jam)
   
   // Vibration data
   float vibrationBuffer[VIBRATION_SAMPLE_SIZE];
   int vibrationBufferIndex;
   float vibrationMagnitude;
+  float accelMagnitude;             // Latest single accel sample (g)
   
   // Gesture data
   GestureType lastGesture;
   unsigned long lastGestureTime;
+  GestureClassifier gestureClassifier;   // Raw FIFO datasets of the gesture in progress
+  unsigned long lastGestureDrain;        // Last FIFO drain (polls the end of a gesture)
+  unsigned long lastGestureActivity;     // micros() of the last drain with the hand over the sensor
+  unsigned long gestureEndMicros;        // lastGestureActivity of lastGesture
+  uint32_t gestureCounts[GESTURE_WAVE + 1];   // Classified gestures by type (NONE = rejected)
+  uint32_t gesturesDebounced;
+  uint32_t gestureDatasets;              // FIFO datasets drained
+  uint32_t gestureActions;               // Gestures handled by the sketch
+  unsigned long gestureLatencyTotal;     // Gesture end to action (us)
+  unsigned long gestureLatencyMax;
   
   // Current readings
   SensorReadings currentReadings;
   
+  // Air quality index derived from gas resistance
+  IAQEstimator iaqEstimator;
+  
+  // Data quality, set at acquisition
+  uint8_t validMask;
+  unsigned long fieldUpdateTime[FIELD_COUNT];
+  
+  // Power duty-cycling (SENSOR_DUTY_CYCLING)
+  EnergyModel* energyModel;
+  bool envMeasuring;               // BME688 forced measurement in progress
+  unsigned long envStartTime;      // When it was started
+  unsigned long lastEnvReading;    // When the last one was collected
+  unsigned long bmeMeasureMs;      // Measurement duration reported by the library
+  bool tofRanging;                 // VL53L1X ranging (false = standby)
+  unsigned long tofWakeTime;       // Ranging started; first range VL53L1X_WAKE_MS later
+  unsigned long tofStandbyTime;    // Entered standby (schedules check measurements)
+  unsigned long lastRunningTime;   // Last read with the belt above MIN_SPEED_THRESHOLD
+  bool gestureEngineOn;            // APDS9960 gesture engine enabled (false = proximity only)
+  unsigned long gestureWakeTime;
+  unsigned long lastPresenceTime;
+  unsigned long lastProximityRead;
+  
   // Private methods
   bool initializeSeesaw();
   bool initializeBME688();
@@ -49,6 +94,34 @@ private:
   bool initializeLSM9DS1();
   bool initializeAPDS9960();
   
+  /**
+   * @brief Record the outcome of acquiring one field
+   * @param field Field that was read
+   * @param ok true if a good value was stored (refreshes its timestamp)
+   */
+  void markField(SensorField field, bool ok);
+  
+  /**
+   * @brief Store a completed BME688 measurement and feed the IAQ estimator
+   */
+  void storeEnvironmental();
+  
+  /**
+   * @brief Report a sensor power state change to the energy model (if any)
+   */
+  void setPower(EnergyConsumer consumer, PowerState state);
+  
+  /**
+   * @brief Start or stop VL53L1X ranging
+   */
+  void wakeRanging(unsigned long now);
+  void standbyRanging(unsigned long now);
+  
+  /**
+   * @brief Enable the gesture engine while an operator is near, disable it after GESTURE_IDLE_MS
+   */
+  void updateGesturePower(unsigned long now);
+  
   /**
    * @brief Helper method for consistent sensor initialization handling
    * @param initFunc Pointer to sensor-specific initialization function
@@ -67,6 +140,7 @@ private:
   void readGesture();
   
   void calculateVibration();
+  void updateSpeedEstimate();
   void updatePartCount();
   
   // Virtual sensor data generation
@@ -84,10 +158,11 @@ public:
   
   /**
    * @brief Initialize all I2C sensors and configure hardware
+   * @param energy Energy model told about sensor power state changes (may be nullptr)
    * @return true if all sensors initialized successfully, false if any failed
    * @note In virtual sensor mode, always returns true even if physical sensors fail
    */
-  bool begin();
+  bool begin(EnergyModel* energy);
   
   /**
    * @brief Read all sensor data and update internal state
@@ -97,14 +172,37 @@ public:
    *          - VL53L1X ToF distance sensor
    *          - LSM9DS1 IMU for vibration analysis
    *          - APDS9960 gesture and proximity sensor
+   *          With SENSOR_DUTY_CYCLING the BME688 sleeps between forced
+   *          measurements timed to finish every ENV_READ_INTERVAL, the
+   *          VL53L1X stands by while the belt is stopped, and the APDS9960
+   *          gesture engine only runs while an operator is near.
    */
   void readAll();
   
   /**
    * @brief Get current conveyor speed in RPM
-   * @return Speed in RPM (0-100), calculated from encoder position offset
+   * @return Speed in RPM (0-100): the encoder position offset, filtered with
+   *         the IMU motion cue unless SPEED_FILTER_ENABLED is false
+   */
+  float getConveyorSpeed() const { return SPEED_FILTER_ENABLED ? speedFilter.getSpeed() : currentSpeed_rpm; }
+  
+  /**
+   * @brief Get the unfiltered encoder speed
+   * @return Speed in RPM, whole detents
    */
-  float getConveyorSpeed() const { return currentSpeed_rpm; }
+  float getEncoderSpeed() const { return currentSpeed_rpm; }
+  
+  /**
+   * @brief Get the uncertainty of the filtered speed
+   * @return One standard deviation in RPM
+   */
+  float getSpeedUncertainty() const { return speedFilter.getStdDev(); }
+  
+  /**
+   * @brief Get the speed filter for its counters
+   * @return Reference to the SpeedFilter
+   */
+  const SpeedFilter& getSpeedFilter() const { return speedFilter; }
   
   /**
    * @brief Get parts per minute count based on object detection
@@ -112,6 +210,24 @@ public:
    */
   int getPartsCount() const;
   
+  /**
+   * @brief Get total parts detected since startup
+   * @return Monotonic part count (never reset by the per-minute rate window)
+   */
+  uint32_t getTotalParts() const { return totalParts; }
+  
+  /**
+   * @brief Get the part flow irregularity (pre-jam bunching)
+   * @return 0 (regular) - 1 (bunched), see PartFlowMonitor
+   */
+  float getFlowIrregularity() const { return partFlow.getScore(); }
+  
+  /**
+   * @brief Get the part flow model for its measures
+   * @return Reference to the PartFlowMonitor
+   */
+  const PartFlowMonitor& getPartFlow() const { return partFlow; }
+  
   /**
    * @brief Get current vibration magnitude from IMU
    * @return RMS vibration magnitude in g-force units
@@ -142,6 +258,24 @@ public:
    */
   uint32_t getAirQuality() const { return currentReadings.gasResistance; }
   
+  /**
+   * @brief Get the indoor air quality index
+   * @return 0 (clean) to 500 (very poor), see IAQEstimator
+   */
+  uint16_t getIAQ() const { return iaqEstimator.getIAQ(); }
+  
+  /**
+   * @brief Get the confidence in the IAQ index
+   * @return IAQAccuracy, unreliable during heater burn-in
+   */
+  IAQAccuracy getIAQAccuracy() const { return iaqEstimator.getAccuracy(); }
+  
+  /**
+   * @brief Get the IAQ estimator for baseline details
+   * @return Reference to the IAQEstimator
+   */
+  const IAQEstimator& getIAQEstimator() const { return iaqEstimator; }
+  
   /**
    * @brief Check if operator is present near the system
    * @return true if APDS9960 proximity sensor detects presence (>10 units)
@@ -154,12 +288,49 @@ public:
    */
   GestureType getLastGesture() const { return lastGesture; }
   
+  /**
+   * @brief Check whether the gesture FIFO needs draining
+   * @return true after an APDS9960 interrupt, or every GESTURE_POLL_MS while a
+   *         gesture is in progress (its last datasets stay below the FIFO threshold)
+   */
+  bool gesturePending() const;
+  
+  /**
+   * @brief Drain the APDS9960 gesture FIFO and classify the gesture once it ends
+   * @details Burst-reads GESTURE_FIFO_BURST datasets per I2C transfer and feeds
+   *          them to the GestureClassifier; a gesture is published through
+   *          getLastGesture() when the engine leaves gesture mode. Never waits.
+   */
+  void serviceGesture();
+  
+  /**
+   * @brief Record that the sketch acted on getLastGesture() (latency statistics)
+   */
+  void recordGestureAction();
+  
+  /**
+   * @brief Print gesture counts, FIFO use and gesture-to-action latency to Serial
+   */
+  void printGestureStats() const;
+  
   /**
    * @brief Get complete raw sensor readings structure
    * @return Reference to SensorReadings with all current sensor values
    */
   const SensorReadings& getRawReadings() const { return currentReadings; }
   
+  /**
+   * @brief Get fields whose current value came from a good reading
+   * @return FIELD_BIT mask (invalid values are never stored, the last good one is kept)
+   */
+  uint8_t getValidMask() const { return validMask; }
+  
+  /**
+   * @brief Get fields not refreshed within their stale window
+   * @return FIELD_BIT mask (MOTION_STALE_MS / ENV_STALE_MS)
+   */
+  uint8_t getStaleMask() const;
+  
   /**
    * @brief Clear the last detected gesture (mark as processed)
    */
@@ -171,6 +342,14 @@ public:
    * @details Validates sensor availability and logs any communication errors
    */
   bool checkSensorHealth() const;
+  
+  /**
+   * @brief Check whether the speed/part sensors can be trusted right now
+   * @return true if the ToF sensor keeps timing out, or a motion sensor is
+   *         missing with no virtual fallback
+   * @details Cheap enough to call on every sensor read (no logging)
+   */
+  bool hasMotionSensorFault() const;
 };
 
 
@@ -0,0 +1,66 @@
+#include "speed_filter.h"
+
+SpeedFilter::SpeedFilter() {
+  updates = 0;
+  rejected = 0;
+  begin();
+}
+
+void SpeedFilter::begin() {
+  speed = 0.0f;
+  rate = 0.0f;
+  p00 = SPEED_INITIAL_VARIANCE;
+  p01 = 0.0f;
+  p11 = SPEED_INITIAL_VARIANCE;
+  motionAverage = 0.0f;
+  motionRpm = 0.0f;
+  initialized = false;
+}
+
+void SpeedFilter::update(float encoderRpm, float accelMagnitude, float dtSeconds) {
+  updates++;
+  if (!initialized) {
+    speed = encoderRpm;
+    rate = 0.0f;
+    p00 = SPEED_ENCODER_VARIANCE;
+    motionAverage = accelMagnitude;
+    initialized = true;
+    return;
+  }
+
+  // Motion cue: how far the accel magnitude moved off its recent level
+  float accelChange = fabsf(accelMagnitude - motionAverage);
+  motionAverage += SPEED_MOTION_SMOOTHING * (accelMagnitude - motionAverage);
+  motionRpm = max(accelChange - SPEED_MOTION_DEADBAND_G, 0.0f) * SPEED_MOTION_RPM_PER_G;
+
+  // Predict: x = F x, P = F P F' + Q (white jerk, plus the cue on speed)
+  float dt = dtSeconds;
+  float q = SPEED_PROCESS_NOISE;
+  speed += rate * dt;
+  p00 += dt * (2.0f * p01 + dt * p11) + q * dt * dt * dt / 3.0f + motionRpm * motionRpm;
+  p01 += dt * p11 + q * dt * dt / 2.0f;
+  p11 += q * dt;
+
+  // Correct with the encoder (H = [1 0])
+  float innovation = encoderRpm - speed;
+  float innovationVariance = p00 + SPEED_ENCODER_VARIANCE;
+  if (innovation * innovation > SPEED_GATE_SIGMA * SPEED_GATE_SIGMA * innovationVariance) {
+    // Unexplained jump: widen the estimate so the next read decides
+    rejected++;
+    p00 += innovation * innovation;
+    return;
+  }
+
+  float k0 = p00 / innovationVariance;
+  float k1 = p01 / innovationVariance;
+  speed += k0 * innovation;
+  rate += k1 * innovation;
+  p11 -= k1 * p01;
+  p01 -= k0 * p01;
+  p00 -= k0 * p00;
+
+  if (speed < 0.0f) {
+    speed = 0.0f;
+    rate = max(rate, 0.0f);
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef SPEED_FILTER_H
+#define SPEED_FILTER_H
+
+#include <Arduino.h>
+#include "../config/sensor_config.h"
+
+/**
+ * @brief Belt speed from the encoder, smoothed by a Kalman filter steered by the IMU
+ *
+ * State: speed and its rate of change (RPM, RPM/s), with a 2x2 covariance.
+ * Each read predicts with x' = F x, F = [1 dt; 0 1], and white jerk of
+ * density q as process noise, then corrects with the encoder speed
+ * (variance SPEED_ENCODER_VARIANCE). Constant time, fixed size.
+ *
+ * The IMU supplies the motion cue: the change of the accel magnitude
+ * against its short average. Frame vibration grows roughly with belt
+ * speed, so a change beyond SPEED_MOTION_DEADBAND_G is taken as a speed
+ * change of SPEED_MOTION_RPM_PER_G per g and added to the speed variance.
+ * In steady running the cue is silent and the quantisation noise is
+ * averaged out; when the belt starts or stops the gain goes to ~1 and the
+ * encoder is followed with no lag.
+ *
+ * Encoder readings more than SPEED_GATE_SIGMA standard deviations from the
+ * prediction without a motion cue to explain them are held back: the
+ * covariance is widened instead, so a glitch is skipped and a real change
+ * (confirmed by the next read) costs one read of latency.
+ */
+class SpeedFilter {
+private:
+  float speed;            // RPM
+  float rate;             // RPM per second
+  float p00, p01, p11;    // Covariance of (speed, rate)
+  float motionAverage;    // Short average of the accel magnitude (g)
+  float motionRpm;        // Speed change the motion cue allowed for in the last update
+  bool initialized;
+  uint32_t updates;
+  uint32_t rejected;
+
+public:
+  /**
+   * @brief Constructor
+   */
+  SpeedFilter();
+
+  /**
+   * @brief Forget the estimate; the next reading initialises it
+   */
+  void begin();
+
+  /**
+   * @brief Predict over dt and correct with one encoder reading
+   * @param encoderRpm Encoder speed (RPM)
+   * @param accelMagnitude Latest accel magnitude (g), the motion cue
+   * @param dtSeconds Time since the previous update
+   */
+  void update(float encoderRpm, float accelMagnitude, float dtSeconds);
+
+  /**
+   * @brief Get the filtered speed
+   * @return RPM, never negative
+   */
+  float getSpeed() const { return speed; }
+
+  /**
+   * @brief Get the speed uncertainty
+   * @return One standard deviation (RPM)
+   */
+  float getStdDev() const { return sqrtf(max(p00, 0.0f)); }
+
+  float getRate() const { return rate; }
+  float getMotionRpm() const { return motionRpm; }
+  uint32_t getUpdates() const { return updates; }
+  uint32_t getRejected() const { return rejected; }
+};
+
+#endif // SPEED_FILTER_H
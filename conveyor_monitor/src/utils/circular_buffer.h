@@ -58,6 +58,24 @@ public:
     return true;
   }
   
+  /**
+   * @brief Add an element only if it is valid, without branching on validity
+   * @param item Element to add
+   * @param valid Non-zero to add the element, zero to leave the buffer unchanged
+   * @details Intended for per-field quality masks: callers pass
+   *          (mask & FIELD_BIT(f)) directly. Always overwrite-mode semantics.
+   */
+  void pushMasked(const T& item, uint32_t valid) {
+    size_t accept = (valid != 0);
+    size_t full = (count == SIZE);
+    
+    // Select instead of branch - an invalid push rewrites the slot unchanged
+    buffer[head] = accept ? item : buffer[head];
+    head = (head + accept) % SIZE;
+    tail = (tail + (accept & full)) % SIZE;
+    count += accept & (full ^ 1);
+  }
+  
   /**
    * @brief Remove and return the oldest element
    * @param item Reference to store the removed element
@@ -0,0 +1,156 @@
+#include "energy_model.h"
+
+namespace {
+
+// Typical currents per state (OFF, STANDBY, ACTIVE)
+const float CURRENT_MA[ENERGY_CONSUMER_COUNT][POWER_STATE_COUNT] = {
+  {0.0f, MCU_SLEEP_MA, MCU_ACTIVE_MA},
+  {0.0f, ENCODER_ACTIVE_MA, ENCODER_ACTIVE_MA},
+  {0.0f, BME688_STANDBY_MA, BME688_ACTIVE_MA},
+  {0.0f, VL53L1X_STANDBY_MA, VL53L1X_ACTIVE_MA},
+  {0.0f, IMU_ACTIVE_MA, IMU_ACTIVE_MA},
+  {0.0f, APDS9960_STANDBY_MA, APDS9960_ACTIVE_MA},
+  {0.0f, NOTECARD_IDLE_MA, NOTECARD_RADIO_MA},
+};
+
+constexpr float MICROS_PER_HOUR = 3.6e9f;
+
+} // namespace
+
+EnergyModel::EnergyModel() {
+  begin();
+}
+
+void EnergyModel::begin() {
+  unsigned long now = micros();
+  for (int i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    state[i] = POWER_OFF;
+    stateSince[i] = now;
+    for (int s = 0; s < POWER_STATE_COUNT; s++) {
+      stateMicros[i][s] = 0;
+    }
+    pulseMicros[i] = 0;
+    wakeups[i] = 0;
+  }
+  radioSeconds = 0;
+}
+
+void EnergyModel::accumulate(EnergyConsumer consumer, unsigned long now) {
+  stateMicros[consumer][state[consumer]] += now - stateSince[consumer];
+  stateSince[consumer] = now;
+}
+
+void EnergyModel::setState(EnergyConsumer consumer, PowerState newState) {
+  if (newState == state[consumer]) {
+    return;
+  }
+  accumulate(consumer, micros());
+  if (newState == POWER_ACTIVE) {
+    wakeups[consumer]++;
+  }
+  state[consumer] = newState;
+}
+
+void EnergyModel::addPulse(EnergyConsumer consumer, uint32_t durationMicros) {
+  pulseMicros[consumer] += durationMicros;
+  wakeups[consumer]++;
+}
+
+void EnergyModel::update() {
+  unsigned long now = micros();
+  for (int i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    accumulate((EnergyConsumer)i, now);
+  }
+}
+
+uint64_t EnergyModel::getStateMicros(EnergyConsumer consumer, PowerState s) const {
+  uint64_t standby = stateMicros[consumer][POWER_STANDBY];
+  uint64_t active = stateMicros[consumer][POWER_ACTIVE];
+
+  // Pulses and radio time happened while the consumer was nominally in standby
+  uint64_t extra = pulseMicros[consumer];
+  if (consumer == ENERGY_NOTECARD) {
+    extra += (uint64_t)radioSeconds * 1000000ULL;
+  }
+  extra = min(extra, standby);
+
+  switch (s) {
+    case POWER_STANDBY: return standby - extra;
+    case POWER_ACTIVE: return active + extra;
+    default: return stateMicros[consumer][s];
+  }
+}
+
+uint64_t EnergyModel::getTotalMicros(EnergyConsumer consumer) const {
+  uint64_t total = 0;
+  for (int s = 0; s < POWER_STATE_COUNT; s++) {
+    total += stateMicros[consumer][s];
+  }
+  return total;
+}
+
+float EnergyModel::getDutyCycle(EnergyConsumer consumer) const {
+  uint64_t total = getTotalMicros(consumer);
+  return total > 0 ? (float)getStateMicros(consumer, POWER_ACTIVE) / (float)total : 0.0f;
+}
+
+float EnergyModel::getChargeMah(EnergyConsumer consumer) const {
+  float charge = 0.0f;
+  for (int s = 0; s < POWER_STATE_COUNT; s++) {
+    charge += (float)getStateMicros(consumer, (PowerState)s) * CURRENT_MA[consumer][s];
+  }
+  return charge / MICROS_PER_HOUR;
+}
+
+float EnergyModel::getTotalChargeMah() const {
+  float charge = 0.0f;
+  for (int i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    charge += getChargeMah((EnergyConsumer)i);
+  }
+  return charge;
+}
+
+float EnergyModel::getAverageCurrentMa(EnergyConsumer consumer) const {
+  uint64_t total = getTotalMicros(consumer);
+  return total > 0 ? getChargeMah(consumer) * MICROS_PER_HOUR / (float)total : 0.0f;
+}
+
+float EnergyModel::getAverageCurrentMa() const {
+  float current = 0.0f;
+  for (int i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    current += getAverageCurrentMa((EnergyConsumer)i);
+  }
+  return current;
+}
+
+void EnergyModel::printStats() const {
+  Serial.print(F("Energy - Avg: "));
+  Serial.print(getAverageCurrentMa());
+  Serial.print(F("mA, Used: "));
+  Serial.print(getTotalChargeMah(), 1);
+  Serial.println(F("mAh"));
+  for (int i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    EnergyConsumer consumer = (EnergyConsumer)i;
+    Serial.print(F("  "));
+    Serial.print(getConsumerName(consumer));
+    Serial.print(F(": "));
+    Serial.print(getAverageCurrentMa(consumer), 3);
+    Serial.print(F("mA, Active: "));
+    Serial.print(getDutyCycle(consumer) * 100.0f, 1);
+    Serial.print(F("%, Wakeups: "));
+    Serial.println(wakeups[i]);
+  }
+}
+
+const char* EnergyModel::getConsumerName(EnergyConsumer consumer) {
+  switch (consumer) {
+    case ENERGY_MCU: return "mcu";
+    case ENERGY_ENCODER: return "encoder";
+    case ENERGY_BME688: return "bme688";
+    case ENERGY_VL53L1X: return "vl53l1x";
+    case ENERGY_IMU: return "imu";
+    case ENERGY_APDS9960: return "apds9960";
+    case ENERGY_NOTECARD: return "notecard";
+    default: return "unknown";
+  }
+}
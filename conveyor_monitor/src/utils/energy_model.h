@@ -0,0 +1,132 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Consumers tracked by the energy model
+ */
+enum EnergyConsumer {
+  ENERGY_MCU = 0,
+  ENERGY_ENCODER,
+  ENERGY_BME688,
+  ENERGY_VL53L1X,
+  ENERGY_IMU,
+  ENERGY_APDS9960,
+  ENERGY_NOTECARD,
+  ENERGY_CONSUMER_COUNT
+};
+
+/**
+ * @brief Power state of one consumer
+ */
+enum PowerState {
+  POWER_OFF = 0,       // Absent, draws nothing
+  POWER_STANDBY,       // Sensor standby, MCU sleep (WFI), Notecard idle
+  POWER_ACTIVE,        // Measuring, MCU running, Notecard radio on
+  POWER_STATE_COUNT
+};
+
+/**
+ * @brief Estimated charge per consumer from time spent in each power state
+ *
+ * Consumers report state changes (setState) or, for sensors that go back to
+ * sleep on their own after a measurement, the length of each active pulse
+ * (addPulse). Time is kept in microseconds per state and multiplied by the
+ * typical currents in system_config.h only when charge is read, so the
+ * currents can be corrected afterwards for a given board.
+ *
+ * The Notecard is the exception: it stays in standby here and the radio-on
+ * estimate from SyncPolicy (setRadioSeconds) is carved out of that time.
+ *
+ * micros() wraps after 71 minutes; update() must run more often than that to
+ * fold long-held states (the health check calls it every 30 seconds).
+ */
+class EnergyModel {
+private:
+  PowerState state[ENERGY_CONSUMER_COUNT];
+  unsigned long stateSince[ENERGY_CONSUMER_COUNT];                  // micros()
+  uint64_t stateMicros[ENERGY_CONSUMER_COUNT][POWER_STATE_COUNT];
+  uint64_t pulseMicros[ENERGY_CONSUMER_COUNT];                      // Active pulses taken out of standby
+  uint32_t wakeups[ENERGY_CONSUMER_COUNT];
+  uint32_t radioSeconds;
+
+  void accumulate(EnergyConsumer consumer, unsigned long now);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  EnergyModel();
+
+  /**
+   * @brief Start accounting now with every consumer off
+   */
+  void begin();
+
+  /**
+   * @brief Record a power state change
+   */
+  void setState(EnergyConsumer consumer, PowerState newState);
+
+  PowerState getState(EnergyConsumer consumer) const { return state[consumer]; }
+
+  /**
+   * @brief Record one active pulse of a consumer that stays in standby
+   * @param durationMicros Time the consumer was active before sleeping again
+   */
+  void addPulse(EnergyConsumer consumer, uint32_t durationMicros);
+
+  /**
+   * @brief Set the Notecard radio-on time so far
+   * @param seconds Radio-on estimate (SyncPolicy::getRadioOnSeconds)
+   */
+  void setRadioSeconds(uint32_t seconds) { radioSeconds = seconds; }
+
+  /**
+   * @brief Fold the time in the current states into the totals
+   */
+  void update();
+
+  /**
+   * @brief Time spent in a state, including pulses and the radio carve-out
+   */
+  uint64_t getStateMicros(EnergyConsumer consumer, PowerState s) const;
+
+  /**
+   * @brief Time accounted since begin()
+   */
+  uint64_t getTotalMicros(EnergyConsumer consumer) const;
+
+  /**
+   * @brief Share of the accounted time spent active (0..1)
+   */
+  float getDutyCycle(EnergyConsumer consumer) const;
+
+  /**
+   * @brief Estimated charge drawn since begin()
+   */
+  float getChargeMah(EnergyConsumer consumer) const;
+  float getTotalChargeMah() const;
+
+  /**
+   * @brief Average current since begin()
+   */
+  float getAverageCurrentMa(EnergyConsumer consumer) const;
+  float getAverageCurrentMa() const;
+
+  uint32_t getWakeups(EnergyConsumer consumer) const { return wakeups[consumer]; }
+
+  /**
+   * @brief Print average current and duty cycle per consumer to Serial
+   */
+  void printStats() const;
+
+  /**
+   * @brief Get human-readable consumer name
+   */
+  static const char* getConsumerName(EnergyConsumer consumer);
+};
+
+#endif // ENERGY_MODEL_H
@@ -1,4 +1,5 @@
 #include "error_handling.h"
+#include "flight_recorder.h"
 
 // Global error handler instance
 ErrorHandler systemErrorHandler;
@@ -28,6 +29,8 @@ const char* ErrorHandler::getErrorString(SystemError error) const {
     case SystemError::TELEMETRY_FORMAT_ERROR: return "Telemetry formatting error";
     case SystemError::BUFFER_OVERFLOW: return "Buffer overflow";
     case SystemError::INVALID_PARAMETER: return "Invalid parameter";
+    case SystemError::TASK_OVERRUN: return "Task overran its time budget";
+    case SystemError::WATCHDOG_RESET: return "Watchdog reset";
     default: return "Unknown error";
   }
 }
@@ -48,12 +51,14 @@ ErrorSeverity getDefaultSeverity(SystemError error) {
       return ErrorSeverity::INFO;
     case SystemError::SENSOR_DATA_INVALID:
     case SystemError::TELEMETRY_FORMAT_ERROR:
+    case SystemError::TASK_OVERRUN:
       return ErrorSeverity::WARNING;
     case SystemError::SENSOR_READ_TIMEOUT:
     case SystemError::I2C_COMMUNICATION_ERROR:
     case SystemError::NOTECARD_SEND_FAILED:
     case SystemError::CONFIG_VALIDATION_ERROR:
     case SystemError::BUFFER_OVERFLOW:
+    case SystemError::WATCHDOG_RESET:
       return ErrorSeverity::ERROR;
     case SystemError::SENSOR_INIT_FAILED:
     case SystemError::MEMORY_ALLOCATION_ERROR:
@@ -70,6 +75,8 @@ void ErrorHandler::logError(SystemError error, const char* context) {
 }
 
 void ErrorHandler::logError(SystemError error, ErrorSeverity severity, const char* context) {
+  flightRecorder.record(FLIGHT_ERROR, (uint8_t)error, (uint8_t)severity);
+  
   // Store in history
   errorHistory[errorHistoryIndex] = error;
   errorTimestamps[errorHistoryIndex] = millis();
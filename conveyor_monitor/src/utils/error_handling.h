@@ -18,7 +18,9 @@ enum class SystemError {
   CONFIG_VALIDATION_ERROR,
   TELEMETRY_FORMAT_ERROR,
   BUFFER_OVERFLOW,
-  INVALID_PARAMETER
+  INVALID_PARAMETER,
+  TASK_OVERRUN,
+  WATCHDOG_RESET
 };
 
 /**
@@ -0,0 +1,238 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Single-precision math for the Cortex-M4F
+ *
+ * The FPU only does float add/multiply/divide/sqrt in hardware. Anything in
+ * double, and libm's sinf/expf/logf, runs as a software routine costing
+ * hundreds of cycles. These replacements stay in float and use only FPU
+ * operations.
+ *
+ * Error bounds are over the documented input range and were measured against
+ * double-precision libm with tools/bench/math_bench:
+ *   - fastSinTurns/fastCosTurns: 1.5e-7 absolute
+ *   - fastSinf/fastCosf: 1.5e-7 absolute + 1.5e-7 x |radians|
+ *   - fastRsqrtf/fastSqrtf: 5e-6 relative (normal positive floats)
+ *   - fastExpf: 3e-7 relative (-87.3 .. 88.3; 0 below, infinity above)
+ *   - fastLogf: 1e-7 absolute + 2.5e-7 relative (normal positive floats)
+ *
+ * sqrtf() itself is one VSQRT instruction on the FPU, so prefer it to
+ * fastSqrtf() on the target; the bit-trick versions are for reciprocal
+ * square roots and for builds without an FPU.
+ */
+
+namespace fast_math_detail {
+
+constexpr int SIN_TABLE_BITS = 8;
+constexpr int SIN_TABLE_SIZE = 1 << SIN_TABLE_BITS;   // Entries per turn
+constexpr double PI_D = 3.14159265358979323846;
+
+// Taylor series evaluated by the compiler; converged for |x| <= pi
+constexpr double taylorSin(double x) {
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 20; n++) {
+    term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+    sum += term;
+  }
+  return sum;
+}
+
+struct SinTable {
+  float values[SIN_TABLE_SIZE];
+
+  constexpr SinTable() : values() {
+    for (int i = 0; i < SIN_TABLE_SIZE; i++) {
+      double angle = 2.0 * PI_D * i / SIN_TABLE_SIZE;
+      if (angle > PI_D) {
+        angle -= 2.0 * PI_D;
+      }
+      values[i] = (float)taylorSin(angle);
+    }
+  }
+};
+
+// Built at compile time, lives in flash
+inline constexpr SinTable SIN_TABLE{};
+
+constexpr float TURN_TO_RAD = (float)(2.0 * PI_D / SIN_TABLE_SIZE);
+constexpr float RAD_TO_TURN = (float)(1.0 / (2.0 * PI_D));
+
+} // namespace fast_math_detail
+
+/**
+ * @brief Round to the nearest integer, halves away from zero (lroundf without libm)
+ * @param x Value within int32_t range
+ */
+inline int32_t roundToInt(float x) {
+  return (int32_t)(x >= 0.0f ? x + 0.5f : x - 0.5f);
+}
+
+/**
+ * @brief Sine of an angle given in turns (1.0 = 360 degrees)
+ *
+ * The nearest of 256 table entries plus sin(a + r) = sin a cos r + cos a sin r,
+ * with |r| <= pi/256 so two-term polynomials for sin r and cos r suffice.
+ * @param turns Angle in turns, |turns| < 8e6
+ */
+inline float fastSinTurns(float turns) {
+  using namespace fast_math_detail;
+  float scaled = turns * SIN_TABLE_SIZE;
+  int32_t k = roundToInt(scaled);
+  float r = (scaled - (float)k) * TURN_TO_RAD;
+  float r2 = r * r;
+  float sinA = SIN_TABLE.values[k & (SIN_TABLE_SIZE - 1)];
+  float cosA = SIN_TABLE.values[(k + SIN_TABLE_SIZE / 4) & (SIN_TABLE_SIZE - 1)];
+  return sinA * (1.0f - 0.5f * r2) + cosA * r * (1.0f - r2 * (1.0f / 6.0f));
+}
+
+/**
+ * @brief Cosine of an angle given in turns (1.0 = 360 degrees)
+ */
+inline float fastCosTurns(float turns) {
+  return fastSinTurns(turns + 0.25f);
+}
+
+/**
+ * @brief Sine in radians; large arguments lose accuracy in the float conversion
+ *
+ * For time-based waves prefer fastSinTurns(periodPhase(t, period)), which
+ * keeps the reduction in integers.
+ */
+inline float fastSinf(float radians) {
+  return fastSinTurns(radians * fast_math_detail::RAD_TO_TURN);
+}
+
+/**
+ * @brief Cosine in radians
+ */
+inline float fastCosf(float radians) {
+  return fastCosTurns(radians * fast_math_detail::RAD_TO_TURN);
+}
+
+/**
+ * @brief Position within a repeating period, in turns (0 .. 1)
+ * @param time Timestamp, e.g. millis()
+ * @param period Period in the same unit
+ */
+inline float periodPhase(uint32_t time, uint32_t period) {
+  return (float)(time % period) / (float)period;
+}
+
+/**
+ * @brief Fast reciprocal square root, 1 / sqrt(x)
+ *
+ * Bit-level first guess (magic constant tuned for the refined result) and two
+ * Newton steps. Max relative error 5e-6; one step alone gives 1.8e-3.
+ * @param x Positive normal float
+ */
+inline float fastRsqrtf(float x) {
+  union {
+    float f;
+    uint32_t i;
+  } conv = {x};
+
+  conv.i = 0x5f375a86 - (conv.i >> 1);
+  float halfX = 0.5f * x;
+  conv.f *= 1.5f - halfX * conv.f * conv.f;
+  conv.f *= 1.5f - halfX * conv.f * conv.f;
+  return conv.f;
+}
+
+/**
+ * @brief Fast floating point square root approximation
+ * @param x Input value
+ * @return Approximate square root (5e-6 relative), 0 for x <= 0
+ */
+inline float fastSqrtf(float x) {
+  if (x <= 0.0f) return 0.0f;
+  return x * fastRsqrtf(x);
+}
+
+/**
+ * @brief Fast e^x
+ *
+ * x = k ln2 + r with |r| <= ln2/2, e^r from a degree-6 polynomial, 2^k
+ * written straight into the exponent bits.
+ * @param x Exponent; saturates to 0 below -87.3 and to infinity above 88.3
+ */
+inline float fastExpf(float x) {
+  if (x < -87.3f) return 0.0f;
+  if (x > 88.3f) return INFINITY;
+
+  int32_t k = roundToInt(x * 1.44269504f);
+  // ln2 split in two so k * 0.693359375 is exact
+  float r = x - (float)k * 0.693359375f + (float)k * 2.12194440e-4f;
+  float p = 1.0f + r * (1.0f + r * (0.5f + r * (1.0f / 6.0f + r * (1.0f / 24.0f +
+            r * (1.0f / 120.0f + r * (1.0f / 720.0f))))));
+
+  union {
+    float f;
+    uint32_t i;
+  } scale;
+  scale.i = (uint32_t)(k + 127) << 23;
+  return p * scale.f;
+}
+
+/**
+ * @brief Fast natural logarithm
+ *
+ * x = m 2^e with m in [sqrt(1/2), sqrt(2)), ln m = 2 atanh(s) with
+ * s = (m - 1) / (m + 1), |s| <= 0.172, from an odd series to s^9.
+ * @param x Positive normal float; returns -infinity for 0 and NaN below
+ */
+inline float fastLogf(float x) {
+  if (x <= 0.0f) return (x == 0.0f) ? -INFINITY : NAN;
+
+  union {
+    float f;
+    uint32_t i;
+  } conv = {x};
+
+  int32_t e = (int32_t)(conv.i >> 23) - 127;
+  conv.i = (conv.i & 0x007FFFFF) | 0x3F800000;
+  float m = conv.f;
+  if (m > 1.41421356f) {
+    m *= 0.5f;
+    e++;
+  }
+
+  float s = (m - 1.0f) / (m + 1.0f);
+  float s2 = s * s;
+  float lnM = 2.0f * s * (1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f +
+              s2 * (1.0f / 7.0f + s2 * (1.0f / 9.0f)))));
+  return lnM + (float)e * 0.693147181f;
+}
+
+/**
+ * @brief Fast integer square root implementation (faster than sqrt for integers)
+ * @param x Input value
+ * @return Integer square root of x
+ */
+inline uint32_t fastSqrt(uint32_t x) {
+  if (x == 0) return 0;
+
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30; // The second-to-top bit is set
+
+  // "bit" starts at the highest power of four <= the argument.
+  while (bit > x) {
+    bit >>= 2;
+  }
+
+  while (bit != 0) {
+    if (x >= result + bit) {
+      x -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+#endif // FAST_MATH_H
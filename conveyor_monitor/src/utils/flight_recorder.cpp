@@ -0,0 +1,252 @@
+#include "flight_recorder.h"
+
+// Global flight recorder instance
+FlightRecorder flightRecorder;
+
+namespace {
+
+constexpr uint32_t RECORD_MAGIC = 0x46524332;   // "FRC2"
+constexpr uint16_t RING_MASK = FLIGHT_RECORDER_EVENTS - 1;
+constexpr uint8_t ARG_ZERO = 0x80;              // Type byte flag: arg omitted
+
+/**
+ * Written as the loop runs and by the HardFault handler, read back after the
+ * reset. Random after power-on, hence the magic and the range checks.
+ */
+struct NoInitRecorder {
+  uint32_t magic;
+  uint16_t head;            // Slot of the next event
+  uint16_t count;           // Valid events
+  uint32_t total;           // Events recorded this run
+  uint8_t frozen;           // FlightFreeze
+  uint32_t timeRefMs;       // millis() of the last card.time sync
+  uint32_t timeRefEpoch;    // Unix time then, 0 if never synced
+  FlightFault fault;
+  FlightEvent events[FLIGHT_RECORDER_EVENTS];
+};
+
+// Left out of .bss so the startup code does not zero it
+NoInitRecorder ring __attribute__((section(".noinit")));
+
+size_t putVarint(uint8_t* out, size_t pos, size_t maxLength, uint32_t value) {
+  do {
+    if (pos >= maxLength) {
+      return 0;
+    }
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    out[pos++] = byte | (value ? 0x80 : 0);
+  } while (value);
+  return pos;
+}
+
+bool getVarint(const uint8_t* in, size_t length, size_t& pos, uint32_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= length) {
+      return false;
+    }
+    uint8_t byte = in[pos++];
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+#if defined(__arm__)
+// HardFault: record the stacked frame and fault registers, then reset
+extern "C" void flightRecorderFault(const uint32_t* frame) {
+  ring.fault.lr = frame[5];
+  ring.fault.pc = frame[6];
+  ring.fault.psr = frame[7];
+  ring.fault.cfsr = SCB->CFSR;
+  ring.fault.hfsr = SCB->HFSR;
+  ring.fault.mmfar = SCB->MMFAR;
+  ring.fault.bfar = SCB->BFAR;
+  ring.frozen = FLIGHT_FROZEN_FAULT;
+  NVIC_SystemReset();
+}
+
+// MemManage, BusFault and UsageFault are not enabled, so they all escalate here
+extern "C" __attribute__((naked)) void HardFault_Handler() {
+  __asm volatile(
+    "tst lr, #4          \n"   // EXC_RETURN bit 2: which stack holds the frame
+    "ite eq              \n"
+    "mrseq r0, msp       \n"
+    "mrsne r0, psp       \n"
+    "b flightRecorderFault \n");
+}
+#endif
+
+FlightRecorder::FlightRecorder() {
+  recording = false;
+  previousValid = false;
+  previousFreeze = FLIGHT_RUNNING;
+  memset(&previousFault, 0, sizeof(previousFault));
+  previousEndMs = 0;
+  previousEndTime = 0;
+  previousTotal = 0;
+  previousEvents = 0;
+  payloadLength = 0;
+}
+
+void FlightRecorder::begin() {
+  previousValid = ring.magic == RECORD_MAGIC && ring.head < FLIGHT_RECORDER_EVENTS &&
+                  ring.count <= FLIGHT_RECORDER_EVENTS && ring.frozen <= FLIGHT_FROZEN_HALT;
+  if (previousValid) {
+    previousFreeze = (FlightFreeze)ring.frozen;
+    previousFault = ring.fault;
+    previousTotal = ring.total;
+    previousEndMs = ring.count > 0 ? ring.events[(ring.head - 1) & RING_MASK].timeMs : 0;
+    if (ring.timeRefEpoch != 0) {
+      previousEndTime = ring.timeRefEpoch + (int32_t)(previousEndMs - ring.timeRefMs) / 1000;
+    }
+    payloadLength = encode(ring.events, ring.head, ring.count, payload, sizeof(payload), previousEvents);
+  }
+
+  memset(&ring, 0, sizeof(ring));
+  ring.magic = RECORD_MAGIC;
+  recording = true;
+  record(FLIGHT_BOOT);
+}
+
+void FlightRecorder::record(FlightEventType type, uint8_t code, uint32_t arg) {
+  if (!recording) {
+    return;
+  }
+  FlightEvent& event = ring.events[ring.head];
+  event.timeMs = millis();
+  event.type = type;
+  event.code = code;
+  event.arg = arg < UINT16_MAX ? (uint16_t)arg : UINT16_MAX;
+  ring.head = (ring.head + 1) & RING_MASK;
+  if (ring.count < FLIGHT_RECORDER_EVENTS) {
+    ring.count++;
+  }
+  ring.total++;
+}
+
+bool FlightRecorder::retract(FlightEventType type, uint8_t code) {
+  if (!recording || ring.count == 0) {
+    return false;
+  }
+  uint16_t last = (ring.head - 1) & RING_MASK;
+  if (ring.events[last].type != type || ring.events[last].code != code) {
+    return false;
+  }
+  ring.head = last;
+  ring.count--;
+  ring.total--;
+  return true;
+}
+
+void FlightRecorder::setTimeReference(uint32_t ms, uint32_t epochSeconds) {
+  ring.timeRefMs = ms;
+  ring.timeRefEpoch = epochSeconds;
+}
+
+void FlightRecorder::freeze(FlightFreeze cause) {
+  ring.frozen = cause;
+  recording = false;
+}
+
+uint32_t FlightRecorder::getTotal() const {
+  return ring.magic == RECORD_MAGIC ? ring.total : 0;
+}
+
+size_t FlightRecorder::encode(const FlightEvent* events, uint16_t head, uint16_t count, uint8_t* out,
+                              size_t maxLength, uint16_t& encoded) {
+  encoded = 0;
+  if (maxLength == 0) {
+    return 0;
+  }
+  size_t length = 0;
+  out[length++] = FLIGHT_FORMAT_VERSION;
+
+  uint32_t newerMs = count > 0 ? events[(head - 1) & RING_MASK].timeMs : 0;
+  for (uint16_t i = 0; i < count; i++) {
+    const FlightEvent& event = events[(head - 1 - i) & RING_MASK];
+    size_t pos = length;
+    if (pos + 2 > maxLength) {
+      break;
+    }
+    out[pos++] = event.type | (event.arg == 0 ? ARG_ZERO : 0);
+    out[pos++] = event.code;
+    pos = putVarint(out, pos, maxLength, newerMs - event.timeMs);
+    if (pos != 0 && event.arg != 0) {
+      pos = putVarint(out, pos, maxLength, event.arg);
+    }
+    if (pos == 0) {
+      break;   // Out of room: older events are dropped
+    }
+    length = pos;
+    newerMs = event.timeMs;
+    encoded++;
+  }
+  return length;
+}
+
+int FlightRecorder::decode(const uint8_t* in, size_t length, uint32_t endMs, FlightEvent* out, int maxEvents) {
+  if (length == 0 || in[0] != FLIGHT_FORMAT_VERSION) {
+    return -1;
+  }
+  size_t pos = 1;
+  int count = 0;
+  uint32_t timeMs = endMs;
+  while (pos < length && count < maxEvents) {
+    if (pos + 2 > length) {
+      return -1;
+    }
+    uint8_t type = in[pos++];
+    uint8_t code = in[pos++];
+    uint32_t delta = 0;
+    uint32_t arg = 0;
+    if (!getVarint(in, length, pos, delta) || (!(type & ARG_ZERO) && !getVarint(in, length, pos, arg))) {
+      return -1;
+    }
+    timeMs -= delta;
+    out[count].timeMs = timeMs;
+    out[count].type = type & ~ARG_ZERO;
+    out[count].code = code;
+    out[count].arg = (uint16_t)arg;
+    count++;
+  }
+  return count;
+}
+
+void FlightRecorder::printStats() const {
+  Serial.print(F("Flight recorder - Events: "));
+  Serial.print(getTotal());
+  Serial.print(F(" ("));
+  Serial.print(min(getTotal(), (uint32_t)FLIGHT_RECORDER_EVENTS));
+  Serial.print(F(" held)"));
+  if (previousValid) {
+    Serial.print(F(", Previous run: "));
+    Serial.print(getFreezeName(previousFreeze));
+    Serial.print(F(", "));
+    Serial.print(previousEvents);
+    Serial.print(F(" events in "));
+    Serial.print((unsigned long)payloadLength);
+    Serial.print(F(" bytes"));
+    if (previousFreeze == FLIGHT_FROZEN_FAULT) {
+      Serial.print(F(", PC 0x"));
+      Serial.print((unsigned long)previousFault.pc, 16);
+      Serial.print(F(", CFSR 0x"));
+      Serial.print((unsigned long)previousFault.cfsr, 16);
+    }
+  }
+  Serial.println();
+}
+
+const char* FlightRecorder::getFreezeName(FlightFreeze freeze) {
+  switch (freeze) {
+    case FLIGHT_RUNNING: return "reset";
+    case FLIGHT_FROZEN_FAULT: return "fault";
+    case FLIGHT_FROZEN_HALT: return "halt";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,190 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Trace event types (code and arg meaning per type)
+ */
+enum FlightEventType : uint8_t {
+  FLIGHT_BOOT = 0,          // First event of a run
+  FLIGHT_TASK_BEGIN,        // code: WatchdogTask
+  FLIGHT_TASK_END,          // code: WatchdogTask, arg: run time (ms)
+  FLIGHT_ERROR,             // code: SystemError, arg: ErrorSeverity
+  FLIGHT_NOTE,              // code: NoteFile, arg: 1 = note queued, 0 = request failed
+  FLIGHT_ALERT,             // code: AlertType, arg: AlertLevel
+  FLIGHT_FEED_WITHHELD,     // code: late WatchdogTask, arg: time since its check-in (ms)
+  FLIGHT_HALT,              // halt(); recording stops after it
+  FLIGHT_EVENT_TYPE_COUNT
+};
+
+/**
+ * @brief Why recording stopped before the reset
+ */
+enum FlightFreeze : uint8_t {
+  FLIGHT_RUNNING = 0,       // Not frozen: watchdog, pin or power reset
+  FLIGHT_FROZEN_FAULT,      // HardFault; registers in FlightFault
+  FLIGHT_FROZEN_HALT        // TaskWatchdog::halt()
+};
+
+/**
+ * @brief One trace event (8 bytes in the ring)
+ */
+struct FlightEvent {
+  uint32_t timeMs;          // millis()
+  uint8_t type;             // FlightEventType
+  uint8_t code;
+  uint16_t arg;             // Saturated at UINT16_MAX
+};
+
+static_assert(sizeof(FlightEvent) == 8, "Flight events must stay 8 bytes");
+
+/**
+ * @brief Cortex-M fault state captured by the HardFault handler
+ */
+struct FlightFault {
+  uint32_t pc;              // Stacked PC: the faulting instruction
+  uint32_t lr;              // Stacked LR: its caller
+  uint32_t psr;
+  uint32_t cfsr;            // SCB configurable fault status (MemManage, BusFault, UsageFault bits)
+  uint32_t hfsr;
+  uint32_t mmfar;           // Valid if CFSR.MMARVALID
+  uint32_t bfar;            // Valid if CFSR.BFARVALID
+};
+
+/**
+ * @brief Ring of trace events in no-init RAM, reported after a crash
+ *
+ * record() stores a fixed 8-byte event in a ring of FLIGHT_RECORDER_EVENTS
+ * slots that the reset does not clear: a few stores and a masked index
+ * update, cheap enough to stay enabled.
+ * The task watchdog, the error handler, the Notecard manager and the alert
+ * handler feed it. Main loop only (not re-entrant); ISRs do not record.
+ *
+ * The HardFault handler copies the fault registers into the same no-init
+ * record, freezes it and resets; halt() freezes it too. A watchdog reset
+ * needs no handler: the ring simply stops where the loop stopped.
+ *
+ * begin() (first thing in setup(), before the watchdog records anything)
+ * compresses the previous run's ring into a payload of at most
+ * FLIGHT_NOTE_BYTES, newest event first, and starts a fresh ring. Format
+ * (FLIGHT_FORMAT_VERSION), per event:
+ *   byte  type | 0x80 if arg is 0
+ *   byte  code
+ *   varint  ms before the previous (newer) event; the newest is relative to end_ms
+ *   varint  arg (omitted if 0)
+ * Varints are little-endian base-128. Events that do not fit are dropped,
+ * oldest first.
+ *
+ * The Notecard manager leaves a millis()/Unix time pair in the record after
+ * every card.time sync, so the previous run's end can be placed in wall time
+ * (end_time) even though its event times are uptime.
+ */
+class FlightRecorder {
+private:
+  bool recording;
+
+  // Previous run, captured by begin()
+  bool previousValid;
+  FlightFreeze previousFreeze;
+  FlightFault previousFault;
+  uint32_t previousEndMs;       // millis() of its newest event
+  uint32_t previousEndTime;     // Unix time of its newest event, 0 if it never synced
+  uint32_t previousTotal;       // Events it recorded (older ones were overwritten)
+  uint16_t previousEvents;      // Events in the payload
+  uint16_t payloadLength;
+  uint8_t payload[FLIGHT_NOTE_BYTES];
+
+public:
+  /**
+   * @brief Constructor (leaves the no-init ring alone)
+   */
+  FlightRecorder();
+
+  /**
+   * @brief Capture the previous run's ring, if valid, and start recording a new one
+   */
+  void begin();
+
+  /**
+   * @brief Append an event (overwrites the oldest when full)
+   */
+  void record(FlightEventType type, uint8_t code = 0, uint32_t arg = 0);
+
+  /**
+   * @brief Remove the newest event if it is this one
+   *
+   * Lets a span that turned out too short to matter (a task run under
+   * FLIGHT_SPAN_MIN_MS with nothing recorded inside) leave no trace instead
+   * of flooding the ring. A task that never ends keeps its begin event.
+   * @return true if it was removed
+   */
+  bool retract(FlightEventType type, uint8_t code);
+
+  /**
+   * @brief Pair a millis() timestamp with Unix time for the crash note's end_time
+   * @param ms millis() timestamp
+   * @param epochSeconds Unix time at ms
+   */
+  void setTimeReference(uint32_t ms, uint32_t epochSeconds);
+
+  /**
+   * @brief Stop recording so the ring survives the coming reset as it is
+   */
+  void freeze(FlightFreeze cause);
+
+  /**
+   * @brief Whether begin() found a ring from the previous run
+   */
+  bool hasPreviousRun() const { return previousValid; }
+
+  FlightFreeze getPreviousFreeze() const { return previousFreeze; }
+  const FlightFault& getPreviousFault() const { return previousFault; }
+  uint32_t getPreviousEndMs() const { return previousEndMs; }
+  uint32_t getPreviousEndTime() const { return previousEndTime; }
+  uint32_t getPreviousTotal() const { return previousTotal; }
+  uint16_t getPreviousEvents() const { return previousEvents; }
+  const uint8_t* getPayload() const { return payload; }
+  size_t getPayloadLength() const { return payloadLength; }
+
+  /**
+   * @brief Events recorded since begin()
+   */
+  uint32_t getTotal() const;
+
+  /**
+   * @brief Compress ring events, newest first, into the payload format
+   * @param ring Ring of FLIGHT_RECORDER_EVENTS slots
+   * @param head Slot after the newest event
+   * @param count Valid events in the ring
+   * @param out Output buffer
+   * @param maxLength Output buffer size
+   * @param encoded Set to the number of events written
+   * @return Bytes written
+   */
+  static size_t encode(const FlightEvent* ring, uint16_t head, uint16_t count, uint8_t* out, size_t maxLength,
+                       uint16_t& encoded);
+
+  /**
+   * @brief Expand a payload back into events, newest first
+   * @param endMs Time of the newest event (end_ms of the crash note)
+   * @return Events decoded, or -1 if the payload is malformed
+   */
+  static int decode(const uint8_t* in, size_t length, uint32_t endMs, FlightEvent* out, int maxEvents);
+
+  /**
+   * @brief Print event counts and the previous run summary to Serial
+   */
+  void printStats() const;
+
+  /**
+   * @brief Get human-readable freeze cause name
+   */
+  static const char* getFreezeName(FlightFreeze freeze);
+};
+
+// Global flight recorder instance
+extern FlightRecorder flightRecorder;
+
+#endif // FLIGHT_RECORDER_H
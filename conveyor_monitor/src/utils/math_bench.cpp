@@ -0,0 +1,80 @@
+#include "math_bench.h"
+#include "fast_math.h"
+
+#if defined(__arm__)
+
+namespace {
+
+constexpr int BENCH_INPUTS = 256;
+constexpr int BENCH_ROUNDS = 4;
+
+float inputs[BENCH_INPUTS];
+volatile float sink;   // Keeps the results alive
+
+void fillInputs(float lo, float hi, bool logSpaced) {
+  for (int i = 0; i < BENCH_INPUTS; i++) {
+    float f = (float)i / (BENCH_INPUTS - 1);
+    inputs[i] = logSpaced ? lo * powf(hi / lo, f) : lo + (hi - lo) * f;
+  }
+}
+
+// Average cycles per call over the inputs, less the loop overhead
+template<class F>
+float cyclesPerCall(F f, float overhead) {
+  float acc = 0.0f;
+  noInterrupts();
+  uint32_t start = DWT->CYCCNT;
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    for (int i = 0; i < BENCH_INPUTS; i++) {
+      acc += f(inputs[i]);
+    }
+  }
+  uint32_t elapsed = DWT->CYCCNT - start;
+  interrupts();
+  sink = acc;
+  return (float)elapsed / (BENCH_ROUNDS * BENCH_INPUTS) - overhead;
+}
+
+template<class Fast, class Libm>
+void benchRow(const char* name, float lo, float hi, bool logSpaced, Fast fast, Libm libm) {
+  fillInputs(lo, hi, logSpaced);
+  float overhead = cyclesPerCall([](float x) { return x; }, 0.0f);
+  float fastCycles = cyclesPerCall(fast, overhead);
+  float libmCycles = cyclesPerCall(libm, overhead);
+
+  Serial.print(F("  "));
+  Serial.print(name);
+  Serial.print(F(": "));
+  Serial.print(fastCycles, 1);
+  Serial.print(F(" vs "));
+  Serial.print(libmCycles, 1);
+  Serial.print(F(" libm ("));
+  Serial.print(fastCycles > 0.0f ? libmCycles / fastCycles : 0.0f, 1);
+  Serial.println(F("x)"));
+}
+
+} // namespace
+
+void runMathBench() {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  Serial.println(F("Math bench (cycles/call):"));
+  benchRow("sinTurns", -1.0f, 1.0f, false, fastSinTurns,
+           [](float t) { return sinf(t * 6.28318531f); });
+  benchRow("sinf", -10.0f, 10.0f, false, fastSinf, [](float x) { return sinf(x); });
+  benchRow("cosf", -10.0f, 10.0f, false, fastCosf, [](float x) { return cosf(x); });
+  benchRow("expf", -20.0f, 20.0f, false, fastExpf, [](float x) { return expf(x); });
+  benchRow("logf", 1e-3f, 1e6f, true, fastLogf, [](float x) { return logf(x); });
+  benchRow("rsqrtf", 1e-3f, 1e6f, true, fastRsqrtf, [](float x) { return 1.0f / sqrtf(x); });
+  benchRow("sqrtf", 1e-3f, 1e6f, true, fastSqrtf, [](float x) { return sqrtf(x); });
+}
+
+#else
+
+void runMathBench() {
+  Serial.println(F("Math bench: needs the DWT cycle counter (Cortex-M)"));
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef MATH_BENCH_H
+#define MATH_BENCH_H
+
+#include <Arduino.h>
+
+/**
+ * @brief On-target cycle counts of utils/fast_math.h against libm
+ *
+ * tools/bench/math_bench checks accuracy, but its timings come from a host
+ * with double-precision hardware and a different libm. This runs the same
+ * functions on the device and prints the cycles per call of each fast
+ * version and of the libm call it replaces, counted with the DWT cycle
+ * counter (CYCCNT) and interrupts off. The loop's own cost is subtracted.
+ *
+ * Called from setup() when MATH_BENCH_AT_BOOT is set. Host builds have no
+ * cycle counter and only print a note.
+ */
+void runMathBench();
+
+#endif // MATH_BENCH_H
@@ -0,0 +1,100 @@
+#include "p2_quantile.h"
+#include "fast_math.h"
+
+P2Quantile::P2Quantile(float q) {
+  reset(q);
+}
+
+void P2Quantile::reset(float q) {
+  quantile = constrain(q, 0.0f, 1.0f);
+  count = 0;
+  for (int i = 0; i < 5; i++) {
+    heights[i] = 0.0f;
+    positions[i] = (float)(i + 1);
+  }
+  desired[0] = 1.0f;
+  desired[1] = 1.0f + 2.0f * quantile;
+  desired[2] = 1.0f + 4.0f * quantile;
+  desired[3] = 3.0f + 2.0f * quantile;
+  desired[4] = 5.0f;
+  increments[0] = 0.0f;
+  increments[1] = quantile / 2.0f;
+  increments[2] = quantile;
+  increments[3] = (1.0f + quantile) / 2.0f;
+  increments[4] = 1.0f;
+}
+
+void P2Quantile::add(float x) {
+  // The first five samples become the markers, kept sorted
+  if (count < 5) {
+    int i = count++;
+    while (i > 0 && heights[i - 1] > x) {
+      heights[i] = heights[i - 1];
+      i--;
+    }
+    heights[i] = x;
+    return;
+  }
+  count++;
+
+  // Find the cell holding x, stretching the extremes if needed
+  int k;
+  if (x < heights[0]) {
+    heights[0] = x;
+    k = 0;
+  } else if (x >= heights[4]) {
+    heights[4] = x;
+    k = 3;
+  } else {
+    k = 0;
+    while (k < 3 && x >= heights[k + 1]) {
+      k++;
+    }
+  }
+  for (int i = k + 1; i < 5; i++) {
+    positions[i] += 1.0f;
+  }
+  for (int i = 0; i < 5; i++) {
+    desired[i] += increments[i];
+  }
+
+  // Nudge the three middle markers towards their desired positions
+  for (int i = 1; i <= 3; i++) {
+    float d = desired[i] - positions[i];
+    if ((d >= 1.0f && positions[i + 1] - positions[i] > 1.0f) ||
+        (d <= -1.0f && positions[i - 1] - positions[i] < -1.0f)) {
+      int step = (d >= 0.0f) ? 1 : -1;
+      float h = parabolic(i, (float)step);
+      if (heights[i - 1] < h && h < heights[i + 1]) {
+        heights[i] = h;
+      } else {
+        heights[i] = linear(i, step);
+      }
+      positions[i] += (float)step;
+    }
+  }
+}
+
+float P2Quantile::parabolic(int i, float d) const {
+  float span = positions[i + 1] - positions[i - 1];
+  float upper = (positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) /
+                (positions[i + 1] - positions[i]);
+  float lower = (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) /
+                (positions[i] - positions[i - 1]);
+  return heights[i] + d / span * (upper + lower);
+}
+
+float P2Quantile::linear(int i, int d) const {
+  return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
+
+float P2Quantile::getValue() const {
+  if (count == 0) {
+    return 0.0f;
+  }
+  if (count < 5) {
+    int index = roundToInt(quantile * (count - 1));
+    return heights[index];
+  }
+  return heights[2];
+}
@@ -0,0 +1,55 @@
+#ifndef P2_QUANTILE_H
+#define P2_QUANTILE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Streaming quantile estimate without storing the samples (P-square)
+ *
+ * Jain & Chlamtac's P² algorithm keeps five markers - the minimum, the
+ * maximum, the target quantile and two halfway points - and moves them with
+ * a piecewise-parabolic fit as samples arrive. Memory and time per sample
+ * are constant; accuracy is typically within a few percent of the sorted
+ * quantile after a few hundred samples.
+ */
+class P2Quantile {
+private:
+  float quantile;
+  float heights[5];
+  float positions[5];
+  float desired[5];
+  float increments[5];
+  uint32_t count;
+
+  float parabolic(int i, float d) const;
+  float linear(int i, int d) const;
+
+public:
+  /**
+   * @brief Constructor
+   * @param q Quantile to track (0..1)
+   */
+  explicit P2Quantile(float q = 0.5f);
+
+  /**
+   * @brief Forget all samples and track a (new) quantile
+   * @param q Quantile to track (0..1)
+   */
+  void reset(float q);
+
+  /**
+   * @brief Add a sample
+   */
+  void add(float x);
+
+  /**
+   * @brief Get the current estimate
+   * @return Estimated quantile; the nearest stored sample before 5 samples, 0 when empty
+   */
+  float getValue() const;
+
+  uint32_t getCount() const { return count; }
+  float getQuantile() const { return quantile; }
+};
+
+#endif // P2_QUANTILE_H
@@ -3,4 +3,7 @@
 // Global performance timers
 PerformanceTimer sensorReadTimer;
 PerformanceTimer dataProcessTimer;
-PerformanceTimer telemetryTimer;
\ No newline at end of file
+PerformanceTimer telemetryTimer;
+PerformanceTimer spcTimer;
+PerformanceTimer gestureTimer;
+PerformanceTimer sampleTimer;
\ No newline at end of file
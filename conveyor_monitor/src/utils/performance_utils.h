@@ -2,6 +2,7 @@
 #define PERFORMANCE_UTILS_H
 
 #include <Arduino.h>
+#include "fast_math.h"
 
 /**
  * @brief Performance optimization utilities for embedded systems
@@ -10,54 +11,6 @@
  * and memory management utilities specifically designed for microcontrollers.
  */
 
-/**
- * @brief Fast integer square root implementation (faster than sqrt for integers)
- * @param x Input value
- * @return Integer square root of x
- */
-inline uint32_t fastSqrt(uint32_t x) {
-  if (x == 0) return 0;
-  
-  uint32_t result = 0;
-  uint32_t bit = 1UL << 30; // The second-to-top bit is set
-  
-  // "bit" starts at the highest power of four <= the argument.
-  while (bit > x) {
-    bit >>= 2;
-  }
-  
-  while (bit != 0) {
-    if (x >= result + bit) {
-      x -= result + bit;
-      result = (result >> 1) + bit;
-    } else {
-      result >>= 1;
-    }
-    bit >>= 2;
-  }
-  return result;
-}
-
-/**
- * @brief Fast floating point square root approximation
- * @param x Input value
- * @return Approximate square root (good for ~4-5 decimal places)
- */
-inline float fastSqrtf(float x) {
-  if (x <= 0.0f) return 0.0f;
-  
-  // Fast inverse square root (Quake algorithm variant)
-  union {
-    float f;
-    uint32_t i;
-  } conv = {x};
-  
-  conv.i = 0x5f3759df - (conv.i >> 1);
-  conv.f *= 1.5f - (x * 0.5f * conv.f * conv.f);
-  
-  return x * conv.f; // Multiply by original to get sqrt instead of inverse sqrt
-}
-
 /**
  * @brief Stack-based memory pool for temporary allocations
  * @tparam SIZE Size of the memory pool in bytes
@@ -218,6 +171,17 @@ public:
     return *this;
   }
   
+  /**
+   * @brief Append a signed integer
+   */
+  FastStringBuilder& appendInt(int32_t value) {
+    if (value < 0) {
+      append("-");
+      return appendUInt(static_cast<uint32_t>(-(int64_t)value));
+    }
+    return appendUInt(static_cast<uint32_t>(value));
+  }
+  
   /**
    * @brief Append a boolean value
    */
@@ -308,10 +272,63 @@ public:
   }
 };
 
+/**
+ * @brief Derived value computed lazily, at most once per input epoch
+ *
+ * The owner keeps an epoch counter and bumps it whenever the inputs change
+ * (a new sample, new thresholds). get() computes on the first read of an
+ * epoch and returns the stored value for every further read in it.
+ * Declare as mutable to fill it from const getters.
+ * @tparam T Value type (copyable)
+ */
+template<typename T>
+class EpochCache {
+private:
+  T value;
+  uint32_t epoch;
+  bool valid;
+  uint32_t hits;
+  uint32_t misses;
+
+public:
+  EpochCache() : value(), epoch(0), valid(false), hits(0), misses(0) {}
+
+  /**
+   * @brief Get the value for an epoch
+   * @param currentEpoch Owner's input epoch
+   * @param compute Callable returning T, run only if the epoch changed
+   */
+  template<typename Compute>
+  const T& get(uint32_t currentEpoch, Compute compute) {
+    if (valid && epoch == currentEpoch) {
+      hits++;
+      return value;
+    }
+    value = compute();
+    epoch = currentEpoch;
+    valid = true;
+    misses++;
+    return value;
+  }
+
+  /**
+   * @brief Drop the value (the next get() computes it)
+   */
+  void invalidate() {
+    valid = false;
+  }
+
+  uint32_t getHits() const { return hits; }
+  uint32_t getMisses() const { return misses; }
+};
+
 // Global performance timers for key functions
 extern PerformanceTimer sensorReadTimer;
 extern PerformanceTimer dataProcessTimer;
 extern PerformanceTimer telemetryTimer;
+extern PerformanceTimer spcTimer;
+extern PerformanceTimer gestureTimer;
+extern PerformanceTimer sampleTimer;
 
 // Macro for automatic performance timing
 #define PERF_TIME(timer, code) do { \
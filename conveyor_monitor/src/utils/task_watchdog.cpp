@@ -0,0 +1,282 @@
+#include "task_watchdog.h"
+#include <IWatchdog.h>
+#include "error_handling.h"
+#include "flight_recorder.h"
+
+namespace {
+
+struct TaskBudget {
+  unsigned long runMs;        // Longest single run before it counts as an overrun
+  unsigned long deadlineMs;   // Longest gap between completions (0 = not periodic)
+};
+
+const TaskBudget TASK_BUDGETS[WDT_TASK_COUNT] = {
+  {WDT_SETUP_BUDGET_MS, 0},
+  {WDT_SENSOR_READ_BUDGET_MS, WDT_CHECKIN_DEADLINE_MS},
+  {WDT_PROCESSING_BUDGET_MS, WDT_CHECKIN_DEADLINE_MS},
+  {WDT_SYNC_BUDGET_MS, WDT_SYNC_DEADLINE_MS},
+  {WDT_HEALTH_BUDGET_MS, WDT_HEALTH_DEADLINE_MS},
+  {WDT_GESTURE_BUDGET_MS, 0},
+  {WDT_HOUSEKEEPING_BUDGET_MS, WDT_CHECKIN_DEADLINE_MS},
+};
+
+constexpr uint32_t RECORD_MAGIC = 0x57445433;   // "WDT3"
+constexpr size_t HALT_REASON_LENGTH = sizeof(WatchdogReport::haltReason);
+
+/**
+ * Written as the loop runs, read back after the reset. Random after power-on,
+ * hence the magic and the range checks on the task IDs.
+ */
+struct NoInitRecord {
+  uint32_t magic;
+  uint32_t resets;
+  uint8_t activeTask;
+  uint8_t lateTask;
+  uint8_t halted;
+  uint32_t activeSince;
+  uint32_t lastFeed;
+  uint32_t lateMs;
+  uint16_t overruns[WDT_TASK_COUNT];
+  uint32_t worstMs[WDT_TASK_COUNT];
+  char haltReason[HALT_REASON_LENGTH];
+};
+
+// Left out of .bss so the startup code does not zero it
+NoInitRecord record __attribute__((section(".noinit")));
+
+uint8_t validTask(uint8_t task) {
+  return task < WDT_TASK_COUNT ? task : (uint8_t)WDT_TASK_NONE;
+}
+
+} // namespace
+
+TaskWatchdog::TaskWatchdog() {
+  memset(&lastBoot, 0, sizeof(lastBoot));
+  lastBoot.cause = WDT_RESET_NONE;
+  lastBoot.task = WDT_TASK_NONE;
+  for (int i = 0; i < WDT_TASK_COUNT; i++) {
+    taskStart[i] = 0;
+    lastCheckIn[i] = 0;
+  }
+  overrunsSinceBoot = 0;
+  slowestTask = WDT_TASK_NONE;
+  slowestMs = 0;
+  monitoring = false;
+}
+
+void TaskWatchdog::begin() {
+  bool watchdogReset = IWatchdog.isReset(true);
+
+  if (record.magic == RECORD_MAGIC) {
+    lastBoot.resets = record.resets;
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+      lastBoot.overruns[i] = record.overruns[i];
+      lastBoot.worstMs[i] = record.worstMs[i];
+    }
+
+    if (watchdogReset) {
+      lastBoot.resets++;
+      // The IWDG fired WATCHDOG_TIMEOUT_MS after the last feed
+      uint32_t resetAt = record.lastFeed + WATCHDOG_TIMEOUT_MS;
+      if (record.halted) {
+        lastBoot.cause = WDT_RESET_HALT;
+        lastBoot.task = validTask(record.activeTask);
+        lastBoot.stuckMs = resetAt - record.activeSince;
+      } else if (validTask(record.lateTask) != WDT_TASK_NONE) {
+        lastBoot.cause = WDT_RESET_DEADLINE;
+        lastBoot.task = record.lateTask;
+        lastBoot.stuckMs = record.lateMs + WATCHDOG_TIMEOUT_MS;
+      } else {
+        lastBoot.cause = WDT_RESET_HANG;
+        lastBoot.task = validTask(record.activeTask);
+        lastBoot.stuckMs = lastBoot.task != WDT_TASK_NONE ? resetAt - record.activeSince : WATCHDOG_TIMEOUT_MS;
+      }
+      if (record.halted) {
+        memcpy(lastBoot.haltReason, record.haltReason, HALT_REASON_LENGTH);
+        lastBoot.haltReason[HALT_REASON_LENGTH - 1] = '\0';
+      }
+      LOG_ERROR_CTX(SystemError::WATCHDOG_RESET, getTaskName(lastBoot.task));
+    }
+  }
+
+  // Start a fresh record; only the reset count carries over
+  memset(&record, 0, sizeof(record));
+  record.magic = RECORD_MAGIC;
+  record.resets = lastBoot.resets;
+  record.activeTask = WDT_TASK_NONE;
+  record.lateTask = WDT_TASK_NONE;
+
+  if (WATCHDOG_ENABLED) {
+    IWatchdog.begin(WATCHDOG_TIMEOUT_MS * 1000UL);
+  }
+  record.lastFeed = millis();
+  beginTask(WDT_TASK_SETUP);
+}
+
+void TaskWatchdog::beginTask(WatchdogTask task) {
+  unsigned long now = millis();
+  taskStart[task] = now;
+  record.activeTask = task;
+  record.activeSince = now;
+  flightRecorder.record(FLIGHT_TASK_BEGIN, task);
+}
+
+void TaskWatchdog::endTask(WatchdogTask task) {
+  unsigned long now = millis();
+  uint32_t duration = now - taskStart[task];
+  lastCheckIn[task] = now;
+  record.activeTask = WDT_TASK_NONE;
+  if (duration >= FLIGHT_SPAN_MIN_MS || !flightRecorder.retract(FLIGHT_TASK_BEGIN, task)) {
+    flightRecorder.record(FLIGHT_TASK_END, task, duration);
+  }
+
+  if (duration > TASK_BUDGETS[task].runMs) {
+    recordOverrun(task, duration);
+  }
+
+  if (task == WDT_TASK_SETUP) {
+    // Loop deadlines count from here
+    for (int i = 0; i < WDT_TASK_COUNT; i++) {
+      lastCheckIn[i] = now;
+    }
+    monitoring = true;
+  }
+}
+
+void TaskWatchdog::recordOverrun(uint8_t task, uint32_t durationMs) {
+  overrunsSinceBoot++;
+  if (record.overruns[task] < UINT16_MAX) {
+    record.overruns[task]++;
+  }
+  record.worstMs[task] = max(record.worstMs[task], durationMs);
+  if (durationMs > slowestMs) {
+    slowestMs = durationMs;
+    slowestTask = task;
+  }
+
+  LOG_ERROR_CTX(SystemError::TASK_OVERRUN, getTaskName(task));
+  Serial.print(F("Task "));
+  Serial.print(getTaskName(task));
+  Serial.print(F(" took "));
+  Serial.print(durationMs);
+  Serial.print(F("ms (budget "));
+  Serial.print(TASK_BUDGETS[task].runMs);
+  Serial.println(F("ms)"));
+}
+
+uint8_t TaskWatchdog::findLateTask(unsigned long now, uint32_t& lateMs) const {
+  for (int i = 0; i < WDT_TASK_COUNT; i++) {
+    unsigned long deadline = TASK_BUDGETS[i].deadlineMs;
+    if (deadline != 0 && now - lastCheckIn[i] > deadline) {
+      lateMs = now - lastCheckIn[i];
+      return i;
+    }
+  }
+  return WDT_TASK_NONE;
+}
+
+bool TaskWatchdog::feed() {
+  unsigned long now = millis();
+
+  if (monitoring) {
+    uint32_t lateMs = 0;
+    uint8_t late = findLateTask(now, lateMs);
+    if (late != WDT_TASK_NONE) {
+      if (record.lateTask == WDT_TASK_NONE) {
+        flightRecorder.record(FLIGHT_FEED_WITHHELD, late, lateMs);
+        Serial.print(F("Watchdog: "));
+        Serial.print(getTaskName(late));
+        Serial.println(F(" missed its deadline, feed withheld"));
+      }
+      record.lateTask = late;
+      record.lateMs = lateMs;
+      return false;
+    }
+    record.lateTask = WDT_TASK_NONE;
+  }
+
+  if (WATCHDOG_ENABLED) {
+    IWatchdog.reload();
+  }
+  record.lastFeed = now;
+  return true;
+}
+
+void TaskWatchdog::halt(const char* reason) {
+  strncpy(record.haltReason, reason, HALT_REASON_LENGTH - 1);
+  record.haltReason[HALT_REASON_LENGTH - 1] = '\0';
+  record.halted = 1;
+  flightRecorder.record(FLIGHT_HALT);
+  flightRecorder.freeze(FLIGHT_FROZEN_HALT);
+
+  Serial.print(F("HALT: "));
+  Serial.println(reason);
+  if (WATCHDOG_ENABLED) {
+    Serial.println(F("Watchdog will reset the device"));
+  }
+  while (true) {
+    delay(1000); // Not fed from here on
+  }
+}
+
+bool TaskWatchdog::hasBootReport() const {
+  if (lastBoot.cause != WDT_RESET_NONE) {
+    return true;
+  }
+  for (int i = 0; i < WDT_TASK_COUNT; i++) {
+    if (lastBoot.overruns[i] > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskWatchdog::printStats() const {
+  Serial.print(F("Watchdog - "));
+  Serial.print(WATCHDOG_ENABLED ? F("armed") : F("disabled"));
+  Serial.print(F(", Overruns: "));
+  Serial.print(overrunsSinceBoot);
+  if (slowestTask != WDT_TASK_NONE) {
+    Serial.print(F(", Slowest: "));
+    Serial.print(getTaskName(slowestTask));
+    Serial.print(F(" "));
+    Serial.print(slowestMs);
+    Serial.print(F("ms"));
+  }
+  Serial.print(F(", Resets: "));
+  Serial.print(lastBoot.resets);
+  if (lastBoot.cause != WDT_RESET_NONE) {
+    Serial.print(F(", Last: "));
+    Serial.print(getResetCauseName(lastBoot.cause));
+    Serial.print(F(" in "));
+    Serial.print(getTaskName(lastBoot.task));
+    Serial.print(F(" after "));
+    Serial.print(lastBoot.stuckMs);
+    Serial.print(F("ms"));
+  }
+  Serial.println();
+}
+
+const char* TaskWatchdog::getTaskName(uint8_t task) {
+  switch (task) {
+    case WDT_TASK_SETUP: return "setup";
+    case WDT_TASK_SENSOR_READ: return "sensor";
+    case WDT_TASK_PROCESSING: return "processing";
+    case WDT_TASK_CLOUD_SYNC: return "sync";
+    case WDT_TASK_HEALTH: return "health";
+    case WDT_TASK_GESTURE: return "gesture";
+    case WDT_TASK_HOUSEKEEPING: return "housekeeping";
+    case WDT_TASK_NONE: return "loop";
+    default: return "unknown";
+  }
+}
+
+const char* TaskWatchdog::getResetCauseName(WatchdogResetCause cause) {
+  switch (cause) {
+    case WDT_RESET_NONE: return "none";
+    case WDT_RESET_HANG: return "hang";
+    case WDT_RESET_DEADLINE: return "deadline";
+    case WDT_RESET_HALT: return "halt";
+    default: return "unknown";
+  }
+}
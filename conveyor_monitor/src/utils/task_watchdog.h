@@ -0,0 +1,148 @@
+#ifndef TASK_WATCHDOG_H
+#define TASK_WATCHDOG_H
+
+#include <Arduino.h>
+#include "../config/system_config.h"
+
+/**
+ * @brief Stages of the main loop watched by the task watchdog
+ */
+enum WatchdogTask {
+  WDT_TASK_SETUP = 0,       // setup(), fed between stages
+  WDT_TASK_SENSOR_READ,     // readSensors()
+  WDT_TASK_PROCESSING,      // processData() and checkAlerts()
+  WDT_TASK_CLOUD_SYNC,      // syncToCloud()
+  WDT_TASK_HEALTH,          // performHealthCheck()
+  WDT_TASK_GESTURE,         // serviceGesture(), only when the APDS9960 signals
+  WDT_TASK_HOUSEKEEPING,    // Notecard housekeeping and env overrides, every loop
+  WDT_TASK_COUNT,
+  WDT_TASK_NONE = 0xFF      // Between tasks
+};
+
+/**
+ * @brief Why the previous run ended, as far as the watchdog knows
+ */
+enum WatchdogResetCause {
+  WDT_RESET_NONE = 0,       // Power-on or clean reset, nothing to report
+  WDT_RESET_HANG,           // A task never returned
+  WDT_RESET_DEADLINE,       // The loop ran but a task stopped checking in
+  WDT_RESET_HALT            // halt() after a fatal init failure
+};
+
+/**
+ * @brief What the previous run left behind (reported once at boot)
+ */
+struct WatchdogReport {
+  WatchdogResetCause cause;
+  uint8_t task;                         // WDT_TASK_NONE = outside any task
+  uint32_t stuckMs;                     // How long the task had been running (or silent) at reset
+  uint32_t resets;                      // Watchdog resets since power-on
+  uint16_t overruns[WDT_TASK_COUNT];    // Budget overruns per task
+  uint32_t worstMs[WDT_TASK_COUNT];     // Longest run per overrunning task
+  char haltReason[24];                  // halt() message (cause WDT_RESET_HALT)
+};
+
+/**
+ * @brief Independent watchdog fed only while every loop task keeps its budget
+ *
+ * Each stage brackets its work with beginTask()/endTask(). A stage has a
+ * run budget (one call taking longer is an overrun, counted and logged) and
+ * a check-in deadline (the longest it may go without completing). feed() at
+ * the end of each loop reloads the IWDG only while every deadline holds, so
+ * a stuck Wire call or Notecard transaction, or a stage that stopped being
+ * scheduled, resets the MCU WATCHDOG_TIMEOUT_MS later.
+ *
+ * The active task, its start time, the last feed and the overrun counters
+ * live in a record in no-init RAM that the reset does not clear. begin()
+ * turns it into a WatchdogReport for the previous run: which task hung and
+ * for how long, and which stages were slow. Task begin/end, withheld
+ * feeds and halt() also go to the flight recorder.
+ */
+class TaskWatchdog {
+private:
+  WatchdogReport lastBoot;
+  unsigned long taskStart[WDT_TASK_COUNT];
+  unsigned long lastCheckIn[WDT_TASK_COUNT];
+  uint32_t overrunsSinceBoot;
+  uint8_t slowestTask;
+  uint32_t slowestMs;
+  bool monitoring;          // Loop deadlines apply (setup() finished)
+
+  /**
+   * @brief Find a loop task past its check-in deadline
+   * @return Task ID, or WDT_TASK_NONE if all are on time
+   */
+  uint8_t findLateTask(unsigned long now, uint32_t& lateMs) const;
+
+  void recordOverrun(uint8_t task, uint32_t durationMs);
+
+public:
+  /**
+   * @brief Constructor
+   */
+  TaskWatchdog();
+
+  /**
+   * @brief Read the previous run's record, arm the IWDG and enter the setup task
+   *
+   * Call first thing in setup().
+   */
+  void begin();
+
+  /**
+   * @brief Mark the start of a task
+   */
+  void beginTask(WatchdogTask task);
+
+  /**
+   * @brief Mark the end of a task: checks its run budget and counts as a check-in
+   *
+   * Ending WDT_TASK_SETUP starts the loop deadlines.
+   */
+  void endTask(WatchdogTask task);
+
+  /**
+   * @brief Reload the IWDG if every loop task is within its deadline
+   *
+   * Call once per loop (and between the stages of setup()).
+   * @return false if the feed was withheld
+   */
+  bool feed();
+
+  /**
+   * @brief Stop after a fatal error and let the watchdog reset the MCU
+   * @param reason Logged to serial before halting
+   */
+  void halt(const char* reason);
+
+  /**
+   * @brief The previous run's record (cause WDT_RESET_NONE if nothing happened)
+   */
+  const WatchdogReport& getLastBoot() const { return lastBoot; }
+
+  /**
+   * @brief Whether the previous run left anything worth reporting
+   */
+  bool hasBootReport() const;
+
+  uint32_t getOverruns() const { return overrunsSinceBoot; }
+  uint8_t getSlowestTask() const { return slowestTask; }
+  uint32_t getSlowestMs() const { return slowestMs; }
+
+  /**
+   * @brief Print budgets, overruns and the boot report to Serial
+   */
+  void printStats() const;
+
+  /**
+   * @brief Get human-readable task name
+   */
+  static const char* getTaskName(uint8_t task);
+
+  /**
+   * @brief Get human-readable reset cause name
+   */
+  static const char* getResetCauseName(WatchdogResetCause cause);
+};
+
+#endif // TASK_WATCHDOG_H
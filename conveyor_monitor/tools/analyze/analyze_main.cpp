@@ -0,0 +1,263 @@
+/**
+ * Offline analyzer for exported telemetry.qo, events.qo and alerts.qo notes
+ *
+ * Memory-maps Notehub NDJSON exports (or replay harness records), scans them
+ * in parallel with the zero-copy NoteScanner, groups notes by production line
+ * and replays each line's telemetry through the firmware's StatisticalAnalyzer
+ * and AnomalyDetector. Prints one summary row per line comparing the alerts
+ * the devices sent with what the current detector code would raise.
+ *
+ *   analyze export-2026-*.ndjson
+ *   analyze --threads 8 --window 300 --csv lines.csv export.ndjson
+ *
+ * Exit status: 0 = ok, 2 = usage or unreadable input.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "line_backtest.h"
+#include "note_scanner.h"
+#include "parallel_for.h"
+
+#define MIN_CHUNK_BYTES (4u << 20)
+
+struct MappedFile {
+  const char* data;
+  size_t size;
+};
+
+struct Chunk {
+  const char* begin;
+  const char* end;
+  std::unordered_map<std::string_view, std::vector<NoteRecord>> lines;
+};
+
+static bool mapFile(const char* path, MappedFile& file) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+  file.size = (size_t)st.st_size;
+  file.data = nullptr;
+  if (file.size > 0) {
+    void* p = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    // Advice values are not flags; each needs its own call
+    madvise(p, file.size, MADV_SEQUENTIAL);
+    madvise(p, file.size, MADV_WILLNEED);
+    file.data = static_cast<const char*>(p);
+  }
+  close(fd);
+  return true;
+}
+
+// Split a mapping into newline-aligned chunks
+static void splitFile(const MappedFile& file, size_t chunkBytes, std::vector<Chunk>& chunks) {
+  const char* end = file.data + file.size;
+  const char* p = file.data;
+  while (p < end) {
+    const char* cut = (size_t)(end - p) > chunkBytes ? p + chunkBytes : end;
+    if (cut < end) {
+      const char* nl = static_cast<const char*>(memchr(cut, '\n', end - cut));
+      cut = nl ? nl + 1 : end;
+    }
+    Chunk chunk;
+    chunk.begin = p;
+    chunk.end = cut;
+    chunks.push_back(std::move(chunk));
+    p = cut;
+  }
+}
+
+static void scanChunk(Chunk& chunk, NoteScanner& scanner) {
+  const char* p = chunk.begin;
+  NoteRecord record;
+  std::string_view lineId;
+  while (p < chunk.end) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', chunk.end - p));
+    const char* lineEnd = nl ? nl : chunk.end;
+    if (scanner.scan(p, lineEnd, record, lineId)) {
+      chunk.lines[lineId].push_back(record);
+    }
+    p = lineEnd + 1;
+  }
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: analyze [options] FILE.ndjson...\n"
+          "  --threads N   worker threads (default: all cores)\n"
+          "  --window S    seconds between an onset and a recorded alert to count\n"
+          "                as a match (default 120)\n"
+          "  --csv FILE    also write the per-line summary as CSV\n");
+}
+
+int main(int argc, char** argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  double window = 120.0;
+  const char* csvPath = nullptr;
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (arg == "--threads" && hasValue) threads = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--window" && hasValue) window = strtod(argv[++i], nullptr);
+    else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+    else if (arg.size() > 1 && arg[0] == '-') { usage(); return 2; }
+    else paths.push_back(argv[i]);
+  }
+  if (paths.empty()) {
+    usage();
+    return 2;
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  // Map every file and cut it into chunks of roughly equal size
+  std::vector<MappedFile> files(paths.size());
+  size_t totalBytes = 0;
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (!mapFile(paths[i], files[i])) {
+      fprintf(stderr, "analyze: cannot read %s\n", paths[i]);
+      return 2;
+    }
+    totalBytes += files[i].size;
+  }
+  size_t chunkBytes = std::max<size_t>(MIN_CHUNK_BYTES, totalBytes / (threads * 8) + 1);
+  std::vector<Chunk> chunks;
+  for (const MappedFile& file : files) {
+    splitFile(file, chunkBytes, chunks);
+  }
+
+  // Phase 1: scan chunks in parallel, notes grouped by line per chunk
+  std::vector<NoteScanner> scanners(threads);
+  parallelFor(chunks.size(), threads, [&](unsigned t, size_t i) {
+    scanChunk(chunks[i], scanners[t]);
+  });
+  NoteScanner totals;
+  for (const NoteScanner& s : scanners) {
+    totals.merge(s);
+  }
+
+  // Merge in chunk order so equal timestamps keep their file order
+  std::unordered_map<std::string_view, size_t> lineIndex;
+  std::vector<std::vector<NoteRecord>> lineRecords;
+  std::vector<LineSummary> summaries;
+  for (Chunk& chunk : chunks) {
+    for (auto& kv : chunk.lines) {
+      auto found = lineIndex.emplace(kv.first, lineRecords.size());
+      if (found.second) {
+        lineRecords.emplace_back();
+        summaries.emplace_back();
+        summaries.back().lineId = std::string(kv.first);
+      }
+      std::vector<NoteRecord>& dest = lineRecords[found.first->second];
+      dest.insert(dest.end(), kv.second.begin(), kv.second.end());
+    }
+    chunk.lines.clear();
+  }
+  double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Phase 2: one backtest per line, lines spread over the workers
+  parallelFor(lineRecords.size(), threads, [&](unsigned t, size_t i) {
+    std::vector<NoteRecord>& records = lineRecords[i];
+    std::stable_sort(records.begin(), records.end(),
+                     [](const NoteRecord& a, const NoteRecord& b) { return a.when < b.when; });
+    LineBacktest backtest(window);
+    backtest.run(records, summaries[i]);
+  });
+  double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::sort(summaries.begin(), summaries.end(),
+            [](const LineSummary& a, const LineSummary& b) { return a.lineId < b.lineId; });
+
+  // Per-line summary; alert columns are recorded/backtest/matched
+  printf("%-24s %9s %7s %7s %8s %5s %7s %6s %6s", "line", "telemetry", "events", "alerts",
+         "hours", "run%", "rpm", "vib", "vmax");
+  for (int a = 0; a < DETECT_COUNT; a++) {
+    printf(" %14s", DetectorPipeline::getChannelName((DetectorChannel)a));
+  }
+  printf("\n");
+  for (const LineSummary& s : summaries) {
+    uint64_t telemetry = s.notes[NOTE_TELEMETRY];
+    double running = s.runningSamples ? (double)s.runningSamples : 1.0;
+    printf("%-24.24s %9llu %7llu %7llu %8.1f %5.1f %7.1f %6.3f %6.3f",
+           s.lineId.c_str(), (unsigned long long)telemetry,
+           (unsigned long long)s.notes[NOTE_EVENT], (unsigned long long)s.notes[NOTE_ALERT],
+           (s.lastWhen - s.firstWhen) / 3600.0,
+           telemetry ? 100.0 * s.runningSamples / telemetry : 0.0,
+           s.speedSum / running, s.vibrationSum / running, s.maxVibration);
+    for (int a = 0; a < DETECT_COUNT; a++) {
+      char cell[32];
+      snprintf(cell, sizeof(cell), "%u/%u/%u", s.recorded[a], s.backtest[a], s.matched[a]);
+      printf(" %14s", cell);
+    }
+    printf("\n");
+  }
+
+  if (csvPath) {
+    FILE* f = fopen(csvPath, "w");
+    if (!f) {
+      fprintf(stderr, "analyze: cannot write %s\n", csvPath);
+      return 2;
+    }
+    fprintf(f, "line,telemetry,events,alerts,first_when,last_when,running,avg_rpm,avg_vib,max_vib,max_temp");
+    for (int a = 0; a < DETECT_COUNT; a++) {
+      const char* name = DetectorPipeline::getChannelName((DetectorChannel)a);
+      fprintf(f, ",%s_recorded,%s_backtest,%s_matched", name, name, name);
+    }
+    fprintf(f, "\n");
+    for (const LineSummary& s : summaries) {
+      double running = s.runningSamples ? (double)s.runningSamples : 1.0;
+      fprintf(f, "%s,%llu,%llu,%llu,%.3f,%.3f,%llu,%.2f,%.4f,%.4f,%.2f", s.lineId.c_str(),
+              (unsigned long long)s.notes[NOTE_TELEMETRY], (unsigned long long)s.notes[NOTE_EVENT],
+              (unsigned long long)s.notes[NOTE_ALERT], s.firstWhen, s.lastWhen,
+              (unsigned long long)s.runningSamples, s.speedSum / running, s.vibrationSum / running,
+              s.maxVibration, s.maxTemperature);
+      for (int a = 0; a < DETECT_COUNT; a++) {
+        fprintf(f, ",%u,%u,%u", s.recorded[a], s.backtest[a], s.matched[a]);
+      }
+      fprintf(f, "\n");
+    }
+    fclose(f);
+  }
+
+  for (const MappedFile& file : files) {
+    if (file.data) {
+      munmap(const_cast<char*>(file.data), file.size);
+    }
+  }
+
+  printf("\n%zu lines, %llu NDJSON records (%llu telemetry, %llu events, %llu alerts, %llu other, %llu malformed, "
+         "%llu without wall time)\n",
+         summaries.size(), (unsigned long long)totals.getLines(),
+         (unsigned long long)totals.getNotes(NOTE_TELEMETRY), (unsigned long long)totals.getNotes(NOTE_EVENT),
+         (unsigned long long)totals.getNotes(NOTE_ALERT), (unsigned long long)totals.getSkipped(),
+         (unsigned long long)totals.getMalformed(), (unsigned long long)totals.getUnsynced());
+  printf("%.1f MB in %.3f s (scan %.3f s) on %u threads: %.2f GB/min\n",
+         totalBytes / 1e6, totalSeconds, scanSeconds, threads,
+         totalSeconds > 0 ? totalBytes / 1e9 / (totalSeconds / 60.0) : 0.0);
+  return 0;
+}
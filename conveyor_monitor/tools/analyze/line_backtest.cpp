@@ -0,0 +1,83 @@
+#include "line_backtest.h"
+
+LineBacktest::LineBacktest(double matchWindowSeconds) {
+  matchWindow = matchWindowSeconds;
+}
+
+uint32_t LineBacktest::countMatches(const std::vector<double>& onsets, const std::vector<double>& recorded,
+                                    double window) {
+  // Both sorted; each recorded alert explains at most one onset
+  uint32_t matches = 0;
+  size_t r = 0;
+  for (double t : onsets) {
+    while (r < recorded.size() && recorded[r] < t - window) {
+      r++;
+    }
+    if (r < recorded.size() && recorded[r] <= t + window) {
+      matches++;
+      r++;
+    }
+  }
+  return matches;
+}
+
+void LineBacktest::run(const std::vector<NoteRecord>& records, LineSummary& summary) {
+  for (int i = 0; i < NOTE_KIND_COUNT; i++) summary.notes[i] = 0;
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    summary.recorded[i] = summary.backtest[i] = summary.matched[i] = 0;
+  }
+  summary.firstWhen = records.empty() ? 0 : records.front().when;
+  summary.lastWhen = records.empty() ? 0 : records.back().when;
+  summary.runningSamples = 0;
+  summary.speedSum = 0;
+  summary.vibrationSum = 0;
+  summary.maxTemperature = -1000.0f;
+  summary.maxVibration = 0;
+  if (records.empty()) {
+    return;
+  }
+
+  // Fresh detectors on a clock starting at this line's first note
+  pipeline.reset(defaultAnomalyThresholds());
+
+  std::vector<double> onsets[DETECT_COUNT];
+  std::vector<double> recorded[DETECT_COUNT];
+
+  for (const NoteRecord& record : records) {
+    summary.notes[record.kind]++;
+    if (record.kind == NOTE_ALERT) {
+      int index = DetectorPipeline::channelFor((AlertType)record.alert);
+      if (index < DETECT_COUNT) {
+        summary.recorded[index]++;
+        recorded[index].push_back(record.when);
+      }
+      continue;
+    }
+    if (record.kind != NOTE_TELEMETRY) {
+      continue;
+    }
+
+    const SystemState& state = record.state;
+    hostSetMicros((uint64_t)((record.when - summary.firstWhen) * 1e6));
+    if (state.conveyorRunning) {
+      summary.runningSamples++;
+      summary.speedSum += state.speed_rpm;
+      summary.vibrationSum += state.vibrationLevel;
+    }
+    if (state.temperature > summary.maxTemperature) summary.maxTemperature = state.temperature;
+    if (state.vibrationLevel > summary.maxVibration) summary.maxVibration = state.vibrationLevel;
+
+    bool detected[DETECT_COUNT];
+    pipeline.update(state, detected);
+    for (int i = 0; i < DETECT_COUNT; i++) {
+      if (detected[i]) {
+        summary.backtest[i]++;
+        onsets[i].push_back(record.when);
+      }
+    }
+  }
+
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    summary.matched[i] = countMatches(onsets[i], recorded[i], matchWindow);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef LINE_BACKTEST_H
+#define LINE_BACKTEST_H
+
+#include <string>
+#include <vector>
+#include "detector_pipeline.h"
+#include "note_scanner.h"
+
+/**
+ * @brief Per-production-line totals from one analyzer run
+ */
+struct LineSummary {
+  std::string lineId;
+  uint64_t notes[NOTE_KIND_COUNT];
+  double firstWhen;
+  double lastWhen;
+  uint64_t runningSamples;
+  double speedSum;            // Over running samples
+  double vibrationSum;        // Over running samples
+  float maxTemperature;
+  float maxVibration;
+  uint32_t recorded[DETECT_COUNT];    // Alerts in alerts.qo
+  uint32_t backtest[DETECT_COUNT];    // Detector onsets during replay
+  uint32_t matched[DETECT_COUNT];     // Onsets with a recorded alert nearby
+};
+
+/**
+ * @brief Replays one line's telemetry through the firmware's detectors
+ *
+ * Telemetry notes become SystemState updates for a DetectorPipeline on this
+ * thread's simulated clock (set from the note time). Detector onsets are
+ * compared with the alerts the device actually sent, so threshold or rule
+ * changes in src/ can be backtested against archived data.
+ *
+ * History windows are counted in updates, so results at telemetry cadence
+ * (15 s - 5 min) differ from the 2 Hz on-device processing; compare runs of
+ * the same archive rather than absolute counts.
+ */
+class LineBacktest {
+private:
+  DetectorPipeline pipeline;
+  double matchWindow;
+
+  static uint32_t countMatches(const std::vector<double>& onsets, const std::vector<double>& recorded,
+                               double window);
+
+public:
+  /**
+   * @brief Constructor
+   * @param matchWindowSeconds Max distance between an onset and a recorded alert
+   */
+  explicit LineBacktest(double matchWindowSeconds);
+
+  /**
+   * @brief Run one line
+   * @param records The line's notes, sorted by time
+   * @param summary Filled in (lineId is left to the caller)
+   */
+  void run(const std::vector<NoteRecord>& records, LineSummary& summary);
+};
+
+#endif // LINE_BACKTEST_H
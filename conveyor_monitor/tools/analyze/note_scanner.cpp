@@ -0,0 +1,284 @@
+#include "note_scanner.h"
+
+#include <string.h>
+
+namespace {
+
+inline void skipSpace(const char*& p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+}
+
+// Raw string contents between the quotes; escapes are skipped, not decoded
+inline bool readString(const char*& p, const char* end, std::string_view& out) {
+  if (p >= end || *p != '"') return false;
+  const char* start = ++p;
+  while (p < end && *p != '"') {
+    p += (*p == '\\') ? 2 : 1;
+  }
+  if (p >= end) return false;
+  out = std::string_view(start, p - start);
+  p++;
+  return true;
+}
+
+inline bool readNumber(const char*& p, const char* end, double& out) {
+  static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                                  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+  bool negative = (p < end && *p == '-');
+  if (negative) p++;
+  const char* digits = p;
+  uint64_t mantissa = 0;
+  int scale = 0;
+  while (p < end && (unsigned)(*p - '0') < 10) {
+    mantissa = mantissa * 10 + (uint64_t)(*p++ - '0');
+  }
+  if (p < end && *p == '.') {
+    p++;
+    while (p < end && (unsigned)(*p - '0') < 10) {
+      if (mantissa < 100000000000000000ull) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        scale--;
+      }
+      p++;
+    }
+  }
+  if (p == digits) return false;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    bool negativeExp = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    int exponent = 0;
+    while (p < end && (unsigned)(*p - '0') < 10) {
+      exponent = exponent * 10 + (*p++ - '0');
+    }
+    scale += negativeExp ? -exponent : exponent;
+  }
+  double value = (double)mantissa;
+  while (scale < -18) { value /= 1e18; scale += 18; }
+  while (scale > 18) { value *= 1e18; scale -= 18; }
+  value = scale < 0 ? value / POW10[-scale] : value * POW10[scale];
+  out = negative ? -value : value;
+  return true;
+}
+
+inline bool readBool(const char*& p, const char* end, bool& out) {
+  if (end - p >= 4 && memcmp(p, "true", 4) == 0) { p += 4; out = true; return true; }
+  if (end - p >= 5 && memcmp(p, "false", 5) == 0) { p += 5; out = false; return true; }
+  return false;
+}
+
+// Skip any value, tracking nesting and strings only
+bool skipValue(const char*& p, const char* end) {
+  if (p >= end) return false;
+  if (*p == '"') {
+    std::string_view ignored;
+    return readString(p, end, ignored);
+  }
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    while (p < end) {
+      char c = *p;
+      if (c == '"') {
+        std::string_view ignored;
+        if (!readString(p, end, ignored)) return false;
+        continue;
+      }
+      if (c == '{' || c == '[') depth++;
+      else if (c == '}' || c == ']') {
+        if (--depth == 0) { p++; return true; }
+      }
+      p++;
+    }
+    return false;
+  }
+  const char* start = p;
+  while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ') p++;
+  return p > start;
+}
+
+// Walk the members of an object: fn(key, p) must consume the value
+template<class Fn>
+bool forEachMember(const char*& p, const char* end, Fn fn) {
+  skipSpace(p, end);
+  if (p >= end || *p != '{') return false;
+  p++;
+  skipSpace(p, end);
+  if (p < end && *p == '}') { p++; return true; }
+  while (p < end) {
+    std::string_view key;
+    skipSpace(p, end);
+    if (!readString(p, end, key)) return false;
+    skipSpace(p, end);
+    if (p >= end || *p != ':') return false;
+    p++;
+    skipSpace(p, end);
+    if (!fn(key, p)) return false;
+    skipSpace(p, end);
+    if (p < end && *p == ',') { p++; continue; }
+    if (p < end && *p == '}') { p++; return true; }
+    return false;
+  }
+  return false;
+}
+
+} // namespace
+
+NoteScanner::NoteScanner() {
+  lines = 0;
+  skipped = 0;
+  malformed = 0;
+  unsynced = 0;
+  for (int i = 0; i < NOTE_KIND_COUNT; i++) {
+    notes[i] = 0;
+  }
+}
+
+AlertType NoteScanner::parseAlertType(std::string_view name) {
+  if (name == "speed_anomaly") return ALERT_SPEED_ANOMALY;
+  if (name == "jam_detected") return ALERT_JAM_DETECTED;
+  if (name == "vibration_high") return ALERT_VIBRATION_HIGH;
+  if (name == "environmental") return ALERT_ENV_CONDITION;
+  if (name == "sensor_failure") return ALERT_SENSOR_FAILURE;
+  if (name == "comm_failure") return ALERT_COMM_FAILURE;
+  return ALERT_NONE;
+}
+
+bool NoteScanner::parseBody(const char* p, const char* end, NoteRecord& record, double& bodyTime,
+                            bool& uptimeTime) const {
+  SystemState& s = record.state;
+  return forEachMember(p, end, [&](std::string_view key, const char*& v) {
+    double number = 0;
+    bool flag = false;
+    if (key == "time") {
+      return readNumber(v, end, bodyTime);
+    }
+    if (key == "ts") {
+      std::string_view base;
+      if (!readString(v, end, base)) return false;
+      uptimeTime = (base == "uptime");
+      return true;
+    }
+    if (record.kind == NOTE_ALERT && key == "alert") {
+      std::string_view name;
+      if (!readString(v, end, name)) return false;
+      record.alert = (uint8_t)parseAlertType(name);
+      return true;
+    }
+    if (record.kind != NOTE_TELEMETRY) {
+      return skipValue(v, end);
+    }
+
+    // Telemetry schema (TelemetryFormatter::formatTelemetry)
+    switch (key.size()) {
+      case 2:
+        if (key == "dq" && readNumber(v, end, number)) { s.validMask = (uint8_t)number; return true; }
+        break;
+      case 3:
+        if (key == "iaq" && readNumber(v, end, number)) { s.iaq = (uint16_t)number; return true; }
+        break;
+      case 4:
+        if (key == "temp" && readNumber(v, end, number)) { s.temperature = (float)number; return true; }
+        break;
+      case 7:
+        if (key == "running" && readBool(v, end, flag)) { s.conveyorRunning = flag; return true; }
+        if (key == "iaq_acc" && readNumber(v, end, number)) { s.iaqAccuracy = (uint8_t)number; return true; }
+        break;
+      case 8:
+        if (key == "humidity" && readNumber(v, end, number)) { s.humidity = (float)number; return true; }
+        if (key == "pressure" && readNumber(v, end, number)) { s.pressure = (float)number; return true; }
+        if (key == "operator" && readBool(v, end, flag)) { s.operatorPresent = flag; return true; }
+        break;
+      case 9:
+        if (key == "speed_rpm" && readNumber(v, end, number)) { s.speed_rpm = (float)number; return true; }
+        if (key == "vibration" && readNumber(v, end, number)) { s.vibrationLevel = (float)number; return true; }
+        break;
+      case 13:
+        if (key == "parts_per_min" && readNumber(v, end, number)) { s.partsPerMinute = (int)number; return true; }
+        break;
+      case 14:
+        if (key == "gas_resistance" && readNumber(v, end, number)) { s.gasResistance = (uint32_t)number; return true; }
+        break;
+    }
+    return skipValue(v, end);
+  });
+}
+
+bool NoteScanner::scan(const char* begin, const char* end, NoteRecord& record, std::string_view& lineId) {
+  const char* p = begin;
+  lines++;
+  skipSpace(p, end);
+  if (p >= end) {
+    lines--;   // Blank line
+    return false;
+  }
+
+  // Replay harness records carry a leading millisecond timestamp
+  double prefixMs = -1;
+  if (*p != '{') {
+    if (!readNumber(p, end, prefixMs)) {
+      malformed++;
+      return false;
+    }
+  }
+
+  std::string_view file, sn, device;
+  const char* body = nullptr;
+  double when = -1;
+  bool ok = forEachMember(p, end, [&](std::string_view key, const char*& v) {
+    if (key == "file") return readString(v, end, file);
+    if (key == "sn") return readString(v, end, sn);
+    if (key == "device") return readString(v, end, device);
+    if (key == "when") return readNumber(v, end, when);
+    if (key == "body") body = v;
+    return skipValue(v, end);
+  });
+  if (!ok) {
+    malformed++;
+    return false;
+  }
+
+  if (file == "telemetry.qo") record.kind = NOTE_TELEMETRY;
+  else if (file == "events.qo") record.kind = NOTE_EVENT;
+  else if (file == "alerts.qo") record.kind = NOTE_ALERT;
+  else {
+    skipped++;
+    return false;
+  }
+
+  memset(&record.state, 0, sizeof(record.state));
+  record.state.validMask = FIELD_ALL_MASK;   // Firmware before the "dq" field
+  record.alert = ALERT_NONE;
+  double bodyTime = -1;
+  bool uptimeTime = false;
+  if (body && !parseBody(body, end, record, bodyTime, uptimeTime)) {
+    malformed++;
+    return false;
+  }
+
+  if (when >= 0) record.when = when;
+  else if (prefixMs >= 0) record.when = prefixMs / 1000.0;
+  else if (bodyTime >= 0 && !uptimeTime) record.when = bodyTime;
+  else if (bodyTime >= 0) {
+    // Stamped before the device clock synced: no wall time to order it by
+    unsynced++;
+    return false;
+  }
+  else {
+    malformed++;
+    return false;
+  }
+
+  lineId = !sn.empty() ? sn : (!device.empty() ? device : std::string_view("-"));
+  notes[record.kind]++;
+  return true;
+}
+
+void NoteScanner::merge(const NoteScanner& other) {
+  lines += other.lines;
+  skipped += other.skipped;
+  malformed += other.malformed;
+  unsynced += other.unsynced;
+  for (int i = 0; i < NOTE_KIND_COUNT; i++) {
+    notes[i] += other.notes[i];
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef NOTE_SCANNER_H
+#define NOTE_SCANNER_H
+
+#include <stdint.h>
+#include <string_view>
+#include "config/alert_config.h"
+#include "config/data_types.h"
+
+/**
+ * @brief Notefiles the analyzer understands
+ */
+enum NoteKind {
+  NOTE_TELEMETRY = 0,   // telemetry.qo
+  NOTE_EVENT,           // events.qo
+  NOTE_ALERT,           // alerts.qo
+  NOTE_KIND_COUNT
+};
+
+/**
+ * @brief One note reduced to what the backtest needs
+ */
+struct NoteRecord {
+  double when;          // Seconds (Notehub "when", else body "time" when it is Unix time)
+  SystemState state;    // Telemetry only
+  uint8_t kind;         // NoteKind
+  uint8_t alert;        // AlertType, alerts only
+};
+
+/**
+ * @brief Zero-copy scanner for exported Notehub NDJSON events
+ *
+ * Specialised to this firmware's payloads: it walks the top-level event
+ * object once, keeps views into the mapped file for the keys it needs
+ * ("file", "sn"/"device", "when", "body") and skips everything else without
+ * copying or unescaping. Lines written by the replay harness
+ * ("<t_ms> {note.add request}") are accepted as well.
+ *
+ * One scanner per thread; the counters are not shared.
+ */
+class NoteScanner {
+private:
+  uint64_t lines;
+  uint64_t skipped;     // Valid JSON, but not a note we analyze
+  uint64_t malformed;
+  uint64_t unsynced;    // Only an uptime body "time" ("ts":"uptime"), so no wall time
+  uint64_t notes[NOTE_KIND_COUNT];
+
+  bool parseBody(const char* p, const char* end, NoteRecord& record, double& bodyTime, bool& uptimeTime) const;
+
+public:
+  NoteScanner();
+
+  /**
+   * @brief Scan one line
+   * @param begin First byte of the line
+   * @param end One past the last byte (excluding the newline)
+   * @param record Filled in when the line is a telemetry, event or alert note
+   * @param lineId View of the production line id ("sn", else "device")
+   * @return true if record and lineId were filled in
+   */
+  bool scan(const char* begin, const char* end, NoteRecord& record, std::string_view& lineId);
+
+  uint64_t getLines() const { return lines; }
+  uint64_t getSkipped() const { return skipped; }
+  uint64_t getMalformed() const { return malformed; }
+  uint64_t getUnsynced() const { return unsynced; }
+  uint64_t getNotes(NoteKind kind) const { return notes[kind]; }
+
+  /**
+   * @brief Add another scanner's counters (after a parallel scan)
+   */
+  void merge(const NoteScanner& other);
+
+  /**
+   * @brief Map an alerts.qo "alert" string to its AlertType
+   */
+  static AlertType parseAlertType(std::string_view name);
+};
+
+#endif // NOTE_SCANNER_H
@@ -0,0 +1,160 @@
+/**
+ * Cost of the flight recorder and size of its crash note
+ *
+ * Drives the firmware FlightRecorder with the event pattern of the main
+ * loop, as TaskWatchdog brackets it: the sync task on every 1 ms loop pass,
+ * sensor reads every 100 ms (2-15 ms each), processing every second, a
+ * note a minute, and occasional errors and alerts. Task runs under
+ * FLIGHT_SPAN_MIN_MS are retracted. Reports the time per recorded event and
+ * per retracted span and how much history the ring holds, then simulates a
+ * reset: begin() compresses the ring into the crash note payload, which is
+ * decoded again and compared with the events recorded.
+ *
+ *   flight_bench [--seconds N] [--seed N]
+ *
+ * Exit status: 0 = ok, 1 = payload does not decode to the recorded events, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/system_config.h"
+#include "utils/error_handling.h"
+#include "utils/flight_recorder.h"
+#include "utils/task_watchdog.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+  uint32_t seconds = 600;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--seconds" && hasValue) seconds = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr,
+              "usage: flight_bench [options]\n"
+              "  --seconds N     simulated run time (default 600)\n"
+              "  --seed N        event seed (default 1)\n");
+      return 2;
+    }
+  }
+  if (seconds == 0) {
+    fprintf(stderr, "flight_bench: --seconds must be positive\n");
+    return 2;
+  }
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::vector<FlightEvent> shadow;   // What the ring should hold, oldest first
+  auto record = [&](FlightEventType type, uint8_t code, uint32_t arg) {
+    flightRecorder.record(type, code, arg);
+    shadow.push_back({(uint32_t)millis(), type, code, (uint16_t)min(arg, (uint32_t)UINT16_MAX)});
+  };
+  auto endTask = [&](uint8_t task, uint32_t durationMs) {
+    if (durationMs >= FLIGHT_SPAN_MIN_MS || !flightRecorder.retract(FLIGHT_TASK_BEGIN, task)) {
+      record(FLIGHT_TASK_END, task, durationMs);
+    } else {
+      shadow.pop_back();
+    }
+  };
+
+  hostSetMicros(0);
+  flightRecorder.begin();
+  shadow.push_back({0, FLIGHT_BOOT, 0, 0});
+
+  // Main loop pattern, one pass per simulated ms
+  uint32_t spans = 0;
+  size_t kept = 0;
+  for (uint32_t ms = 1; ms <= seconds * 1000; ms++) {
+    hostSetMicros((uint64_t)ms * 1000ULL);
+    size_t before = shadow.size();
+    if (ms % SENSOR_READ_INTERVAL == 0) {
+      uint32_t runMs = 2 + rng() % 14;
+      record(FLIGHT_TASK_BEGIN, WDT_TASK_SENSOR_READ, 0);
+      if (uniform(rng) < 0.001f) {
+        record(FLIGHT_ERROR, (uint8_t)SystemError::I2C_COMMUNICATION_ERROR, 2);
+      }
+      hostAdvanceMicros(runMs * 1000ULL);
+      endTask(WDT_TASK_SENSOR_READ, runMs);
+      spans++;
+    }
+    if (ms % DATA_PROCESS_INTERVAL == 0) {
+      record(FLIGHT_TASK_BEGIN, WDT_TASK_PROCESSING, 0);
+      if (uniform(rng) < 0.01f) {
+        record(FLIGHT_ALERT, (uint8_t)(rng() % 10), 1);
+      }
+      hostAdvanceMicros(1000);
+      endTask(WDT_TASK_PROCESSING, 1);
+      spans++;
+    }
+    // notecardManager.update() on every pass: usually nothing to do
+    record(FLIGHT_TASK_BEGIN, WDT_TASK_CLOUD_SYNC, 0);
+    bool noteAdded = ms % 60000 == 0;
+    if (noteAdded) {
+      record(FLIGHT_NOTE, 0, 1);
+      hostAdvanceMicros(40000);
+    }
+    endTask(WDT_TASK_CLOUD_SYNC, noteAdded ? 40 : 0);
+    spans++;
+    kept += shadow.size() - before;
+  }
+
+  // Plain record() cost, without the loop bookkeeping
+  const uint32_t n = 10000000;
+  auto start = Clock::now();
+  for (uint32_t i = 0; i < n; i++) {
+    flightRecorder.record(FLIGHT_NOTE, (uint8_t)i, i & 1);
+  }
+  double nsPerRecord = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / n;
+  start = Clock::now();
+  for (uint32_t i = 0; i < n; i++) {
+    flightRecorder.record(FLIGHT_TASK_BEGIN, WDT_TASK_CLOUD_SYNC);
+    flightRecorder.retract(FLIGHT_TASK_BEGIN, WDT_TASK_CLOUD_SYNC);
+  }
+  double nsPerSpan = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / n;
+
+  // The timing loops overwrote the ring: record the loop pattern's tail again, then "reset"
+  shadow.erase(shadow.begin(), shadow.end() - min(shadow.size(), (size_t)FLIGHT_RECORDER_EVENTS));
+  uint32_t coverMs = shadow.back().timeMs - shadow.front().timeMs;
+  hostSetMicros(0);
+  flightRecorder.begin();
+  for (const FlightEvent& e : shadow) {
+    hostSetMicros((uint64_t)e.timeMs * 1000ULL);
+    flightRecorder.record((FlightEventType)e.type, e.code, e.arg);
+  }
+  start = Clock::now();
+  flightRecorder.begin();
+  double usEncode = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+  std::vector<FlightEvent> decoded(FLIGHT_RECORDER_EVENTS);
+  int count = FlightRecorder::decode(flightRecorder.getPayload(), flightRecorder.getPayloadLength(),
+                                     flightRecorder.getPreviousEndMs(), decoded.data(), (int)decoded.size());
+  bool match = count == flightRecorder.getPreviousEvents() && count > 0;
+  for (int i = 0; match && i < count; i++) {
+    const FlightEvent& want = shadow[shadow.size() - 1 - i];
+    match = decoded[i].timeMs == want.timeMs && decoded[i].type == want.type && decoded[i].code == want.code &&
+            decoded[i].arg == want.arg;
+  }
+
+  printf("%-12s %10s %10s\n", "operation", "ns", "per");
+  printf("%-12s %10.1f %10s\n", "record", nsPerRecord, "event");
+  printf("%-12s %10.1f %10s\n", "short span", nsPerSpan, "begin+end");
+  printf("%u s simulated, %u task spans, %zu events kept (%.2f/s), ring of %u events holds the last %.0f s\n",
+         seconds, spans, kept, (double)kept / seconds, (unsigned)FLIGHT_RECORDER_EVENTS, coverMs / 1000.0);
+  printf("crash note: %u events in %zu bytes (%.2f bytes/event, %zu raw), %zu base64, encode %.1f us\n",
+         flightRecorder.getPreviousEvents(), flightRecorder.getPayloadLength(),
+         (double)flightRecorder.getPayloadLength() / max(1, (int)flightRecorder.getPreviousEvents()),
+         shadow.size() * sizeof(FlightEvent), ((flightRecorder.getPayloadLength() + 2) / 3) * 4, usEncode);
+
+  if (!match) {
+    printf("MISMATCH: decoded payload differs from the recorded events\n");
+    return 1;
+  }
+  return 0;
+}
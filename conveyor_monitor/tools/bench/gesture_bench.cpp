@@ -0,0 +1,161 @@
+/**
+ * Accuracy and cost of the raw-FIFO gesture classifier
+ *
+ * Synthesizes APDS9960 gesture FIFO streams: a hand (a reflectance blob at
+ * a random height) swiping across the four photodiodes in each direction
+ * at random speed and angle, held over the sensor (wave), or brushing past
+ * an edge (should be rejected), with photodiode noise and ambient offset.
+ * Each stream is fed through the firmware GestureClassifier one dataset at
+ * a time, as serviceGesture() does after a FIFO burst read.
+ *
+ * Directions follow the SparkFun library: UP enters on the U side and
+ * leaves on the D side, RIGHT enters on the R side and leaves on the L side.
+ *
+ *   gesture_bench [--gestures N] [--seed N]
+ *
+ * Exit status: 0 = ok, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/sensor_config.h"
+#include "sensors/gesture_classifier.h"
+
+constexpr float DATASET_MS = 3.6f;   // GWTIME 2.8 ms plus the four LED pulses
+
+struct Dataset {
+  uint8_t up, down, left, right;
+};
+
+struct GestureStream {
+  GestureType truth;
+  std::vector<Dataset> data;
+};
+
+static const char* const gestureNames[] = {"none", "up", "down", "left", "right", "wave"};
+
+// Photodiode positions (sensor plane, arbitrary units): U top, D bottom, L left, R right
+static const float diodeX[4] = {0.0f, 0.0f, -0.5f, 0.5f};
+static const float diodeY[4] = {0.5f, -0.5f, 0.0f, 0.0f};
+
+static Dataset sample(float x, float y, float peak, float ambient, std::mt19937& rng) {
+  std::normal_distribution<float> noise(0.0f, 4.0f);
+  float counts[4];
+  for (int d = 0; d < 4; d++) {
+    float r2 = sq(x - diodeX[d]) + sq(y - diodeY[d]);
+    counts[d] = ambient + peak * expf(-r2 / 0.5f) + noise(rng);
+  }
+  auto clamp8 = [](float c) { return (uint8_t)constrain(lroundf(c), 0L, 255L); };
+  return {clamp8(counts[0]), clamp8(counts[1]), clamp8(counts[2]), clamp8(counts[3])};
+}
+
+static GestureStream makeStream(GestureType truth, std::mt19937& rng) {
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  GestureStream s;
+  s.truth = truth;
+  float peak = 25.0f + 215.0f * uniform(rng);   // Hand height
+  float ambient = 12.0f * uniform(rng);          // Ambient light not fully rejected
+
+  if (truth == GESTURE_WAVE || truth == GESTURE_NONE) {
+    // Wave: hold over the middle 150-600 ms; none: brush past one edge in 20-60 ms
+    bool hold = truth == GESTURE_WAVE;
+    int n = (int)((hold ? 150.0f + 450.0f * uniform(rng) : 20.0f + 40.0f * uniform(rng)) / DATASET_MS);
+    float cx = hold ? 0.3f * (uniform(rng) - 0.5f) : 0.8f * (uniform(rng) < 0.5f ? -1.0f : 1.0f);
+    float cy = hold ? 0.3f * (uniform(rng) - 0.5f) : 0.3f * (uniform(rng) - 0.5f);
+    for (int i = 0; i < n; i++) {
+      float drift = 0.05f * sinf(6.28f * i / 20.0f);
+      float envelope = sinf(3.1416f * (i + 0.5f) / n);   // Hand comes and goes
+      s.data.push_back(sample(cx + drift, cy, peak * envelope, ambient, rng));
+    }
+    return s;
+  }
+
+  // Swipe from -1.5 to +1.5 along the direction, in 40-500 ms, up to 35 degrees off axis
+  float dx = 0.0f, dy = 0.0f;
+  switch (truth) {
+    case GESTURE_SWIPE_UP:    dy = -1.0f; break;   // U side to D side
+    case GESTURE_SWIPE_DOWN:  dy = 1.0f;  break;
+    case GESTURE_SWIPE_LEFT:  dx = 1.0f;  break;   // L side to R side
+    case GESTURE_SWIPE_RIGHT: dx = -1.0f; break;
+    default: break;
+  }
+  float angle = 0.611f * (2.0f * uniform(rng) - 1.0f);
+  float ax = dx * cosf(angle) - dy * sinf(angle);
+  float ay = dx * sinf(angle) + dy * cosf(angle);
+  float offset = 0.5f * (uniform(rng) - 0.5f);   // Path off the centre
+  int n = (int)((40.0f + 460.0f * uniform(rng)) / DATASET_MS);
+  for (int i = 0; i < n; i++) {
+    float t = -1.5f + 3.0f * i / (n - 1);
+    s.data.push_back(sample(ax * t - ay * offset, ay * t + ax * offset, peak, ambient, rng));
+  }
+  return s;
+}
+
+int main(int argc, char** argv) {
+  size_t count = 20000;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--gestures" && hasValue) count = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr,
+              "usage: gesture_bench [options]\n"
+              "  --gestures N    synthetic gestures (default 20000)\n"
+              "  --seed N        stream seed (default 1)\n");
+      return 2;
+    }
+  }
+  if (count == 0) {
+    fprintf(stderr, "gesture_bench: --gestures must be positive\n");
+    return 2;
+  }
+
+  std::mt19937 rng(seed);
+  std::vector<GestureStream> streams;
+  size_t datasets = 0;
+  for (size_t i = 0; i < count; i++) {
+    streams.push_back(makeStream((GestureType)(i % (GESTURE_WAVE + 1)), rng));
+    datasets += streams.back().data.size();
+  }
+
+  uint32_t confusion[GESTURE_WAVE + 1][GESTURE_WAVE + 1] = {};
+  GestureClassifier classifier;
+  auto start = std::chrono::steady_clock::now();
+  for (const GestureStream& s : streams) {
+    for (const Dataset& d : s.data) {
+      classifier.add(d.up, d.down, d.left, d.right);
+    }
+    confusion[s.truth][classifier.finish()]++;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%-8s %8s %8s", "truth", "count", "correct");
+  for (int c = 0; c <= GESTURE_WAVE; c++) {
+    printf(" %6s", gestureNames[c]);
+  }
+  printf("\n");
+  uint32_t correct = 0;
+  for (int t = 0; t <= GESTURE_WAVE; t++) {
+    uint32_t total = 0;
+    for (int c = 0; c <= GESTURE_WAVE; c++) {
+      total += confusion[t][c];
+    }
+    correct += confusion[t][t];
+    printf("%-8s %8u %7.1f%%", gestureNames[t], total, total ? 100.0 * confusion[t][t] / total : 0.0);
+    for (int c = 0; c <= GESTURE_WAVE; c++) {
+      printf(" %6u", confusion[t][c]);
+    }
+    printf("\n");
+  }
+  printf("accuracy %.2f%%, %zu datasets (%.1f per gesture), %.1f ns/dataset, %.0f ns/gesture\n",
+         100.0 * correct / count, datasets, (double)datasets / count, seconds * 1e9 / datasets,
+         seconds * 1e9 / count);
+  return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * Accuracy and throughput of the float fast-math functions
+ *
+ * Sweeps each function in utils/fast_math.h over its documented input range,
+ * reports the worst absolute and relative error against double-precision
+ * libm, and times it against the float libm call it replaces. Error bounds in
+ * the header come from this tool; rerun it after touching a function.
+ *
+ * The timings compare against the host's libm, which has double-precision
+ * hardware behind it; on the Cortex-M4F the libm calls are software routines,
+ * so the host speedup understates the gain on the device. For device cycle
+ * counts, build the firmware with MATH_BENCH_AT_BOOT (utils/math_bench.h).
+ *
+ *   math_bench [--samples N] [--seed N]
+ *
+ * Exit status: 0 = ok, 1 = a bound in the header was exceeded, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "utils/fast_math.h"
+
+struct Accuracy {
+  double maxAbs;
+  double maxRel;
+  float worstInput;
+};
+
+struct MathCase {
+  const char* name;
+  float (*fast)(float);
+  float (*libm)(float);
+  double (*reference)(double);
+  float lo;
+  float hi;
+  bool logSpaced;
+  double absBound;   // Header bound: |error| <= absBound + relBound * |reference|
+  double relBound;   //                             + argBound * |input|
+  double argBound;
+};
+
+static float libmSinTurns(float t) { return sinf(t * 6.28318531f); }
+static float libmCosTurns(float t) { return cosf(t * 6.28318531f); }
+static double refSinTurns(double t) { return sin(t * 2.0 * M_PI); }
+static double refCosTurns(double t) { return cos(t * 2.0 * M_PI); }
+static float libmRsqrtf(float x) { return 1.0f / sqrtf(x); }
+static double refRsqrt(double x) { return 1.0 / sqrt(x); }
+static double refSin(double x) { return sin(x); }
+static double refCos(double x) { return cos(x); }
+static double refSqrt(double x) { return sqrt(x); }
+static double refExp(double x) { return exp(x); }
+static double refLog(double x) { return log(x); }
+static float libmSinf(float x) { return sinf(x); }
+static float libmCosf(float x) { return cosf(x); }
+static float libmSqrtf(float x) { return sqrtf(x); }
+static float libmExpf(float x) { return expf(x); }
+static float libmLogf(float x) { return logf(x); }
+
+static const MathCase CASES[] = {
+  {"fastSinTurns", fastSinTurns, libmSinTurns, refSinTurns, -4.0f, 4.0f, false, 1.5e-7, 0.0, 0.0},
+  {"fastCosTurns", fastCosTurns, libmCosTurns, refCosTurns, -4.0f, 4.0f, false, 1.5e-7, 0.0, 0.0},
+  {"fastSinf", fastSinf, libmSinf, refSin, -100.0f, 100.0f, false, 1.5e-7, 0.0, 1.5e-7},
+  {"fastCosf", fastCosf, libmCosf, refCos, -100.0f, 100.0f, false, 1.5e-7, 0.0, 1.5e-7},
+  {"fastRsqrtf", fastRsqrtf, libmRsqrtf, refRsqrt, 1e-30f, 1e30f, true, 0.0, 5e-6, 0.0},
+  {"fastSqrtf", fastSqrtf, libmSqrtf, refSqrt, 1e-30f, 1e30f, true, 0.0, 5e-6, 0.0},
+  {"fastExpf", fastExpf, libmExpf, refExp, -87.0f, 88.0f, false, 0.0, 3e-7, 0.0},
+  {"fastLogf", fastLogf, libmLogf, refLog, 1e-30f, 1e30f, true, 1e-7, 2.5e-7, 0.0},
+};
+
+static std::vector<float> makeInputs(const MathCase& c, size_t count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<float> inputs(count);
+  if (c.logSpaced) {
+    std::uniform_real_distribution<double> exponent(log(c.lo), log(c.hi));
+    for (float& x : inputs) x = (float)exp(exponent(rng));
+  } else {
+    std::uniform_real_distribution<float> value(c.lo, c.hi);
+    for (float& x : inputs) x = value(rng);
+  }
+  return inputs;
+}
+
+static Accuracy measureAccuracy(const MathCase& c, const std::vector<float>& inputs, bool& withinBound) {
+  Accuracy a = {0.0, 0.0, 0.0f};
+  withinBound = true;
+  for (float x : inputs) {
+    double expected = c.reference((double)x);
+    double error = fabs((double)c.fast(x) - expected);
+    double rel = expected != 0.0 ? error / fabs(expected) : 0.0;
+    if (error > a.maxAbs) {
+      a.maxAbs = error;
+      a.worstInput = x;
+    }
+    a.maxRel = std::max(a.maxRel, rel);
+    if (error > c.absBound + c.relBound * fabs(expected) + c.argBound * fabs((double)x)) {
+      withinBound = false;
+    }
+  }
+  return a;
+}
+
+static double nsPerCall(float (*fn)(float), const std::vector<float>& inputs) {
+  volatile float sink = 0.0f;
+  float acc = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (float x : inputs) {
+    acc += fn(x);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  sink = acc;
+  (void)sink;
+  return seconds * 1e9 / inputs.size();
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: math_bench [options]\n"
+          "  --samples N     inputs per function (default 4000000)\n"
+          "  --seed N        input seed (default 1)\n");
+}
+
+int main(int argc, char** argv) {
+  size_t count = 4000000;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--samples" && hasValue) count = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      usage();
+      return 2;
+    }
+  }
+  if (count == 0) {
+    usage();
+    return 2;
+  }
+
+  printf("%-14s %12s %12s %14s %10s %10s %8s  %s\n",
+         "function", "max abs", "max rel", "worst input", "ns fast", "ns libm", "speedup", "bound");
+  bool allWithin = true;
+  for (const MathCase& c : CASES) {
+    std::vector<float> inputs = makeInputs(c, count, seed);
+    bool withinBound;
+    Accuracy a = measureAccuracy(c, inputs, withinBound);
+    // Warm up once so the first case does not pay for page faults
+    nsPerCall(c.fast, inputs);
+    double fastNs = nsPerCall(c.fast, inputs);
+    double libmNs = nsPerCall(c.libm, inputs);
+    printf("%-14s %12.3g %12.3g %14.7g %10.2f %10.2f %7.2fx  %s\n",
+           c.name, a.maxAbs, a.maxRel, a.worstInput, fastNs, libmNs,
+           fastNs > 0.0 ? libmNs / fastNs : 0.0, withinBound ? "ok" : "EXCEEDED");
+    allWithin = allWithin && withinBound;
+  }
+
+  // Integer helpers against exact results
+  uint32_t isqrtErrors = 0;
+  std::mt19937 rng(seed);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t x = rng();
+    uint32_t r = fastSqrt(x);
+    if ((uint64_t)r * r > x || (uint64_t)(r + 1) * (r + 1) <= x) isqrtErrors++;
+  }
+  uint32_t roundErrors = 0;
+  std::uniform_real_distribution<float> roundInput(-1e6f, 1e6f);
+  for (size_t i = 0; i < count; i++) {
+    float x = roundInput(rng);
+    if (roundToInt(x) != (int32_t)lroundf(x)) roundErrors++;
+  }
+  printf("%-14s %u mismatches\n", "fastSqrt", isqrtErrors);
+  printf("%-14s %u mismatches\n", "roundToInt", roundErrors);
+  allWithin = allWithin && isqrtErrors == 0 && roundErrors == 0;
+
+  return allWithin ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+ * Size, cost and precision of the packed SensorReadings record
+ *
+ * Generates raw readings across each sensor's working range (belt speed,
+ * +/-8 g accelerometer, 245 dps gyro, magnetometer, BME688 climate and gas
+ * resistance, ToF distance), packs them with packReadings() and unpacks
+ * them again. Reports bytes per sample against the unpacked struct, the
+ * time per encode and decode, and the largest round-trip error of each
+ * field, which must stay within half a step. Also sizes the sample capture
+ * payload that SampleCapture uploads.
+ *
+ *   packed_bench [--samples N] [--seed N]
+ *
+ * Exit status: 0 = ok, 1 = a round-trip error exceeds half a step, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/sensor_config.h"
+#include "sensors/packed_readings.h"
+#include "data_processing/sample_capture.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct FieldError {
+  const char* name;
+  float step;           // Field units per count
+  double worst;
+};
+
+int main(int argc, char** argv) {
+  size_t count = 1000000;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--samples" && hasValue) count = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr,
+              "usage: packed_bench [options]\n"
+              "  --samples N     readings to pack (default 1000000)\n"
+              "  --seed N        reading seed (default 1)\n");
+      return 2;
+    }
+  }
+  if (count == 0) {
+    fprintf(stderr, "packed_bench: --samples must be positive\n");
+    return 2;
+  }
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  auto span = [&](float lo, float hi) { return lo + (hi - lo) * uniform(rng); };
+  std::vector<SensorReadings> readings(count);
+  for (SensorReadings& r : readings) {
+    r.encoderSpeed = span(0.0f, 100.0f);
+    r.encoderPulses = (int32_t)(rng() % 2000000) - 1000000;
+    r.distance_mm = rng() % 4000;
+    r.objectDetected = r.distance_mm < PART_DETECT_THRESHOLD;
+    r.accel_x = span(-8.0f, 8.0f);
+    r.accel_y = span(-8.0f, 8.0f);
+    r.accel_z = span(-8.0f, 8.0f);
+    r.gyro_x = span(-245.0f, 245.0f);
+    r.gyro_y = span(-245.0f, 245.0f);
+    r.gyro_z = span(-245.0f, 245.0f);
+    r.mag_x = span(-4.0f, 4.0f);
+    r.mag_y = span(-4.0f, 4.0f);
+    r.mag_z = span(-4.0f, 4.0f);
+    r.temperature = span(-40.0f, 85.0f);
+    r.humidity = span(0.0f, 100.0f);
+    r.pressure = span(300.0f, 1100.0f);
+    r.gasResistance = rng() % 5000000;
+    r.gesture = rng() % 6;
+    r.proximity = rng() % 256;
+  }
+
+  std::vector<PackedReadings> packed(count);
+  auto start = Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    packed[i] = packReadings(readings[i], 100);
+  }
+  double nsEncode = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+  std::vector<SensorReadings> unpacked(count);
+  start = Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    unpacked[i] = unpackReadings(packed[i]);
+  }
+  double nsDecode = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+  FieldError errors[] = {
+    {"speed", 1.0f / PACKED_SPEED_PER_RPM, 0},
+    {"accel", 1.0f / PACKED_ACCEL_PER_G, 0},
+    {"gyro", 1.0f / PACKED_GYRO_PER_DPS, 0},
+    {"mag", 1.0f / PACKED_MAG_PER_GAUSS, 0},
+    {"temperature", 1.0f / PACKED_TEMP_PER_C, 0},
+    {"humidity", 1.0f / PACKED_HUMIDITY_PER_PCT, 0},
+    {"pressure", 1.0f / PACKED_PRESSURE_PER_HPA, 0},
+    {"gas", (float)PACKED_GAS_OHMS, 0},
+  };
+  bool exact = true;
+  for (size_t i = 0; i < count; i++) {
+    const SensorReadings& a = readings[i];
+    const SensorReadings& b = unpacked[i];
+    double diffs[][3] = {
+      {a.encoderSpeed - b.encoderSpeed, 0, 0},
+      {a.accel_x - b.accel_x, a.accel_y - b.accel_y, a.accel_z - b.accel_z},
+      {a.gyro_x - b.gyro_x, a.gyro_y - b.gyro_y, a.gyro_z - b.gyro_z},
+      {a.mag_x - b.mag_x, a.mag_y - b.mag_y, a.mag_z - b.mag_z},
+      {a.temperature - b.temperature, 0, 0},
+      {a.humidity - b.humidity, 0, 0},
+      {a.pressure - b.pressure, 0, 0},
+      {(double)a.gasResistance - (double)b.gasResistance, 0, 0},
+    };
+    for (size_t f = 0; f < sizeof(errors) / sizeof(errors[0]); f++) {
+      for (double d : diffs[f]) {
+        errors[f].worst = max(errors[f].worst, fabs(d));
+      }
+    }
+    exact = exact && a.encoderPulses == b.encoderPulses && a.distance_mm == b.distance_mm &&
+            a.objectDetected == b.objectDetected && a.gesture == b.gesture && a.proximity == b.proximity;
+  }
+
+  printf("record: %zu bytes packed, %zu unpacked (%.0f%%); %zu samples per KB instead of %zu\n",
+         sizeof(PackedReadings), sizeof(SensorReadings), 100.0 * sizeof(PackedReadings) / sizeof(SensorReadings),
+         1024 / sizeof(PackedReadings), 1024 / sizeof(SensorReadings));
+  printf("%-12s %10s %10s\n", "operation", "ns", "per");
+  printf("%-12s %10.1f %10s\n", "pack", nsEncode, "sample");
+  printf("%-12s %10.1f %10s\n", "unpack", nsDecode, "sample");
+  printf("%-12s %12s %12s\n", "field", "step", "max error");
+  bool withinBound = exact;
+  for (const FieldError& e : errors) {
+    // 2% slack for the float rounding of values like 1013.25 hPa
+    bool ok = e.worst <= 0.51 * e.step;
+    withinBound = withinBound && ok;
+    printf("%-12s %12g %12g%s\n", e.name, e.step, e.worst, ok ? "" : "  EXCEEDS HALF A STEP");
+  }
+  printf("integer fields: %s\n", exact ? "exact" : "MISMATCH");
+  printf("sample capture: %u records in %zu bytes, %zu base64 (%zu bytes unpacked)\n",
+         (unsigned)SAMPLE_CAPTURE_SAMPLES, SAMPLE_CAPTURE_PAYLOAD_BYTES, ((SAMPLE_CAPTURE_PAYLOAD_BYTES + 2) / 3) * 4,
+         SAMPLE_CAPTURE_SAMPLES * sizeof(SensorReadings));
+  return withinBound ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/**
+ * Per-tick processing cost with and without memoized derived metrics
+ *
+ * Feeds a simulated sensor trace through the firmware DataProcessor at
+ * DATA_PROCESS_INTERVAL and, after each update, makes the same reads as
+ * processData() in the sketch (the four detectors, the vibration trend
+ * for the rate controller) plus the periodic report reads. The run is
+ * repeated with memoization off, so every read recomputes as before, and
+ * on. Detector decisions must be identical; the tool exits 1 if not.
+ *
+ *   process_bench [--minutes N] [--seed N] [--repeat N]
+ *
+ * Exit status: 0 = ok, 1 = results differ, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "data_processing/data_processor.h"
+#include "config/system_config.h"
+#include "sensor_trace.h"
+
+struct TickInput {
+  uint32_t t_ms;
+  SystemState state;
+};
+
+struct ProcessResult {
+  double nsPerTick;
+  uint32_t detections;     // Detector reads that returned true
+  uint64_t checksum;       // Detector decisions, in order
+  uint32_t hits;
+  uint32_t misses;
+};
+
+static std::vector<TickInput> makeTicks(SensorTrace& trace) {
+  std::vector<TickInput> ticks;
+  uint32_t totalParts = 0;
+  bool partPresent = false;
+  for (uint32_t t = 0; t <= trace.durationMs(); t += DATA_PROCESS_INTERVAL) {
+    const TraceSample& s = trace.at(t);
+    bool present = s.distance_mm > 0 && s.distance_mm < PART_DETECT_THRESHOLD;
+    totalParts += present && !partPresent;
+    partPresent = present;
+
+    TickInput tick = {};
+    tick.t_ms = t;
+    SystemState& state = tick.state;
+    state.speed_rpm = s.speed_rpm;
+    state.conveyorRunning = s.speed_rpm > MIN_SPEED_THRESHOLD;
+    state.partsPerMinute = EXPECTED_PARTS_PER_MIN;
+    state.totalParts = totalParts;
+    state.vibrationLevel = s.vibration_g;
+    state.temperature = s.temp_c;
+    state.humidity = s.humidity_pct;
+    state.pressure = s.pressure_hpa;
+    state.gasResistance = s.gas_ohm;
+    state.validMask = FIELD_ALL_MASK;
+    state.staleMask = 0;
+    ticks.push_back(tick);
+  }
+  return ticks;
+}
+
+static ProcessResult run(const std::vector<TickInput>& ticks, bool memoize) {
+  ProcessResult result = {};
+  DataProcessor processor;
+  processor.begin();
+  processor.setMemoization(memoize);
+
+  std::chrono::steady_clock::duration elapsed{};
+  volatile float sink = 0.0f;
+  for (size_t i = 0; i < ticks.size(); i++) {
+    hostSetMicros((uint64_t)ticks[i].t_ms * 1000ULL);
+    auto start = std::chrono::steady_clock::now();
+
+    // processData()
+    processor.update(ticks[i].state);
+    bool detected[4] = {
+      processor.detectSpeedAnomaly(),
+      processor.detectJam(),
+      processor.detectVibrationAnomaly(),
+      processor.detectEnvironmentalAnomaly(),
+    };
+    const StatisticalAnalyzer& stats = processor.getStatisticalAnalyzer();
+    float trend = stats.getVibrationTrend() + stats.getCurrentVibration();
+
+    // Reports: health line every 30 s, RUL and efficiency in the stats
+    if (i % (HEALTH_CHECK_INTERVAL / DATA_PROCESS_INTERVAL) == 0) {
+      RULEstimate rul;
+      trend += processor.getAverageSpeed() + processor.getSpeedStability() + processor.getVibrationTrend();
+      trend += processor.estimateRUL(rul) ? rul.hours : 0.0f;
+      trend += processor.predictMaintenanceHours() + processor.getEfficiencyScore();
+    }
+
+    elapsed += std::chrono::steady_clock::now() - start;
+    sink = sink + trend;
+    for (int d = 0; d < 4; d++) {
+      result.detections += detected[d];
+      result.checksum = result.checksum * 31 + detected[d];
+    }
+  }
+  (void)sink;
+
+  result.nsPerTick = std::chrono::duration<double, std::nano>(elapsed).count() / ticks.size();
+  result.hits = processor.getCacheHits();
+  result.misses = processor.getCacheMisses();
+  return result;
+}
+
+static void printResult(const char* name, const ProcessResult& r, size_t ticks) {
+  printf("%-10s %10.1f %10u %12.2f %12.2f\n", name, r.nsPerTick, r.detections, (double)r.misses / ticks,
+         (double)r.hits / ticks);
+}
+
+int main(int argc, char** argv) {
+  uint32_t minutes = 720;
+  uint32_t seed = 1;
+  int repeat = 3;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--minutes" && hasValue) minutes = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--repeat" && hasValue) repeat = atoi(argv[++i]);
+    else {
+      fprintf(stderr,
+              "usage: process_bench [options]\n"
+              "  --minutes N     simulated trace length (default 720)\n"
+              "  --seed N        trace seed (default 1)\n"
+              "  --repeat N      runs per mode, fastest is reported (default 3)\n");
+      return 2;
+    }
+  }
+  if (minutes == 0 || repeat < 1) {
+    fprintf(stderr, "process_bench: --minutes and --repeat must be positive\n");
+    return 2;
+  }
+
+  SensorTrace trace;
+  trace.simulate(minutes, seed);
+  std::vector<TickInput> ticks = makeTicks(trace);
+
+  ProcessResult best[2];
+  for (int mode = 0; mode < 2; mode++) {
+    for (int r = 0; r < repeat; r++) {
+      ProcessResult result = run(ticks, mode == 1);
+      if (r == 0 || result.nsPerTick < best[mode].nsPerTick) {
+        best[mode] = result;
+      }
+    }
+  }
+
+  printf("%-10s %10s %10s %12s %12s\n", "mode", "ns/tick", "detections", "computed/tick", "cached/tick");
+  printResult("recompute", best[0], ticks.size());
+  printResult("memoized", best[1], ticks.size());
+  printf("%zu ticks, speedup %.2fx\n", ticks.size(), best[0].nsPerTick / best[1].nsPerTick);
+
+  if (best[0].checksum != best[1].checksum || best[0].detections != best[1].detections) {
+    printf("MISMATCH: memoized detector decisions differ\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Per-point cost of the SPC control charts
+ *
+ * Feeds a long synthetic signal (in-control noise with occasional shifts,
+ * drifts and oscillation so every rule fires) through an individuals chart
+ * and an X-bar/R chart and reports the time per sample and per plotted
+ * point, plus how often each rule fired. The chart code is the unmodified
+ * firmware module; only the clock and RNG come from the host layer.
+ *
+ *   spc_bench [--points N] [--subgroup N] [--seed N]
+ *
+ * Exit status: 0 = ok, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "data_processing/spc_chart.h"
+
+struct BenchResult {
+  double nsPerSample;
+  double nsPerPoint;
+  uint32_t points;
+  uint32_t onsets[SPC_RULE_COUNT];
+  uint32_t outOfControl;
+};
+
+// In control, then a mean shift, a drift, an oscillation, back in control
+static std::vector<float> makeSignal(size_t count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  std::vector<float> signal(count);
+  for (size_t i = 0; i < count; i++) {
+    size_t phase = (i / 5000) % 8;
+    float offset = 0.0f;
+    switch (phase) {
+      case 3: offset = 1.5f; break;
+      case 5: offset = (float)(i % 5000) * 0.0008f; break;
+      case 6: offset = (i & 1) ? 1.2f : -1.2f; break;
+      default: break;
+    }
+    signal[i] = 50.0f + offset + noise(rng);
+  }
+  return signal;
+}
+
+static BenchResult run(const std::vector<float>& signal, uint8_t subgroup) {
+  BenchResult result = {};
+  SPCChart chart;
+  chart.begin(subgroup, 0.0f);
+
+  volatile uint8_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (float value : signal) {
+    uint8_t onsets = chart.addSample(value);
+    sink ^= onsets;
+    for (int r = 0; r < SPC_RULE_COUNT; r++) {
+      result.onsets[r] += (onsets >> r) & 1;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  (void)sink;
+
+  result.points = chart.getPointCount();
+  result.outOfControl = chart.getViolationCount();
+  result.nsPerSample = seconds * 1e9 / signal.size();
+  result.nsPerPoint = result.points ? seconds * 1e9 / result.points : 0.0;
+  return result;
+}
+
+static void printResult(const char* name, const BenchResult& r) {
+  printf("%-14s %10u %10.1f %10.1f %8u", name, r.points, r.nsPerSample, r.nsPerPoint, r.outOfControl);
+  for (int i = 0; i < SPC_RULE_COUNT; i++) {
+    printf(" %7u", r.onsets[i]);
+  }
+  printf("\n");
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: spc_bench [options]\n"
+          "  --points N      samples per chart (default 10000000)\n"
+          "  --subgroup N    X-bar/R subgroup size, 2..%d (default SPC_SPEED_SUBGROUP)\n"
+          "  --seed N        signal seed (default 1)\n",
+          SPC_MAX_SUBGROUP);
+}
+
+int main(int argc, char** argv) {
+  size_t count = 10000000;
+  int subgroup = SPC_SPEED_SUBGROUP;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--points" && hasValue) count = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--subgroup" && hasValue) subgroup = atoi(argv[++i]);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      usage();
+      return 2;
+    }
+  }
+  if (count == 0 || subgroup < 2 || subgroup > SPC_MAX_SUBGROUP) {
+    usage();
+    return 2;
+  }
+
+  std::vector<float> signal = makeSignal(count, seed);
+
+  printf("%-14s %10s %10s %10s %8s", "chart", "points", "ns/sample", "ns/point", "ooc");
+  for (int i = 0; i < SPC_RULE_COUNT; i++) {
+    printf(" %7.7s", SPCChart::getRuleName((SPCRule)(1 << i)));
+  }
+  printf("\n");
+
+  printResult("individuals", run(signal, 1));
+  char name[16];
+  snprintf(name, sizeof(name), "xbar-r n=%d", subgroup);
+  printResult(name, run(signal, (uint8_t)subgroup));
+  return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * Cost and accuracy of the belt speed filter
+ *
+ * Drives a synthetic belt (steady running with load ripple, starts, stops,
+ * speed changes with and without a vibration change, and single-read
+ * encoder glitches) through the firmware SpeedFilter at the nominal sensor
+ * rate. Reports the time per update and, against the true speed, the RMS
+ * error of the raw encoder and of the filter in steady running, the reads
+ * needed to settle within 1 RPM after a step, and glitches let through.
+ *
+ *   speed_bench [--reads N] [--interval MS] [--seed N]
+ *
+ * Exit status: 0 = ok, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/system_config.h"
+#include "sensors/speed_filter.h"
+
+struct BeltSample {
+  float trueRpm;
+  float encoderRpm;
+  float accelG;
+  bool steady;      // Not within a few seconds of a step
+  bool glitch;      // Encoder read corrupted
+  bool step;        // First read after a speed step
+};
+
+// Cycles through running, a speed change (frame vibration unchanged), a stop and a restart
+static std::vector<BeltSample> makeBelt(size_t count, float intervalS, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::vector<BeltSample> belt(count);
+
+  const size_t phaseReads = (size_t)(60.0f / intervalS);   // One minute per phase
+  const size_t settleReads = (size_t)(3.0f / intervalS);
+  const float phaseRpm[4] = {NOMINAL_SPEED_RPM, 45.0f, 0.0f, NOMINAL_SPEED_RPM};
+  for (size_t i = 0; i < count; i++) {
+    size_t phase = (i / phaseReads) % 4;
+    size_t inPhase = i % phaseReads;
+    float target = phaseRpm[phase];
+    float ripple = target > 0.0f ? 0.3f * sinf(2.0f * (float)M_PI * 0.05f * i * intervalS) : 0.0f;
+
+    BeltSample& s = belt[i];
+    s.trueRpm = target + ripple;
+    s.encoderRpm = target > 0.0f ? roundf(s.trueRpm + 0.4f * noise(rng)) : 0.0f;
+    s.glitch = target > 0.0f && uniform(rng) < 0.001f;
+    if (s.glitch) {
+      s.encoderRpm += (uniform(rng) < 0.5f ? -1.0f : 1.0f) * 20.0f;
+    }
+    s.accelG = (target > 0.0f ? 0.5f : 0.05f) + (target > 0.0f ? 0.04f : 0.01f) * noise(rng);
+    s.steady = inPhase >= settleReads;
+    s.step = i > 0 && inPhase == 0;
+  }
+  return belt;
+}
+
+int main(int argc, char** argv) {
+  size_t count = 10000000;
+  unsigned long intervalMs = SENSOR_READ_INTERVAL;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--reads" && hasValue) count = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--interval" && hasValue) intervalMs = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr,
+              "usage: speed_bench [options]\n"
+              "  --reads N       encoder reads (default 10000000)\n"
+              "  --interval MS   read interval (default SENSOR_READ_INTERVAL)\n"
+              "  --seed N        belt seed (default 1)\n");
+      return 2;
+    }
+  }
+  if (count == 0 || intervalMs == 0) {
+    fprintf(stderr, "speed_bench: --reads and --interval must be positive\n");
+    return 2;
+  }
+
+  float intervalS = intervalMs / 1000.0f;
+  std::vector<BeltSample> belt = makeBelt(count, intervalS, seed);
+  std::vector<float> estimate(count);
+
+  SpeedFilter filter;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; i++) {
+    filter.update(belt[i].encoderRpm, belt[i].accelG, intervalS);
+    estimate[i] = filter.getSpeed();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double rawSq = 0.0, filteredSq = 0.0;
+  size_t steadyReads = 0, steps = 0, settleTotal = 0, settleWorst = 0, glitches = 0, glitchesPassed = 0;
+  for (size_t i = 0; i < count; i++) {
+    const BeltSample& s = belt[i];
+    if (s.steady && !s.glitch) {
+      rawSq += sq(s.encoderRpm - s.trueRpm);
+      filteredSq += sq(estimate[i] - s.trueRpm);
+      steadyReads++;
+    }
+    if (s.glitch) {
+      glitches++;
+      glitchesPassed += fabsf(estimate[i] - s.trueRpm) > 5.0f;
+    }
+    if (s.step) {
+      size_t settle = 0;
+      while (i + settle < count && fabsf(estimate[i + settle] - belt[i + settle].trueRpm) > 1.0f) {
+        settle++;
+      }
+      steps++;
+      settleTotal += settle;
+      settleWorst = std::max(settleWorst, settle);
+    }
+  }
+
+  printf("%-14s %10s %10s %10s %10s %10s %10s %10s\n", "filter", "reads", "ns/update", "raw rms", "rms",
+         "settle", "worst", "glitches");
+  printf("%-14s %10zu %10.1f %10.3f %10.3f %10.1f %10zu %6zu/%zu\n", "speed", count, seconds * 1e9 / count,
+         steadyReads ? sqrt(rawSq / steadyReads) : 0.0, steadyReads ? sqrt(filteredSq / steadyReads) : 0.0,
+         steps ? (double)settleTotal / steps : 0.0, settleWorst, glitchesPassed, glitches);
+  printf("final sd %.3f rpm, %u of %u reads held back\n", filter.getStdDev(), filter.getRejected(),
+         filter.getUpdates());
+  return 0;
+}
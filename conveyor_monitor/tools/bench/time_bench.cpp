@@ -0,0 +1,160 @@
+/**
+ * Accuracy and request rate of the card.time disciplined epoch clock
+ *
+ * Runs the firmware TimeSync against a simulated MCU oscillator that is off
+ * by a fixed error plus a daily (temperature) wander, and a Notecard whose
+ * card.time truncates to the second and answers after 30-150 ms of serial
+ * round trip. The Notecard has no time for the first minutes after boot.
+ * Once a minute the clock's Unix time is compared with the true time.
+ * Reports the timestamp error, the drift estimate and the card.time
+ * requests made per day, against a clock set once at the first sync and
+ * left to run on millis().
+ *
+ *   time_bench [--days N] [--ppm X] [--wander X] [--no-time N] [--seed N]
+ *
+ * Exit status: 0 = ok, 1 = the 95th percentile error after the first day
+ * exceeds TIME_SYNC_TOLERANCE_MS, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "config/system_config.h"
+#include "communication/time_sync.h"
+
+namespace {
+
+constexpr uint64_t EPOCH_START_MS = 1767225600000ULL;   // 2026-01-01T00:00:00Z
+constexpr double DAY_S = 86400.0;
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  size_t index = std::min(values.size() - 1, (size_t)(p * values.size()));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  double days = 14.0;
+  double ppm = 100.0;
+  double wander = 10.0;
+  double noTimeMinutes = 10.0;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--days" && hasValue) days = atof(argv[++i]);
+    else if (arg == "--ppm" && hasValue) ppm = atof(argv[++i]);
+    else if (arg == "--wander" && hasValue) wander = atof(argv[++i]);
+    else if (arg == "--no-time" && hasValue) noTimeMinutes = atof(argv[++i]);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr,
+              "usage: time_bench [options]\n"
+              "  --days N        simulated days (default 14)\n"
+              "  --ppm X         MCU clock error, + runs fast (default 100)\n"
+              "  --wander X      daily swing of the error, ppm (default 10)\n"
+              "  --no-time N     minutes before the Notecard has time (default 10)\n"
+              "  --seed N        latency and phase seed (default 1)\n");
+      return 2;
+    }
+  }
+  if (days <= 0.0) {
+    fprintf(stderr, "time_bench: --days must be positive\n");
+    return 2;
+  }
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> latencyMs(30, 150);
+  std::uniform_real_distribution<double> phaseMs(0.0, 1000.0);
+  auto clockError = [&](double trueS) { return ppm + wander * sin(2.0 * M_PI * trueS / DAY_S); };
+
+  TimeSync clock;
+  double localMs = 0.0;                // millis() of the simulated MCU
+  bool freeRunSet = false;             // Baseline: set at the first sync, never corrected
+  double freeRunBaseLocal = 0.0;
+  double freeRunBaseEpoch = 0.0;
+
+  std::vector<double> disciplined;
+  std::vector<double> settled;         // After the first day
+  std::vector<double> freeRun;
+  std::vector<double> settledFreeRun;
+  uint32_t requests = 0;
+  uint32_t requestsLastDay = 0;
+
+  uint64_t seconds = (uint64_t)(days * DAY_S);
+  for (uint64_t s = 0; s < seconds; s++) {
+    double trueMs = s * 1000.0;
+    hostSetMicros((uint64_t)(localMs * 1000.0));
+
+    if (clock.syncDue()) {
+      requests++;
+      if (s >= seconds - (uint64_t)DAY_S) {
+        requestsLastDay++;
+      }
+      // The loop reaches the request anywhere within the second
+      double phase = phaseMs(rng);
+      double latency = latencyMs(rng);
+      double rate = 1.0 + clockError(s) * 1e-6;
+      unsigned long requestTime = (unsigned long)(localMs + phase * rate);
+      unsigned long responseTime = (unsigned long)(localMs + (phase + latency) * rate);
+      hostSetMicros((uint64_t)responseTime * 1000);
+      if (s < noTimeMinutes * 60.0) {
+        clock.recordFailure(responseTime);
+      } else {
+        // The Notecard reads its clock mid-way through the round trip
+        uint64_t epochMs = EPOCH_START_MS + (uint64_t)(trueMs + phase + latency / 2);
+        clock.apply((uint32_t)(epochMs / 1000), requestTime, responseTime);
+        if (!freeRunSet) {
+          freeRunSet = true;
+          freeRunBaseLocal = localMs + (phase + latency / 2) * rate;
+          freeRunBaseEpoch = (double)(epochMs / 1000) * 1000.0 + 500.0;
+        }
+      }
+    }
+
+    if (clock.isSynced() && s % 60 == 0) {
+      double truth = (double)EPOCH_START_MS + trueMs;
+      double error = fabs((double)clock.epochMsAt(millis()) - truth);
+      double freeError = fabs(freeRunBaseEpoch + (localMs - freeRunBaseLocal) - truth);
+      disciplined.push_back(error);
+      freeRun.push_back(freeError);
+      if (s >= DAY_S) {
+        settled.push_back(error);
+        settledFreeRun.push_back(freeError);
+      }
+    }
+
+    localMs += 1000.0 * (1.0 + clockError(s) * 1e-6);
+  }
+
+  printf("clock: %+.0f ppm %+.0f ppm daily wander, %.0f days, card.time from minute %.0f\n",
+         ppm, wander, days, noTimeMinutes);
+  printf("%-22s %10s %10s %10s\n", "timestamp error (ms)", "p50", "p95", "max");
+  auto row = [](const char* name, const std::vector<double>& values) {
+    printf("%-22s %10.0f %10.0f %10.0f\n", name, percentile(values, 0.50), percentile(values, 0.95),
+           values.empty() ? 0.0 : *std::max_element(values.begin(), values.end()));
+  };
+  row("disciplined", disciplined);
+  row("disciplined, day 2+", settled);
+  row("set once", freeRun);
+  row("set once, day 2+", settledFreeRun);
+  printf("drift estimate: %+.1f ppm (ideal now %+.1f ppm)\n", clock.getDriftPpm(),
+         -clockError(seconds) / (1.0 + clockError(seconds) * 1e-6));
+  printf("card.time: %u requests (%.1f/day, %u in the last day), %u syncs, %u steps, %u failures, interval %lu min\n",
+         requests, requests / days, requestsLastDay, clock.getSyncCount(), clock.getStepCount(),
+         clock.getFailureCount(), clock.getInterval() / 60000UL);
+
+  bool ok = percentile(settled, 0.95) <= TIME_SYNC_TOLERANCE_MS;
+  if (!ok) {
+    printf("p95 error after the first day exceeds %ld ms\n", TIME_SYNC_TOLERANCE_MS);
+  }
+  return ok ? 0 : 1;
+}
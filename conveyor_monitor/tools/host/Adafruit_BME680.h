@@ -0,0 +1,45 @@
+#ifndef HOST_ADAFRUIT_BME680_H
+#define HOST_ADAFRUIT_BME680_H
+
+#include <Arduino.h>
+
+#define BME680_OS_NONE 0
+#define BME680_OS_1X 1
+#define BME680_OS_2X 2
+#define BME680_OS_4X 3
+#define BME680_OS_8X 4
+#define BME680_FILTER_SIZE_3 2
+
+// Trace-backed BME680: a reading loads the current trace sample. Forced
+// measurements take as long as the library computes for the configured
+// oversampling and heater time; the sensor sleeps again on its own.
+class Adafruit_BME680 {
+  uint8_t osTemp = 0, osHum = 0, osPres = 0;
+  uint16_t heaterMs = 0;
+  unsigned long readyAt = 0;
+  bool measuring = false;
+  HostOnTime onTime;
+  uint32_t measurements = 0;
+public:
+  bool begin(uint8_t = 0x77, bool = true) { return true; }
+  bool setTemperatureOversampling(uint8_t os) { osTemp = os; return true; }
+  bool setHumidityOversampling(uint8_t os) { osHum = os; return true; }
+  bool setPressureOversampling(uint8_t os) { osPres = os; return true; }
+  bool setIIRFilterSize(uint8_t) { return true; }
+  bool setGasHeater(uint16_t, uint16_t ms) { heaterMs = ms; return true; }
+  bool performReading() { return beginReading() != 0 && endReading(); }
+  uint32_t beginReading();
+  bool endReading();
+  int remainingReadingMillis();
+
+  // Host only
+  uint64_t hostActiveMicros() const { return onTime.onMicros(); }
+  uint32_t hostMeasurements() const { return measurements; }
+
+  float temperature = 0;
+  float humidity = 0;
+  float pressure = 0;
+  uint32_t gas_resistance = 0;
+};
+
+#endif // HOST_ADAFRUIT_BME680_H
@@ -0,0 +1,18 @@
+#ifndef HOST_ADAFRUIT_SEESAW_H
+#define HOST_ADAFRUIT_SEESAW_H
+
+#include <Arduino.h>
+
+// Trace-backed rotary encoder: one detent per RPM above the power-up position
+class Adafruit_seesaw {
+  bool baselineRead = false;
+public:
+  bool begin(uint8_t = 0x49, int8_t = -1, bool = true) { return true; }
+  uint32_t getVersion() { return (uint32_t)4991 << 16; }
+  void pinMode(uint8_t, uint8_t) {}
+  void setGPIOInterrupts(uint32_t, bool) {}
+  void enableEncoderInterrupt(uint8_t = 0) {}
+  int32_t getEncoderPosition(uint8_t = 0);
+};
+
+#endif // HOST_ADAFRUIT_SEESAW_H
@@ -0,0 +1,148 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * Minimal Arduino core for building firmware modules on a Linux host.
+ *
+ * Time is simulated: millis()/micros() only move when the host tool calls
+ * hostAdvanceMicros(), or when firmware blocks in delay() or a fake driver
+ * call (hostChargeMicros()), so a replay is fully deterministic and runs as
+ * fast as the CPU allows. Serial output is
+ * discarded unless hostSetSerialEcho(true) is called.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <cmath>
+#include <string>
+#include <type_traits>
+
+using std::isnan;
+using std::isfinite;
+using std::abs;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define PROGMEM
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LOW 0
+#define HIGH 1
+#define FALLING 2
+
+// Pins and interrupts: no pin changes on the host, so no ISR ever runs
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+
+// Simulated time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void hostAdvanceMicros(uint64_t us);
+void hostSetMicros(uint64_t us);
+uint64_t hostNowMicros();
+// Blocking time the fakes spent with the MCU awake (delay(), bus transfers)
+void hostChargeMicros(uint64_t us);
+uint64_t hostBusyMicros();
+
+// Deterministic pseudo-random numbers (seeded by the host tool)
+long random(long maxValue);
+long random(long minValue, long maxValue);
+void randomSeed(unsigned long seed);
+
+template<class T> auto sq(T x) -> decltype(x * x) { return x * x; }
+template<class A, class B> auto min(A a, B b) -> typename std::common_type<A, B>::type { return a < b ? a : b; }
+template<class A, class B> auto max(A a, B b) -> typename std::common_type<A, B>::type { return a > b ? a : b; }
+template<class A, class B, class C> A constrain(A x, B lo, C hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+class String {
+  std::string s;
+public:
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned int v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(double v, int precision = 2) { char b[48]; snprintf(b, sizeof(b), "%.*f", precision, v); s = b; }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  const char* c_str() const { return s.c_str(); }
+  size_t length() const { return s.size(); }
+  bool operator==(const char* o) const { return s == o; }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const char* str) { size_t n = 0; while (*str) n += write((uint8_t)*str++); return n; }
+  size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = 10) { return printNumber((unsigned long)v, base); }
+  size_t print(int v, int base = 10) { return printNumber((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return printNumber((unsigned long)v, base); }
+  size_t print(long v, int base = 10) { return printNumber(v, base); }
+  size_t print(unsigned long v, int base = 10) { return printNumber(v, base); }
+  size_t print(double v, int digits = 2) { char b[48]; snprintf(b, sizeof(b), "%.*f", digits, v); return write(b); }
+  template<class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template<class T> size_t println(T v, int format) { size_t n = print(v, format); return n + println(); }
+  size_t println() { return write((uint8_t)'\n'); }
+private:
+  size_t printNumber(long v, int base) { char b[40]; snprintf(b, sizeof(b), base == 16 ? "%lX" : "%ld", v); return write(b); }
+  size_t printNumber(unsigned long v, int base) { char b[40]; snprintf(b, sizeof(b), base == 16 ? "%lX" : "%lu", v); return write(b); }
+};
+
+class Stream : public Print {};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  explicit operator bool() const { return true; }
+  size_t write(uint8_t c) override;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+void hostSetSerialEcho(bool echo);
+
+// Cortex-M sleep until the next interrupt; simulated time moves between loops anyway
+inline void __WFI() {}
+
+// Simulated on-time of a fake device, to check the firmware's energy accounting
+class HostOnTime {
+  bool on = false;
+  uint64_t since = 0;
+  uint64_t total = 0;
+public:
+  void set(bool state) {
+    uint64_t now = hostNowMicros();
+    if (on) total += now - since;
+    on = state;
+    since = now;
+  }
+  void addPulse(uint64_t startMicros, uint64_t durationMicros) {
+    total += durationMicros;
+    since = startMicros + durationMicros;   // Pulse end, for the in-flight part
+  }
+  bool isOn() const { return on; }
+  uint64_t onMicros() const {
+    uint64_t now = hostNowMicros();
+    if (on) return total + (now - since);
+    return since > now ? total - (since - now) : total;   // Pulse still running
+  }
+};
+
+#endif // HOST_ARDUINO_H
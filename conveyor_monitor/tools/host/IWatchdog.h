@@ -0,0 +1,42 @@
+#ifndef HOST_IWATCHDOG_H
+#define HOST_IWATCHDOG_H
+
+#include <Arduino.h>
+
+/**
+ * Host stand-in for the STM32duino IWatchdog library.
+ *
+ * Never resets anything; it measures the longest simulated gap between
+ * reloads so the replay can show the firmware would have kept the real
+ * watchdog fed.
+ */
+class IWatchdogClass {
+  uint32_t timeoutMicros = 0;
+  uint64_t lastReload = 0;
+  uint64_t longestGap = 0;
+  uint32_t reloads = 0;
+
+public:
+  void begin(uint32_t timeout_us) {
+    timeoutMicros = timeout_us;
+    lastReload = hostNowMicros();
+  }
+  void reload() {
+    uint64_t now = hostNowMicros();
+    if (now - lastReload > longestGap) longestGap = now - lastReload;
+    lastReload = now;
+    reloads++;
+  }
+  bool isEnabled() const { return timeoutMicros != 0; }
+  bool isReset(bool clear = false) { return false; }
+  void clearReset() {}
+
+  // Host only
+  uint32_t hostTimeoutMicros() const { return timeoutMicros; }
+  uint64_t hostLongestGapMicros() const { return longestGap; }
+  uint32_t hostReloads() const { return reloads; }
+};
+
+extern IWatchdogClass IWatchdog;
+
+#endif // HOST_IWATCHDOG_H
@@ -0,0 +1,50 @@
+#ifndef HOST_NOTECARD_H
+#define HOST_NOTECARD_H
+
+/**
+ * Host replacement for note-arduino: a small J JSON tree and a Notecard that
+ * answers requests locally and hands every request to a recorder callback.
+ */
+
+#include <Arduino.h>
+
+typedef struct J J;
+typedef double JNUMBER;
+
+J* JCreateObject();
+J* JParse(const char* text);
+void JDelete(J* item);
+char* JPrintUnformatted(J* item);
+void JFree(void* p);
+bool JHasObjectItem(J* object, const char* field);
+J* JGetObject(J* object, const char* field);
+JNUMBER JGetNumber(J* object, const char* field);
+int JGetInt(J* object, const char* field);
+bool JGetBool(J* object, const char* field);
+char* JGetString(J* object, const char* field);
+J* JAddStringToObject(J* object, const char* field, const char* value);
+J* JAddNumberToObject(J* object, const char* field, JNUMBER value);
+J* JAddBoolToObject(J* object, const char* field, bool value);
+void JAddItemToObject(J* object, const char* field, J* item);
+int JB64EncodeLen(int len);
+int JB64Encode(char* encoded, const char* data, int len);
+
+/**
+ * @brief Called with every request the firmware sends (request still owned by caller)
+ */
+typedef void (*NotecardRecorder)(J* req);
+
+class Notecard {
+public:
+  void begin(HardwareSerial&, uint32_t) {}
+  void setDebugOutputStream(Stream&) {}
+  J* newRequest(const char* request);
+  bool sendRequest(J* req);
+  J* requestAndResponse(J* req);
+  void deleteResponse(J* rsp) { JDelete(rsp); }
+  bool responseError(J* rsp) { return JHasObjectItem(rsp, "err"); }
+};
+
+void hostSetNotecardRecorder(NotecardRecorder recorder);
+
+#endif // HOST_NOTECARD_H
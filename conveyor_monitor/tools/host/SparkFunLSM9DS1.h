@@ -0,0 +1,31 @@
+#ifndef HOST_SPARKFUN_LSM9DS1_H
+#define HOST_SPARKFUN_LSM9DS1_H
+
+#include <Arduino.h>
+
+#define IMU_MODE_I2C 1
+
+struct LSM9DS1Settings {
+  struct { uint8_t commInterface; uint8_t mAddress; uint8_t agAddress; } device;
+  struct { uint8_t scale; uint8_t sampleRate; } accel;
+  struct { uint16_t scale; uint8_t sampleRate; } gyro;
+};
+
+// Trace-backed IMU: the trace vibration level is reported on the X axis (mg)
+class LSM9DS1 {
+public:
+  LSM9DS1Settings settings;
+  int16_t ax = 0, ay = 0, az = 0, gx = 0, gy = 0, gz = 0, mx = 0, my = 0, mz = 0;
+  uint16_t begin() { return 1; }
+  uint8_t accelAvailable() { return 1; }
+  uint8_t gyroAvailable() { return 0; }
+  uint8_t magAvailable(uint8_t = 3) { return 0; }
+  void readAccel();
+  void readGyro() {}
+  void readMag() {}
+  float calcAccel(int16_t raw) { return raw / 1000.0f; }
+  float calcGyro(int16_t raw) { return raw; }
+  float calcMag(int16_t raw) { return raw; }
+};
+
+#endif // HOST_SPARKFUN_LSM9DS1_H
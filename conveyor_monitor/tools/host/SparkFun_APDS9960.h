@@ -0,0 +1,29 @@
+#ifndef HOST_SPARKFUN_APDS9960_H
+#define HOST_SPARKFUN_APDS9960_H
+
+#include <Arduino.h>
+
+enum { DIR_NONE, DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN, DIR_NEAR, DIR_FAR, DIR_ALL };
+
+#define GGAIN_2X 1
+#define LED_DRIVE_25MA 2
+
+// Trace-backed gesture sensor: proximity from the trace, no gestures
+class SparkFun_APDS9960 {
+  HostOnTime gestureOnTime;
+public:
+  bool init() { return true; }
+  bool enableGestureSensor(bool = true) { gestureOnTime.set(true); return true; }
+  bool disableGestureSensor() { gestureOnTime.set(false); return true; }
+  bool enableProximitySensor(bool = false) { return true; }
+  bool setGestureGain(uint8_t) { return true; }
+  bool setGestureLEDDrive(uint8_t) { return true; }
+  bool isGestureAvailable() { return false; }
+  int readGesture() { return DIR_NONE; }
+  bool readProximity(uint8_t& value);
+
+  // Host only
+  uint64_t hostGestureMicros() const { return gestureOnTime.onMicros(); }
+};
+
+#endif // HOST_SPARKFUN_APDS9960_H
@@ -0,0 +1,65 @@
+#include "detector_pipeline.h"
+
+DetectorPipeline::DetectorPipeline() {
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    active[i] = false;
+  }
+}
+
+void DetectorPipeline::reset(const AnomalyThresholds& thresholds) {
+  hostSetMicros(0);
+  statisticalAnalyzer = StatisticalAnalyzer();
+  anomalyDetector = AnomalyDetector();
+  anomalyDetector.setThresholds(thresholds);
+  statisticalAnalyzer.begin();
+  anomalyDetector.begin();
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    active[i] = false;
+  }
+}
+
+void DetectorPipeline::update(const SystemState& state, bool onsets[DETECT_COUNT]) {
+  // Same sequence as DataProcessor::update and processData()
+  statisticalAnalyzer.update(state);
+  anomalyDetector.update(state,
+                         statisticalAnalyzer.getAverageSpeed(),
+                         statisticalAnalyzer.getSpeedVariance(),
+                         statisticalAnalyzer.getVibrationBaseline());
+
+  bool detected[DETECT_COUNT] = {
+    anomalyDetector.detectSpeedAnomaly(statisticalAnalyzer.getAverageSpeed(),
+                                       statisticalAnalyzer.getSpeedVariance()),
+    anomalyDetector.detectJam(),
+    anomalyDetector.detectVibrationAnomaly(statisticalAnalyzer.getCurrentVibration(),
+                                           statisticalAnalyzer.getVibrationBaseline(),
+                                           statisticalAnalyzer.getVibrationTrend()),
+    anomalyDetector.detectEnvironmentalAnomaly(statisticalAnalyzer.getCurrentTemperature(),
+                                               statisticalAnalyzer.getCurrentHumidity(),
+                                               statisticalAnalyzer.getTemperatureVariance()) ||
+      anomalyDetector.detectAirQualityAnomaly(state.iaq, state.iaqAccuracy)
+  };
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    onsets[i] = detected[i] && !active[i];
+    active[i] = detected[i];
+  }
+}
+
+DetectorChannel DetectorPipeline::channelFor(AlertType type) {
+  switch (type) {
+    case ALERT_SPEED_ANOMALY: return DETECT_SPEED;
+    case ALERT_JAM_DETECTED: return DETECT_JAM;
+    case ALERT_VIBRATION_HIGH: return DETECT_VIBRATION;
+    case ALERT_ENV_CONDITION: return DETECT_ENVIRONMENT;
+    default: return DETECT_COUNT;
+  }
+}
+
+const char* DetectorPipeline::getChannelName(DetectorChannel channel) {
+  switch (channel) {
+    case DETECT_SPEED: return "speed";
+    case DETECT_JAM: return "jam";
+    case DETECT_VIBRATION: return "vib";
+    case DETECT_ENVIRONMENT: return "env";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef DETECTOR_PIPELINE_H
+#define DETECTOR_PIPELINE_H
+
+#include "data_processing/statistical_analyzer.h"
+#include "data_processing/anomaly_detector.h"
+#include "config/alert_config.h"
+
+/**
+ * @brief Detector outputs, in AlertType order from ALERT_SPEED_ANOMALY
+ */
+enum DetectorChannel {
+  DETECT_SPEED = 0,
+  DETECT_JAM,
+  DETECT_VIBRATION,
+  DETECT_ENVIRONMENT,
+  DETECT_COUNT
+};
+
+/**
+ * @brief StatisticalAnalyzer + AnomalyDetector wired as on the device
+ *
+ * Runs the same update/detect sequence as DataProcessor::update() and
+ * processData(), on the calling thread's simulated clock, and reports
+ * which detectors fired and which just started firing (onsets).
+ */
+class DetectorPipeline {
+private:
+  StatisticalAnalyzer statisticalAnalyzer;
+  AnomalyDetector anomalyDetector;
+  bool active[DETECT_COUNT];
+
+public:
+  DetectorPipeline();
+
+  /**
+   * @brief Start over at simulated time 0 with the given thresholds
+   */
+  void reset(const AnomalyThresholds& thresholds);
+
+  /**
+   * @brief Process one state at the current simulated time
+   * @param state System state
+   * @param onsets Set for detectors that fired now but not on the previous update
+   */
+  void update(const SystemState& state, bool onsets[DETECT_COUNT]);
+
+  bool isActive(DetectorChannel channel) const { return active[channel]; }
+
+  /**
+   * @brief Channel for an alert type, or DETECT_COUNT if no detector raises it
+   */
+  static DetectorChannel channelFor(AlertType type);
+
+  static const char* getChannelName(DetectorChannel channel);
+};
+
+#endif // DETECTOR_PIPELINE_H
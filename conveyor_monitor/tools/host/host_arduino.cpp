@@ -0,0 +1,160 @@
+// Host implementations of the Arduino core and the trace-backed sensor libraries
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <IWatchdog.h>
+#include <Adafruit_BME680.h>
+#include <Adafruit_seesaw.h>
+#include <VL53L1X.h>
+#include <SparkFunLSM9DS1.h>
+#include <SparkFun_APDS9960.h>
+#include "sensor_trace.h"
+
+// --- Simulated time ---------------------------------------------------------
+
+// One clock per thread so analysis tools can replay independent lines in parallel
+static thread_local uint64_t simMicros = 0;
+static thread_local uint64_t busyMicros = 0;
+
+unsigned long millis() { return (unsigned long)(simMicros / 1000); }
+unsigned long micros() { return (unsigned long)simMicros; }
+void delay(unsigned long ms) { hostChargeMicros((uint64_t)ms * 1000); }
+void hostChargeMicros(uint64_t us) {
+  simMicros += us;
+  busyMicros += us;
+}
+uint64_t hostBusyMicros() { return busyMicros; }
+void hostAdvanceMicros(uint64_t us) { simMicros += us; }
+void hostSetMicros(uint64_t us) { simMicros = us; }
+uint64_t hostNowMicros() { return simMicros; }
+
+// --- Random -----------------------------------------------------------------
+
+static thread_local uint32_t rngState = 1;
+
+void randomSeed(unsigned long seed) { rngState = seed ? (uint32_t)seed : 1; }
+
+static uint32_t nextRandom() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+long random(long maxValue) { return maxValue > 0 ? (long)(nextRandom() % (uint32_t)maxValue) : 0; }
+long random(long minValue, long maxValue) { return maxValue > minValue ? minValue + random(maxValue - minValue) : minValue; }
+
+// --- Serial -----------------------------------------------------------------
+
+static bool serialEcho = false;
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+TwoWire Wire;
+IWatchdogClass IWatchdog;
+
+void hostSetSerialEcho(bool echo) { serialEcho = echo; }
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (serialEcho && this == &Serial) {
+    fputc(c, stderr);
+  }
+  return 1;
+}
+
+// --- Trace-backed sensors ---------------------------------------------------
+
+static SensorTrace* activeTrace = nullptr;
+static uint64_t sensorReads = 0;
+static const TraceSample idleSample = { 0, 0.0f, 300, 0.05f, 22.0f, 45.0f, 1013.2f, 150000, 0, LABEL_NONE };
+
+void hostSetSensorTrace(SensorTrace* trace) { activeTrace = trace; }
+SensorTrace* hostSensorTrace() { return activeTrace; }
+uint64_t hostSensorReads() { return sensorReads; }
+
+// A blocking I2C transaction: 9 clocks per byte at 400 kHz (Wire.setClock in setup())
+static void chargeI2C(uint32_t bytes, uint32_t waitUs = 0) {
+  hostChargeMicros(bytes * 9 * 1000000ULL / 400000 + waitUs);
+}
+
+static const TraceSample& currentSample() {
+  if (activeTrace == nullptr || activeTrace->size() == 0) {
+    return idleSample;
+  }
+  return activeTrace->at(millis());
+}
+
+int32_t Adafruit_seesaw::getEncoderPosition(uint8_t) {
+  // The power-up read defines zero speed
+  if (!baselineRead) {
+    baselineRead = true;
+    return 0;
+  }
+  sensorReads++;   // Encoder is read once per SensorManager::readAll()
+  chargeI2C(8, 250);   // Register write, the library's 250 us wait, 4 data bytes
+  return (int32_t)lroundf(currentSample().speed_rpm);
+}
+
+uint32_t Adafruit_BME680::beginReading() {
+  if (measuring) {
+    return readyAt;
+  }
+  // Same estimate as the library (bme68x_get_meas_dur plus the heater time)
+  static const uint8_t osCycles[] = {0, 1, 2, 4, 8, 16};
+  uint32_t cycles = osCycles[osTemp] + osCycles[osPres] + osCycles[osHum];
+  uint32_t durationUs = cycles * 1963 + 477 * 4 + 477 * 5 + 1000 + heaterMs * 1000UL;
+  onTime.addPulse(hostNowMicros(), durationUs);
+  measurements++;
+  measuring = true;
+  readyAt = millis() + durationUs / 1000;
+  return readyAt;
+}
+
+int Adafruit_BME680::remainingReadingMillis() {
+  if (!measuring) return -1;   // Library: no reading in progress
+  long remaining = (long)(readyAt - millis());
+  return remaining > 0 ? (int)remaining : 0;
+}
+
+bool Adafruit_BME680::endReading() {
+  if (!measuring) {
+    return false;
+  }
+  // The library blocks for whatever is left of the measurement
+  int remaining = remainingReadingMillis();
+  if (remaining > 0) {
+    delay(remaining);
+  }
+  measuring = false;
+  chargeI2C(20);   // Field 0 data block
+  const TraceSample& s = currentSample();
+  temperature = s.temp_c;
+  humidity = s.humidity_pct;
+  pressure = s.pressure_hpa * 100.0f;   // Library reports Pa
+  gas_resistance = s.gas_ohm;
+  return true;
+}
+
+uint16_t VL53L1X::read(bool) {
+  if (!onTime.isOn()) {
+    timedOut = true;   // No ranging in standby
+    return 0;
+  }
+  chargeI2C(25);   // 17-byte result block and the interrupt clear
+  uint16_t distance = currentSample().distance_mm;
+  timedOut = (distance == 0);
+  return distance;
+}
+
+void LSM9DS1::readAccel() {
+  chargeI2C(9);   // Six output bytes
+  ax = (int16_t)lroundf(currentSample().vibration_g * 1000.0f);
+  ay = 0;
+  az = 0;
+}
+
+bool SparkFun_APDS9960::readProximity(uint8_t& value) {
+  chargeI2C(4);
+  value = currentSample().proximity;
+  return true;
+}
@@ -0,0 +1,334 @@
+// Host J JSON tree and a Notecard that answers locally and records requests
+
+#include <Notecard.h>
+#include <ctype.h>
+#include <vector>
+
+struct J {
+  enum Type { OBJECT, ARRAY, NUMBER, STRING, BOOLEAN, NIL } type;
+  std::string key;
+  double number = 0;
+  std::string text;
+  bool flag = false;
+  std::vector<J*> items;
+
+  explicit J(Type t) : type(t) {}
+  ~J() { for (J* item : items) delete item; }
+};
+
+// --- Construction and lookup ------------------------------------------------
+
+J* JCreateObject() { return new J(J::OBJECT); }
+
+void JDelete(J* item) { delete item; }
+
+void JFree(void* p) { free(p); }
+
+static J* findItem(J* object, const char* field) {
+  if (object == nullptr || object->type != J::OBJECT) {
+    return nullptr;
+  }
+  for (J* item : object->items) {
+    if (item->key == field) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
+bool JHasObjectItem(J* object, const char* field) { return findItem(object, field) != nullptr; }
+
+J* JGetObject(J* object, const char* field) {
+  J* item = findItem(object, field);
+  return (item && item->type == J::OBJECT) ? item : nullptr;
+}
+
+JNUMBER JGetNumber(J* object, const char* field) {
+  J* item = findItem(object, field);
+  if (item == nullptr) return 0;
+  if (item->type == J::NUMBER) return item->number;
+  if (item->type == J::BOOLEAN) return item->flag ? 1 : 0;
+  return 0;
+}
+
+int JGetInt(J* object, const char* field) { return (int)JGetNumber(object, field); }
+
+bool JGetBool(J* object, const char* field) {
+  J* item = findItem(object, field);
+  return item && item->type == J::BOOLEAN && item->flag;
+}
+
+char* JGetString(J* object, const char* field) {
+  static char empty[] = "";
+  J* item = findItem(object, field);
+  return (item && item->type == J::STRING) ? &item->text[0] : empty;
+}
+
+void JAddItemToObject(J* object, const char* field, J* item) {
+  if (object == nullptr || item == nullptr) {
+    delete item;
+    return;
+  }
+  item->key = field;
+  object->items.push_back(item);
+}
+
+J* JAddStringToObject(J* object, const char* field, const char* value) {
+  J* item = new J(J::STRING);
+  item->text = value ? value : "";
+  JAddItemToObject(object, field, item);
+  return item;
+}
+
+J* JAddNumberToObject(J* object, const char* field, JNUMBER value) {
+  J* item = new J(J::NUMBER);
+  item->number = value;
+  JAddItemToObject(object, field, item);
+  return item;
+}
+
+J* JAddBoolToObject(J* object, const char* field, bool value) {
+  J* item = new J(J::BOOLEAN);
+  item->flag = value;
+  JAddItemToObject(object, field, item);
+  return item;
+}
+
+// --- Parsing ----------------------------------------------------------------
+
+namespace {
+
+struct Parser {
+  const char* p;
+
+  void skip() { while (*p && isspace((unsigned char)*p)) p++; }
+
+  bool parseString(std::string& out) {
+    if (*p != '"') return false;
+    p++;
+    while (*p && *p != '"') {
+      if (*p == '\\' && p[1]) {
+        p++;
+        switch (*p) {
+          case 'n': out += '\n'; break;
+          case 't': out += '\t'; break;
+          case 'r': out += '\r'; break;
+          default: out += *p; break;
+        }
+      } else {
+        out += *p;
+      }
+      p++;
+    }
+    if (*p != '"') return false;
+    p++;
+    return true;
+  }
+
+  J* parseValue() {
+    skip();
+    if (*p == '{') return parseContainer(J::OBJECT, '}');
+    if (*p == '[') return parseContainer(J::ARRAY, ']');
+    if (*p == '"') {
+      J* item = new J(J::STRING);
+      if (!parseString(item->text)) { delete item; return nullptr; }
+      return item;
+    }
+    if (strncmp(p, "true", 4) == 0) { p += 4; J* item = new J(J::BOOLEAN); item->flag = true; return item; }
+    if (strncmp(p, "false", 5) == 0) { p += 5; return new J(J::BOOLEAN); }
+    if (strncmp(p, "null", 4) == 0) { p += 4; return new J(J::NIL); }
+    char* end = nullptr;
+    double value = strtod(p, &end);
+    if (end == p) return nullptr;
+    p = end;
+    J* item = new J(J::NUMBER);
+    item->number = value;
+    return item;
+  }
+
+  J* parseContainer(J::Type type, char close) {
+    J* container = new J(type);
+    p++;
+    skip();
+    if (*p == close) { p++; return container; }
+    while (true) {
+      skip();
+      std::string key;
+      if (type == J::OBJECT) {
+        if (!parseString(key)) break;
+        skip();
+        if (*p != ':') break;
+        p++;
+      }
+      J* item = parseValue();
+      if (item == nullptr) break;
+      item->key = key;
+      container->items.push_back(item);
+      skip();
+      if (*p == ',') { p++; continue; }
+      if (*p == close) { p++; return container; }
+      break;
+    }
+    delete container;
+    return nullptr;
+  }
+};
+
+void printItem(const J* item, std::string& out) {
+  char buf[40];
+  switch (item->type) {
+    case J::OBJECT:
+    case J::ARRAY: {
+      out += item->type == J::OBJECT ? '{' : '[';
+      for (size_t i = 0; i < item->items.size(); i++) {
+        if (i) out += ',';
+        if (item->type == J::OBJECT) {
+          out += '"';
+          out += item->items[i]->key;
+          out += "\":";
+        }
+        printItem(item->items[i], out);
+      }
+      out += item->type == J::OBJECT ? '}' : ']';
+      break;
+    }
+    case J::NUMBER:
+      if (item->number == (double)(long long)item->number && fabs(item->number) < 1e15) {
+        snprintf(buf, sizeof(buf), "%lld", (long long)item->number);
+      } else {
+        snprintf(buf, sizeof(buf), "%.10g", item->number);
+      }
+      out += buf;
+      break;
+    case J::STRING:
+      out += '"';
+      for (char c : item->text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+      }
+      out += '"';
+      break;
+    case J::BOOLEAN:
+      out += item->flag ? "true" : "false";
+      break;
+    default:
+      out += "null";
+      break;
+  }
+}
+
+} // namespace
+
+J* JParse(const char* text) {
+  if (text == nullptr) return nullptr;
+  Parser parser = { text };
+  return parser.parseValue();
+}
+
+char* JPrintUnformatted(J* item) {
+  if (item == nullptr) return nullptr;
+  std::string out;
+  printItem(item, out);
+  return strdup(out.c_str());
+}
+
+// --- Base64 -----------------------------------------------------------------
+
+int JB64EncodeLen(int len) { return ((len + 2) / 3) * 4 + 1; }
+
+int JB64Encode(char* encoded, const char* data, int len) {
+  static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const uint8_t* in = (const uint8_t*)data;
+  char* out = encoded;
+  int i = 0;
+  for (; i + 2 < len; i += 3) {
+    *out++ = alphabet[in[i] >> 2];
+    *out++ = alphabet[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+    *out++ = alphabet[((in[i + 1] & 0x0F) << 2) | (in[i + 2] >> 6)];
+    *out++ = alphabet[in[i + 2] & 0x3F];
+  }
+  if (i < len) {
+    *out++ = alphabet[in[i] >> 2];
+    if (i + 1 < len) {
+      *out++ = alphabet[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+      *out++ = alphabet[(in[i + 1] & 0x0F) << 2];
+    } else {
+      *out++ = alphabet[(in[i] & 0x03) << 4];
+      *out++ = '=';
+    }
+    *out++ = '=';
+  }
+  *out++ = '\0';
+  return (int)(out - encoded);
+}
+
+// --- Notecard ---------------------------------------------------------------
+
+static NotecardRecorder recorder = nullptr;
+
+void hostSetNotecardRecorder(NotecardRecorder r) { recorder = r; }
+
+// The MCU waits out the transaction: both lines at 9600 baud, 10 bits per byte
+static void chargeSerial(J* req, J* rsp) {
+  size_t bytes = 0;
+  for (J* item : {req, rsp}) {
+    char* json = JPrintUnformatted(item);
+    bytes += strlen(json) + 1;   // Newline-terminated
+    JFree(json);
+  }
+  hostChargeMicros(bytes * 10 * 1000000ULL / 9600);
+}
+
+J* Notecard::newRequest(const char* request) {
+  J* req = JCreateObject();
+  JAddStringToObject(req, "req", request);
+  return req;
+}
+
+bool Notecard::sendRequest(J* req) {
+  if (req == nullptr) {
+    return false;
+  }
+  if (recorder) {
+    recorder(req);
+  }
+  // note-c still reads the reply, it only discards it
+  J* rsp = JCreateObject();
+  chargeSerial(req, rsp);
+  JDelete(rsp);
+  JDelete(req);
+  return true;
+}
+
+J* Notecard::requestAndResponse(J* req) {
+  if (req == nullptr) {
+    return nullptr;
+  }
+  if (recorder) {
+    recorder(req);
+  }
+
+  // Answer like a mains-powered card with good coverage and an empty queue
+  std::string name = JGetString(req, "req");
+  J* rsp = JCreateObject();
+  if (name == "card.voltage") {
+    JAddNumberToObject(rsp, "value", 5.1);
+    JAddBoolToObject(rsp, "usb", true);
+  } else if (name == "file.changes") {
+    JAddItemToObject(rsp, "info", JCreateObject());
+  } else if (name == "note.get") {
+    JAddStringToObject(rsp, "err", "note not found {note-noexist}");
+  } else if (name == "card.wireless") {
+    JAddNumberToObject(rsp, "rssi", -70);
+    JAddNumberToObject(rsp, "bars", 3);
+  } else if (name == "hub.sync.status") {
+    JAddNumberToObject(rsp, "time", millis() / 1000);
+  } else if (name == "card.time") {
+    // Simulated clock starts at 2026-01-01T00:00:00Z
+    JAddNumberToObject(rsp, "time", 1767225600UL + millis() / 1000);
+    JAddStringToObject(rsp, "zone", "UTC,Etc/UTC");
+  }
+  chargeSerial(req, rsp);
+  JDelete(req);
+  return rsp;
+}
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Convert the sketch to C++ the way the Arduino builder does: add prototypes
+# for every top-level function after the last #include.
+# Usage: ino2cpp.sh <sketch.ino> <out.cpp>
+set -e
+ino="$1"
+out="$2"
+protos=$(grep -E '^[A-Za-z_][A-Za-z0-9_<>:*& ]* [A-Za-z_][A-Za-z0-9_]*\([^;]*\) *\{' "$ino" | sed -E 's/ *\{.*$/;/')
+last=$(grep -n '^#include' "$ino" | tail -1 | cut -d: -f1)
+{
+  echo "#include <Arduino.h>"
+  echo "#line 1 \"$ino\""
+  head -n "$last" "$ino"
+  echo "$protos"
+  echo "#line $((last + 1)) \"$ino\""
+  tail -n +"$((last + 1))" "$ino"
+} > "$out"
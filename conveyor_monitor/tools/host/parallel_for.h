@@ -0,0 +1,31 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <atomic>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Run fn(worker, index) for index in [0, count) on worker threads
+ *
+ * Items are handed out one at a time from a shared counter, so uneven item
+ * costs balance themselves. fn must only touch per-item or per-worker state.
+ */
+template<class Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      for (size_t i = next++; i < count; i = next++) {
+        fn(t, i);
+      }
+    });
+  }
+  for (std::thread& w : workers) {
+    w.join();
+  }
+}
+
+#endif // PARALLEL_FOR_H
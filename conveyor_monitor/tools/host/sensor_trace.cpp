@@ -0,0 +1,344 @@
+#include "sensor_trace.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+// xorshift32 - identical sequence on every platform for a given seed
+struct TraceRng {
+  uint32_t state;
+  explicit TraceRng(uint32_t seed) : state(seed ? seed : 0x9E3779B9u) {}
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+  float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+  float range(float lo, float hi) { return lo + (hi - lo) * uniform(); }
+  uint32_t range(uint32_t lo, uint32_t hi) { return lo + next() % (hi - lo + 1); }
+  // Approximately normal (Irwin-Hall, 4 terms), unit variance
+  float noise() { return (uniform() + uniform() + uniform() + uniform() - 2.0f) * 1.7320508f; }
+};
+
+enum Episode {
+  EP_NORMAL,
+  EP_MICROSTOP,
+  EP_IDLE,
+  EP_JAM,
+  EP_SPEED_DRIFT,
+  EP_VIBRATION,
+  EP_ENVIRONMENT,
+  EP_TOF_DROPOUT
+};
+
+struct Segment {
+  Episode type;
+  uint32_t start_ms;
+  uint32_t end_ms;
+  float param;
+};
+
+const uint32_t MINUTE_MS = 60000;
+const uint32_t WARMUP_MS = 2 * MINUTE_MS;     // Let baselines form before the first incident
+const uint32_t PART_PERIOD_MS = 2000;         // EXPECTED_PARTS_PER_MIN = 30
+const uint32_t PART_PRESENT_MS = 300;
+const float PRECURSOR_SHARE = 0.8f;           // Jams preceded by part bunching; the rest come without warning
+
+Episode pickIncident(TraceRng& rng) {
+  // Weighted: micro-stops are the most common stoppage
+  static const Episode table[] = {
+    EP_MICROSTOP, EP_MICROSTOP, EP_MICROSTOP, EP_IDLE,
+    EP_JAM, EP_JAM, EP_SPEED_DRIFT, EP_SPEED_DRIFT,
+    EP_VIBRATION, EP_VIBRATION, EP_ENVIRONMENT, EP_TOF_DROPOUT
+  };
+  return table[rng.next() % (sizeof(table) / sizeof(table[0]))];
+}
+
+Segment makeIncident(TraceRng& rng, uint32_t start) {
+  Segment s = { pickIncident(rng), start, start, 0.0f };
+  switch (s.type) {
+    case EP_MICROSTOP:   s.end_ms = start + rng.range(5000u, 20000u); break;
+    case EP_IDLE:        s.end_ms = start + rng.range(120000u, 240000u); break;
+    case EP_JAM:         s.end_ms = start + rng.range(60000u, 120000u); break;
+    case EP_SPEED_DRIFT:
+      s.end_ms = start + rng.range(60000u, 120000u);
+      s.param = (rng.next() & 1) ? rng.range(70.0f, 75.0f) : rng.range(45.0f, 50.0f);
+      break;
+    case EP_VIBRATION:
+      s.end_ms = start + rng.range(120000u, 240000u);
+      s.param = rng.range(2.2f, 2.8f);      // Peak level reached at the end of the ramp
+      break;
+    case EP_ENVIRONMENT:
+      s.end_ms = start + rng.range(120000u, 240000u);
+      s.param = rng.range(42.0f, 45.0f);
+      break;
+    case EP_TOF_DROPOUT: s.end_ms = start + rng.range(5000u, 15000u); break;
+    default: break;
+  }
+  return s;
+}
+
+IncidentLabel labelFor(Episode e) {
+  switch (e) {
+    case EP_JAM: return LABEL_JAM;
+    case EP_SPEED_DRIFT: return LABEL_SPEED;
+    case EP_VIBRATION: return LABEL_VIBRATION;
+    case EP_ENVIRONMENT: return LABEL_ENVIRONMENT;
+    case EP_TOF_DROPOUT: return LABEL_SENSOR_FAULT;
+    default: return LABEL_NONE;   // Stops are production events, not anomalies
+  }
+}
+
+} // namespace
+
+SensorTrace::SensorTrace() : cursor(0) {}
+
+bool SensorTrace::loadCsv(const char* path, std::string& error) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    error = std::string("cannot open ") + path;
+    return false;
+  }
+
+  samples.clear();
+  cursor = 0;
+  char line[512];
+  unsigned lineNo = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNo++;
+    if (line[0] == '#' || line[0] == '\n' || line[0] == 't') {
+      continue;   // Comment, blank or header
+    }
+    TraceSample s;
+    unsigned long t, dist, gas, prox, label = 0;
+    int n = sscanf(line, "%lu,%f,%lu,%f,%f,%f,%f,%lu,%lu,%lu",
+                   &t, &s.speed_rpm, &dist, &s.vibration_g, &s.temp_c,
+                   &s.humidity_pct, &s.pressure_hpa, &gas, &prox, &label);
+    if (n < 9) {
+      fclose(f);
+      error = std::string(path) + ":" + std::to_string(lineNo) + ": expected at least 9 columns";
+      return false;
+    }
+    s.t_ms = t;
+    s.distance_mm = (uint16_t)dist;
+    s.gas_ohm = gas;
+    s.proximity = (uint8_t)prox;
+    s.label = (uint8_t)(label < (int)LABEL_COUNT ? label : (int)LABEL_NONE);
+    if (!samples.empty() && s.t_ms < samples.back().t_ms) {
+      fclose(f);
+      error = std::string(path) + ":" + std::to_string(lineNo) + ": timestamps must not decrease";
+      return false;
+    }
+    samples.push_back(s);
+  }
+  fclose(f);
+
+  if (samples.empty()) {
+    error = std::string(path) + ": no samples";
+    return false;
+  }
+  return true;
+}
+
+bool SensorTrace::saveCsv(const char* path) const {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    return false;
+  }
+  fprintf(f, "t_ms,speed_rpm,distance_mm,vibration_g,temp_c,humidity_pct,pressure_hpa,gas_ohm,proximity,label\n");
+  for (const TraceSample& s : samples) {
+    fprintf(f, "%lu,%.2f,%u,%.3f,%.2f,%.2f,%.2f,%lu,%u,%u\n",
+            (unsigned long)s.t_ms, s.speed_rpm, (unsigned)s.distance_mm, s.vibration_g,
+            s.temp_c, s.humidity_pct, s.pressure_hpa, (unsigned long)s.gas_ohm,
+            (unsigned)s.proximity, (unsigned)s.label);
+  }
+  fclose(f);
+  return true;
+}
+
+void SensorTrace::simulate(uint32_t minutes, uint32_t seed, uint32_t periodMs) {
+  TraceRng rng(seed);
+  uint32_t duration = minutes * MINUTE_MS;
+
+  // Episode timeline: normal running between incidents
+  std::vector<Segment> timeline;
+  uint32_t t = 0;
+  uint32_t normalLength = WARMUP_MS + rng.range(60000u, 180000u);
+  while (t < duration) {
+    timeline.push_back({ EP_NORMAL, t, t + normalLength, 0.0f });
+    t += normalLength;
+    if (t >= duration) {
+      break;
+    }
+    Segment incident = makeIncident(rng, t);
+    timeline.push_back(incident);
+    t = incident.end_ms;
+    normalLength = rng.range(3 * MINUTE_MS, 8 * MINUTE_MS);
+  }
+
+  // Part bunching: irregular spacing and longer dwell at the ToF sensor,
+  // ramping up over the 1-3 minutes before most jams, plus milder upstream
+  // hiccups that clear without one. Drawn from their own generator so the
+  // rest of the trace does not change with them. param = peak severity.
+  TraceRng flowRng(seed ^ 0x5A17C0DEu);
+  std::vector<Segment> bunches;   // type = the episode that follows
+  uint32_t nextHiccup = flowRng.range(20 * MINUTE_MS, 60 * MINUTE_MS);
+  for (size_t i = 1; i < timeline.size(); i++) {
+    const Segment& before = timeline[i - 1];
+    const Segment& seg = timeline[i];
+    if (before.type != EP_NORMAL) {
+      continue;
+    }
+    if (nextHiccup + 240000u < seg.start_ms && nextHiccup >= before.start_ms) {
+      uint32_t length = flowRng.range(30000u, 60000u);
+      bunches.push_back({ EP_NORMAL, nextHiccup, nextHiccup + length, flowRng.range(0.2f, 0.6f) });
+      nextHiccup += flowRng.range(20 * MINUTE_MS, 60 * MINUTE_MS);
+    }
+    if (seg.type == EP_JAM && flowRng.uniform() < PRECURSOR_SHARE) {
+      uint32_t lead = std::min(flowRng.range(60000u, 180000u), seg.start_ms - before.start_ms);
+      bunches.push_back({ EP_JAM, seg.start_ms - lead, seg.start_ms, 1.0f });
+    }
+    while (nextHiccup < seg.end_ms) {
+      nextHiccup += flowRng.range(20 * MINUTE_MS, 60 * MINUTE_MS);
+    }
+  }
+
+  samples.clear();
+  cursor = 0;
+  samples.reserve(duration / periodMs + 1);
+
+  size_t seg = 0;
+  size_t bunch = 0;
+  uint32_t nextPartTime = rng.range(500u, PART_PERIOD_MS);
+  uint32_t partEndTime = 0;
+  uint32_t nextVisit = rng.range(5 * MINUTE_MS, 15 * MINUTE_MS);
+  uint32_t visitEnd = 0;
+
+  for (uint32_t now = 0; now <= duration; now += periodMs) {
+    while (seg + 1 < timeline.size() && now >= timeline[seg].end_ms) {
+      seg++;
+    }
+    const Segment& s = timeline[seg];
+    bool stopped = (s.type == EP_MICROSTOP || s.type == EP_IDLE);
+
+    TraceSample out;
+    out.t_ms = now;
+    out.label = labelFor(s.type);
+
+    // Speed - the encoder is on the motor, so it keeps turning through a jam
+    float targetSpeed = (s.type == EP_SPEED_DRIFT) ? s.param : 60.0f;
+    out.speed_rpm = stopped ? 0.0f : targetSpeed + 0.4f * rng.noise();
+
+    // Parts pass the ToF sensor while the belt moves them
+    while (bunch < bunches.size() && now >= bunches[bunch].end_ms) {
+      bunch++;
+    }
+    bool moving = !stopped && s.type != EP_JAM;
+    if (moving && now >= nextPartTime) {
+      partEndTime = now + PART_PRESENT_MS;
+      float rate = targetSpeed / 60.0f;
+      nextPartTime = now + (uint32_t)(PART_PERIOD_MS / rate) + rng.range(0u, 400u) - 200;
+      if (bunch < bunches.size() && now >= bunches[bunch].start_ms) {
+        // Bunching: spacing spreads, parts tailgate and linger in front of the sensor
+        const Segment& b = bunches[bunch];
+        float severity = b.param * (float)(now - b.start_ms) / (float)(b.end_ms - b.start_ms);
+        float spacing = PART_PERIOD_MS / rate;
+        uint32_t dwell = (uint32_t)(PART_PRESENT_MS * (1.0f + 1.5f * severity * flowRng.uniform()));
+        float gap = spacing * (1.0f + severity * flowRng.range(-0.5f, 0.5f));
+        if (flowRng.uniform() < 0.4f * severity) {
+          gap = spacing * flowRng.range(0.25f, 0.5f);
+        }
+        partEndTime = now + dwell;
+        nextPartTime = now + std::max((uint32_t)gap, dwell + 3 * periodMs);
+      }
+    } else if (!moving && now >= nextPartTime) {
+      nextPartTime = now + periodMs;
+    }
+    bool partPresent = moving && now < partEndTime;
+    out.distance_mm = partPresent ? (uint16_t)(40 + rng.range(0u, 10u)) : (uint16_t)(300 + rng.range(0u, 10u));
+    if (s.type == EP_TOF_DROPOUT) {
+      out.distance_mm = 0;
+    }
+
+    // Vibration
+    if (stopped) {
+      out.vibration_g = 0.05f + 0.01f * rng.noise();
+    } else if (s.type == EP_JAM) {
+      out.vibration_g = 0.10f + 0.02f * rng.noise();
+    } else if (s.type == EP_VIBRATION) {
+      float frac = (float)(now - s.start_ms) / (float)(s.end_ms - s.start_ms);
+      out.vibration_g = 0.5f + (s.param - 0.5f) * frac + 0.05f * rng.noise();
+    } else {
+      out.vibration_g = 0.5f + 0.04f * rng.noise();
+    }
+    out.vibration_g = fabsf(out.vibration_g);
+
+    // Environment - slow daily-ish drift plus excursions
+    float drift = 1.5f * sinf(2.0f * (float)M_PI * now / (4.0f * 60.0f * MINUTE_MS));
+    out.temp_c = (s.type == EP_ENVIRONMENT) ? s.param : 22.0f + drift;
+    out.temp_c += 0.05f * rng.noise();
+    out.humidity_pct = 45.0f + 0.3f * rng.noise();
+    out.pressure_hpa = 1013.2f + 0.1f * rng.noise();
+    out.gas_ohm = 150000 + (uint32_t)(rng.range(0u, 2000u));
+
+    // Occasional operator visits
+    if (now >= nextVisit) {
+      visitEnd = now + rng.range(15000u, 45000u);
+      nextVisit = visitEnd + rng.range(5 * MINUTE_MS, 15 * MINUTE_MS);
+    }
+    out.proximity = (now < visitEnd) ? 50 : 0;
+
+    samples.push_back(out);
+  }
+}
+
+const TraceSample& SensorTrace::at(uint32_t t_ms) {
+  if (cursor >= samples.size() || samples[cursor].t_ms > t_ms) {
+    cursor = 0;   // Time went backwards - restart the scan
+  }
+  while (cursor + 1 < samples.size() && samples[cursor + 1].t_ms <= t_ms) {
+    cursor++;
+  }
+  return samples[cursor];
+}
+
+size_t SensorTrace::samplesUntil(uint32_t t_ms) const {
+  size_t lo = 0, hi = samples.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (samples[mid].t_ms <= t_ms) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
+
+std::vector<Incident> SensorTrace::incidents() const {
+  std::vector<Incident> out;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint8_t label = samples[i].label;
+    if (label == LABEL_NONE) {
+      continue;
+    }
+    if (!out.empty() && out.back().label == label && out.back().end_ms == samples[i - 1].t_ms) {
+      out.back().end_ms = samples[i].t_ms;
+    } else {
+      out.push_back({ (IncidentLabel)label, samples[i].t_ms, samples[i].t_ms });
+    }
+  }
+  return out;
+}
+
+const char* SensorTrace::getLabelName(IncidentLabel label) {
+  switch (label) {
+    case LABEL_JAM: return "jam";
+    case LABEL_SPEED: return "speed";
+    case LABEL_VIBRATION: return "vibration";
+    case LABEL_ENVIRONMENT: return "environment";
+    case LABEL_SENSOR_FAULT: return "sensor_fault";
+    default: return "none";
+  }
+}
@@ -0,0 +1,104 @@
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Ground-truth incident labels carried by a trace
+ */
+enum IncidentLabel {
+  LABEL_NONE = 0,
+  LABEL_JAM,
+  LABEL_SPEED,
+  LABEL_VIBRATION,
+  LABEL_ENVIRONMENT,
+  LABEL_SENSOR_FAULT,
+  LABEL_COUNT
+};
+
+/**
+ * @brief One raw sensor sample, as the sensor libraries would report it
+ */
+struct TraceSample {
+  uint32_t t_ms;
+  float speed_rpm;        // Encoder detents above the power-up position
+  uint16_t distance_mm;   // ToF distance, 0 = read timeout
+  float vibration_g;      // Accelerometer magnitude
+  float temp_c;
+  float humidity_pct;
+  float pressure_hpa;
+  uint32_t gas_ohm;
+  uint8_t proximity;
+  uint8_t label;          // IncidentLabel active at this sample
+};
+
+/**
+ * @brief Labeled incident, derived from runs of equal non-zero labels
+ */
+struct Incident {
+  IncidentLabel label;
+  uint32_t start_ms;
+  uint32_t end_ms;
+};
+
+/**
+ * @brief Recorded or simulated sensor trace shared by the host tools
+ *
+ * CSV format (header line optional, '#' starts a comment):
+ *   t_ms,speed_rpm,distance_mm,vibration_g,temp_c,humidity_pct,pressure_hpa,gas_ohm,proximity[,label]
+ *
+ * The simulator is deterministic for a given seed: a running line with
+ * sensor noise and parts every ~2 s, interrupted by micro-stops, idle
+ * periods, jams, speed drift, bearing-wear vibration, environmental
+ * excursions and ToF dropouts, each labeled with its IncidentLabel.
+ * Most jams are preceded by a few minutes of part bunching (irregular
+ * spacing, longer dwell), and milder bunching now and then clears without
+ * a jam; neither is labeled, the jam that follows is.
+ */
+class SensorTrace {
+private:
+  std::vector<TraceSample> samples;
+  size_t cursor;
+
+public:
+  SensorTrace();
+
+  bool loadCsv(const char* path, std::string& error);
+  bool saveCsv(const char* path) const;
+
+  /**
+   * @brief Replace the trace with a simulated one
+   * @param minutes Trace length
+   * @param seed Random seed (same seed = same trace)
+   * @param periodMs Sample period
+   */
+  void simulate(uint32_t minutes, uint32_t seed, uint32_t periodMs = 50);
+
+  /**
+   * @brief Latest sample at or before t_ms (amortised O(1) for increasing t)
+   */
+  const TraceSample& at(uint32_t t_ms);
+
+  /**
+   * @brief Number of samples up to and including t_ms
+   */
+  size_t samplesUntil(uint32_t t_ms) const;
+
+  std::vector<Incident> incidents() const;
+
+  size_t size() const { return samples.size(); }
+  uint32_t durationMs() const { return samples.empty() ? 0 : samples.back().t_ms; }
+  const TraceSample& operator[](size_t i) const { return samples[i]; }
+  void rewind() { cursor = 0; }
+
+  static const char* getLabelName(IncidentLabel label);
+};
+
+// Trace read by the host sensor libraries
+void hostSetSensorTrace(SensorTrace* trace);
+SensorTrace* hostSensorTrace();
+uint64_t hostSensorReads();
+
+#endif // SENSOR_TRACE_H
@@ -0,0 +1,83 @@
+#include "golden_diff.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool startsNumber(const char* p, const char* lineStart) {
+  // Only a number if not glued to an identifier (e.g. "telemetry2", base64)
+  if (p > lineStart && (isalpha((unsigned char)p[-1]) || p[-1] == '_')) {
+    return false;
+  }
+  if (isdigit((unsigned char)*p)) {
+    return true;
+  }
+  return *p == '-' && (isdigit((unsigned char)p[1]) || p[1] == '.');
+}
+
+GoldenDiff::GoldenDiff(double rtol, double atol, size_t maxReported)
+  : rtol(rtol), atol(atol), maxReported(maxReported) {}
+
+bool GoldenDiff::linesMatch(const std::string& a, const std::string& b) const {
+  const char* pa = a.c_str();
+  const char* pb = b.c_str();
+  while (*pa && *pb) {
+    if (startsNumber(pa, a.c_str()) && startsNumber(pb, b.c_str())) {
+      char* ea;
+      char* eb;
+      double va = strtod(pa, &ea);
+      double vb = strtod(pb, &eb);
+      if (fabs(va - vb) > atol + rtol * fmax(fabs(va), fabs(vb))) {
+        return false;
+      }
+      pa = ea;
+      pb = eb;
+      continue;
+    }
+    if (*pa != *pb) {
+      return false;
+    }
+    pa++;
+    pb++;
+  }
+  return *pa == *pb;
+}
+
+long GoldenDiff::compare(const char* golden, const std::vector<std::string>& actual) const {
+  FILE* f = fopen(golden, "r");
+  if (!f) {
+    fprintf(stderr, "golden: cannot open %s\n", golden);
+    return -1;
+  }
+
+  std::vector<std::string> expected;
+  char* line = nullptr;
+  size_t cap = 0;
+  ssize_t len;
+  while ((len = getline(&line, &cap, f)) >= 0) {
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+      line[--len] = '\0';
+    }
+    expected.push_back(line);
+  }
+  free(line);
+  fclose(f);
+
+  long mismatches = 0;
+  size_t common = expected.size() < actual.size() ? expected.size() : actual.size();
+  for (size_t i = 0; i < common; i++) {
+    if (!linesMatch(expected[i], actual[i])) {
+      if ((size_t)mismatches < maxReported) {
+        fprintf(stderr, "golden: line %zu differs\n  expected: %s\n  actual:   %s\n",
+                i + 1, expected[i].c_str(), actual[i].c_str());
+      }
+      mismatches++;
+    }
+  }
+  if (expected.size() != actual.size()) {
+    fprintf(stderr, "golden: %zu lines expected, %zu produced\n", expected.size(), actual.size());
+    mismatches += (long)(expected.size() > actual.size() ? expected.size() - common : actual.size() - common);
+  }
+  return mismatches;
+}
@@ -0,0 +1,35 @@
+#ifndef GOLDEN_DIFF_H
+#define GOLDEN_DIFF_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Tolerant line-by-line comparison of replay output against a golden file
+ *
+ * Text must match exactly; every number is compared as a value and passes if
+ * |a - b| <= atol + rtol * max(|a|, |b|). That absorbs float formatting and
+ * compiler/FPU rounding differences while still catching a changed alert,
+ * a shifted timestamp or a different payload.
+ */
+class GoldenDiff {
+private:
+  double rtol;
+  double atol;
+  size_t maxReported;
+
+  bool linesMatch(const std::string& a, const std::string& b) const;
+
+public:
+  GoldenDiff(double rtol, double atol, size_t maxReported = 10);
+
+  /**
+   * @brief Compare actual output lines with the golden file
+   * @param golden Path of the golden file
+   * @param actual Output lines of this run
+   * @return Number of mismatching lines (-1 if the golden file cannot be read)
+   */
+  long compare(const char* golden, const std::vector<std::string>& actual) const;
+};
+
+#endif // GOLDEN_DIFF_H
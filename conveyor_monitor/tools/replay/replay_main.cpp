@@ -0,0 +1,298 @@
+/**
+ * Golden-output replay harness
+ *
+ * Runs the unmodified firmware (conveyor_monitor.ino and everything below it)
+ * against a recorded or simulated sensor trace in simulated time. The sensor
+ * libraries read the trace, and the Notecard records every request instead of
+ * sending it. Each note.add (telemetry, events, alerts, health, downtime) and
+ * hub.set becomes one output line "<t_ms> <request JSON>".
+ *
+ *   replay --simulate 60 --seed 1 --record out.golden
+ *   replay --simulate 60 --seed 1 --golden replay/golden/sim60_seed1.golden
+ *   replay --trace line3.csv --golden line3.golden --rtol 1e-3
+ *   replay --simulate 720 --no-tuning      (alert volume with the fixed thresholds)
+ *
+ * Exit status: 0 = ran (and matched the golden file), 1 = mismatch, 2 = usage.
+ */
+
+#include <Arduino.h>
+#include <Notecard.h>
+#include <IWatchdog.h>
+#include <Adafruit_BME680.h>
+#include <VL53L1X.h>
+#include <SparkFun_APDS9960.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "../host/sensor_trace.h"
+#include "data_processing/data_processor.h"
+#include "utils/task_watchdog.h"
+#include "utils/energy_model.h"
+#include "golden_diff.h"
+
+// Sketch entry points and globals (build/sketch.cpp)
+void setup();
+void loop();
+extern DataProcessor dataProcessor;
+extern TaskWatchdog taskWatchdog;
+extern EnergyModel energyModel;
+extern Adafruit_BME680 bme;
+extern VL53L1X distanceSensor;
+extern SparkFun_APDS9960 gestureSensor;
+
+static std::vector<std::string> outputLines;
+static std::map<std::string, unsigned long> outputCounts;
+static std::map<std::string, unsigned long> alertCounts;
+static std::vector<uint32_t> preJamOnsets;
+
+// A pre-jam warning counts for a jam starting within this time after it
+static const uint32_t PREJAM_HORIZON_MS = 600000;
+
+static void recordRequest(J* req) {
+  std::string name = JGetString(req, "req");
+  if (name != "note.add" && name != "hub.set") {
+    return;   // Status polls and local state are not observable behaviour
+  }
+
+  std::string kind = (name == "note.add") ? JGetString(req, "file") : name;
+  outputCounts[kind]++;
+  if (kind == "alerts.qo") {
+    J* body = JGetObject(req, "body");
+    alertCounts[body ? JGetString(body, "alert") : ""]++;
+  }
+
+  char* json = JPrintUnformatted(req);
+  outputLines.push_back(std::to_string(millis()) + " " + json);
+  JFree(json);
+}
+
+/**
+ * Score the pre-jam warnings against the labeled jams: lead time of the
+ * first warning within PREJAM_HORIZON_MS before each jam (and after the
+ * previous incident), and warnings with no jam in that horizon. Warnings
+ * are the detector's onsets, not the alerts sent: those are rate limited
+ * and dropped once the data budget is spent.
+ */
+static void printPreJam(const SensorTrace& trace) {
+  std::vector<uint32_t> leads;
+  size_t jams = 0;
+  uint32_t previousEnd = 0;
+  std::vector<Incident> incidents = trace.incidents();
+  for (const Incident& incident : incidents) {
+    if (incident.label == LABEL_JAM) {
+      jams++;
+      uint32_t from = std::max(previousEnd, incident.start_ms > PREJAM_HORIZON_MS ? incident.start_ms - PREJAM_HORIZON_MS : 0);
+      for (uint32_t t : preJamOnsets) {
+        if (t >= from && t <= incident.start_ms) {
+          leads.push_back(incident.start_ms - t);
+          break;
+        }
+      }
+    }
+    previousEnd = incident.end_ms;
+  }
+
+  size_t falseWarnings = 0;
+  for (uint32_t t : preJamOnsets) {
+    bool followed = false;
+    for (const Incident& incident : incidents) {
+      if (incident.label == LABEL_JAM && incident.end_ms >= t && incident.start_ms <= t + PREJAM_HORIZON_MS) {
+        followed = true;
+        break;
+      }
+    }
+    falseWarnings += !followed;
+  }
+
+  printf("Pre-jam:    %zu/%zu jams warned", leads.size(), jams);
+  if (!leads.empty()) {
+    std::sort(leads.begin(), leads.end());
+    printf(", lead median %.0f s (%.0f-%.0f s)", leads[leads.size() / 2] / 1000.0, leads.front() / 1000.0,
+           leads.back() / 1000.0);
+  }
+  double hours = trace.durationMs() / 3600000.0;
+  printf(", %zu of %zu warnings false (%.2f/h)\n", falseWarnings, preJamOnsets.size(),
+         hours > 0 ? falseWarnings / hours : 0.0);
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: replay (--trace FILE | --simulate MINUTES [--seed N]) [options]\n"
+          "  --save-trace FILE   write the (simulated) trace as CSV\n"
+          "  --record FILE       write captured output lines\n"
+          "  --golden FILE       compare captured output with a golden file\n"
+          "  --rtol R            relative numeric tolerance (default 1e-4)\n"
+          "  --atol A            absolute numeric tolerance (default 1e-6)\n"
+          "  --step-us N         simulated time per loop() call (default 1000)\n"
+          "  --no-tuning         detect with the fixed thresholds only\n"
+          "  --verbose           echo firmware Serial output to stderr\n");
+}
+
+int main(int argc, char** argv) {
+  const char* tracePath = nullptr;
+  const char* saveTracePath = nullptr;
+  const char* recordPath = nullptr;
+  const char* goldenPath = nullptr;
+  uint32_t simulateMinutes = 0;
+  uint32_t seed = 1;
+  uint32_t stepMicros = 1000;
+  double rtol = 1e-4;
+  double atol = 1e-6;
+  bool tuning = true;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (arg == "--trace" && hasValue) tracePath = argv[++i];
+    else if (arg == "--simulate" && hasValue) simulateMinutes = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) seed = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--save-trace" && hasValue) saveTracePath = argv[++i];
+    else if (arg == "--record" && hasValue) recordPath = argv[++i];
+    else if (arg == "--golden" && hasValue) goldenPath = argv[++i];
+    else if (arg == "--rtol" && hasValue) rtol = strtod(argv[++i], nullptr);
+    else if (arg == "--atol" && hasValue) atol = strtod(argv[++i], nullptr);
+    else if (arg == "--step-us" && hasValue) stepMicros = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--no-tuning") tuning = false;
+    else if (arg == "--verbose") hostSetSerialEcho(true);
+    else { usage(); return 2; }
+  }
+  if ((tracePath == nullptr) == (simulateMinutes == 0) || stepMicros == 0) {
+    usage();
+    return 2;
+  }
+
+  SensorTrace trace;
+  if (tracePath) {
+    std::string error;
+    if (!trace.loadCsv(tracePath, error)) {
+      fprintf(stderr, "replay: %s\n", error.c_str());
+      return 2;
+    }
+  } else {
+    trace.simulate(simulateMinutes, seed);
+  }
+  if (saveTracePath && !trace.saveCsv(saveTracePath)) {
+    fprintf(stderr, "replay: cannot write %s\n", saveTracePath);
+    return 2;
+  }
+
+  hostSetSensorTrace(&trace);
+  hostSetNotecardRecorder(recordRequest);
+  randomSeed(seed);
+
+  // Run the firmware over the whole trace
+  auto wallStart = std::chrono::steady_clock::now();
+  setup();
+  // After setup(), which applies the runtime configuration
+  dataProcessor.setThresholdTuning(tuning && TUNING_ENABLED);
+  uint64_t loops = 0;
+  uint64_t endMicros = (uint64_t)trace.durationMs() * 1000;
+  bool preJam = false;
+  while (hostNowMicros() < endMicros) {
+    loop();
+    if (dataProcessor.detectPreJam() != preJam) {
+      preJam = !preJam;
+      if (preJam) {
+        preJamOnsets.push_back(millis());
+      }
+    }
+    hostAdvanceMicros(stepMicros);
+    loops++;
+  }
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  if (recordPath) {
+    FILE* f = fopen(recordPath, "w");
+    if (!f) {
+      fprintf(stderr, "replay: cannot write %s\n", recordPath);
+      return 2;
+    }
+    for (const std::string& line : outputLines) {
+      fprintf(f, "%s\n", line.c_str());
+    }
+    fclose(f);
+  }
+
+  // Throughput and output summary
+  double simSeconds = trace.durationMs() / 1000.0;
+  printf("Trace:      %zu samples, %.0f s simulated\n", trace.size(), simSeconds);
+  printf("Firmware:   %llu loop() calls, %llu sensor reads\n",
+         (unsigned long long)loops, (unsigned long long)hostSensorReads());
+  printf("Wall time:  %.3f s (%.0fx real time)\n", wallSeconds, wallSeconds > 0 ? simSeconds / wallSeconds : 0.0);
+  printf("Throughput: %.0f trace samples/s, %.0f sensor reads/s\n",
+         wallSeconds > 0 ? trace.size() / wallSeconds : 0.0,
+         wallSeconds > 0 ? hostSensorReads() / wallSeconds : 0.0);
+  printf("Output:     %zu lines", outputLines.size());
+  for (const auto& kv : outputCounts) {
+    printf(", %s %lu", kv.first.c_str(), kv.second);
+  }
+  printf("\n");
+  // The note rate the queue limits are sized from (config: QUEUE_NOTES_PER_HOUR, alerts left out)
+  unsigned long queuedNotes = 0;
+  for (const char* file : {"telemetry.qo", "events.qo", "health.qo", "downtime.qo"}) {
+    auto it = outputCounts.find(file);
+    queuedNotes += it != outputCounts.end() ? it->second : 0;
+  }
+  double notesPerHour = simSeconds > 0 ? queuedNotes * 3600.0 / simSeconds : 0.0;
+  printf("Queue:      %.0f notes/h besides alerts (limits sized for %d/h), soft limit after %.1f h without a sync\n",
+         notesPerHour, QUEUE_NOTES_PER_HOUR, notesPerHour > 0 ? QUEUE_SOFT_LIMIT / notesPerHour : 0.0);
+  printf("Alerts:    ");
+  for (const auto& kv : alertCounts) {
+    printf(" %s %lu", kv.first.c_str(), kv.second);
+  }
+  const ThresholdTuner& tuner = dataProcessor.getThresholdTuner();
+  printf("\nTuning:     %s", !tuner.isEnabled() ? "off" : (tuner.isTuned() ? "tuned" : "learning"));
+  if (tuner.isTuned()) {
+    const AnomalyThresholds& t = tuner.getThresholds();
+    printf(", %lu epochs, jam %.3fg, warning %.3fg, critical %.3fg", (unsigned long)tuner.getEpochs(),
+           t.jamVibrationG, t.vibrationWarningG, t.vibrationCriticalG);
+  }
+  printf("\n");
+  // Simulated time only moves between loop() calls, so a gap here means the feed was withheld
+  printf("Watchdog:   %u feeds, longest gap %.0f ms (timeout %.0f ms), %lu overruns\n",
+         IWatchdog.hostReloads(), IWatchdog.hostLongestGapMicros() / 1000.0,
+         IWatchdog.hostTimeoutMicros() / 1000.0, (unsigned long)taskWatchdog.getOverruns());
+  // Active time the energy model booked against the time the fake sensors were actually on
+  energyModel.update();
+  auto activePct = [](EnergyConsumer c) {
+    return 100.0 * energyModel.getStateMicros(c, POWER_ACTIVE) / std::max<uint64_t>(energyModel.getTotalMicros(c), 1);
+  };
+  auto onPct = [](EnergyConsumer c, uint64_t onMicros) {
+    return 100.0 * onMicros / std::max<uint64_t>(energyModel.getTotalMicros(c), 1);
+  };
+  // The fakes charge their blocking time to the clock; the MCU must be booked awake for exactly that
+  uint64_t mcuActiveMicros = energyModel.getStateMicros(ENERGY_MCU, POWER_ACTIVE);
+  bool mcuBooked = mcuActiveMicros == hostBusyMicros();
+  printf("Energy:     %.2f mA average, %.1f mAh, MCU asleep %.1f%% (fake busy %.2f%%)%s\n",
+         energyModel.getAverageCurrentMa(), energyModel.getTotalChargeMah(), 100.0 - activePct(ENERGY_MCU),
+         onPct(ENERGY_MCU, hostBusyMicros()), mcuBooked ? "" : " MISMATCH");
+  printf("Sensor on:  bme688 %.2f%% (fake %.2f%%), vl53l1x %.1f%% (fake %.1f%%), gesture %.1f%% (fake %.1f%%)\n",
+         activePct(ENERGY_BME688), onPct(ENERGY_BME688, bme.hostActiveMicros()),
+         activePct(ENERGY_VL53L1X), onPct(ENERGY_VL53L1X, distanceSensor.hostActiveMicros()),
+         activePct(ENERGY_APDS9960), onPct(ENERGY_APDS9960, gestureSensor.hostGestureMicros()));
+  const RULEstimator& rulEstimator = dataProcessor.getRULEstimator();
+  printf("RUL:        %lu points, %lu skipped, %.1f operating hours, HI %.3fg", (unsigned long)rulEstimator.getPoints(),
+         (unsigned long)rulEstimator.getIntervalsSkipped(), rulEstimator.getOperatingHours(), rulEstimator.getLastIndicator());
+  RULEstimate rul;
+  if (dataProcessor.estimateRUL(rul)) {
+    printf(", %.0f h (%.0f-%.0f h)", rul.hours, rul.lowHours, rul.highHours);
+  }
+  printf("\n");
+  printPreJam(trace);
+
+  if (!mcuBooked) {
+    return 1;
+  }
+  if (goldenPath) {
+    GoldenDiff diff(rtol, atol);
+    long mismatches = diff.compare(goldenPath, outputLines);
+    if (mismatches != 0) {
+      printf("Golden:     MISMATCH (%ld lines) against %s\n", mismatches < 0 ? 0 : mismatches, goldenPath);
+      return 1;
+    }
+    printf("Golden:     match (rtol %g, atol %g)\n", rtol, atol);
+  }
+  return 0;
+}
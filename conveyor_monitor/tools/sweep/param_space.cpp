@@ -0,0 +1,133 @@
+#include "param_space.h"
+
+#include <math.h>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+
+ParamSpace::ParamSpace() {
+  AnomalyThresholds defaults = defaultAnomalyThresholds();
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    float value = get(defaults, (SweepParam)i);
+    ranges[i] = { value, value, 0.0f };
+  }
+}
+
+bool ParamSpace::parse(const char* spec, std::string& error) {
+  const char* eq = strchr(spec, '=');
+  if (eq == nullptr) {
+    error = std::string("expected name=lo[:hi[:step]]: ") + spec;
+    return false;
+  }
+  std::string name(spec, eq - spec);
+  int param = 0;
+  while (param < PARAM_COUNT && name != getParamName((SweepParam)param)) {
+    param++;
+  }
+  if (param == PARAM_COUNT) {
+    error = "unknown parameter " + name + " (speed_pct, jam_g, jam_ms, vib_warn, vib_crit)";
+    return false;
+  }
+
+  float values[3] = { 0, 0, 0 };
+  int count = 0;
+  const char* p = eq + 1;
+  while (count < 3) {
+    char* end = nullptr;
+    values[count++] = strtof(p, &end);
+    if (end == p) {
+      error = std::string("bad number in ") + spec;
+      return false;
+    }
+    if (*end != ':') {
+      break;
+    }
+    p = end + 1;
+  }
+
+  Range range = { values[0], count > 1 ? values[1] : values[0], count > 2 ? values[2] : 0.0f };
+  if (range.hi < range.lo || range.step < 0) {
+    error = std::string("empty range in ") + spec;
+    return false;
+  }
+  if (count == 2) {
+    range.step = (range.hi - range.lo) / 4.0f;   // Five grid points by default
+  }
+  ranges[param] = range;
+  return true;
+}
+
+size_t ParamSpace::stepsFor(SweepParam param) const {
+  const Range& r = ranges[param];
+  if (r.step <= 0 || r.hi <= r.lo) {
+    return 1;
+  }
+  return (size_t)floorf((r.hi - r.lo) / r.step + 1e-4f) + 1;
+}
+
+size_t ParamSpace::gridSize() const {
+  size_t size = 1;
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    size *= stepsFor((SweepParam)i);
+  }
+  return size;
+}
+
+void ParamSpace::grid(std::vector<AnomalyThresholds>& out) const {
+  size_t total = gridSize();
+  for (size_t index = 0; index < total; index++) {
+    AnomalyThresholds t = defaultAnomalyThresholds();
+    size_t rest = index;
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      size_t steps = stepsFor((SweepParam)i);
+      set(t, (SweepParam)i, ranges[i].lo + ranges[i].step * (float)(rest % steps));
+      rest /= steps;
+    }
+    out.push_back(t);
+  }
+}
+
+void ParamSpace::random(size_t count, uint32_t seed, std::vector<AnomalyThresholds>& out) const {
+  std::mt19937 rng(seed);
+  for (size_t n = 0; n < count; n++) {
+    AnomalyThresholds t = defaultAnomalyThresholds();
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      std::uniform_real_distribution<float> dist(ranges[i].lo, ranges[i].hi);
+      set(t, (SweepParam)i, ranges[i].hi > ranges[i].lo ? dist(rng) : ranges[i].lo);
+    }
+    out.push_back(t);
+  }
+}
+
+float ParamSpace::get(const AnomalyThresholds& t, SweepParam param) {
+  switch (param) {
+    case PARAM_SPEED_PCT: return t.speedTolerancePct;
+    case PARAM_JAM_G: return t.jamVibrationG;
+    case PARAM_JAM_MS: return (float)t.jamDetectTimeMs;
+    case PARAM_VIB_WARN: return t.vibrationWarningG;
+    case PARAM_VIB_CRIT: return t.vibrationCriticalG;
+    default: return 0;
+  }
+}
+
+void ParamSpace::set(AnomalyThresholds& t, SweepParam param, float value) {
+  switch (param) {
+    case PARAM_SPEED_PCT: t.speedTolerancePct = value; break;
+    case PARAM_JAM_G: t.jamVibrationG = value; break;
+    case PARAM_JAM_MS: t.jamDetectTimeMs = (unsigned long)lroundf(value); break;
+    case PARAM_VIB_WARN: t.vibrationWarningG = value; break;
+    case PARAM_VIB_CRIT: t.vibrationCriticalG = value; break;
+    default: break;
+  }
+}
+
+const char* ParamSpace::getParamName(SweepParam param) {
+  switch (param) {
+    case PARAM_SPEED_PCT: return "speed_pct";
+    case PARAM_JAM_G: return "jam_g";
+    case PARAM_JAM_MS: return "jam_ms";
+    case PARAM_VIB_WARN: return "vib_warn";
+    case PARAM_VIB_CRIT: return "vib_crit";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef PARAM_SPACE_H
+#define PARAM_SPACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "data_processing/anomaly_detector.h"
+
+/**
+ * @brief AnomalyThresholds fields that can be swept
+ */
+enum SweepParam {
+  PARAM_SPEED_PCT = 0,    // speed_pct - SPEED_TOLERANCE_PCT
+  PARAM_JAM_G,            // jam_g     - JAM_VIBRATION_THRESHOLD
+  PARAM_JAM_MS,           // jam_ms    - JAM_DETECT_TIME_MS
+  PARAM_VIB_WARN,         // vib_warn  - VIBRATION_WARNING_G
+  PARAM_VIB_CRIT,         // vib_crit  - VIBRATION_CRITICAL_G
+  PARAM_COUNT
+};
+
+/**
+ * @brief Search space over AnomalyThresholds
+ *
+ * Each parameter is fixed at its sensor_config.h default unless given a
+ * range with "name=lo:hi:step" (grid and random search) or a single value
+ * with "name=value".
+ */
+class ParamSpace {
+private:
+  struct Range {
+    float lo;
+    float hi;
+    float step;
+  };
+  Range ranges[PARAM_COUNT];
+
+  size_t stepsFor(SweepParam param) const;
+
+public:
+  ParamSpace();
+
+  /**
+   * @brief Parse one "name=lo[:hi[:step]]" specification
+   * @param spec Specification text
+   * @param error Set when the specification is rejected
+   * @return true on success
+   */
+  bool parse(const char* spec, std::string& error);
+
+  /**
+   * @brief Number of grid points
+   */
+  size_t gridSize() const;
+
+  /**
+   * @brief Append every grid point
+   */
+  void grid(std::vector<AnomalyThresholds>& out) const;
+
+  /**
+   * @brief Append uniform random points from the ranges (steps ignored)
+   */
+  void random(size_t count, uint32_t seed, std::vector<AnomalyThresholds>& out) const;
+
+  static float get(const AnomalyThresholds& t, SweepParam param);
+  static void set(AnomalyThresholds& t, SweepParam param, float value);
+  static const char* getParamName(SweepParam param);
+};
+
+#endif // PARAM_SPACE_H
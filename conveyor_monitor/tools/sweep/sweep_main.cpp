@@ -0,0 +1,201 @@
+/**
+ * Parameter-sweep backtester for the anomaly detector thresholds
+ *
+ * Evaluates a grid or random sample of AnomalyThresholds against labeled
+ * sensor traces (recorded CSV or simulated), one configuration per worker at
+ * a time on all cores, and ranks them by F1. Every configuration runs the
+ * unmodified StatisticalAnalyzer/AnomalyDetector with its thresholds injected.
+ *
+ *   sweep --simulate 240 --seeds 8 --param jam_g=0.15:0.35:0.05 --param jam_ms=4000:16000:2000
+ *   sweep --trace line3.csv --random 500 --param speed_pct=4:15 --param vib_warn=0.7:1.5
+ *
+ * The sensor_config.h defaults are always evaluated too and marked '*'.
+ * Exit status: 0 = ok, 2 = usage or unreadable input.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config/system_config.h"
+#include "param_space.h"
+#include "parallel_for.h"
+#include "trace_evaluator.h"
+
+struct Candidate {
+  AnomalyThresholds thresholds;
+  EvalScore score;
+  bool isDefault;
+};
+
+static void printRow(size_t rank, const Candidate& c) {
+  printf("%4zu%c", rank, c.isDefault ? '*' : ' ');
+  printf(" %9.2f %6.3f %7lu %8.3f %8.3f", c.thresholds.speedTolerancePct, c.thresholds.jamVibrationG,
+         c.thresholds.jamDetectTimeMs, c.thresholds.vibrationWarningG, c.thresholds.vibrationCriticalG);
+  printf(" %6.3f %6.3f %6.3f %7.1f %6.2f", c.score.precision(), c.score.recall(), c.score.f1(),
+         c.score.meanLatencySeconds(), c.score.falsePositivesPerHour());
+  for (int ch = 0; ch < DETECT_COUNT; ch++) {
+    printf(" %5.2f", c.score.recall((DetectorChannel)ch));
+  }
+  printf("\n");
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: sweep (--trace FILE... | --simulate MINUTES [--seeds N]) [options]\n"
+          "  --param NAME=LO[:HI[:STEP]]  sweep range (speed_pct, jam_g, jam_ms, vib_warn,\n"
+          "                               vib_crit); LO:HI alone gives 5 grid points\n"
+          "  --random N      N random points from the ranges instead of the grid\n"
+          "  --seed N        random search seed (default 1)\n"
+          "  --grace-ms N    onset may follow the incident end by this much (default 30000)\n"
+          "  --threads N     worker threads (default: all cores)\n"
+          "  --top N         rows to print (default 15)\n"
+          "  --csv FILE      write every configuration as CSV\n");
+}
+
+int main(int argc, char** argv) {
+  std::vector<const char*> tracePaths;
+  uint32_t simulateMinutes = 0;
+  uint32_t seeds = 4;
+  size_t randomCount = 0;
+  uint32_t randomSeed = 1;
+  uint32_t graceMs = 30000;
+  unsigned threads = std::thread::hardware_concurrency();
+  size_t top = 15;
+  const char* csvPath = nullptr;
+  ParamSpace space;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    std::string error;
+    if (arg == "--trace" && hasValue) tracePaths.push_back(argv[++i]);
+    else if (arg == "--simulate" && hasValue) simulateMinutes = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seeds" && hasValue) seeds = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--random" && hasValue) randomCount = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--seed" && hasValue) randomSeed = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--grace-ms" && hasValue) graceMs = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--threads" && hasValue) threads = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--top" && hasValue) top = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+    else if (arg == "--param" && hasValue) {
+      if (!space.parse(argv[++i], error)) {
+        fprintf(stderr, "sweep: %s\n", error.c_str());
+        return 2;
+      }
+    } else { usage(); return 2; }
+  }
+  if (tracePaths.empty() == (simulateMinutes == 0) || seeds == 0) {
+    usage();
+    return 2;
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+
+  // Labeled traces
+  std::vector<std::unique_ptr<SensorTrace>> traces;
+  for (const char* path : tracePaths) {
+    std::string error;
+    traces.emplace_back(new SensorTrace());
+    if (!traces.back()->loadCsv(path, error)) {
+      fprintf(stderr, "sweep: %s\n", error.c_str());
+      return 2;
+    }
+  }
+  for (uint32_t seed = 1; simulateMinutes > 0 && seed <= seeds; seed++) {
+    traces.emplace_back(new SensorTrace());
+    traces.back()->simulate(simulateMinutes, seed);
+  }
+  std::vector<TraceEvaluator> evaluators;
+  for (const auto& trace : traces) {
+    evaluators.emplace_back(*trace, graceMs, DATA_PROCESS_INTERVAL);
+  }
+
+  // Configurations: defaults first, then the grid or random sample
+  std::vector<AnomalyThresholds> configs;
+  configs.push_back(defaultAnomalyThresholds());
+  if (randomCount > 0) {
+    space.random(randomCount, randomSeed, configs);
+  } else {
+    space.grid(configs);
+  }
+
+  std::vector<Candidate> candidates(configs.size());
+  auto start = std::chrono::steady_clock::now();
+  std::vector<DetectorPipeline> pipelines(threads);
+  parallelFor(configs.size(), threads, [&](unsigned t, size_t i) {
+    Candidate& c = candidates[i];
+    c.thresholds = configs[i];
+    c.isDefault = (i == 0);
+    for (const TraceEvaluator& evaluator : evaluators) {
+      evaluator.evaluate(c.thresholds, pipelines[t], c.score);
+    }
+  });
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    if (a.score.f1() != b.score.f1()) return a.score.f1() > b.score.f1();
+    return a.score.meanLatencySeconds() < b.score.meanLatencySeconds();
+  });
+
+  printf("%5s %9s %6s %7s %8s %8s %6s %6s %6s %7s %6s", "rank", "speed_pct", "jam_g", "jam_ms",
+         "vib_warn", "vib_crit", "prec", "recall", "f1", "lat_s", "fp/h");
+  for (int ch = 0; ch < DETECT_COUNT; ch++) {
+    printf(" %5s", DetectorPipeline::getChannelName((DetectorChannel)ch));
+  }
+  printf("\n");
+  size_t defaultRank = 0;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (candidates[i].isDefault) {
+      defaultRank = i;
+    }
+    if (i < top) {
+      printRow(i + 1, candidates[i]);
+    }
+  }
+  if (defaultRank >= top) {
+    printf("  ...\n");
+    printRow(defaultRank + 1, candidates[defaultRank]);
+  }
+
+  if (csvPath) {
+    FILE* f = fopen(csvPath, "w");
+    if (!f) {
+      fprintf(stderr, "sweep: cannot write %s\n", csvPath);
+      return 2;
+    }
+    fprintf(f, "rank,default,speed_pct,jam_g,jam_ms,vib_warn,vib_crit,precision,recall,f1,latency_s,fp_per_hour");
+    for (int ch = 0; ch < DETECT_COUNT; ch++) {
+      const char* name = DetectorPipeline::getChannelName((DetectorChannel)ch);
+      fprintf(f, ",%s_incidents,%s_detected,%s_onsets,%s_tp", name, name, name, name);
+    }
+    fprintf(f, "\n");
+    for (size_t i = 0; i < candidates.size(); i++) {
+      const Candidate& c = candidates[i];
+      fprintf(f, "%zu,%d,%.3f,%.4f,%lu,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.3f", i + 1, c.isDefault ? 1 : 0,
+              c.thresholds.speedTolerancePct, c.thresholds.jamVibrationG, c.thresholds.jamDetectTimeMs,
+              c.thresholds.vibrationWarningG, c.thresholds.vibrationCriticalG, c.score.precision(),
+              c.score.recall(), c.score.f1(), c.score.meanLatencySeconds(), c.score.falsePositivesPerHour());
+      for (int ch = 0; ch < DETECT_COUNT; ch++) {
+        fprintf(f, ",%u,%u,%u,%u", c.score.incidents[ch], c.score.detected[ch], c.score.onsets[ch],
+                c.score.truePositives[ch]);
+      }
+      fprintf(f, "\n");
+    }
+    fclose(f);
+  }
+
+  double traceHours = 0;
+  for (const auto& trace : traces) {
+    traceHours += trace->durationMs() / 3600000.0;
+  }
+  double updates = (double)configs.size() * traceHours * 3600000.0 / DATA_PROCESS_INTERVAL;
+  printf("\n%zu configurations x %zu traces (%.1f h) in %.2f s on %u threads: %.0f configs/s, %.2fM updates/s\n",
+         configs.size(), traces.size(), traceHours, seconds, threads,
+         seconds > 0 ? configs.size() / seconds : 0.0, seconds > 0 ? updates / seconds / 1e6 : 0.0);
+  return 0;
+}
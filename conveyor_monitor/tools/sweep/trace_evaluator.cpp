@@ -0,0 +1,154 @@
+#include "trace_evaluator.h"
+
+EvalScore::EvalScore() {
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    onsets[i] = truePositives[i] = incidents[i] = detected[i] = 0;
+    latencySumMs[i] = 0;
+  }
+  hours = 0;
+}
+
+void EvalScore::add(const EvalScore& other) {
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    onsets[i] += other.onsets[i];
+    truePositives[i] += other.truePositives[i];
+    incidents[i] += other.incidents[i];
+    detected[i] += other.detected[i];
+    latencySumMs[i] += other.latencySumMs[i];
+  }
+  hours += other.hours;
+}
+
+double EvalScore::precision() const {
+  uint32_t all = 0, tp = 0;
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    all += onsets[i];
+    tp += truePositives[i];
+  }
+  return all ? (double)tp / all : 1.0;
+}
+
+double EvalScore::recall() const {
+  uint32_t all = 0, found = 0;
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    all += incidents[i];
+    found += detected[i];
+  }
+  return all ? (double)found / all : 1.0;
+}
+
+double EvalScore::recall(DetectorChannel channel) const {
+  return incidents[channel] ? (double)detected[channel] / incidents[channel] : 1.0;
+}
+
+double EvalScore::f1() const {
+  double p = precision();
+  double r = recall();
+  return (p + r) > 0 ? 2.0 * p * r / (p + r) : 0.0;
+}
+
+double EvalScore::meanLatencySeconds() const {
+  uint32_t found = 0;
+  double sum = 0;
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    found += detected[i];
+    sum += latencySumMs[i];
+  }
+  return found ? sum / found / 1000.0 : 0.0;
+}
+
+double EvalScore::falsePositivesPerHour() const {
+  uint32_t fp = 0;
+  for (int i = 0; i < DETECT_COUNT; i++) {
+    fp += onsets[i] - truePositives[i];
+  }
+  return hours > 0 ? fp / hours : 0.0;
+}
+
+TraceEvaluator::TraceEvaluator(const SensorTrace& trace, uint32_t graceMs, uint32_t stepMs)
+  : trace(trace), graceMs(graceMs), stepMs(stepMs) {
+  for (const Incident& incident : trace.incidents()) {
+    DetectorChannel channel = channelFor(incident.label);
+    if (channel < DETECT_COUNT) {
+      incidents[channel].push_back(incident);
+    }
+  }
+}
+
+DetectorChannel TraceEvaluator::channelFor(IncidentLabel label) {
+  switch (label) {
+    case LABEL_SPEED: return DETECT_SPEED;
+    case LABEL_JAM: return DETECT_JAM;
+    case LABEL_VIBRATION: return DETECT_VIBRATION;
+    case LABEL_ENVIRONMENT: return DETECT_ENVIRONMENT;
+    default: return DETECT_COUNT;
+  }
+}
+
+void TraceEvaluator::evaluate(const AnomalyThresholds& thresholds, DetectorPipeline& pipeline,
+                              EvalScore& score) const {
+  EvalScore local;
+  std::vector<bool> found[DETECT_COUNT];
+  size_t cursor[DETECT_COUNT];
+  for (int c = 0; c < DETECT_COUNT; c++) {
+    local.incidents[c] = (uint32_t)incidents[c].size();
+    found[c].assign(incidents[c].size(), false);
+    cursor[c] = 0;
+  }
+
+  pipeline.reset(thresholds);
+  IAQEstimator iaqEstimator;
+  iaqEstimator.begin();
+  SystemState state = {};
+  size_t index = 0;
+  uint32_t duration = trace.durationMs();
+  for (uint32_t now = 0; now <= duration && trace.size() > 0; now += stepMs) {
+    while (index + 1 < trace.size() && trace[index + 1].t_ms <= now) {
+      index++;
+    }
+    const TraceSample& sample = trace[index];
+    hostSetMicros((uint64_t)now * 1000);
+
+    // Same derivation as readSensors() in the sketch
+    state.speed_rpm = sample.speed_rpm;
+    state.conveyorRunning = (sample.speed_rpm > MIN_SPEED_THRESHOLD);
+    state.vibrationLevel = sample.vibration_g;
+    state.temperature = sample.temp_c;
+    state.humidity = sample.humidity_pct;
+    state.pressure = sample.pressure_hpa;
+    state.gasResistance = sample.gas_ohm;
+    iaqEstimator.update(sample.gas_ohm, sample.humidity_pct);
+    state.iaq = iaqEstimator.getIAQ();
+    state.iaqAccuracy = iaqEstimator.getAccuracy();
+    state.operatorPresent = sample.proximity > 0;
+    state.validMask = FIELD_ALL_MASK & ~(sample.distance_mm == 0 ? FIELD_BIT(FIELD_PARTS) : 0);
+    state.staleMask = 0;
+
+    bool onsets[DETECT_COUNT];
+    pipeline.update(state, onsets);
+
+    for (int c = 0; c < DETECT_COUNT; c++) {
+      if (!onsets[c]) {
+        continue;
+      }
+      local.onsets[c]++;
+
+      // Incidents are in time order and onsets only move forward
+      const std::vector<Incident>& list = incidents[c];
+      while (cursor[c] < list.size() && list[cursor[c]].end_ms + graceMs < now) {
+        cursor[c]++;
+      }
+      if (cursor[c] < list.size() && list[cursor[c]].start_ms <= now) {
+        local.truePositives[c]++;
+        if (!found[c][cursor[c]]) {
+          found[c][cursor[c]] = true;
+          local.detected[c]++;
+          local.latencySumMs[c] += now - list[cursor[c]].start_ms;
+        }
+      }
+    }
+  }
+
+  local.hours = duration / 3600000.0;
+  score.add(local);
+}
@@ -0,0 +1,64 @@
+#ifndef TRACE_EVALUATOR_H
+#define TRACE_EVALUATOR_H
+
+#include <stdint.h>
+#include <vector>
+#include "detector_pipeline.h"
+#include "sensor_trace.h"
+
+/**
+ * @brief Detection counts for one configuration, summed over traces
+ */
+struct EvalScore {
+  uint32_t onsets[DETECT_COUNT];        // Detector onsets
+  uint32_t truePositives[DETECT_COUNT]; // Onsets inside a same-type incident (+ grace)
+  uint32_t incidents[DETECT_COUNT];     // Labeled incidents
+  uint32_t detected[DETECT_COUNT];      // Incidents with at least one onset
+  double latencySumMs[DETECT_COUNT];    // Incident start to first onset
+  double hours;                         // Trace time evaluated
+
+  EvalScore();
+  void add(const EvalScore& other);
+
+  double precision() const;
+  double recall() const;
+  double f1() const;
+  double meanLatencySeconds() const;
+  double falsePositivesPerHour() const;
+  double recall(DetectorChannel channel) const;
+};
+
+/**
+ * @brief Scores detector thresholds against one labeled trace
+ *
+ * The trace is resampled at DATA_PROCESS_INTERVAL (the device's 2 Hz
+ * processing rate) into SystemState updates for a DetectorPipeline. An
+ * onset counts as a true positive when it falls inside an incident of the
+ * matching label or within the grace period after it; the incident is then
+ * detected with latency = onset - incident start. Sensor-fault incidents
+ * are not scored because no detector targets them.
+ *
+ * The trace is only read, so one evaluator can be shared by all threads.
+ */
+class TraceEvaluator {
+private:
+  const SensorTrace& trace;
+  std::vector<Incident> incidents[DETECT_COUNT];
+  uint32_t graceMs;
+  uint32_t stepMs;
+
+public:
+  TraceEvaluator(const SensorTrace& trace, uint32_t graceMs, uint32_t stepMs);
+
+  /**
+   * @brief Run one configuration over the trace
+   * @param thresholds Detector thresholds
+   * @param pipeline Caller's (per-thread) pipeline, reset here
+   * @param score Counts are added to this score
+   */
+  void evaluate(const AnomalyThresholds& thresholds, DetectorPipeline& pipeline, EvalScore& score) const;
+
+  static DetectorChannel channelFor(IncidentLabel label);
+};
+
+#endif // TRACE_EVALUATOR_H